@@ -16,6 +16,7 @@
 #include "vtkCallbackCommand.h"
 #include "vtkDebugLeaks.h"
 #include "vtkGarbageCollector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObject.h"
 #include "vtkSmartPointer.h"
 
@@ -74,6 +75,25 @@ static void MyDeleteCallback(vtkObject*, unsigned long, void*, void*)
   called = 1;
 }
 
+// A callback that counts its calls.
+static int deleted = 0;
+static void MyCountingDeleteCallback(vtkObject*, unsigned long, void*, void*)
+{
+  ++deleted;
+}
+
+// Delete the object given to the second thread.
+static VTK_THREAD_RETURN_TYPE MyThreadedDelete(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  if(info->ThreadID == 1)
+    {
+    static_cast<vtkObject*>(info->UserData)->Delete();
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 // Main test function.
 int TestGarbageCollector(int,char *[])
 {
@@ -115,5 +135,53 @@ int TestGarbageCollector(int,char *[])
     return 1;
     }
 
+  // Defer the collection of several objects and collect them a few at
+  // a time.
+  vtkSmartPointer<vtkCallbackCommand> counter =
+    vtkSmartPointer<vtkCallbackCommand>::New();
+  counter->SetCallback(MyCountingDeleteCallback);
+  vtkGarbageCollector::DeferredCollectionPush();
+  for(int i = 0; i < 10; ++i)
+    {
+    obj = vtkTestReferenceLoop::New();
+    obj->AddObserver(vtkCommand::DeleteEvent, counter);
+    obj->Delete();
+    }
+  deleted = 0;
+  if(vtkGarbageCollector::GetNumberOfDeferredObjects() != 10 ||
+     vtkGarbageCollector::CollectIncremental(3) != 7 || deleted != 3)
+    {
+    cerr << "Incremental collection did not collect 3 objects." << endl;
+    return 1;
+    }
+  if(vtkGarbageCollector::CollectIncremental(100) != 0 || deleted != 10)
+    {
+    cerr << "Incremental collection did not collect all objects." << endl;
+    return 1;
+    }
+
+  // Release an object from another thread while collection is
+  // deferred.  The main thread collects it.
+  obj = vtkTestReferenceLoop::New();
+  obj->AddObserver(vtkCommand::DeleteEvent, counter);
+  deleted = 0;
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(2);
+  threader->SetSingleMethod(MyThreadedDelete, obj);
+  threader->SingleMethodExecute();
+  threader->Delete();
+  if(deleted != 0 || vtkGarbageCollector::GetNumberOfDeferredObjects() != 1)
+    {
+    cerr << "Collection of object released by a thread not deferred."
+         << endl;
+    return 1;
+    }
+  vtkGarbageCollector::DeferredCollectionPop();
+  if(deleted != 1)
+    {
+    cerr << "Object released by a thread not collected." << endl;
+    return 1;
+    }
+
   return 0;
 }
@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestObjectPerformance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test speed of the basic vtkObject operations.
+// .SECTION Description
+// Probe the speed of vtkObject::Modified (without observers, with an
+// observer of another event and with a ModifiedEvent observer),
+// vtkObject::InvokeEvent, vtkTimeStamp::Modified and New/Delete, and check
+// that time stamps taken concurrently are unique.
+
+#include "vtkCommand.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkTimeStamp.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <vector>
+
+// How many times each operation is repeated.
+static const int OPERATION_COUNT = 1000000;
+
+//------------------------------------------------------------------------------
+class vtkCountingCommand : public vtkCommand
+{
+public:
+  static vtkCountingCommand* New() { return new vtkCountingCommand();}
+  vtkTypeMacro(vtkCountingCommand, vtkCommand);
+
+  virtual void Execute(vtkObject*, unsigned long, void*)
+    {
+      ++this->Count;
+    }
+
+  int Count;
+
+protected:
+  vtkCountingCommand() : Count(0) {}
+};
+
+//------------------------------------------------------------------------------
+class TimeStampFunctor
+{
+public:
+  vtkSMPThreadLocal<std::vector<unsigned long> > Stamps;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<unsigned long>& stamps = this->Stamps.Local();
+    vtkTimeStamp stamp;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      stamp.Modified();
+      stamps.push_back(stamp.GetMTime());
+      }
+  }
+};
+
+//------------------------------------------------------------------------------
+static void ReportTime(const char* name, vtkTimerLog* timer)
+{
+  // Nanoseconds per operation.
+  double time = 1.0e9 * timer->GetElapsedTime() / OPERATION_COUNT;
+  std::cout << "<DartMeasurement name=\"" << name
+            << "\" type=\"numeric/double\">"
+            << time << "</DartMeasurement>" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+int TestObjectPerformance(int, char*[])
+{
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkObject> object;
+
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    object->Modified();
+    }
+  timer->StopTimer();
+  ReportTime("Modified-NoObserver", timer.GetPointer());
+
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    object->InvokeEvent(vtkCommand::ModifiedEvent);
+    }
+  timer->StopTimer();
+  ReportTime("InvokeEvent-NoObserver", timer.GetPointer());
+
+  vtkNew<vtkCountingCommand> otherObserver;
+  object->AddObserver(vtkCommand::DeleteEvent, otherObserver.GetPointer());
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    object->Modified();
+    }
+  timer->StopTimer();
+  ReportTime("Modified-OtherObserver", timer.GetPointer());
+  if (otherObserver->Count != 0)
+    {
+    std::cerr << "DeleteEvent observer called by Modified." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkCountingCommand> modifiedObserver;
+  object->AddObserver(vtkCommand::ModifiedEvent,
+                      modifiedObserver.GetPointer());
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    object->Modified();
+    }
+  timer->StopTimer();
+  ReportTime("Modified-Observer", timer.GetPointer());
+  if (modifiedObserver->Count != OPERATION_COUNT)
+    {
+    std::cerr << "ModifiedEvent observer called " << modifiedObserver->Count
+              << " times instead of " << OPERATION_COUNT << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkTimeStamp stamp;
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    stamp.Modified();
+    }
+  timer->StopTimer();
+  ReportTime("TimeStamp-Modified", timer.GetPointer());
+
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    vtkObject::New()->Delete();
+    }
+  timer->StopTimer();
+  ReportTime("NewDelete-vtkObject", timer.GetPointer());
+
+  timer->StartTimer();
+  for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+    vtkIdList::New()->Delete();
+    }
+  timer->StopTimer();
+  ReportTime("NewDelete-vtkIdList", timer.GetPointer());
+
+  // Time stamps taken by several threads must all be different.
+  TimeStampFunctor functor;
+  timer->StartTimer();
+  vtkSMPTools::For(0, OPERATION_COUNT, functor);
+  timer->StopTimer();
+  ReportTime("TimeStamp-Modified-SMP", timer.GetPointer());
+
+  std::vector<unsigned long> stamps;
+  vtkSMPThreadLocal<std::vector<unsigned long> >::iterator iter;
+  for (iter = functor.Stamps.begin(); iter != functor.Stamps.end(); ++iter)
+    {
+    stamps.insert(stamps.end(), iter->begin(), iter->end());
+    }
+  std::sort(stamps.begin(), stamps.end());
+  if (stamps.size() != static_cast<size_t>(OPERATION_COUNT) ||
+      std::adjacent_find(stamps.begin(), stamps.end()) != stamps.end())
+    {
+    std::cerr << "Time stamps taken concurrently are not unique."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
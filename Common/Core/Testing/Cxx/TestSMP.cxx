@@ -16,9 +16,13 @@
 #include "vtkNew.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPSort.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
 
+#include <algorithm>
+#include <vector>
+
 static const int Target = 10000;
 
 class ARangeFunctor
@@ -89,6 +93,81 @@ public:
 
 };
 
+// Orders the (key, index) pairs by key only, so that equal keys are left
+// in an unspecified order.
+struct KeyLess
+{
+  bool operator()(const std::pair<int, int>& a,
+                  const std::pair<int, int>& b) const
+  {
+    return a.first < b.first;
+  }
+};
+
+// Sorts odd sized ranges with many duplicate keys in a given number of
+// chunks, so that the chunked merge runs whatever the SMP back-end.
+static bool TestSort()
+{
+  const vtkIdType sizes[] = { 0, 1, 2, 7, 1001, 4099, 30011 };
+  const vtkIdType chunks[] = { 1, 2, 3, 5, 8, 64, 40000 };
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+    std::vector<int> values(sizes[s]);
+    std::vector<std::pair<int, int> > pairs(sizes[s]);
+    for (vtkIdType i = 0; i < sizes[s]; ++i)
+      {
+      values[i] = static_cast<int>((i * 7919) % 97);
+      pairs[i] = std::make_pair(values[i], static_cast<int>(i));
+      }
+    std::vector<int> expected(values);
+    std::sort(expected.begin(), expected.end());
+
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c)
+      {
+      std::vector<int> sorted(values);
+      vtkSMPSort::Sort(sorted.begin(), sorted.end(),
+                       vtk::detail::smp::vtkSMPSort_Less<int>(), chunks[c]);
+      if (sorted != expected)
+        {
+        cerr << "Error: sorting " << sizes[s] << " values in " << chunks[c]
+             << " chunks gave a wrong order" << endl;
+        return false;
+        }
+
+      std::vector<std::pair<int, int> > sortedPairs(pairs);
+      vtkSMPSort::Sort(sortedPairs.begin(), sortedPairs.end(), KeyLess(),
+                       chunks[c]);
+      std::vector<int> seen(sizes[s], 0);
+      for (vtkIdType i = 0; i < sizes[s]; ++i)
+        {
+        if (sortedPairs[i].first != expected[i] ||
+            seen[sortedPairs[i].second]++ != 0)
+          {
+          cerr << "Error: sorting " << sizes[s] << " pairs in " << chunks[c]
+               << " chunks lost or reordered elements" << endl;
+          return false;
+          }
+        }
+      }
+    }
+
+  std::vector<int> values(5000);
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    values[i] = static_cast<int>(values.size() - i) / 3;
+    }
+  vtkSMPSort::Sort(&values[0], &values[0] + values.size());
+  for (size_t i = 1; i < values.size(); ++i)
+    {
+    if (values[i - 1] > values[i])
+      {
+      cerr << "Error: vtkSMPSort::Sort did not sort the values" << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
 int TestSMP(int, char*[])
 {
   //vtkSMPTools::Initialize(8);
@@ -135,5 +214,10 @@ int TestSMP(int, char*[])
     return 1;
     }
 
+  if (!TestSort())
+    {
+    return 1;
+    }
+
   return 0;
 }
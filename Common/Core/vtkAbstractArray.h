@@ -506,6 +506,13 @@ protected:
   // information keys. See CopyInformation.
   virtual void SetInformation( vtkInformation* );
 
+  // Description:
+  // Arrays do not report references to the garbage collector.
+  virtual bool MayReportReferences() const
+  {
+    return false;
+  }
+
   // Description:
   // Obtain the set of unique values taken on by each component of the array,
   // as well as by the tuples of the array.
@@ -16,6 +16,7 @@
 
 #include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkSmartPointerBase.h"
 
 #include <vtksys/ios/sstream>
@@ -66,10 +67,11 @@ static bool vtkGarbageCollectorGlobalDebugFlag;
 
 //----------------------------------------------------------------------------
 // The thread identifier of the main thread.  Delayed garbage
-// collection is supported only for objects in the main thread.  This
-// is initialized when the program loads.  All garbage collection
-// calls test whether they are called from this thread.  If not, no
-// references are accepted by the singleton.  This must be default
+// collection is done only in the main thread.  This is initialized
+// when the program loads.  All garbage collection calls test whether
+// they are called from this thread.  If not, the singleton accepts
+// references only while collection is deferred, and hands them to the
+// main thread at its next collection.  This must be default
 // initialized to zero by the compiler and is therefore not
 // initialized here.  The ClassInitialize and ClassFinalize methods
 // handle it.
@@ -140,6 +142,10 @@ public:
     // not try to report the call back to the garbage collector.
     obj->UnRegisterInternal(from, 0);
     }
+  static bool MayReportReferences(vtkObjectBase* obj)
+    {
+    return obj->MayReportReferences();
+    }
 };
 
 //----------------------------------------------------------------------------
@@ -165,6 +171,13 @@ public:
   // Internal implementation of vtkGarbageCollector::TakeReference.
   int TakeReference(vtkObjectBase* obj);
 
+  // Called by GiveReference in other threads than the main thread.
+  int GiveThreadReference(vtkObjectBase* obj);
+
+  // Move the references given by other threads to the map.  Called
+  // only in the main thread.
+  void MergeThreadReferences();
+
   // Called by GiveReference to decide whether to accept a reference.
   int CheckAccept();
 
@@ -185,8 +198,14 @@ public:
   int TotalNumberOfReferences;
 
   // The number of times DeferredCollectionPush has been called not
-  // matched by a DeferredCollectionPop.
+  // matched by a DeferredCollectionPop.  Modified in the main thread
+  // while holding the lock, read by other threads with the lock.
   int DeferredCollectionCount;
+
+  // References given by other threads, waiting to be merged into the
+  // map by the main thread.
+  std::vector<vtkObjectBase*> ThreadReferences;
+  vtkSimpleCriticalSection ThreadReferencesLock;
 };
 
 //----------------------------------------------------------------------------
@@ -233,12 +252,21 @@ public:
     EntryEdge(Entry* r, void* p): Reference(r), Pointer(p) {}
   };
 
+  // A reference to an object that is not visited because it reports
+  // no references.
+  struct LeafEdge
+  {
+    vtkObjectBase* Object;
+    void* Pointer;
+    LeafEdge(vtkObjectBase* o, void* p): Object(o), Pointer(p) {}
+  };
+
   // Store garbage collection entries keyed by object.
   struct Entry
   {
     Entry(vtkObjectBase* obj): Object(obj), Root(0), Component(0),
                                VisitOrder(0), Count(0), GarbageCount(0),
-                               References() {}
+                               References(), LeafReferences() {}
     ~Entry() { assert(this->GarbageCount == 0); }
 
     // The object corresponding to this entry.
@@ -263,6 +291,10 @@ public:
     // The list of references reported by this entry's object.
     typedef std::vector<EntryEdge> ReferencesType;
     ReferencesType References;
+
+    // The references to objects that are not visited.
+    typedef std::vector<LeafEdge> LeafReferencesType;
+    LeafReferencesType LeafReferences;
   };
 
   // Compare entries by object pointer for quick lookup.
@@ -630,6 +662,15 @@ void vtkGarbageCollectorImpl::Report(vtkObjectBase* obj, void* ptr,
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorImpl::Report(vtkObjectBase* obj, void* ptr)
 {
+  // An object that reports no references cannot be part of a reference
+  // loop.  Do not visit it, only remember the reference so that it is
+  // removed if the current object is collected.
+  if(!vtkGarbageCollectorToObjectBaseFriendship::MayReportReferences(obj))
+    {
+    this->Current->LeafReferences.push_back(LeafEdge(obj, ptr));
+    return;
+    }
+
   // Get the source and destination of this reference.
   Entry* v = this->Current;
   Entry* w = this->MaybeVisit(obj);
@@ -686,6 +727,17 @@ void vtkGarbageCollectorImpl::CollectComponent(ComponentType* c)
       vtkGarbageCollectorToObjectBaseFriendship::UnRegister(obj,
                                                             entry->Object);
       }
+
+    // Remove the references to objects that were not visited.  They
+    // are deleted if nothing else holds them.
+    for(unsigned int i = 0; i < entry->LeafReferences.size(); ++i)
+      {
+      vtkObjectBase* obj = entry->LeafReferences[i].Object;
+      void** ptr = static_cast<void**>(entry->LeafReferences[i].Pointer);
+      *ptr = 0;
+      vtkGarbageCollectorToObjectBaseFriendship::UnRegister(obj,
+                                                            entry->Object);
+      }
     }
 
   // Remove the Entries' references to objects.
@@ -879,6 +931,12 @@ void vtkGarbageCollector::Collect()
   // This must be called only from the main thread.
   assert(vtkGarbageCollectorIsMainThread());
 
+  // Take the references given by other threads.
+  if(vtkGarbageCollectorSingletonInstance)
+    {
+    vtkGarbageCollectorSingletonInstance->MergeThreadReferences();
+    }
+
   // Keep collecting until no deferred checks exist.
   while(vtkGarbageCollectorSingletonInstance &&
         vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0)
@@ -892,6 +950,49 @@ void vtkGarbageCollector::Collect()
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::CollectIncremental(int maximumNumberOfChecks)
+{
+  // This must be called only from the main thread.
+  assert(vtkGarbageCollectorIsMainThread());
+
+  if(!vtkGarbageCollectorSingletonInstance)
+    {
+    return 0;
+    }
+
+  // Take the references given by other threads.
+  vtkGarbageCollectorSingletonInstance->MergeThreadReferences();
+
+  // Collect starting from at most maximumNumberOfChecks deferred
+  // objects.
+  for(int i = 0; i < maximumNumberOfChecks &&
+        vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0; ++i)
+    {
+    vtkObjectBase* root =
+      vtkGarbageCollectorSingletonInstance->References.begin()->first;
+    vtkGarbageCollector::Collect(root);
+    }
+
+  return static_cast<int>(
+    vtkGarbageCollectorSingletonInstance->References.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::GetNumberOfDeferredObjects()
+{
+  // This must be called only from the main thread.
+  assert(vtkGarbageCollectorIsMainThread());
+
+  if(!vtkGarbageCollectorSingletonInstance)
+    {
+    return 0;
+    }
+  vtkGarbageCollectorSingletonInstance->MergeThreadReferences();
+  return static_cast<int>(
+    vtkGarbageCollectorSingletonInstance->References.size());
+}
+
 //----------------------------------------------------------------------------
 void vtkGarbageCollector::Collect(vtkObjectBase* root)
 {
@@ -939,10 +1040,13 @@ int vtkGarbageCollector::GiveReference(vtkObjectBase* obj)
   assert(obj != 0);
 
   // See if the singleton will accept a reference.
-  if(vtkGarbageCollectorIsMainThread() &&
-     vtkGarbageCollectorSingletonInstance)
+  if(vtkGarbageCollectorSingletonInstance)
     {
-    return vtkGarbageCollectorSingletonInstance->GiveReference(obj);
+    if(vtkGarbageCollectorIsMainThread())
+      {
+      return vtkGarbageCollectorSingletonInstance->GiveReference(obj);
+      }
+    return vtkGarbageCollectorSingletonInstance->GiveThreadReference(obj);
     }
 
   // Could not accept the reference.
@@ -1027,6 +1131,37 @@ int vtkGarbageCollectorSingleton::TakeReference(vtkObjectBase* obj)
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int vtkGarbageCollectorSingleton::GiveThreadReference(vtkObjectBase* obj)
+{
+  // Walking the reference graph from another thread than the main one
+  // could visit objects in use by the main thread.  While collection is
+  // deferred, keep the reference for the main thread.  Otherwise the
+  // caller collects immediately in its own thread.
+  this->ThreadReferencesLock.Lock();
+  int accept = this->DeferredCollectionCount > 0;
+  if(accept)
+    {
+    this->ThreadReferences.push_back(obj);
+    }
+  this->ThreadReferencesLock.Unlock();
+  return accept;
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollectorSingleton::MergeThreadReferences()
+{
+  this->ThreadReferencesLock.Lock();
+  for(std::vector<vtkObjectBase*>::iterator i = this->ThreadReferences.begin(),
+        iend = this->ThreadReferences.end(); i != iend; ++i)
+    {
+    ++this->References[*i];
+    ++this->TotalNumberOfReferences;
+    }
+  this->ThreadReferences.clear();
+  this->ThreadReferencesLock.Unlock();
+}
+
 //----------------------------------------------------------------------------
 int vtkGarbageCollectorSingleton::CheckAccept()
 {
@@ -1043,7 +1178,10 @@ int vtkGarbageCollectorSingleton::CheckAccept()
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorSingleton::DeferredCollectionPush()
 {
-  if(++this->DeferredCollectionCount <= 0)
+  this->ThreadReferencesLock.Lock();
+  int count = ++this->DeferredCollectionCount;
+  this->ThreadReferencesLock.Unlock();
+  if(count <= 0)
     {
     // Deferred collection is disabled.  Collect immediately.
     vtkGarbageCollector::Collect();
@@ -1053,7 +1191,10 @@ void vtkGarbageCollectorSingleton::DeferredCollectionPush()
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorSingleton::DeferredCollectionPop()
 {
-  if(--this->DeferredCollectionCount <= 0)
+  this->ThreadReferencesLock.Lock();
+  int count = --this->DeferredCollectionCount;
+  this->ThreadReferencesLock.Unlock();
+  if(count <= 0)
     {
     // Deferred collection is disabled.  Collect immediately.
     vtkGarbageCollector::Collect();
@@ -72,6 +72,15 @@
 //
 // If subclassing from a class that already supports garbage
 // collection, one need only provide the ReportReferences method.
+//
+// Objects whose MayReportReferences method returns false, such as
+// arrays and most data objects, are not visited during the reference
+// graph walk since they cannot be part of a reference loop.
+//
+// References released by other threads than the main thread while
+// collection is deferred are handed to the main thread, which checks
+// them at its next collection.  Applications that defer collection
+// can bound the work done per call with CollectIncremental.
 
 #ifndef vtkGarbageCollector_h
 #define vtkGarbageCollector_h
@@ -122,6 +131,19 @@ public:
   // collecting in this case.
   static void Collect(vtkObjectBase* root);
 
+  // Description:
+  // Collect using at most maximumNumberOfChecks of the objects whose
+  // collection was deferred as roots for reference graph walks, for
+  // example from an idle callback while DeferredCollectionPush is in
+  // effect.  Returns the number of objects whose collection is still
+  // deferred.
+  static int CollectIncremental(int maximumNumberOfChecks);
+
+  // Description:
+  // Return the number of objects whose collection was deferred and not
+  // checked yet.
+  static int GetNumberOfDeferredObjects();
+
   // Description:
   // Push/Pop whether to do deferred collection.  Whenever the total
   // number of pushes exceeds the total number of pops collection will
@@ -462,6 +462,19 @@ int vtkSubjectHelper::InvokeEvent(unsigned long event, void *callData,
 {
   int focusHandled = 0;
 
+  // Most events, ModifiedEvent in particular, have no observer. Return
+  // before setting up the passes over the observers.
+  vtkObserver *elem = this->Start;
+  while (elem &&
+         elem->Event != event && elem->Event != vtkCommand::AnyEvent)
+    {
+    elem = elem->Next;
+    }
+  if (!elem)
+    {
+    return 0;
+    }
+
   // When we invoke an event, the observer may add or remove observers.  To make
   // sure that the iteration over the observers goes smoothly, we capture any
   // change to the list with the ListModified ivar.  However, an observer may
@@ -479,7 +492,7 @@ int vtkSubjectHelper::InvokeEvent(unsigned long event, void *callData,
   // invocation.
   typedef std::vector<unsigned long> VisitedListType;
   VisitedListType visited;
-  vtkObserver *elem = this->Start;
+  elem = this->Start;
   // If an element with a tag greater than maxTag is found, that means it has
   // been added after InvokeEvent is called (as a side effect of calling an
   // element command. In that case, the element is discarded and not executed.
@@ -848,7 +861,12 @@ void vtkObject::InternalReleaseFocus()
 void vtkObject::Modified()
 {
   this->MTime.Modified();
-  this->InvokeEvent(vtkCommand::ModifiedEvent,NULL);
+
+  // Objects without observers only pay for the time stamp.
+  if (this->SubjectHelper)
+    {
+    this->SubjectHelper->InvokeEvent(vtkCommand::ModifiedEvent, NULL, this);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -175,6 +175,15 @@ protected:
   // See vtkGarbageCollector.h:
   virtual void ReportReferences(vtkGarbageCollector*);
 
+  // Description:
+  // Return false when ReportReferences() never reports a reference, so
+  // that the garbage collector does not walk into instances of the class.
+  // A subclass of such a class that reports references must return true.
+  virtual bool MayReportReferences() const
+  {
+    return true;
+  }
+
 private:
   //BTX
   friend VTKCOMMONCORE_EXPORT ostream& operator<<(ostream& os, vtkObjectBase& o);
@@ -0,0 +1,174 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPSort.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPSort - Parallel sort built on vtkSMPTools.
+// .SECTION Description
+// vtkSMPSort sorts a range by splitting it into chunks that are sorted
+// concurrently with vtkSMPTools::For and then merged pairwise, each level
+// of merges also running concurrently. It lives apart from vtkSMPTools so
+// that only the code that sorts depends on the standard algorithms.
+//
+// .SECTION See Also
+// vtkSMPTools
+
+#ifndef vtkSMPSort_h
+#define vtkSMPSort_h
+
+#include "vtkSMPTools.h"
+
+#include <algorithm> // For std::sort and std::inplace_merge
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#ifndef __WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+// Sorts each chunk of [begin, begin+size) independently.
+template <typename RandomAccessIterator, typename Compare>
+class vtkSMPSort_SortChunks
+{
+public:
+  vtkSMPSort_SortChunks(RandomAccessIterator begin, vtkIdType size,
+                        vtkIdType chunkSize, Compare comp)
+    : Begin(begin), Size(size), ChunkSize(chunkSize), Comp(comp)
+  {
+  }
+
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    for (vtkIdType chunk = first; chunk < last; ++chunk)
+      {
+      vtkIdType start = std::min(chunk * this->ChunkSize, this->Size);
+      vtkIdType end = std::min(start + this->ChunkSize, this->Size);
+      std::sort(this->Begin + start, this->Begin + end, this->Comp);
+      }
+  }
+
+private:
+  RandomAccessIterator Begin;
+  vtkIdType Size;
+  vtkIdType ChunkSize;
+  Compare Comp;
+};
+
+// Merges pairs of adjacent sorted runs of the given width.
+template <typename RandomAccessIterator, typename Compare>
+class vtkSMPSort_MergeChunks
+{
+public:
+  vtkSMPSort_MergeChunks(RandomAccessIterator begin, vtkIdType size,
+                         vtkIdType width, Compare comp)
+    : Begin(begin), Size(size), Width(width), Comp(comp)
+  {
+  }
+
+  void operator()(vtkIdType first, vtkIdType last) const
+  {
+    for (vtkIdType pair = first; pair < last; ++pair)
+      {
+      vtkIdType start = 2 * pair * this->Width;
+      vtkIdType middle = std::min(start + this->Width, this->Size);
+      vtkIdType end = std::min(middle + this->Width, this->Size);
+      std::inplace_merge(this->Begin + start, this->Begin + middle,
+                         this->Begin + end, this->Comp);
+      }
+  }
+
+private:
+  RandomAccessIterator Begin;
+  vtkIdType Size;
+  vtkIdType Width;
+  Compare Comp;
+};
+
+// Default comparison used by vtkSMPSort.
+template <typename T>
+struct vtkSMPSort_Less
+{
+  bool operator()(const T& a, const T& b) const
+  {
+    return a < b;
+  }
+};
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // __WRAP__
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+class vtkSMPSort
+{
+public:
+  // Description:
+  // Sort the range [begin, end) in parallel using comp as the ordering.
+  // The number of chunks is chosen from the number of threads of the
+  // SMP back-end, so that small ranges and sequential builds simply use
+  // std::sort. As with std::sort, the relative order of equivalent
+  // elements is not preserved, so comp should define a total order when
+  // the result has to be deterministic.
+  template <typename RandomAccessIterator, typename Compare>
+  static void Sort(RandomAccessIterator begin, RandomAccessIterator end,
+                   Compare comp)
+  {
+    vtkIdType size = static_cast<vtkIdType>(end - begin);
+    int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+    vtkIdType numChunks = numThreads <= 1 ? 1 :
+      std::min(static_cast<vtkIdType>(4 * numThreads), size / 4096);
+    vtkSMPSort::Sort(begin, end, comp, numChunks);
+  }
+
+  // Description:
+  // Sort the range [begin, end) in parallel using operator<.
+  template <typename T>
+  static void Sort(T* begin, T* end)
+  {
+    vtkSMPSort::Sort(begin, end, vtk::detail::smp::vtkSMPSort_Less<T>());
+  }
+
+  // Description:
+  // Sort the range [begin, end) using comp as the ordering, after
+  // splitting it into numChunks chunks of equal size (the last one may be
+  // shorter). Each chunk is sorted concurrently and adjacent sorted runs
+  // are then merged pairwise until one run is left. With numChunks <= 1
+  // this is std::sort.
+  template <typename RandomAccessIterator, typename Compare>
+  static void Sort(RandomAccessIterator begin, RandomAccessIterator end,
+                   Compare comp, vtkIdType numChunks)
+  {
+    vtkIdType size = static_cast<vtkIdType>(end - begin);
+    if (numChunks <= 1 || size <= 1)
+      {
+      std::sort(begin, end, comp);
+      return;
+      }
+    vtkIdType chunkSize = (size + numChunks - 1) / numChunks;
+    numChunks = (size + chunkSize - 1) / chunkSize;
+    vtk::detail::smp::vtkSMPSort_SortChunks<RandomAccessIterator, Compare>
+      sorter(begin, size, chunkSize, comp);
+    vtkSMPTools::For(0, numChunks, 1, sorter);
+    for (vtkIdType width = chunkSize; width < size; width *= 2)
+      {
+      vtk::detail::smp::vtkSMPSort_MergeChunks<RandomAccessIterator, Compare>
+        merger(begin, size, width, comp);
+      vtkSMPTools::For(0, (size + 2 * width - 1) / (2 * width), 1, merger);
+      }
+  }
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPSort.h
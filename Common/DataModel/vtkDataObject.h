@@ -368,6 +368,14 @@ protected:
   vtkDataObject();
   ~vtkDataObject();
 
+  // Description:
+  // Data objects do not report references to the garbage collector,
+  // except for the subclasses that override this method.
+  virtual bool MayReportReferences() const
+  {
+    return false;
+  }
+
   // General field data associated with data object
   vtkFieldData  *FieldData;
 
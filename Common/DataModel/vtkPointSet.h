@@ -118,6 +118,10 @@ protected:
   vtkPointLocator *Locator;
 
   virtual void ReportReferences(vtkGarbageCollector*);
+  virtual bool MayReportReferences() const
+  {
+    return true;
+  }
 private:
 
   void Cleanup();
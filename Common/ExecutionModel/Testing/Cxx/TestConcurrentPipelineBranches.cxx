@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConcurrentPipelineBranches.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Appends the outputs of several independent sources, of a source shared
+// by two branches and of a source that requires serial execution, using
+// vtkThreadedCompositeDataPipeline, and checks that every source executed
+// exactly once.
+
+#include "vtkAppendPolyData.h"
+#include "vtkAtomicTypes.h"
+#include "vtkCellArray.h"
+#include "vtkCleanPolyData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkThreadedCompositeDataPipeline.h"
+
+#define TEST_SUCCESS 0
+#define TEST_FAILURE 1
+
+// A source producing NumberOfPoints vertices, counting its executions.
+class vtkTestCountingSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestCountingSource* New();
+  vtkTypeMacro(vtkTestCountingSource, vtkPolyDataAlgorithm);
+
+  vtkSetMacro(NumberOfPoints, int);
+
+  int GetNumberOfExecutions() { return this->NumberOfExecutions; }
+
+protected:
+  vtkTestCountingSource() : NumberOfPoints(1), NumberOfExecutions(0)
+  {
+    this->SetNumberOfInputPorts(0);
+  }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector* outputVector)
+  {
+    vtkPolyData* output = vtkPolyData::GetData(outputVector);
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkCellArray> verts;
+    for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+      points->InsertNextPoint(i, this->NumberOfPoints, 0.0);
+      verts->InsertNextCell(1, &i);
+      }
+    output->SetPoints(points.GetPointer());
+    output->SetVerts(verts.GetPointer());
+    ++this->NumberOfExecutions;
+    return 1;
+  }
+
+  int NumberOfPoints;
+  vtkAtomicInt32 NumberOfExecutions;
+
+private:
+  vtkTestCountingSource(const vtkTestCountingSource&);  // Not implemented.
+  void operator=(const vtkTestCountingSource&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkTestCountingSource);
+
+int TestConcurrentPipelineBranches(int, char*[])
+{
+  const int numSources = 6;
+  vtkNew<vtkTestCountingSource> sources[numSources];
+  vtkNew<vtkTestCountingSource> shared;
+  vtkNew<vtkCleanPolyData> cleans[2];
+  vtkNew<vtkTestCountingSource> serial;
+  vtkNew<vtkAppendPolyData> append;
+
+  vtkNew<vtkThreadedCompositeDataPipeline> executive;
+  append->SetExecutive(executive.GetPointer());
+
+  int expectedPoints = 0;
+  for (int i = 0; i < numSources; ++i)
+    {
+    sources[i]->SetNumberOfPoints(10 + i);
+    append->AddInputConnection(sources[i]->GetOutputPort());
+    expectedPoints += 10 + i;
+    }
+
+  // Two inputs sharing the same source are updated by the same task.
+  shared->SetNumberOfPoints(100);
+  for (int i = 0; i < 2; ++i)
+    {
+    cleans[i]->SetInputConnection(shared->GetOutputPort());
+    append->AddInputConnection(cleans[i]->GetOutputPort());
+    expectedPoints += 100;
+    }
+
+  serial->SetNumberOfPoints(1000);
+  serial->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+  append->AddInputConnection(serial->GetOutputPort());
+  expectedPoints += 1000;
+
+  for (int pass = 0; pass < 2; ++pass)
+    {
+    if (pass == 1)
+      {
+      // Only the modified branch executes again.
+      sources[2]->Modified();
+      }
+    append->Update();
+
+    vtkIdType numPoints = append->GetOutput()->GetNumberOfPoints();
+    if (numPoints != expectedPoints)
+      {
+      cerr << __LINE__ << ": ERROR: " << numPoints << " points, expected "
+           << expectedPoints << endl;
+      return TEST_FAILURE;
+      }
+
+    for (int i = 0; i < numSources; ++i)
+      {
+      int expected = (pass == 1 && i == 2) ? 2 : 1;
+      if (sources[i]->GetNumberOfExecutions() != expected)
+        {
+        cerr << __LINE__ << ": ERROR: source " << i << " executed "
+             << sources[i]->GetNumberOfExecutions() << " times." << endl;
+        return TEST_FAILURE;
+        }
+      }
+    if (shared->GetNumberOfExecutions() != 1 ||
+        serial->GetNumberOfExecutions() != 1)
+      {
+      cerr << __LINE__ << ": ERROR: shared source executed "
+           << shared->GetNumberOfExecutions() << " times, serial source "
+           << serial->GetNumberOfExecutions() << " times." << endl;
+      return TEST_FAILURE;
+      }
+    }
+
+  return TEST_SUCCESS;
+}
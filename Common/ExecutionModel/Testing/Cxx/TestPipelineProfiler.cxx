@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkCellArray.h"
+#include "vtkCleanPolyData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPipelineProfiler.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkPolyDataNormals.h"
+
+#include <vtksys/ios/sstream>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILURE 1
+
+// A filter that runs an internal pipeline, to produce nested requests.
+class vtkTestNestedPipelineFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestNestedPipelineFilter* New();
+  vtkTypeMacro(vtkTestNestedPipelineFilter, vtkPolyDataAlgorithm);
+
+protected:
+  virtual int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+  {
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+    vtkPolyData* output = vtkPolyData::GetData(outputVector);
+
+    vtkNew<vtkCleanPolyData> clean;
+    clean->SetInputData(input);
+    clean->Update();
+    output->ShallowCopy(clean->GetOutput());
+    return 1;
+  }
+};
+vtkStandardNewMacro(vtkTestNestedPipelineFilter);
+
+int TestPipelineProfiler(int, char*[])
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 1.0, 0.0);
+  points->InsertNextPoint(0.0, 1.0, 0.0);
+  vtkNew<vtkCellArray> polys;
+  vtkIdType quad[4] = { 0, 1, 2, 3 };
+  polys->InsertNextCell(4, quad);
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  polyData->SetPolys(polys.GetPointer());
+
+  vtkNew<vtkTestNestedPipelineFilter> nested;
+  nested->SetInputData(polyData.GetPointer());
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputConnection(nested->GetOutputPort());
+
+  vtkNew<vtkPipelineProfiler> profiler;
+  profiler->Start();
+  if (vtkPipelineProfiler::GetActiveProfiler() != profiler.GetPointer())
+    {
+    cerr << __LINE__ << ": ERROR: the profiler is not active." << endl;
+    return TEST_FAILURE;
+    }
+  normals->Update();
+  profiler->Stop();
+
+  vtkIdType numEvents = profiler->GetNumberOfEvents();
+  if (numEvents == 0 || profiler->GetNumberOfDroppedEvents() != 0)
+    {
+    cerr << __LINE__ << ": ERROR: " << numEvents << " events recorded." << endl;
+    return TEST_FAILURE;
+    }
+
+  // Nothing is recorded once the profiler is stopped.
+  nested->Modified();
+  normals->Update();
+  if (profiler->GetNumberOfEvents() != numEvents)
+    {
+    cerr << __LINE__ << ": ERROR: events recorded after Stop()." << endl;
+    return TEST_FAILURE;
+    }
+
+  // The caller's stream format is left as it was.
+  vtksys_ios::ostringstream trace;
+  trace.precision(9);
+  std::ios::fmtflags flags = trace.flags();
+  profiler->WriteChromeTrace(trace);
+  if (trace.precision() != 9 || trace.flags() != flags)
+    {
+    cerr << __LINE__ << ": ERROR: WriteChromeTrace changed the stream format."
+         << endl;
+    return TEST_FAILURE;
+    }
+  std::string traceString = trace.str();
+  const char* expected[] =
+    {
+    "{\"traceEvents\":[",
+    "\"name\":\"vtkPolyDataNormals\",\"cat\":\"REQUEST_DATA\"",
+    "\"name\":\"vtkTestNestedPipelineFilter\",\"cat\":\"REQUEST_INFORMATION\"",
+    "\"name\":\"vtkCleanPolyData\",\"cat\":\"REQUEST_DATA\"",
+    // vtkCleanPolyData runs inside the REQUEST_DATA of the nested filter.
+    "\"depth\":1",
+    "\"points\":4,\"cells\":1"
+    };
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i)
+    {
+    if (traceString.find(expected[i]) == std::string::npos)
+      {
+      cerr << __LINE__ << ": ERROR: " << expected[i]
+           << " not found in trace:\n" << traceString << endl;
+      return TEST_FAILURE;
+      }
+    }
+
+  vtksys_ios::ostringstream summary;
+  summary.precision(9);
+  profiler->PrintSummary(summary);
+  if (summary.precision() != 9 || summary.flags() != flags)
+    {
+    cerr << __LINE__ << ": ERROR: PrintSummary changed the stream format."
+         << endl;
+    return TEST_FAILURE;
+    }
+  if (summary.str().find("vtkPolyDataNormals") == std::string::npos ||
+      summary.str().find("REQUEST_UPDATE_EXTENT") == std::string::npos)
+    {
+    cerr << __LINE__ << ": ERROR: unexpected summary:\n" << summary.str()
+         << endl;
+    return TEST_FAILURE;
+    }
+  cout << summary.str();
+
+  profiler->Clear();
+  if (profiler->GetNumberOfEvents() != 0)
+    {
+    cerr << __LINE__ << ": ERROR: Clear() did not remove the events." << endl;
+    return TEST_FAILURE;
+    }
+
+  return TEST_SUCCESS;
+}
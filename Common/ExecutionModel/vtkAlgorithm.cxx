@@ -145,7 +145,13 @@ void vtkAlgorithm::SetProgressObserver(vtkProgressObserver* po)
 // should range between (0,1).
 void vtkAlgorithm::UpdateProgress(double amount)
 {
-  if (this->ProgressObserver)
+  if (this->Executive && this->Executive->GetBackgroundUpdate())
+    {
+    // The observers expect to run on the thread driving the pipeline,
+    // not on the one updating it in the background.
+    this->Progress = amount;
+    }
+  else if (this->ProgressObserver)
     {
     this->ProgressObserver->UpdateProgress(amount);
     }
@@ -88,6 +88,9 @@ vtkDemandDrivenPipeline::ComputePipelineMTime(vtkInformation* request,
                                               int requestFromOutputPort,
                                               unsigned long* mtime)
 {
+  // Keep other threads out of the pipeline while it is traversed.
+  vtkExecutiveRequestLocker locker(this);
+
   // The pipeline's MTime starts with this algorithm's MTime.
   // Invoke the request on the algorithm.
   this->InAlgorithm = 1;
@@ -161,6 +164,9 @@ int vtkDemandDrivenPipeline::ProcessRequest(vtkInformation* request,
                                             vtkInformationVector** inInfoVec,
                                             vtkInformationVector* outInfoVec)
 {
+  // Keep other threads out of the executive while it serves the request.
+  vtkExecutiveRequestLocker locker(this);
+
   // The algorithm should not invoke anything on the executive.
   if(!this->CheckAlgorithm("ProcessRequest", request))
     {
@@ -309,6 +315,8 @@ int vtkDemandDrivenPipeline::Update()
 //----------------------------------------------------------------------------
 int vtkDemandDrivenPipeline::Update(int port)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   if(!this->UpdateInformation())
     {
     return 0;
@@ -548,8 +556,12 @@ void vtkDemandDrivenPipeline::ExecuteDataStart(vtkInformation* request,
       }
     }
 
-  // Tell observers the algorithm is about to execute.
-  this->Algorithm->InvokeEvent(vtkCommand::StartEvent,NULL);
+  // Tell observers the algorithm is about to execute, unless it is
+  // updated by a background thread they do not expect to run on.
+  if(!this->BackgroundUpdate)
+    {
+    this->Algorithm->InvokeEvent(vtkCommand::StartEvent,NULL);
+    }
 
   // The algorithm has not yet made any progress.
   this->Algorithm->SetAbortExecute(0);
@@ -568,7 +580,10 @@ void vtkDemandDrivenPipeline::ExecuteDataEnd(vtkInformation* request,
     }
 
   // Tell observers the algorithm is done executing.
-  this->Algorithm->InvokeEvent(vtkCommand::EndEvent,NULL);
+  if(!this->BackgroundUpdate)
+    {
+    this->Algorithm->InvokeEvent(vtkCommand::EndEvent,NULL);
+    }
 
   // Tell outputs they have been generated.
   this->MarkOutputsGenerated(request,inInfoVec,outputs);
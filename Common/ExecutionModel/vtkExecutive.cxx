@@ -16,6 +16,7 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
+#include "vtkAtomicTypes.h"
 #include "vtkDataObject.h"
 #include "vtkGarbageCollector.h"
 #include "vtkInformation.h"
@@ -25,7 +26,10 @@
 #include "vtkInformationIterator.h"
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineProfiler.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkSmartPointer.h"
 
 #include <vector>
@@ -50,10 +54,16 @@ public:
   vtkExecutiveInternals();
   ~vtkExecutiveInternals();
   vtkInformationVector** GetInputInformation(int newNumberOfPorts);
+
+  // The recursive request lock: the owner thread is only compared
+  // while the depth is positive, and only the holder changes either.
+  vtkSimpleCriticalSection RequestLock;
+  vtkMultiThreaderIDType RequestLockOwner;
+  vtkAtomicInt32 RequestLockDepth;
 };
 
 //----------------------------------------------------------------------------
-vtkExecutiveInternals::vtkExecutiveInternals()
+vtkExecutiveInternals::vtkExecutiveInternals(): RequestLockDepth(0)
 {
 }
 
@@ -122,6 +132,7 @@ vtkExecutive::vtkExecutive()
   this->OutputInformation = vtkInformationVector::New();
   this->Algorithm = 0;
   this->InAlgorithm = 0;
+  this->BackgroundUpdate = 0;
   this->SharedInputInformation = 0;
   this->SharedOutputInformation = 0;
 }
@@ -163,6 +174,32 @@ void vtkExecutive::UnRegister(vtkObjectBase* o)
   this->UnRegisterInternal(o, 1);
 }
 
+//----------------------------------------------------------------------------
+void vtkExecutive::LockRequests()
+{
+  vtkExecutiveInternals* internal = this->ExecutiveInternal;
+  vtkMultiThreaderIDType self = vtkMultiThreader::GetCurrentThreadID();
+  if(internal->RequestLockDepth > 0 &&
+     vtkMultiThreader::ThreadsEqual(internal->RequestLockOwner, self))
+    {
+    ++internal->RequestLockDepth;
+    return;
+    }
+  internal->RequestLock.Lock();
+  internal->RequestLockOwner = self;
+  internal->RequestLockDepth = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutive::UnlockRequests()
+{
+  vtkExecutiveInternals* internal = this->ExecutiveInternal;
+  if(--internal->RequestLockDepth == 0)
+    {
+    internal->RequestLock.Unlock();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkExecutive::SetAlgorithm(vtkAlgorithm* newAlgorithm)
 {
@@ -771,9 +808,18 @@ int vtkExecutive::CallAlgorithm(vtkInformation* request, int direction,
   this->CopyDefaultInformation(request, direction, inInfo, outInfo);
 
   // Invoke the request on the algorithm.
+  vtkPipelineProfiler* profiler = vtkPipelineProfiler::GetActiveProfiler();
+  if (profiler)
+    {
+    profiler->BeginRequest(this->Algorithm, request);
+    }
   this->InAlgorithm = 1;
   int result = this->Algorithm->ProcessRequest(request, inInfo, outInfo);
   this->InAlgorithm = 0;
+  if (profiler)
+    {
+    profiler->EndRequest(this->Algorithm, request, outInfo);
+    }
 
   // If the algorithm failed report it now.
   if(!result)
@@ -147,6 +147,25 @@ public:
   void SetSharedInputInformation(vtkInformationVector** inInfoVec);
   void SetSharedOutputInformation(vtkInformationVector* outInfoVec);
 
+  // Description:
+  // Lock and unlock the requests of this executive.  The executives
+  // in this module hold the lock while they process a request, so a
+  // thread updating a pipeline in the background can keep every other
+  // thread out of the executives it updates by locking them first.
+  // The lock is recursive.
+  void LockRequests();
+  void UnlockRequests();
+
+  // Description:
+  // Set/Get whether the executive is updating its algorithm on behalf
+  // of a background thread.  While it is set the start, end and
+  // progress events of the algorithm are not invoked, as their
+  // observers expect to be called on the thread driving the pipeline.
+  // Setting this does not change the executive modification time.
+  void SetBackgroundUpdate(int background)
+    { this->BackgroundUpdate = background; }
+  int GetBackgroundUpdate() { return this->BackgroundUpdate; }
+
   // Description:
   // Participate in garbage collection.
   virtual void Register(vtkObjectBase* o);
@@ -229,6 +248,9 @@ protected:
   // Flag set when the algorithm is processing a request.
   int InAlgorithm;
 
+  // Flag set when the algorithm is updated by a background thread.
+  int BackgroundUpdate;
+
   // Pointers to an outside instance of input or output information.
   // No references are held.  These are used to implement internal
   // pipelines.
@@ -250,4 +272,19 @@ private:
   void operator=(const vtkExecutive&);  // Not implemented.
 };
 
+//BTX
+// Holds the request lock of an executive until the end of the scope.
+class vtkExecutiveRequestLocker
+{
+public:
+  vtkExecutiveRequestLocker(vtkExecutive* executive): Executive(executive)
+    { this->Executive->LockRequests(); }
+  ~vtkExecutiveRequestLocker() { this->Executive->UnlockRequests(); }
+private:
+  vtkExecutive* Executive;
+  vtkExecutiveRequestLocker(const vtkExecutiveRequestLocker&);  // Not implemented.
+  void operator=(const vtkExecutiveRequestLocker&);  // Not implemented.
+};
+//ETX
+
 #endif
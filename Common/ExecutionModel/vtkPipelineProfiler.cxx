@@ -0,0 +1,545 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPipelineProfiler.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkAtomic.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataSet.h"
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationRequestKey.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
+
+#ifdef _WIN32
+# include "vtkWindows.h"
+#endif
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkPipelineProfiler);
+
+namespace
+{
+const int vtkPipelineProfilerMaximumNumberOfThreads = 256;
+
+vtkAtomic<vtkPipelineProfiler*> vtkPipelineProfilerActiveProfiler(
+  static_cast<vtkPipelineProfiler*>(NULL));
+
+//----------------------------------------------------------------------------
+// CPU time used by the calling thread, in seconds.
+double vtkPipelineProfilerGetThreadCPUTime()
+{
+#if defined(_WIN32)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime,
+                     &kernelTime, &userTime))
+    {
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    return (kernel.QuadPart + user.QuadPart) * 1e-7;
+    }
+  return 0.0;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    {
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+    }
+  return 0.0;
+#else
+  // Process CPU time, the best we can do portably.
+  return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPipelineProfilerGetRequestName(vtkInformation* request)
+{
+  static vtkInformationRequestKey* const keys[] =
+    {
+    vtkDemandDrivenPipeline::REQUEST_DATA(),
+    vtkDemandDrivenPipeline::REQUEST_INFORMATION(),
+    vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT(),
+    vtkDemandDrivenPipeline::REQUEST_DATA_OBJECT(),
+    vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_TIME(),
+    vtkStreamingDemandDrivenPipeline::REQUEST_TIME_DEPENDENT_INFORMATION(),
+    vtkDemandDrivenPipeline::REQUEST_DATA_NOT_GENERATED()
+    };
+  for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i)
+    {
+    if (request->Has(keys[i]))
+      {
+      return keys[i]->GetName();
+      }
+    }
+  return "OTHER_REQUEST";
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfilerCountOutput(vtkDataObject* dobj,
+                                    vtkIdType& numPoints, vtkIdType& numCells)
+{
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj))
+    {
+    numPoints += ds->GetNumberOfPoints();
+    numCells += ds->GetNumberOfCells();
+    }
+  else if (vtkCompositeDataSet* cds = vtkCompositeDataSet::SafeDownCast(dobj))
+    {
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(cds->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
+      {
+      vtkPipelineProfilerCountOutput(iter->GetCurrentDataObject(),
+                                     numPoints, numCells);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+struct vtkPipelineProfilerEvent
+{
+  const char* ClassName;
+  const void* Algorithm;
+  const char* Request;
+  double StartTime;
+  double WallTime;
+  double ChildrenTime;
+  double CPUTime;
+  int Depth;
+  unsigned long MemorySize;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+};
+
+//----------------------------------------------------------------------------
+// The events of one thread. Only the owning thread appends to it while
+// profiling.
+struct vtkPipelineProfilerThreadBuffer
+{
+  vtkMultiThreaderIDType ThreadId;
+  std::vector<vtkPipelineProfilerEvent> Events;
+  // Indices of the events that have begun but not ended yet, and the CPU
+  // time at which they started.
+  std::vector<std::pair<size_t, double> > OpenEvents;
+};
+
+//----------------------------------------------------------------------------
+struct vtkPipelineProfilerSummary
+{
+  vtkPipelineProfilerSummary() : Calls(0), WallTime(0.0), SelfTime(0.0),
+    CPUTime(0.0), MemorySize(0), NumberOfPoints(-1), NumberOfCells(-1)
+  {
+  }
+
+  vtkIdType Calls;
+  double WallTime;
+  double SelfTime;
+  double CPUTime;
+  unsigned long MemorySize;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+};
+
+typedef std::pair<std::string, std::string> vtkPipelineProfilerSummaryKey;
+typedef std::pair<vtkPipelineProfilerSummaryKey, vtkPipelineProfilerSummary>
+  vtkPipelineProfilerSummaryEntry;
+
+bool vtkPipelineProfilerMoreSelfTime(
+  const vtkPipelineProfilerSummaryEntry& a,
+  const vtkPipelineProfilerSummaryEntry& b)
+{
+  return a.second.SelfTime > b.second.SelfTime;
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkPipelineProfiler::vtkInternals
+{
+public:
+  vtkInternals() : NumberOfBuffers(0), NumberOfDroppedEvents(0),
+    Origin(-1.0)
+  {
+  }
+
+  ~vtkInternals()
+  {
+    this->Clear();
+  }
+
+  void Clear()
+  {
+    int numBuffers = this->NumberOfBuffers.load();
+    for (int i = 0; i < numBuffers; ++i)
+      {
+      delete this->Buffers[i];
+      }
+    this->NumberOfBuffers = 0;
+    this->NumberOfDroppedEvents = 0;
+    this->Origin = -1.0;
+  }
+
+  // Find the buffer of the calling thread, creating it if needed. Only the
+  // creation is locked: a buffer is published by incrementing
+  // NumberOfBuffers after it has been stored.
+  vtkPipelineProfilerThreadBuffer* GetThreadBuffer()
+  {
+    vtkMultiThreaderIDType self = vtkMultiThreader::GetCurrentThreadID();
+    int numBuffers = this->NumberOfBuffers.load();
+    for (int i = 0; i < numBuffers; ++i)
+      {
+      if (vtkMultiThreader::ThreadsEqual(this->Buffers[i]->ThreadId, self))
+        {
+        return this->Buffers[i];
+        }
+      }
+
+    this->Lock.Lock();
+    vtkPipelineProfilerThreadBuffer* buffer = NULL;
+    numBuffers = this->NumberOfBuffers.load();
+    if (numBuffers < vtkPipelineProfilerMaximumNumberOfThreads)
+      {
+      buffer = new vtkPipelineProfilerThreadBuffer;
+      buffer->ThreadId = self;
+      this->Buffers[numBuffers] = buffer;
+      ++this->NumberOfBuffers;
+      }
+    this->Lock.Unlock();
+    return buffer;
+  }
+
+  vtkPipelineProfilerThreadBuffer*
+    Buffers[vtkPipelineProfilerMaximumNumberOfThreads];
+  vtkAtomic<int> NumberOfBuffers;
+  vtkAtomic<vtkIdType> NumberOfDroppedEvents;
+  vtkSimpleCriticalSection Lock;
+  double Origin;
+};
+
+//----------------------------------------------------------------------------
+vtkPipelineProfiler::vtkPipelineProfiler()
+{
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineProfiler::~vtkPipelineProfiler()
+{
+  this->Stop();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::Start()
+{
+  if (this->Internals->Origin < 0.0)
+    {
+    this->Internals->Origin = vtkTimerLog::GetUniversalTime();
+    }
+  vtkPipelineProfilerActiveProfiler = this;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::Stop()
+{
+  if (vtkPipelineProfilerActiveProfiler.load() == this)
+    {
+    vtkPipelineProfilerActiveProfiler = static_cast<vtkPipelineProfiler*>(NULL);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineProfiler* vtkPipelineProfiler::GetActiveProfiler()
+{
+  return vtkPipelineProfilerActiveProfiler.load();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::Clear()
+{
+  this->Internals->Clear();
+  if (vtkPipelineProfilerActiveProfiler.load() == this)
+    {
+    this->Internals->Origin = vtkTimerLog::GetUniversalTime();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPipelineProfiler::GetNumberOfEvents()
+{
+  vtkIdType numEvents = 0;
+  int numBuffers = this->Internals->NumberOfBuffers.load();
+  for (int i = 0; i < numBuffers; ++i)
+    {
+    numEvents +=
+      static_cast<vtkIdType>(this->Internals->Buffers[i]->Events.size());
+    }
+  return numEvents;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPipelineProfiler::GetNumberOfDroppedEvents()
+{
+  return this->Internals->NumberOfDroppedEvents.load();
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineProfiler::GetMaximumNumberOfThreads()
+{
+  return vtkPipelineProfilerMaximumNumberOfThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::BeginRequest(vtkAlgorithm* algorithm,
+                                       vtkInformation* request)
+{
+  vtkPipelineProfilerThreadBuffer* buffer = this->Internals->GetThreadBuffer();
+  if (!buffer)
+    {
+    ++this->Internals->NumberOfDroppedEvents;
+    return;
+    }
+
+  vtkPipelineProfilerEvent event;
+  event.ClassName = algorithm->GetClassName();
+  event.Algorithm = algorithm;
+  event.Request = vtkPipelineProfilerGetRequestName(request);
+  event.WallTime = 0.0;
+  event.ChildrenTime = 0.0;
+  event.CPUTime = 0.0;
+  event.Depth = static_cast<int>(buffer->OpenEvents.size());
+  event.MemorySize = 0;
+  event.NumberOfPoints = -1;
+  event.NumberOfCells = -1;
+
+  buffer->OpenEvents.push_back(std::make_pair(
+    buffer->Events.size(), vtkPipelineProfilerGetThreadCPUTime()));
+  event.StartTime = vtkTimerLog::GetUniversalTime();
+  buffer->Events.push_back(event);
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::EndRequest(vtkAlgorithm* algorithm,
+                                     vtkInformation* request,
+                                     vtkInformationVector* outInfo)
+{
+  double endTime = vtkTimerLog::GetUniversalTime();
+  double endCPUTime = vtkPipelineProfilerGetThreadCPUTime();
+
+  vtkPipelineProfilerThreadBuffer* buffer = this->Internals->GetThreadBuffer();
+  if (!buffer || buffer->OpenEvents.empty())
+    {
+    // The profiler was started while the algorithm was executing.
+    return;
+    }
+
+  vtkPipelineProfilerEvent& event =
+    buffer->Events[buffer->OpenEvents.back().first];
+  if (event.Algorithm != algorithm)
+    {
+    vtkWarningMacro("Unbalanced requests for " << algorithm->GetClassName());
+    return;
+    }
+  event.WallTime = endTime - event.StartTime;
+  event.CPUTime = endCPUTime - buffer->OpenEvents.back().second;
+  buffer->OpenEvents.pop_back();
+  if (!buffer->OpenEvents.empty())
+    {
+    buffer->Events[buffer->OpenEvents.back().first].ChildrenTime +=
+      event.WallTime;
+    }
+
+  if (outInfo && request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    event.NumberOfPoints = 0;
+    event.NumberOfCells = 0;
+    for (int i = 0; i < outInfo->GetNumberOfInformationObjects(); ++i)
+      {
+      vtkDataObject* output = outInfo->GetInformationObject(i)->Get(
+        vtkDataObject::DATA_OBJECT());
+      if (output)
+        {
+        event.MemorySize += output->GetActualMemorySize();
+        vtkPipelineProfilerCountOutput(output, event.NumberOfPoints,
+                                       event.NumberOfCells);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::WriteChromeTrace(ostream& os)
+{
+  double origin = this->Internals->Origin;
+  int numBuffers = this->Internals->NumberOfBuffers.load();
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+
+  os << "{\"traceEvents\":[\n";
+  bool first = true;
+  for (int tid = 0; tid < numBuffers; ++tid)
+    {
+    os << (first ? "" : ",\n")
+       << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+       << ",\"args\":{\"name\":\"Thread " << tid << "\"}}";
+    first = false;
+
+    const std::vector<vtkPipelineProfilerEvent>& events =
+      this->Internals->Buffers[tid]->Events;
+    for (size_t i = 0; i < events.size(); ++i)
+      {
+      const vtkPipelineProfilerEvent& event = events[i];
+      os << ",\n{\"name\":\"" << event.ClassName
+         << "\",\"cat\":\"" << event.Request
+         << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+         << ",\"ts\":" << std::fixed << std::setprecision(3)
+         << (event.StartTime - origin) * 1e6
+         << ",\"dur\":" << event.WallTime * 1e6
+         << ",\"args\":{\"algorithm\":\"" << event.Algorithm
+         << "\",\"depth\":" << event.Depth
+         << ",\"self_us\":" << (event.WallTime - event.ChildrenTime) * 1e6
+         << ",\"cpu_us\":" << event.CPUTime * 1e6;
+      if (event.NumberOfPoints >= 0)
+        {
+        os << ",\"memory_kib\":" << event.MemorySize
+           << ",\"points\":" << event.NumberOfPoints
+           << ",\"cells\":" << event.NumberOfCells;
+        }
+      os << "}}";
+      }
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineProfiler::WriteChromeTrace(const char* fileName)
+{
+  std::ofstream os(fileName);
+  if (!os)
+    {
+    vtkErrorMacro("Unable to open " << (fileName ? fileName : "(null)"));
+    return 0;
+    }
+  this->WriteChromeTrace(os);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::PrintSummary(ostream& os)
+{
+  std::map<vtkPipelineProfilerSummaryKey, vtkPipelineProfilerSummary> table;
+  int numBuffers = this->Internals->NumberOfBuffers.load();
+  for (int tid = 0; tid < numBuffers; ++tid)
+    {
+    const std::vector<vtkPipelineProfilerEvent>& events =
+      this->Internals->Buffers[tid]->Events;
+    for (size_t i = 0; i < events.size(); ++i)
+      {
+      const vtkPipelineProfilerEvent& event = events[i];
+      vtkPipelineProfilerSummary& summary = table[
+        vtkPipelineProfilerSummaryKey(event.ClassName, event.Request)];
+      summary.Calls++;
+      summary.WallTime += event.WallTime;
+      summary.SelfTime += event.WallTime - event.ChildrenTime;
+      summary.CPUTime += event.CPUTime;
+      summary.MemorySize = std::max(summary.MemorySize, event.MemorySize);
+      summary.NumberOfPoints =
+        std::max(summary.NumberOfPoints, event.NumberOfPoints);
+      summary.NumberOfCells =
+        std::max(summary.NumberOfCells, event.NumberOfCells);
+      }
+    }
+
+  std::vector<vtkPipelineProfilerSummaryEntry> entries(table.begin(),
+                                                       table.end());
+  std::stable_sort(entries.begin(), entries.end(),
+                   vtkPipelineProfilerMoreSelfTime);
+
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::left
+     << std::setw(40) << "Algorithm"
+     << std::setw(36) << "Request"
+     << std::right
+     << std::setw(8) << "Calls"
+     << std::setw(12) << "Wall (s)"
+     << std::setw(12) << "Self (s)"
+     << std::setw(12) << "CPU (s)"
+     << std::setw(14) << "Memory (KiB)"
+     << std::setw(12) << "Points"
+     << std::setw(12) << "Cells" << "\n";
+  for (size_t i = 0; i < entries.size(); ++i)
+    {
+    const vtkPipelineProfilerSummary& summary = entries[i].second;
+    os << std::left
+       << std::setw(40) << entries[i].first.first
+       << std::setw(36) << entries[i].first.second
+       << std::right << std::fixed
+       << std::setprecision(6)
+       << std::setw(8) << summary.Calls
+       << std::setw(12) << summary.WallTime
+       << std::setw(12) << summary.SelfTime
+       << std::setw(12) << summary.CPUTime;
+    if (summary.NumberOfPoints >= 0)
+      {
+      os << std::setw(14) << summary.MemorySize
+         << std::setw(12) << summary.NumberOfPoints
+         << std::setw(12) << summary.NumberOfCells;
+      }
+    os << "\n";
+    }
+  if (this->GetNumberOfDroppedEvents() > 0)
+    {
+    os << this->GetNumberOfDroppedEvents() << " events were dropped.\n";
+    }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Active: "
+     << (vtkPipelineProfilerActiveProfiler.load() == this ? "Yes" : "No")
+     << "\n";
+  os << indent << "NumberOfThreads: "
+     << this->Internals->NumberOfBuffers.load() << "\n";
+  os << indent << "NumberOfEvents: " << this->GetNumberOfEvents() << "\n";
+  os << indent << "NumberOfDroppedEvents: "
+     << this->GetNumberOfDroppedEvents() << "\n";
+}
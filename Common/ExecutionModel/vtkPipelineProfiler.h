@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineProfiler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPipelineProfiler - Record the requests executed by all algorithms
+// .SECTION Description
+// vtkPipelineProfiler records every request pass (REQUEST_DATA_OBJECT,
+// REQUEST_INFORMATION, REQUEST_UPDATE_EXTENT, REQUEST_DATA, ...) that an
+// executive sends to its algorithm while the profiler is started. For each
+// call it records the wall clock and CPU time, the time spent in nested
+// calls (for example, an internal pipeline run by a filter), the thread
+// that made the call and, for REQUEST_DATA, the memory size and the number
+// of points and cells of the outputs.
+//
+// Each thread records its events in its own buffer, so that algorithms
+// executed concurrently (for example by vtkThreadedCompositeDataPipeline)
+// do not serialize on the profiler. The only lock is taken the first time
+// a thread records an event.
+//
+// Only one profiler is active at a time. The recorded events can be
+// exported in the Chrome trace event format (load the file in
+// chrome://tracing) or summarized per algorithm class and request.
+//
+// .SECTION Caveats
+// The profiler must not be deleted, cleared or exported while a pipeline
+// is executing.
+//
+// .SECTION See Also
+// vtkExecutionTimer vtkTimerLog
+
+#ifndef vtkPipelineProfiler_h
+#define vtkPipelineProfiler_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkAlgorithm;
+class vtkInformation;
+class vtkInformationVector;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkPipelineProfiler : public vtkObject
+{
+public:
+  static vtkPipelineProfiler* New();
+  vtkTypeMacro(vtkPipelineProfiler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Start recording the requests of all executives. This profiler replaces
+  // the active profiler, if any. The times of the events are relative to
+  // the first call to Start() after construction or Clear().
+  void Start();
+
+  // Description:
+  // Stop recording. Does nothing if this profiler is not the active one.
+  void Stop();
+
+  // Description:
+  // Return the profiler that is currently recording, or NULL.
+  static vtkPipelineProfiler* GetActiveProfiler();
+
+  // Description:
+  // Discard all the recorded events.
+  void Clear();
+
+  // Description:
+  // Return the number of events recorded by all threads.
+  vtkIdType GetNumberOfEvents();
+
+  // Description:
+  // Return the number of events that were not recorded because more than
+  // GetMaximumNumberOfThreads() threads executed algorithms.
+  vtkIdType GetNumberOfDroppedEvents();
+
+  // Description:
+  // The maximum number of threads whose events are recorded.
+  static int GetMaximumNumberOfThreads();
+
+  // Description:
+  // Write the recorded events in the Chrome trace event (JSON) format.
+  // Times are in microseconds. Return 0 if the file cannot be opened.
+  void WriteChromeTrace(ostream& os);
+  int WriteChromeTrace(const char* fileName);
+
+  // Description:
+  // Print a table with the number of calls, wall clock time, time not
+  // spent in nested calls ("self" time), CPU time and largest output of
+  // each algorithm class and request, sorted by decreasing self time.
+  void PrintSummary(ostream& os);
+
+  // Description:
+  // Called by the executives around each call to
+  // vtkAlgorithm::ProcessRequest(). outInfo is used to measure the outputs
+  // after a REQUEST_DATA.
+  void BeginRequest(vtkAlgorithm* algorithm, vtkInformation* request);
+  void EndRequest(vtkAlgorithm* algorithm, vtkInformation* request,
+                  vtkInformationVector* outInfo);
+
+protected:
+  vtkPipelineProfiler();
+  ~vtkPipelineProfiler();
+
+  //BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+  //ETX
+
+private:
+  vtkPipelineProfiler(const vtkPipelineProfiler&);  // Not implemented.
+  void operator=(const vtkPipelineProfiler&);  // Not implemented.
+};
+
+#endif
@@ -101,6 +101,9 @@ int vtkStreamingDemandDrivenPipeline
                  vtkInformationVector** inInfoVec,
                  vtkInformationVector* outInfoVec)
 {
+  // Keep other threads out of the executive while it serves the request.
+  vtkExecutiveRequestLocker locker(this);
+
   // The algorithm should not invoke anything on the executive.
   if(!this->CheckAlgorithm("ProcessRequest", request))
     {
@@ -344,6 +347,8 @@ int vtkStreamingDemandDrivenPipeline::Update()
 //----------------------------------------------------------------------------
 int vtkStreamingDemandDrivenPipeline::Update(int port)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   if(!this->UpdateInformation())
     {
     return 0;
@@ -375,6 +380,8 @@ int vtkStreamingDemandDrivenPipeline::Update(int port)
 //----------------------------------------------------------------------------
 int vtkStreamingDemandDrivenPipeline::UpdateWholeExtent()
 {
+  vtkExecutiveRequestLocker locker(this);
+
   this->UpdateInformation();
   // if we have an output then set the UE to WE for it
   if (this->Algorithm->GetNumberOfOutputPorts())
@@ -1397,6 +1404,8 @@ int* vtkStreamingDemandDrivenPipeline::GetWholeExtent(vtkInformation* info)
 int vtkStreamingDemandDrivenPipeline
 ::SetUpdateExtentToWholeExtent(int port)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   return this->SetUpdateExtentToWholeExtent(this->GetOutputInformation(port));
 }
 
@@ -1438,6 +1447,8 @@ int vtkStreamingDemandDrivenPipeline
 int vtkStreamingDemandDrivenPipeline
 ::SetUpdateExtent(int port, int x0, int x1, int y0, int y1, int z0, int z1)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   int extent[6] = {x0, x1, y0, y1, z0, z1};
   return this->SetUpdateExtent(
     this->GetOutputInformation(port), extent);
@@ -1447,6 +1458,8 @@ int vtkStreamingDemandDrivenPipeline
 int vtkStreamingDemandDrivenPipeline
 ::SetUpdateExtent(int port, int extent[6])
 {
+  vtkExecutiveRequestLocker locker(this);
+
   return this->SetUpdateExtent(
     this->GetOutputInformation(port), extent);
 }
@@ -1478,6 +1491,8 @@ int vtkStreamingDemandDrivenPipeline
 int vtkStreamingDemandDrivenPipeline
 ::SetUpdateExtent(int port, int piece,int numPieces, int ghostLevel)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   return this->SetUpdateExtent(
     this->GetOutputInformation(port), piece, numPieces, ghostLevel);
 }
@@ -1563,6 +1578,8 @@ int vtkStreamingDemandDrivenPipeline
 //----------------------------------------------------------------------------
 int vtkStreamingDemandDrivenPipeline::SetUpdateTimeStep(int port, double time)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   return this->SetUpdateTimeStep(this->GetOutputInformation(port), time);
 }
 
@@ -1681,6 +1698,8 @@ int vtkStreamingDemandDrivenPipeline
 //----------------------------------------------------------------------------
 int vtkStreamingDemandDrivenPipeline::SetRequestExactExtent(int port, int flag)
 {
+  vtkExecutiveRequestLocker locker(this);
+
   if(!this->OutputPortIndexInRange(port, "set request exact extent flag on"))
     {
     return 0;
@@ -34,6 +34,7 @@
 #include "vtkNew.h"
 #include "vtkSmartPointer.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineProfiler.h"
 #include "vtkDebugLeaks.h"
 #include "vtkImageData.h"
 
@@ -42,12 +43,16 @@
 #include "vtkSMPTools.h"
 #include "vtkSMPProgressObserver.h"
 
-#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <set>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkThreadedCompositeDataPipeline);
 
+vtkInformationKeyMacro(vtkThreadedCompositeDataPipeline, REQUIRES_SERIAL_EXECUTION, Integer);
+
 //----------------------------------------------------------------------------
 namespace
 {
@@ -220,6 +225,140 @@ protected:
 };
 
 
+//----------------------------------------------------------------------------
+namespace
+{
+  // An input connection of the executive and the executive producing it.
+  struct vtkThreadedCompositeDataPipelineConnection
+  {
+    vtkExecutive* Producer;
+    int ProducerPort;
+  };
+
+  // A set of connections whose upstream pipelines share executives and
+  // must therefore be updated one after the other.
+  struct vtkThreadedCompositeDataPipelineBranch
+  {
+    std::vector<vtkThreadedCompositeDataPipelineConnection> Connections;
+    std::set<vtkExecutive*> Executives;
+    bool Serial;
+  };
+
+  bool RequiresSerialExecution(vtkExecutive* exec)
+  {
+    vtkAlgorithm* alg = exec->GetAlgorithm();
+    if (!alg)
+      {
+      return false;
+      }
+    vtkInformation* algInfo = alg->GetInformation();
+    return algInfo->Has(vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION()) &&
+      algInfo->Get(vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION()) != 0;
+  }
+
+  // Collect exec and all the executives upstream of it.
+  void CollectUpstreamExecutives(vtkExecutive* exec,
+                                 vtkThreadedCompositeDataPipelineBranch& branch)
+  {
+    if (!branch.Executives.insert(exec).second)
+      {
+      return;
+      }
+    if (RequiresSerialExecution(exec))
+      {
+      branch.Serial = true;
+      }
+    vtkAlgorithm* alg = exec->GetAlgorithm();
+    for (int i = 0; alg && i < exec->GetNumberOfInputPorts(); ++i)
+      {
+      for (int j = 0; j < alg->GetNumberOfInputConnections(i); ++j)
+        {
+        if (vtkExecutive* e = exec->GetInputExecutive(i, j))
+          {
+          CollectUpstreamExecutives(e, branch);
+          }
+        }
+      }
+  }
+
+  bool Intersects(const std::set<vtkExecutive*>& a,
+                  const std::set<vtkExecutive*>& b)
+  {
+    std::set<vtkExecutive*>::const_iterator ia = a.begin();
+    std::set<vtkExecutive*>::const_iterator ib = b.begin();
+    while (ia != a.end() && ib != b.end())
+      {
+      if (*ia < *ib)
+        {
+        ++ia;
+        }
+      else if (*ib < *ia)
+        {
+        ++ib;
+        }
+      else
+        {
+        return true;
+        }
+      }
+    return false;
+  }
+
+  int UpdateBranch(const vtkThreadedCompositeDataPipelineBranch& branch,
+                   vtkInformation* request)
+  {
+    int result = 1;
+    int port = request->Get(vtkExecutive::FROM_OUTPUT_PORT());
+    for (size_t i = 0; i < branch.Connections.size(); ++i)
+      {
+      vtkExecutive* e = branch.Connections[i].Producer;
+      request->Set(vtkExecutive::FROM_OUTPUT_PORT(),
+                   branch.Connections[i].ProducerPort);
+      if (!e->ProcessRequest(request,
+                             e->GetInputInformation(),
+                             e->GetOutputInformation()))
+        {
+        result = 0;
+        }
+      }
+    request->Set(vtkExecutive::FROM_OUTPUT_PORT(), port);
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Update the branches that can run concurrently, each with its own copy of
+// the request.
+class vtkThreadedCompositeDataPipelineUpdateBranches
+{
+public:
+  vtkThreadedCompositeDataPipelineUpdateBranches(
+    const std::vector<vtkThreadedCompositeDataPipelineBranch*>& branches,
+    vtkInformation* request,
+    std::vector<int>& results)
+    : Branches(branches), Request(request), Results(results)
+  {
+  }
+
+  void operator() (vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      // The request key itself is not copied by vtkInformation::Copy().
+      vtkNew<vtkInformation> request;
+      request->Copy(this->Request, 1);
+      request->Set(vtkDemandDrivenPipeline::REQUEST_DATA());
+      this->Results[i] = UpdateBranch(*this->Branches[i],
+                                      request.GetPointer());
+      }
+  }
+
+protected:
+  const std::vector<vtkThreadedCompositeDataPipelineBranch*>& Branches;
+  vtkInformation* Request;
+  std::vector<int>& Results;
+};
+
 //----------------------------------------------------------------------------
 vtkThreadedCompositeDataPipeline::vtkThreadedCompositeDataPipeline()
 {
@@ -245,6 +384,17 @@ void vtkThreadedCompositeDataPipeline::ExecuteEach(vtkCompositeDataIterator* ite
                                                    vtkInformation* request,
                                                    vtkCompositeDataSet* compositeOutput)
 {
+  // Algorithms that are not re-entrant have their blocks executed one at a
+  // time.
+  vtkInformation* algInfo = this->Algorithm->GetInformation();
+  if (algInfo->Has(REQUIRES_SERIAL_EXECUTION()) &&
+      algInfo->Get(REQUIRES_SERIAL_EXECUTION()))
+    {
+    this->Superclass::ExecuteEach(iter, inInfoVec, outInfoVec, compositePort,
+                                  connection, request, compositeOutput);
+    return;
+    }
+
   // from input data objects  itr -> (inObjs, indices)
   // inObjs are the non-null objects that we will loop over.
   // indices map the input objects to inObjs
@@ -268,6 +418,15 @@ void vtkThreadedCompositeDataPipeline::ExecuteEach(vtkCompositeDataIterator* ite
   std::vector<vtkDataObject*> outObjs;
   outObjs.resize(indices.size(),NULL);
 
+  // There is nothing to gain from copying the information objects for
+  // each thread when there is at most one block to process.
+  if (inObjs.size() < 2)
+    {
+    this->Superclass::ExecuteEach(iter, inInfoVec, outInfoVec, compositePort,
+                                  connection, request, compositeOutput);
+    return;
+    }
+
   // create the parallel task processBlock
   ProcessBlock processBlock(this,
                             inInfoVec,
@@ -299,6 +458,108 @@ void vtkThreadedCompositeDataPipeline::ExecuteEach(vtkCompositeDataIterator* ite
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkThreadedCompositeDataPipeline::ForwardUpstream(vtkInformation* request)
+{
+  // Do not forward upstream if the input is shared with another
+  // executive.
+  if (!request->Has(REQUEST_DATA()) || this->SharedInputInformation)
+    {
+    return this->Superclass::ForwardUpstream(request);
+    }
+
+  // Group the input connections into branches that do not share any
+  // upstream executive.
+  std::vector<vtkThreadedCompositeDataPipelineBranch> branches;
+  for (int i = 0; i < this->GetNumberOfInputPorts(); ++i)
+    {
+    int nic = this->Algorithm->GetNumberOfInputConnections(i);
+    vtkInformationVector* inVector = this->GetInputInformation()[i];
+    for (int j = 0; j < nic; ++j)
+      {
+      vtkInformation* info = inVector->GetInformationObject(j);
+      vtkThreadedCompositeDataPipelineConnection connection;
+      vtkExecutive::PRODUCER()->Get(info, connection.Producer,
+                                    connection.ProducerPort);
+      if (!connection.Producer)
+        {
+        continue;
+        }
+
+      vtkThreadedCompositeDataPipelineBranch branch;
+      branch.Serial = false;
+      branch.Connections.push_back(connection);
+      CollectUpstreamExecutives(connection.Producer, branch);
+
+      // Merge with all the existing branches it overlaps.
+      for (size_t k = 0; k < branches.size(); )
+        {
+        if (Intersects(branches[k].Executives, branch.Executives))
+          {
+          branches[k].Connections.insert(branches[k].Connections.end(),
+                                         branch.Connections.begin(),
+                                         branch.Connections.end());
+          branches[k].Executives.insert(branch.Executives.begin(),
+                                        branch.Executives.end());
+          branches[k].Serial = branches[k].Serial || branch.Serial;
+          std::swap(branches[k], branch);
+          branches.erase(branches.begin() + k);
+          }
+        else
+          {
+          ++k;
+          }
+        }
+      branches.push_back(branch);
+      }
+    }
+
+  std::vector<vtkThreadedCompositeDataPipelineBranch*> concurrentBranches;
+  std::vector<vtkThreadedCompositeDataPipelineBranch*> serialBranches;
+  for (size_t k = 0; k < branches.size(); ++k)
+    {
+    if (branches[k].Serial)
+      {
+      serialBranches.push_back(&branches[k]);
+      }
+    else
+      {
+      concurrentBranches.push_back(&branches[k]);
+      }
+    }
+  if (concurrentBranches.size() < 2)
+    {
+    return this->Superclass::ForwardUpstream(request);
+    }
+
+  if (!this->Algorithm->ModifyRequest(request, BeforeForward))
+    {
+    return 0;
+    }
+
+  std::vector<int> results(concurrentBranches.size(), 1);
+  vtkThreadedCompositeDataPipelineUpdateBranches updateBranches(
+    concurrentBranches, request, results);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(concurrentBranches.size()), 1,
+                   updateBranches);
+
+  int result = std::find(results.begin(), results.end(), 0) == results.end();
+  for (size_t k = 0; k < serialBranches.size(); ++k)
+    {
+    if (!UpdateBranch(*serialBranches[k], request))
+      {
+      result = 0;
+      }
+    }
+
+  if (!this->Algorithm->ModifyRequest(request, AfterForward))
+    {
+    return 0;
+    }
+
+  return result;
+}
+
 //----------------------------------------------------------------------------
 int vtkThreadedCompositeDataPipeline::CallAlgorithm(vtkInformation* request, int direction,
                                                     vtkInformationVector** inInfo,
@@ -308,7 +569,16 @@ int vtkThreadedCompositeDataPipeline::CallAlgorithm(vtkInformation* request, int
   this->CopyDefaultInformation(request, direction, inInfo, outInfo);
 
   // Invoke the request on the algorithm.
+  vtkPipelineProfiler* profiler = vtkPipelineProfiler::GetActiveProfiler();
+  if (profiler)
+    {
+    profiler->BeginRequest(this->Algorithm, request);
+    }
   int result = this->Algorithm->ProcessRequest(request, inInfo, outInfo);
+  if (profiler)
+    {
+    profiler->EndRequest(this->Algorithm, request, outInfo);
+    }
 
   // If the algorithm failed report it now.
   if(!result)
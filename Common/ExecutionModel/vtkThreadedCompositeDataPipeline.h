@@ -21,6 +21,26 @@
 // algorithm implement all pipeline passes in a re-entrant way. It should
 // store/retrieve all state changes using input and output information
 // objects, which are unique to each thread.
+//
+// This executive also updates the independent upstream branches of an
+// algorithm with several input connections concurrently during the
+// REQUEST_DATA pass. Two input connections are independent when no
+// executive is upstream of both of them; connections that share upstream
+// executives are updated one after the other by the same task.
+//
+// This executive is opt-in: set it on the algorithms that should process
+// their blocks or their inputs concurrently with
+// vtkAlgorithm::SetExecutive(), or on all new algorithms with
+// vtkAlgorithm::SetDefaultExecutivePrototype(). An algorithm that is
+// known not to be re-entrant can opt out by setting
+// REQUIRES_SERIAL_EXECUTION() in its information, in which case its blocks
+// are executed one at a time as with vtkCompositeDataPipeline, and the
+// branches it belongs to are updated by the calling thread once the
+// concurrent branches are done. In all cases the output has the same
+// structure as the input and its blocks are in the same order.
+//
+// Observers of the events fired by the algorithms (progress, start, end)
+// may be invoked from several threads at once.
 
 #ifndef vtkThreadedCompositeDataPipeline_h
 #define vtkThreadedCompositeDataPipeline_h
@@ -28,6 +48,7 @@
 #include "vtkCommonExecutionModelModule.h" // For export macro
 #include "vtkCompositeDataPipeline.h"
 
+class vtkInformationIntegerKey;
 class vtkInformationVector;
 class vtkInformation;
 
@@ -45,6 +66,14 @@ class VTKCOMMONEXECUTIONMODEL_EXPORT vtkThreadedCompositeDataPipeline : public v
                             vtkInformationVector** inInfo,
                             vtkInformationVector* outInfo);
 
+  // Description:
+  // Key set in the information of an algorithm (vtkAlgorithm::GetInformation())
+  // that is not re-entrant. The blocks of the input of such an algorithm
+  // are executed serially even when this executive is used, and the
+  // algorithm is never updated concurrently with another branch of the
+  // pipeline.
+  static vtkInformationIntegerKey* REQUIRES_SERIAL_EXECUTION();
+
  protected:
   vtkThreadedCompositeDataPipeline();
   ~vtkThreadedCompositeDataPipeline();
@@ -56,10 +85,17 @@ class VTKCOMMONEXECUTIONMODEL_EXPORT vtkThreadedCompositeDataPipeline : public v
                            vtkInformation* request,
                            vtkCompositeDataSet* compositeOutput);
 
+  // Description:
+  // Forward REQUEST_DATA to independent input connections concurrently.
+  // Other requests are forwarded by the superclass.
+  virtual int ForwardUpstream(vtkInformation* request);
+  using vtkCompositeDataPipeline::ForwardUpstream;
+
  private:
   vtkThreadedCompositeDataPipeline(const vtkThreadedCompositeDataPipeline&);  // Not implemented.
   void operator=(const vtkThreadedCompositeDataPipeline&);  // Not implemented.
   friend class ProcessBlock;
+  friend class vtkThreadedCompositeDataPipelineUpdateBranches;
 };
 
 #endif
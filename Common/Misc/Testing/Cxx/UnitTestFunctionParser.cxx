@@ -103,6 +103,7 @@ static int TestScalarLogic();
 static int TestVectorLogic();
 static int TestMiscFunctions();
 static int TestErrors();
+static int TestEvaluateBlock();
 
 int UnitTestFunctionParser(int,char *[])
 {
@@ -134,6 +135,7 @@ int UnitTestFunctionParser(int,char *[])
 
   status += TestMiscFunctions();
   status += TestErrors();
+  status += TestEvaluateBlock();
   if (status != 0)
     {
     return EXIT_FAILURE;
@@ -1017,3 +1019,117 @@ int TestErrors()
     }
   return status;
 }
+
+int TestEvaluateBlock()
+{
+  std::cout << "Testing EvaluateBlock" << "...";
+  // The functions and the number of components of their result.
+  struct
+  {
+    const char* Function;
+    int NumberOfComponents;
+  } functions[] = {
+    { "x + y * (x - y) / 3 - -x", 1 },
+    { "sqrt(abs(x)) + exp(y / 1000) + ceil(x) - floor(y) + x^2", 1 },
+    { "sin(x) * cos(y) + tan(x) + atan(y) + sinh(x/1000) + cosh(y/1000)", 1 },
+    { "tanh(x) + sign(y) + min(x, y) + max(x, y)", 1 },
+    { "if(x < y, x, y)", 1 },
+    { "if(x > y | x = 0 & y > 0, u, v)", 3 },
+    { "(u . v) * iHat + mag(u) * jHat + norm(v) + x * u - v / y", 3 },
+    { "cross(u, v) - u + (y * kHat)", 3 },
+    { "log(x) + ln(y) + log10(x) + sqrt(y) + asin(x / 1000) + acos(y / 1000)",
+      1 },
+    { "x / (y - y) * iHat", 3 },
+  };
+  const int numFunctions = sizeof(functions) / sizeof(functions[0]);
+  const vtkIdType n = 100;
+
+  std::vector<double> x(n), y(n), ux(n), uy(n), uz(n), v(3 * n);
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    x[i] = vtkMath::Random(-1000.0, 1000.0);
+    y[i] = (i % 10 == 0) ? 0.0 : vtkMath::Random(-1000.0, 1000.0);
+    ux[i] = vtkMath::Random(-1.0, 1.0);
+    uy[i] = vtkMath::Random(-1.0, 1.0);
+    uz[i] = vtkMath::Random(-1.0, 1.0);
+    }
+  // The columns of v are NULL: v keeps its value for all the tuples.
+  const double* scalarValues[2] = { &x[0], &y[0] };
+  const double* vectorValues[6] = { &ux[0], &uy[0], &uz[0], NULL, NULL, NULL };
+
+  int status = 0;
+  for (int replace = 0; replace < 2; ++replace)
+    {
+    for (int f = 0; f < numFunctions; ++f)
+      {
+      vtkSmartPointer<vtkFunctionParser> parser =
+        vtkSmartPointer<vtkFunctionParser>::New();
+      vtkSmartPointer<vtkTest::ErrorObserver> errorObserver =
+        vtkSmartPointer<vtkTest::ErrorObserver>::New();
+      parser->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+      parser->SetReplaceInvalidValues(replace);
+      parser->SetReplacementValue(-1234.5);
+      parser->SetScalarVariableValue("x", 1.0);
+      parser->SetScalarVariableValue("y", 2.0);
+      parser->SetVectorVariableValue("u", 1.0, 2.0, 3.0);
+      parser->SetVectorVariableValue("v", -1.0, 0.5, 2.0);
+      parser->SetFunction(functions[f].Function);
+      int numComp = functions[f].NumberOfComponents;
+
+      std::vector<double> block(3 * n);
+      vtkIdType numInvalid =
+        parser->EvaluateBlock(n, scalarValues, vectorValues, &block[0]);
+
+      // Compare with the evaluation of each tuple.
+      vtkIdType expectedInvalid = 0;
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        parser->SetScalarVariableValue(0, x[i]);
+        parser->SetScalarVariableValue(1, y[i]);
+        parser->SetVectorVariableValue(0, ux[i], uy[i], uz[i]);
+        errorObserver->Clear();
+        double expected[3];
+        if (numComp == 1)
+          {
+          expected[0] = parser->GetScalarResult();
+          }
+        else
+          {
+          parser->GetVectorResult(expected);
+          }
+        if (errorObserver->GetError())
+          {
+          ++expectedInvalid;
+          }
+        for (int k = 0; k < numComp; ++k)
+          {
+          double result = block[i * numComp + k];
+          if (result != expected[k] &&
+              !vtkMathUtilities::FuzzyCompare(
+                result, expected[k],
+                std::abs(expected[k]) * 1.0e-12))
+            {
+            std::cout << "\n" << functions[f].Function << ": tuple " << i
+                      << " component " << k << " expected " << expected[k]
+                      << " but got " << result << std::endl;
+            ++status;
+            break;
+            }
+          }
+        }
+      if (numInvalid != expectedInvalid)
+        {
+        std::cout << "\n" << functions[f].Function << ": expected "
+                  << expectedInvalid
+                  << " invalid tuples but got " << numInvalid << std::endl;
+        ++status;
+        }
+      }
+    }
+
+  if (status == 0)
+    {
+    std::cout << "PASSED\n";
+    }
+  return status;
+}
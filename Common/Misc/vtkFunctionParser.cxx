@@ -16,12 +16,91 @@
 #include "vtkObjectFactory.h"
 
 #include <ctype.h>
+#include <vector>
 
 vtkStandardNewMacro(vtkFunctionParser);
 
 static double vtkParserVectorErrorResult[3] = { VTK_PARSER_ERROR_RESULT,
                                                 VTK_PARSER_ERROR_RESULT,
                                                 VTK_PARSER_ERROR_RESULT };
+
+//-----------------------------------------------------------------------------
+// Helpers of EvaluateBlock(), which apply an operation to columns of n
+// values.
+namespace
+{
+typedef double (*vtkParserFunction)(double);
+typedef bool (*vtkParserDomain)(double);
+
+double vtkParserAbs(double x) { return fabs(x); }
+double vtkParserExp(double x) { return exp(x); }
+double vtkParserCeil(double x) { return ceil(x); }
+double vtkParserFloor(double x) { return floor(x); }
+double vtkParserLog(double x) { return log(x); }
+double vtkParserLog10(double x) { return log10(x); }
+double vtkParserSqrt(double x) { return sqrt(x); }
+double vtkParserSin(double x) { return sin(x); }
+double vtkParserCos(double x) { return cos(x); }
+double vtkParserTan(double x) { return tan(x); }
+double vtkParserAsin(double x) { return asin(x); }
+double vtkParserAcos(double x) { return acos(x); }
+double vtkParserAtan(double x) { return atan(x); }
+double vtkParserSinh(double x) { return sinh(x); }
+double vtkParserCosh(double x) { return cosh(x); }
+double vtkParserTanh(double x) { return tanh(x); }
+double vtkParserSign(double x) { return x < 0 ? -1 : (x == 0 ? 0 : 1); }
+
+bool vtkParserPositive(double x) { return x > 0; }
+bool vtkParserNonNegative(double x) { return x >= 0; }
+bool vtkParserUnitRange(double x) { return x >= -1 && x <= 1; }
+
+void vtkParserApply(double* x, vtkIdType n, vtkParserFunction f)
+{
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    x[i] = f(x[i]);
+    }
+}
+
+// Apply f where x is in its domain. Elsewhere, replace x or mark the tuple
+// as invalid.
+void vtkParserApply(double* x, vtkIdType n, vtkParserFunction f,
+                    vtkParserDomain domain, int replace,
+                    double replacement, char* invalid)
+{
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    if (domain(x[i]))
+      {
+      x[i] = f(x[i]);
+      }
+    else if (replace)
+      {
+      x[i] = replacement;
+      }
+    else
+      {
+      invalid[i] = 1;
+      }
+    }
+}
+
+void vtkParserFill(double* x, vtkIdType n, double value)
+{
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    x[i] = value;
+    }
+}
+
+void vtkParserCopy(double* x, const double* y, vtkIdType n)
+{
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    x[i] = y[i];
+    }
+}
+}
 //-----------------------------------------------------------------------------
 vtkFunctionParser::vtkFunctionParser()
 {
@@ -891,6 +970,442 @@ bool vtkFunctionParser::Evaluate()
   return true;
 }
 
+//-----------------------------------------------------------------------------
+vtkIdType vtkFunctionParser::EvaluateBlock(vtkIdType n,
+                                           const double* const* scalarValues,
+                                           const double* const* vectorValues,
+                                           double* result)
+{
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime())
+    {
+    if (this->Parse() == 0)
+      {
+      return -1;
+      }
+    }
+  if (n <= 0)
+    {
+    return 0;
+    }
+
+  // The stack holds one column of n values per element of the stack of
+  // Evaluate(). Column k starts at stack + k*n.
+  std::vector<double> stackColumns(static_cast<size_t>(this->StackSize) * n);
+  std::vector<char> invalidTuples(n, 0);
+  double* stack = &stackColumns[0];
+  char* invalid = &invalidTuples[0];
+  int replace = this->ReplaceInvalidValues;
+  double replacement = this->ReplacementValue;
+  int numImmediatesProcessed = 0;
+  int stackPosition = -1;
+  vtkIdType i;
+
+#define vtkParserColumn(k) (stack + static_cast<vtkIdType>(k) * n)
+
+  for (int byte = 0; byte < this->ByteCodeSize; byte++)
+    {
+    // The top two columns of the stack.
+    double* x = stackPosition >= 0 ? vtkParserColumn(stackPosition) : stack;
+    double* y =
+      stackPosition >= 1 ? vtkParserColumn(stackPosition - 1) : stack;
+    switch (this->ByteCode[byte])
+      {
+      case VTK_PARSER_IMMEDIATE:
+        vtkParserFill(vtkParserColumn(++stackPosition), n,
+                      this->Immediates[numImmediatesProcessed++]);
+        break;
+      case VTK_PARSER_UNARY_MINUS:
+        for (i = 0; i < n; ++i)
+          {
+          x[i] = -x[i];
+          }
+        break;
+      case VTK_PARSER_ADD:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] += x[i];
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_SUBTRACT:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] -= x[i];
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_MULTIPLY:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] *= x[i];
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_DIVIDE:
+        for (i = 0; i < n; ++i)
+          {
+          if (x[i] != 0)
+            {
+            y[i] /= x[i];
+            }
+          else if (replace)
+            {
+            y[i] = replacement;
+            }
+          else
+            {
+            invalid[i] = 1;
+            }
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_POWER:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] = pow(y[i], x[i]);
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_ABSOLUTE_VALUE:
+        vtkParserApply(x, n, vtkParserAbs);
+        break;
+      case VTK_PARSER_EXPONENT:
+        vtkParserApply(x, n, vtkParserExp);
+        break;
+      case VTK_PARSER_CEILING:
+        vtkParserApply(x, n, vtkParserCeil);
+        break;
+      case VTK_PARSER_FLOOR:
+        vtkParserApply(x, n, vtkParserFloor);
+        break;
+      case VTK_PARSER_LOGARITHM:
+      case VTK_PARSER_LOGARITHME:
+        vtkParserApply(x, n, vtkParserLog, vtkParserPositive,
+                       replace, replacement, invalid);
+        break;
+      case VTK_PARSER_LOGARITHM10:
+        vtkParserApply(x, n, vtkParserLog10, vtkParserPositive,
+                       replace, replacement, invalid);
+        break;
+      case VTK_PARSER_SQUARE_ROOT:
+        vtkParserApply(x, n, vtkParserSqrt, vtkParserNonNegative,
+                       replace, replacement, invalid);
+        break;
+      case VTK_PARSER_SINE:
+        vtkParserApply(x, n, vtkParserSin);
+        break;
+      case VTK_PARSER_COSINE:
+        vtkParserApply(x, n, vtkParserCos);
+        break;
+      case VTK_PARSER_TANGENT:
+        vtkParserApply(x, n, vtkParserTan);
+        break;
+      case VTK_PARSER_ARCSINE:
+        vtkParserApply(x, n, vtkParserAsin, vtkParserUnitRange,
+                       replace, replacement, invalid);
+        break;
+      case VTK_PARSER_ARCCOSINE:
+        vtkParserApply(x, n, vtkParserAcos, vtkParserUnitRange,
+                       replace, replacement, invalid);
+        break;
+      case VTK_PARSER_ARCTANGENT:
+        vtkParserApply(x, n, vtkParserAtan);
+        break;
+      case VTK_PARSER_HYPERBOLIC_SINE:
+        vtkParserApply(x, n, vtkParserSinh);
+        break;
+      case VTK_PARSER_HYPERBOLIC_COSINE:
+        vtkParserApply(x, n, vtkParserCosh);
+        break;
+      case VTK_PARSER_HYPERBOLIC_TANGENT:
+        vtkParserApply(x, n, vtkParserTanh);
+        break;
+      case VTK_PARSER_MIN:
+        for (i = 0; i < n; ++i)
+          {
+          if (x[i] < y[i])
+            {
+            y[i] = x[i];
+            }
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_MAX:
+        for (i = 0; i < n; ++i)
+          {
+          if (x[i] > y[i])
+            {
+            y[i] = x[i];
+            }
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_CROSS:
+        {
+        double* ux = vtkParserColumn(stackPosition - 5);
+        double* uy = vtkParserColumn(stackPosition - 4);
+        double* uz = vtkParserColumn(stackPosition - 3);
+        double* vx = vtkParserColumn(stackPosition - 2);
+        double* vy = y;
+        double* vz = x;
+        for (i = 0; i < n; ++i)
+          {
+          double cx = uy[i] * vz[i] - uz[i] * vy[i];
+          double cy = uz[i] * vx[i] - ux[i] * vz[i];
+          double cz = ux[i] * vy[i] - uy[i] * vx[i];
+          ux[i] = cx;
+          uy[i] = cy;
+          uz[i] = cz;
+          }
+        stackPosition -= 3;
+        break;
+        }
+      case VTK_PARSER_SIGN:
+        vtkParserApply(x, n, vtkParserSign);
+        break;
+      case VTK_PARSER_VECTOR_UNARY_MINUS:
+        for (int k = 0; k < 3; ++k)
+          {
+          double* c = vtkParserColumn(stackPosition - k);
+          for (i = 0; i < n; ++i)
+            {
+            c[i] = -c[i];
+            }
+          }
+        break;
+      case VTK_PARSER_DOT_PRODUCT:
+        {
+        double* ux = vtkParserColumn(stackPosition - 5);
+        double* uy = vtkParserColumn(stackPosition - 4);
+        double* uz = vtkParserColumn(stackPosition - 3);
+        double* vx = vtkParserColumn(stackPosition - 2);
+        for (i = 0; i < n; ++i)
+          {
+          ux[i] = ux[i] * vx[i] + uy[i] * y[i] + uz[i] * x[i];
+          }
+        stackPosition -= 5;
+        break;
+        }
+      case VTK_PARSER_VECTOR_ADD:
+      case VTK_PARSER_VECTOR_SUBTRACT:
+        {
+        double sign =
+          (this->ByteCode[byte] == VTK_PARSER_VECTOR_ADD) ? 1.0 : -1.0;
+        for (int k = 0; k < 3; ++k)
+          {
+          double* u = vtkParserColumn(stackPosition - 3 - k);
+          double* v = vtkParserColumn(stackPosition - k);
+          for (i = 0; i < n; ++i)
+            {
+            u[i] += sign * v[i];
+            }
+          }
+        stackPosition -= 3;
+        break;
+        }
+      case VTK_PARSER_SCALAR_TIMES_VECTOR:
+        {
+        // The scalar is below the vector: shift the product down.
+        double* c0 = vtkParserColumn(stackPosition - 3);
+        double* c1 = vtkParserColumn(stackPosition - 2);
+        for (i = 0; i < n; ++i)
+          {
+          double scalar = c0[i];
+          c0[i] = c1[i] * scalar;
+          c1[i] = y[i] * scalar;
+          y[i] = x[i] * scalar;
+          }
+        stackPosition--;
+        break;
+        }
+      case VTK_PARSER_VECTOR_TIMES_SCALAR:
+        for (int k = 1; k <= 3; ++k)
+          {
+          double* u = vtkParserColumn(stackPosition - k);
+          for (i = 0; i < n; ++i)
+            {
+            u[i] *= x[i];
+            }
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_VECTOR_OVER_SCALAR:
+        for (int k = 1; k <= 3; ++k)
+          {
+          double* u = vtkParserColumn(stackPosition - k);
+          for (i = 0; i < n; ++i)
+            {
+            u[i] /= x[i];
+            }
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_MAGNITUDE:
+        {
+        double* ux = vtkParserColumn(stackPosition - 2);
+        for (i = 0; i < n; ++i)
+          {
+          ux[i] = sqrt(x[i] * x[i] + y[i] * y[i] + ux[i] * ux[i]);
+          }
+        stackPosition -= 2;
+        break;
+        }
+      case VTK_PARSER_NORMALIZE:
+        {
+        double* ux = vtkParserColumn(stackPosition - 2);
+        for (i = 0; i < n; ++i)
+          {
+          double magnitude = sqrt(x[i] * x[i] + y[i] * y[i] + ux[i] * ux[i]);
+          if (magnitude != 0)
+            {
+            ux[i] /= magnitude;
+            y[i] /= magnitude;
+            x[i] /= magnitude;
+            }
+          }
+        break;
+        }
+      case VTK_PARSER_IHAT:
+      case VTK_PARSER_JHAT:
+      case VTK_PARSER_KHAT:
+        {
+        int axis = this->ByteCode[byte] - VTK_PARSER_IHAT;
+        for (int k = 0; k < 3; ++k)
+          {
+          vtkParserFill(vtkParserColumn(++stackPosition), n,
+                        (k == axis) ? 1.0 : 0.0);
+          }
+        break;
+        }
+      case VTK_PARSER_LESS_THAN:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] = (y[i] < x[i]);
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_GREATER_THAN:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] = (y[i] > x[i]);
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_EQUAL_TO:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] = (y[i] == x[i]);
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_AND:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] = (y[i] != 0 && x[i] != 0);
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_OR:
+        for (i = 0; i < n; ++i)
+          {
+          y[i] = (y[i] != 0 || x[i] != 0);
+          }
+        stackPosition--;
+        break;
+      case VTK_PARSER_IF:
+        {
+        // From the top of the stack: the condition, valtrue and valfalse.
+        double* valFalse = vtkParserColumn(stackPosition - 2);
+        for (i = 0; i < n; ++i)
+          {
+          if (x[i] != 0.0)
+            {
+            valFalse[i] = y[i];
+            }
+          }
+        stackPosition -= 2;
+        break;
+        }
+      case VTK_PARSER_VECTOR_IF:
+        for (int k = 0; k < 3; ++k)
+          {
+          double* valFalse = vtkParserColumn(stackPosition - 6 + k);
+          double* valTrue = vtkParserColumn(stackPosition - 3 + k);
+          for (i = 0; i < n; ++i)
+            {
+            if (x[i] != 0.0)
+              {
+              valFalse[i] = valTrue[i];
+              }
+            }
+          }
+        stackPosition -= 4;
+        break;
+      default:
+        {
+        int variable = this->ByteCode[byte] - VTK_PARSER_BEGIN_VARIABLES;
+        if (variable < this->NumberOfScalarVariables)
+          {
+          double* c = vtkParserColumn(++stackPosition);
+          if (scalarValues && scalarValues[variable])
+            {
+            vtkParserCopy(c, scalarValues[variable], n);
+            }
+          else
+            {
+            vtkParserFill(c, n, this->ScalarVariableValues[variable]);
+            }
+          }
+        else
+          {
+          variable -= this->NumberOfScalarVariables;
+          for (int k = 0; k < 3; ++k)
+            {
+            double* c = vtkParserColumn(++stackPosition);
+            const double* values =
+              vectorValues ? vectorValues[3 * variable + k] : NULL;
+            if (values)
+              {
+              vtkParserCopy(c, values, n);
+              }
+            else
+              {
+              vtkParserFill(c, n, this->VectorVariableValues[variable][k]);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  // Interleave the components of the result.
+  int numberOfComponents = stackPosition + 1;
+  for (int k = 0; k < numberOfComponents; ++k)
+    {
+    const double* c = vtkParserColumn(k);
+    for (i = 0; i < n; ++i)
+      {
+      result[i * numberOfComponents + k] = c[i];
+      }
+    }
+#undef vtkParserColumn
+
+  vtkIdType numberOfInvalidTuples = 0;
+  for (i = 0; i < n; ++i)
+    {
+    if (invalid[i])
+      {
+      for (int k = 0; k < numberOfComponents; ++k)
+        {
+        result[i * numberOfComponents + k] = VTK_PARSER_ERROR_RESULT;
+        }
+      ++numberOfInvalidTuples;
+      }
+    }
+
+  return numberOfInvalidTuples;
+}
+
 //-----------------------------------------------------------------------------
 int vtkFunctionParser::IsScalarResult()
 {
@@ -235,6 +235,30 @@ public:
   vtkSetMacro(ReplacementValue,double);
   vtkGetMacro(ReplacementValue,double);
 
+  // Description:
+  // Evaluate the function for numberOfTuples tuples at once. Each operation
+  // of the parsed function is applied to all the tuples before the next
+  // one, so that the cost of interpreting the function is shared by the
+  // tuples and the loops over the tuples can be vectorized.
+  // scalarValues holds one column of numberOfTuples values per scalar
+  // variable and vectorValues three columns (x, y and z) per vector
+  // variable. A NULL column uses the value set with
+  // SetScalarVariableValue() or SetVectorVariableValue() for all the
+  // tuples. The result of each tuple is written to result, with one or
+  // three (interleaved) components depending on the function. Tuples that
+  // cannot be evaluated (division by zero, logarithm of a negative
+  // value...) are set to ReplacementValue when ReplaceInvalidValues is on
+  // and to VTK_PARSER_ERROR_RESULT otherwise. Return the number of such
+  // tuples when ReplaceInvalidValues is off, 0 when it is on and -1 if
+  // the function cannot be parsed.
+  // The variables must be defined and the function parsed (for example
+  // by evaluating a first tuple) before several threads evaluate blocks
+  // concurrently: this method then does not modify the parser.
+  vtkIdType EvaluateBlock(vtkIdType numberOfTuples,
+                          const double* const* scalarValues,
+                          const double* const* vectorValues,
+                          double* result);
+
   // Description:
   // Check the validity of the function expression.
   void CheckExpression(int &pos, char **error);
@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks the point normals of a cube with and without feature edge
+// splitting.
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSmartPointer.h>
+
+#include <cmath>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> MakeCube()
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int i = 0; i < 8; ++i)
+    {
+    points->InsertNextPoint(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+    }
+
+  // Outward facing quads.
+  const vtkIdType faces[6][4] = { {0,2,3,1}, {4,5,7,6}, {0,1,5,4},
+                                  {2,6,7,3}, {0,4,6,2}, {1,3,7,5} };
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < 6; ++i)
+    {
+    polys->InsertNextCell(4, faces[i]);
+    }
+
+  vtkSmartPointer<vtkPolyData> cube = vtkSmartPointer<vtkPolyData>::New();
+  cube->SetPoints(points);
+  cube->SetPolys(polys);
+  return cube;
+}
+
+// Point normals should be unit vectors pointing away from the center of
+// the cube, either along one axis or along a diagonal.
+bool CheckNormals(vtkPolyData *output, int numPoints, bool axisAligned)
+{
+  if (output->GetNumberOfPoints() != numPoints)
+    {
+    std::cerr << "Expected " << numPoints << " points, got "
+              << output->GetNumberOfPoints() << std::endl;
+    return false;
+    }
+  vtkDataArray *normals = output->GetPointData()->GetNormals();
+  if (!normals || normals->GetNumberOfTuples() != numPoints)
+    {
+    std::cerr << "Missing point normals." << std::endl;
+    return false;
+    }
+
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    double x[3], n[3];
+    output->GetPoint(i, x);
+    normals->GetTuple(i, n);
+    if (std::fabs(vtkMath::Norm(n) - 1.0) > 1e-6)
+      {
+      std::cerr << "Normal " << i << " is not normalized." << std::endl;
+      return false;
+      }
+    int numNonZero = 0;
+    for (int j = 0; j < 3; ++j)
+      {
+      if (std::fabs(n[j]) > 1e-6)
+        {
+        numNonZero++;
+        if ((n[j] > 0) != (x[j] > 0.5))
+          {
+          std::cerr << "Normal " << i << " points inward." << std::endl;
+          return false;
+          }
+        }
+      }
+    if (numNonZero != (axisAligned ? 1 : 3))
+      {
+      std::cerr << "Unexpected normal " << n[0] << " " << n[1] << " "
+                << n[2] << " at point " << i << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestPolyDataNormals(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
+{
+  vtkSmartPointer<vtkPolyData> cube = MakeCube();
+
+  vtkSmartPointer<vtkPolyDataNormals> normals =
+    vtkSmartPointer<vtkPolyDataNormals>::New();
+  normals->SetInputData(cube);
+  normals->SplittingOff();
+  normals->Update();
+  if (!CheckNormals(normals->GetOutput(), 8, false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Each corner is shared by three faces separated by feature edges.
+  normals->SplittingOn();
+  normals->Update();
+  if (!CheckNormals(normals->GetOutput(), 24, true))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The edges are not sharp anymore with a feature angle above 90 degrees.
+  normals->SetFeatureAngle(100.0);
+  normals->Update();
+  if (!CheckNormals(normals->GetOutput(), 8, false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClustering.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Decimates a triangulated torus with and without ParallelClustering and
+// checks that both produce the same cells, and the same points up to
+// round-off. The torus also has a line and vertices, whose bins do not take
+// the quadrics of the triangles.
+
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricClustering.h>
+#include <vtkSmartPointer.h>
+
+#include <cmath>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> MakeTorus(int resolutionU, int resolutionV)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int i = 0; i < resolutionU; ++i)
+    {
+    double u = 2.0 * vtkMath::Pi() * i / resolutionU;
+    for (int j = 0; j < resolutionV; ++j)
+      {
+      double v = 2.0 * vtkMath::Pi() * j / resolutionV;
+      double r = 1.0 + 0.4 * cos(v);
+      points->InsertNextPoint(r * cos(u), r * sin(u), 0.4 * sin(v));
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < resolutionU; ++i)
+    {
+    for (int j = 0; j < resolutionV; ++j)
+      {
+      vtkIdType p0 = i * resolutionV + j;
+      vtkIdType p1 = ((i + 1) % resolutionU) * resolutionV + j;
+      vtkIdType p2 = ((i + 1) % resolutionU) * resolutionV +
+        (j + 1) % resolutionV;
+      vtkIdType p3 = i * resolutionV + (j + 1) % resolutionV;
+      vtkIdType tri0[3] = { p0, p1, p2 };
+      vtkIdType tri1[3] = { p0, p2, p3 };
+      polys->InsertNextCell(3, tri0);
+      polys->InsertNextCell(3, tri1);
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  lines->InsertNextCell(resolutionU + 1);
+  for (int i = 0; i <= resolutionU; ++i)
+    {
+    lines->InsertCellPoint((i % resolutionU) * resolutionV);
+    }
+
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  for (vtkIdType ptId = 17; ptId < points->GetNumberOfPoints(); ptId += 97)
+    {
+    verts->InsertNextCell(1, &ptId);
+    }
+
+  vtkSmartPointer<vtkPolyData> torus = vtkSmartPointer<vtkPolyData>::New();
+  torus->SetPoints(points);
+  torus->SetVerts(verts);
+  torus->SetLines(lines);
+  torus->SetPolys(polys);
+  return torus;
+}
+
+vtkSmartPointer<vtkPolyData> Cluster(vtkPolyData *input, bool parallel,
+                                     bool useInputPoints)
+{
+  vtkSmartPointer<vtkQuadricClustering> clustering =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  clustering->SetInputData(input);
+  clustering->SetNumberOfDivisions(20, 20, 6);
+  clustering->SetUseInputPoints(useInputPoints);
+  clustering->SetParallelClustering(parallel);
+  clustering->Update();
+  return clustering->GetOutput();
+}
+
+bool SameCells(vtkCellArray *cells0, vtkCellArray *cells1)
+{
+  if (cells0->GetNumberOfConnectivityEntries() !=
+      cells1->GetNumberOfConnectivityEntries())
+    {
+    return false;
+    }
+  const vtkIdType *ids0 = cells0->GetPointer();
+  const vtkIdType *ids1 = cells1->GetPointer();
+  for (vtkIdType i = 0; i < cells0->GetNumberOfConnectivityEntries(); ++i)
+    {
+    if (ids0[i] != ids1[i])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+bool CompareOutputs(vtkPolyData *serial, vtkPolyData *parallel)
+{
+  if (serial->GetNumberOfPoints() == 0 ||
+      serial->GetNumberOfLines() == 0 ||
+      serial->GetNumberOfPoints() != parallel->GetNumberOfPoints() ||
+      serial->GetNumberOfPolys() != parallel->GetNumberOfPolys())
+    {
+    std::cout << "Serial output has " << serial->GetNumberOfPoints()
+              << " points and " << serial->GetNumberOfPolys()
+              << " triangles, parallel output has "
+              << parallel->GetNumberOfPoints() << " points and "
+              << parallel->GetNumberOfPolys() << " triangles." << std::endl;
+    return false;
+    }
+
+  if (!SameCells(serial->GetVerts(), parallel->GetVerts()) ||
+      !SameCells(serial->GetLines(), parallel->GetLines()))
+    {
+    std::cout << "Vertices or lines differ." << std::endl;
+    return false;
+    }
+
+  for (vtkIdType i = 0; i < serial->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    serial->GetPoint(i, x);
+    parallel->GetPoint(i, y);
+    if (vtkMath::Distance2BetweenPoints(x, y) > 1e-12)
+      {
+      std::cout << "Point " << i << " differs." << std::endl;
+      return false;
+      }
+    }
+
+  vtkIdType npts0, *pts0, npts1, *pts1;
+  vtkCellArray *polys0 = serial->GetPolys();
+  vtkCellArray *polys1 = parallel->GetPolys();
+  polys0->InitTraversal();
+  polys1->InitTraversal();
+  while (polys0->GetNextCell(npts0, pts0) && polys1->GetNextCell(npts1, pts1))
+    {
+    if (npts0 != npts1 || pts0[0] != pts1[0] || pts0[1] != pts1[1] ||
+        pts0[2] != pts1[2])
+      {
+      std::cout << "Triangles differ." << std::endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+}
+
+int TestQuadricClustering(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> torus = MakeTorus(120, 60);
+
+  for (int useInputPoints = 0; useInputPoints < 2; ++useInputPoints)
+    {
+    vtkSmartPointer<vtkPolyData> serial =
+      Cluster(torus, false, useInputPoints != 0);
+    vtkSmartPointer<vtkPolyData> parallel =
+      Cluster(torus, true, useInputPoints != 0);
+    if (!CompareOutputs(serial, parallel))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
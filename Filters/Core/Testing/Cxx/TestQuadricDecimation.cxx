@@ -0,0 +1,113 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Decimates a triangulated torus one edge at a time and in batches of
+// edges, and checks that both reach the requested reduction.
+
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkSmartPointer.h>
+
+#include <cmath>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> MakeTorus(int resolutionU, int resolutionV)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int i = 0; i < resolutionU; ++i)
+    {
+    double u = 2.0 * vtkMath::Pi() * i / resolutionU;
+    for (int j = 0; j < resolutionV; ++j)
+      {
+      double v = 2.0 * vtkMath::Pi() * j / resolutionV;
+      double r = 1.0 + 0.4 * cos(v);
+      points->InsertNextPoint(r * cos(u), r * sin(u), 0.4 * sin(v));
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < resolutionU; ++i)
+    {
+    for (int j = 0; j < resolutionV; ++j)
+      {
+      vtkIdType p0 = i * resolutionV + j;
+      vtkIdType p1 = ((i + 1) % resolutionU) * resolutionV + j;
+      vtkIdType p2 = ((i + 1) % resolutionU) * resolutionV +
+        (j + 1) % resolutionV;
+      vtkIdType p3 = i * resolutionV + (j + 1) % resolutionV;
+      vtkIdType tri0[3] = { p0, p1, p2 };
+      vtkIdType tri1[3] = { p0, p2, p3 };
+      polys->InsertNextCell(3, tri0);
+      polys->InsertNextCell(3, tri1);
+      }
+    }
+
+  vtkSmartPointer<vtkPolyData> torus = vtkSmartPointer<vtkPolyData>::New();
+  torus->SetPoints(points);
+  torus->SetPolys(polys);
+  return torus;
+}
+
+bool Decimate(vtkPolyData *input, int batchSize)
+{
+  const double targetReduction = 0.9;
+
+  vtkSmartPointer<vtkQuadricDecimation> decimation =
+    vtkSmartPointer<vtkQuadricDecimation>::New();
+  decimation->SetInputData(input);
+  decimation->SetTargetReduction(targetReduction);
+  decimation->SetBatchSize(batchSize);
+  decimation->Update();
+
+  vtkIdType numTris = input->GetNumberOfPolys();
+  vtkIdType numOutputTris = decimation->GetOutput()->GetNumberOfPolys();
+  double reduction =
+    static_cast<double>(numTris - numOutputTris) / numTris;
+  if (reduction < targetReduction ||
+      fabs(reduction - decimation->GetActualReduction()) > 1e-6)
+    {
+    std::cout << "BatchSize " << batchSize << ": reduction " << reduction
+              << " (actual reduction " << decimation->GetActualReduction()
+              << "), expected " << targetReduction << std::endl;
+    return false;
+    }
+
+  // A few more triangles than needed may be removed by the last collapse.
+  if (reduction > targetReduction + 0.01)
+    {
+    std::cout << "BatchSize " << batchSize << ": overshot the reduction, "
+              << reduction << std::endl;
+    return false;
+    }
+
+  return true;
+}
+}
+
+int TestQuadricDecimation(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> torus = MakeTorus(120, 60);
+
+  if (!Decimate(torus, 1) || !Decimate(torus, 256))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
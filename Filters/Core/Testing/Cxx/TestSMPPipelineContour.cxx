@@ -23,6 +23,7 @@
 #include "vtkExtentTranslator.h"
 #include "vtkSMPThreadLocalObject.h"
 #include "vtkImageData.h"
+#include "vtkInformation.h"
 #include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSmartPointer.h"
@@ -141,6 +142,27 @@ int TestSMPPipelineContour(int, char *[])
     return EXIT_FAILURE;
     }
 
+  // An algorithm that opts out of concurrent execution must produce the
+  // same output.
+  cf->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+  cf->Modified();
+  cf->Update();
+
+  vtkIdType numSerialCells = 0;
+  iter.TakeReference(static_cast<vtkCompositeDataSet*>(cf->GetOutputDataObject(0))->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkPolyData* piece = static_cast<vtkPolyData*>(iter->GetCurrentDataObject());
+    numSerialCells += piece->GetNumberOfCells();
+    }
+
+  if (numSerialCells != numCells)
+    {
+    cout << "Number of cells did not match with REQUIRES_SERIAL_EXECUTION." << endl;
+    return EXIT_FAILURE;
+    }
+
 
 #if 0
   vtkNew<vtkXMLMultiBlockDataWriter> writer;
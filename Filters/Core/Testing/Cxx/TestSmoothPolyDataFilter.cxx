@@ -18,6 +18,8 @@
 #include <vtkSmartPointer.h>
 #include <vtkSmoothPolyDataFilter.h>
 
+#include <cmath>
+
 namespace
 {
 void InitializePolyData(vtkPolyData *polyData, int dataType)
@@ -83,6 +85,85 @@ int SmoothPolyData(int dataType, int outputPointsPrecision)
 
   return points->GetDataType();
 }
+
+vtkSmartPointer<vtkPolyData> SmoothPlane(int parallel)
+{
+  const int resolution = 20;
+  vtkSmartPointer<vtkMinimalStandardRandomSequence> randomSequence
+    = vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+  randomSequence->SetSeed(1);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataType(VTK_DOUBLE);
+  for(int j = 0; j < resolution; ++j)
+    {
+    for(int i = 0; i < resolution; ++i)
+      {
+      randomSequence->Next();
+      bool boundary = i == 0 || j == 0 ||
+        i == resolution - 1 || j == resolution - 1;
+      points->InsertNextPoint(i, j, boundary ? 0.0 :
+                              randomSequence->GetValue() - 0.5);
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for(int j = 0; j < resolution - 1; ++j)
+    {
+    for(int i = 0; i < resolution - 1; ++i)
+      {
+      vtkIdType quad[4] = { j * resolution + i, j * resolution + i + 1,
+                            (j + 1) * resolution + i + 1,
+                            (j + 1) * resolution + i };
+      polys->InsertNextCell(4, quad);
+      }
+    }
+
+  vtkSmartPointer<vtkPolyData> inputPolyData
+    = vtkSmartPointer<vtkPolyData>::New();
+  inputPolyData->SetPoints(points);
+  inputPolyData->SetPolys(polys);
+
+  vtkSmartPointer<vtkSmoothPolyDataFilter> smoothPolyDataFilter
+    = vtkSmartPointer<vtkSmoothPolyDataFilter>::New();
+  smoothPolyDataFilter->SetInputData(inputPolyData);
+  smoothPolyDataFilter->SetNumberOfIterations(2000);
+  smoothPolyDataFilter->SetRelaxationFactor(0.5);
+  smoothPolyDataFilter->SetConvergence(1e-9);
+  smoothPolyDataFilter->BoundarySmoothingOff();
+  smoothPolyDataFilter->SetParallelSmoothing(parallel);
+  smoothPolyDataFilter->Update();
+
+  return smoothPolyDataFilter->GetOutput();
+}
+
+// The in-place and the parallel updates must converge to the same (flat)
+// surface.
+bool CheckParallelSmoothing()
+{
+  vtkSmartPointer<vtkPolyData> serial = SmoothPlane(0);
+  vtkSmartPointer<vtkPolyData> parallel = SmoothPlane(1);
+  if(serial->GetNumberOfPoints() != parallel->GetNumberOfPoints())
+    {
+    return false;
+    }
+
+  for(vtkIdType i = 0; i < serial->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    serial->GetPoint(i, x);
+    parallel->GetPoint(i, y);
+    if(fabs(x[2]) > 1e-3 || fabs(y[2]) > 1e-3 ||
+       fabs(x[0] - y[0]) > 1e-3 || fabs(x[1] - y[1]) > 1e-3)
+      {
+      std::cout << "Point " << i << " differs: (" << x[0] << ", " << x[1]
+                << ", " << x[2] << ") vs (" << y[0] << ", " << y[1] << ", "
+                << y[2] << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
 }
 
 int TestSmoothPolyDataFilter(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
@@ -129,5 +210,10 @@ int TestSmoothPolyDataFilter(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
     return EXIT_FAILURE;
     }
 
+  if(!CheckParallelSmoothing())
+    {
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestWindowedSincPolyDataFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Smooths a noisy triangulated plane and checks that the noise is reduced
+// while the boundary and the fixed vertices do not move.
+
+#include <vtkCellArray.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkWindowedSincPolyDataFilter.h>
+
+#include <cmath>
+
+namespace
+{
+const int Resolution = 40;
+
+vtkSmartPointer<vtkPolyData> MakeNoisyPlane()
+{
+  vtkSmartPointer<vtkMinimalStandardRandomSequence> randomSequence
+    = vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+  randomSequence->SetSeed(1);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j < Resolution; ++j)
+    {
+    for (int i = 0; i < Resolution; ++i)
+      {
+      randomSequence->Next();
+      double z = 0.1 * (randomSequence->GetValue() - 0.5);
+      if (i == 0 || j == 0 || i == Resolution - 1 || j == Resolution - 1)
+        {
+        z = 0.0;
+        }
+      points->InsertNextPoint(i, j, z);
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j < Resolution - 1; ++j)
+    {
+    for (int i = 0; i < Resolution - 1; ++i)
+      {
+      vtkIdType p0 = j * Resolution + i;
+      vtkIdType tri0[3] = { p0, p0 + 1, p0 + Resolution + 1 };
+      vtkIdType tri1[3] = { p0, p0 + Resolution + 1, p0 + Resolution };
+      polys->InsertNextCell(3, tri0);
+      polys->InsertNextCell(3, tri1);
+      }
+    }
+
+  // A vertex cell fixes the point in the middle of the plane.
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType center = (Resolution / 2) * Resolution + Resolution / 2;
+  verts->InsertNextCell(1, &center);
+
+  vtkSmartPointer<vtkPolyData> plane = vtkSmartPointer<vtkPolyData>::New();
+  plane->SetPoints(points);
+  plane->SetPolys(polys);
+  plane->SetVerts(verts);
+  return plane;
+}
+
+double RMSHeight(vtkPolyData *polyData)
+{
+  double sum = 0.0;
+  for (vtkIdType i = 0; i < polyData->GetNumberOfPoints(); ++i)
+    {
+    double z = polyData->GetPoint(i)[2];
+    sum += z * z;
+    }
+  return sqrt(sum / polyData->GetNumberOfPoints());
+}
+}
+
+int TestWindowedSincPolyDataFilter(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> plane = MakeNoisyPlane();
+
+  vtkSmartPointer<vtkWindowedSincPolyDataFilter> smoother
+    = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
+  smoother->SetInputData(plane);
+  smoother->SetNumberOfIterations(50);
+  smoother->SetPassBand(0.01);
+  smoother->BoundarySmoothingOff();
+  smoother->Update();
+
+  vtkPolyData *output = smoother->GetOutput();
+  if (output->GetNumberOfPoints() != plane->GetNumberOfPoints())
+    {
+    std::cout << "Unexpected number of points: "
+              << output->GetNumberOfPoints() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for (vtkIdType i = 0; i < plane->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    plane->GetPoint(i, x);
+    output->GetPoint(i, y);
+    int ix = static_cast<int>(x[0]), iy = static_cast<int>(x[1]);
+    bool fixed = ix == 0 || iy == 0 || ix == Resolution - 1 ||
+      iy == Resolution - 1 ||
+      (ix == Resolution / 2 && iy == Resolution / 2);
+    if (fixed && (x[0] != y[0] || x[1] != y[1] || x[2] != y[2]))
+      {
+      std::cout << "Fixed point " << i << " has moved." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  double before = RMSHeight(plane);
+  double after = RMSHeight(output);
+  if (!(after < 0.5 * before))
+    {
+    std::cout << "Noise was not reduced: " << before << " -> " << after
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -15,6 +15,7 @@
 #include "vtkArrayCalculator.h"
 
 #include "vtkCellData.h"
+#include "vtkDataArrayTemplate.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
@@ -26,10 +27,211 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkArrayCalculator);
 
+namespace
+{
+// Number of tuples evaluated at once by vtkFunctionParser::EvaluateBlock.
+// The columns of a block stay in the cache.
+const vtkIdType VTK_CALCULATOR_BLOCK_SIZE = 1024;
+
+//----------------------------------------------------------------------------
+// Copy a component of the tuples [begin, begin + n) of an array to a
+// column.
+template <class T>
+void vtkArrayCalculatorGather(vtkDataArray* array, int component,
+                              vtkIdType begin, vtkIdType n, double* column)
+{
+  vtkDataArrayTemplate<T>* typed =
+    vtkDataArrayTemplate<T>::FastDownCast(array);
+  if (!typed)
+    {
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      column[i] = array->GetComponent(begin + i, component);
+      }
+    return;
+    }
+  int numComp = typed->GetNumberOfComponents();
+  vtkIdType index = begin * numComp + component;
+  for (vtkIdType i = 0; i < n; ++i, index += numComp)
+    {
+    column[i] = static_cast<double>(typed->GetValue(index));
+    }
+}
+
+//----------------------------------------------------------------------------
+// Copy the interleaved results of the tuples [begin, begin + n) to an
+// array.
+template <class T>
+void vtkArrayCalculatorScatter(const double* values, vtkIdType begin,
+                               vtkIdType n, vtkDataArray* array,
+                               void* pointer)
+{
+  int numComp = array->GetNumberOfComponents();
+  if (!pointer)
+    {
+    for (vtkIdType i = 0; i < n; ++i)
+      {
+      array->SetTuple(begin + i, values + i * numComp);
+      }
+    return;
+    }
+  T* output = static_cast<T*>(pointer) + begin * numComp;
+  for (vtkIdType i = 0; i < n * numComp; ++i)
+    {
+    output[i] = static_cast<T>(values[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Where the values of a variable of the function come from: a component
+// of an input array, a coordinate of the input points, or the value set
+// in the function parser when neither is given.
+struct vtkArrayCalculatorColumn
+{
+  vtkArrayCalculatorColumn() : Array(0), Component(-1) {}
+  vtkDataArray* Array;
+  int Component;
+};
+
+//----------------------------------------------------------------------------
+// Evaluate the function for blocks of tuples.
+class vtkArrayCalculatorFunctor
+{
+public:
+  vtkFunctionParser* Parser;
+  vtkDataSet* DataSet;
+  vtkGraph* Graph;
+  // One column per scalar variable and three per vector variable of the
+  // function parser.
+  std::vector<vtkArrayCalculatorColumn> ScalarColumns;
+  std::vector<vtkArrayCalculatorColumn> VectorColumns;
+  vtkDataArray* Result;
+  // Raw pointer to the values of Result, or NULL to use SetTuple.
+  void* ResultPointer;
+  vtkSMPThreadLocal<std::vector<double> > Buffers;
+  vtkSMPThreadLocal<vtkIdType> NumberOfInvalidTuples;
+
+  vtkArrayCalculatorFunctor() : Parser(0), DataSet(0), Graph(0), Result(0),
+    ResultPointer(0), NumberOfInvalidTuples(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end;
+         block += VTK_CALCULATOR_BLOCK_SIZE)
+      {
+      this->Evaluate(block,
+                     std::min(VTK_CALCULATOR_BLOCK_SIZE, end - block));
+      }
+  }
+
+  void Evaluate(vtkIdType begin, vtkIdType n)
+  {
+    size_t numScalars = this->ScalarColumns.size();
+    size_t numVectors = this->VectorColumns.size();
+    size_t numColumns = numScalars + numVectors + 3 + 3;
+    std::vector<double>& buffer = this->Buffers.Local();
+    buffer.resize(numColumns * VTK_CALCULATOR_BLOCK_SIZE);
+    double* coordinates = &buffer[0];
+    double* columns = coordinates + 3 * VTK_CALCULATOR_BLOCK_SIZE;
+    double* result =
+      columns + (numScalars + numVectors) * VTK_CALCULATOR_BLOCK_SIZE;
+
+    // The coordinates of the points, as three columns.
+    bool hasCoordinates = false;
+    for (size_t j = 0; j < numScalars + numVectors; ++j)
+      {
+      const vtkArrayCalculatorColumn& column = (j < numScalars) ?
+        this->ScalarColumns[j] : this->VectorColumns[j - numScalars];
+      hasCoordinates |= (!column.Array && column.Component >= 0);
+      }
+    if (hasCoordinates)
+      {
+      double pt[3];
+      for (vtkIdType i = 0; i < n; ++i)
+        {
+        if (this->DataSet)
+          {
+          this->DataSet->GetPoint(begin + i, pt);
+          }
+        else
+          {
+          this->Graph->GetPoint(begin + i, pt);
+          }
+        coordinates[i] = pt[0];
+        coordinates[VTK_CALCULATOR_BLOCK_SIZE + i] = pt[1];
+        coordinates[2 * VTK_CALCULATOR_BLOCK_SIZE + i] = pt[2];
+        }
+      }
+
+    std::vector<const double*> values(numScalars + numVectors);
+    for (size_t j = 0; j < values.size(); ++j)
+      {
+      const vtkArrayCalculatorColumn& column = (j < numScalars) ?
+        this->ScalarColumns[j] : this->VectorColumns[j - numScalars];
+      double* columnValues = columns + j * VTK_CALCULATOR_BLOCK_SIZE;
+      if (column.Array)
+        {
+        switch (column.Array->GetDataType())
+          {
+          vtkTemplateMacro(vtkArrayCalculatorGather<VTK_TT>(
+                             column.Array, column.Component, begin, n,
+                             columnValues));
+          default:
+            vtkArrayCalculatorGather<double>(
+              column.Array, column.Component, begin, n, columnValues);
+          }
+        values[j] = columnValues;
+        }
+      else if (column.Component >= 0)
+        {
+        values[j] = coordinates + column.Component * VTK_CALCULATOR_BLOCK_SIZE;
+        }
+      else
+        {
+        values[j] = 0;
+        }
+      }
+
+    this->NumberOfInvalidTuples.Local() += this->Parser->EvaluateBlock(
+      n, numScalars ? &values[0] : 0,
+      numVectors ? &values[numScalars] : 0, result);
+
+    switch (this->Result->GetDataType())
+      {
+      vtkTemplateMacro(vtkArrayCalculatorScatter<VTK_TT>(
+                         result, begin, n, this->Result,
+                         this->ResultPointer));
+      default:
+        vtkArrayCalculatorScatter<double>(result, begin, n, this->Result, 0);
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Whether the values of an array can be read and written by several
+// threads at once.
+bool vtkArrayCalculatorIsThreadSafe(vtkDataArray* array)
+{
+  switch (array->GetDataType())
+    {
+    vtkTemplateMacro(
+      return vtkDataArrayTemplate<VTK_TT>::FastDownCast(array) != 0);
+    }
+  return false;
+}
+}
+
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -453,66 +655,107 @@ int vtkArrayCalculator::RequestData(
     resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
     }
 
-  for (i = 1; i < numTuples; i++)
+  // Evaluate the other tuples by blocks. Each block reads the input arrays
+  // and writes the result array directly, so the blocks are evaluated in
+  // parallel unless an array has to be accessed through its generic API.
+  vtkArrayCalculatorFunctor functor;
+  functor.Parser = this->FunctionParser;
+  functor.DataSet = dsInput;
+  functor.Graph = graphInput;
+  functor.Result = resultArray;
+  bool threadSafe = vtkArrayCalculatorIsThreadSafe(resultArray);
+  if (threadSafe)
+    {
+    functor.ResultPointer = resultArray->GetVoidPointer(0);
+    }
+
+  int numScalarVariables = this->FunctionParser->GetNumberOfScalarVariables();
+  functor.ScalarColumns.resize(numScalarVariables);
+  for (j = 0; j < numScalarVariables; j++)
     {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
+    vtkArrayCalculatorColumn& column = functor.ScalarColumns[j];
+    if (j < this->NumberOfScalarArrays)
       {
-      currentArray = inFD->GetArray(this->ScalarArrayNames[j]);
-      if(currentArray)
-        {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j, currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
-        }
+      column.Array = inFD->GetArray(this->ScalarArrayNames[j]);
+      column.Component = this->SelectedScalarComponents[j];
       }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
+    else if (attributeDataType == POINT_DATA &&
+             j < this->NumberOfScalarArrays +
+                 this->NumberOfCoordinateScalarArrays)
       {
-      currentArray = inFD->GetArray(this->VectorArrayNames[j]);
-      this->FunctionParser->
-        SetVectorVariableValue(
-          j, currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-          currentArray->GetComponent(
-            i, this->SelectedVectorComponents[j][1]),
-          currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
+      column.Component = this->SelectedCoordinateScalarComponents[
+        j - this->NumberOfScalarArrays];
       }
-    if(attributeDataType == POINT_DATA)
+    if (j < this->NumberOfScalarArrays && !column.Array)
       {
-      double* pt = 0;
-      if (dsInput)
-        {
-        pt = dsInput->GetPoint(i);
-        }
-      else
-        {
-        pt = graphInput->GetPoint(i);
-        }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
+      // String arrays are ignored: the variable keeps its value.
+      column.Component = -1;
+      }
+    }
+
+  int numVectorVariables = this->FunctionParser->GetNumberOfVectorVariables();
+  functor.VectorColumns.resize(3 * numVectorVariables);
+  for (j = 0; j < numVectorVariables; j++)
+    {
+    for (int k = 0; k < 3; k++)
+      {
+      vtkArrayCalculatorColumn& column = functor.VectorColumns[3 * j + k];
+      if (j < this->NumberOfVectorArrays)
         {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
+        column.Array = inFD->GetArray(this->VectorArrayNames[j]);
+        column.Component = this->SelectedVectorComponents[j][k];
         }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
+      else if (attributeDataType == POINT_DATA &&
+               j < this->NumberOfVectorArrays +
+                   this->NumberOfCoordinateVectorArrays)
         {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
+        column.Component = this->SelectedCoordinateVectorComponents[
+          j - this->NumberOfVectorArrays][k];
         }
       }
-    if (resultType == SCALAR_RESULT)
+    }
+
+  for (size_t c = 0; c < functor.ScalarColumns.size(); c++)
+    {
+    if (functor.ScalarColumns[c].Array)
       {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
+      threadSafe &=
+        vtkArrayCalculatorIsThreadSafe(functor.ScalarColumns[c].Array);
       }
-    else
+    }
+  for (size_t c = 0; c < functor.VectorColumns.size(); c++)
+    {
+    if (functor.VectorColumns[c].Array)
       {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
+      threadSafe &=
+        vtkArrayCalculatorIsThreadSafe(functor.VectorColumns[c].Array);
       }
     }
 
+  if (threadSafe)
+    {
+    vtkSMPTools::For(1, numTuples, VTK_CALCULATOR_BLOCK_SIZE, functor);
+    }
+  else
+    {
+    functor(1, numTuples);
+    }
+
+  vtkIdType numInvalidTuples = 0;
+  vtkSMPThreadLocal<vtkIdType>::iterator invalidIter;
+  for (invalidIter = functor.NumberOfInvalidTuples.begin();
+       invalidIter != functor.NumberOfInvalidTuples.end(); ++invalidIter)
+    {
+    numInvalidTuples += *invalidIter;
+    }
+  if (numInvalidTuples > 0)
+    {
+    vtkErrorMacro("The function could not be evaluated for "
+                  << numInvalidTuples << " tuples, set to "
+                  << VTK_PARSER_ERROR_RESULT
+                  << ". Use ReplaceInvalidValues to replace them.");
+    }
+
   CopyDataSetOrGraph (dsInput, dsOutput, graphInput, graphOutput);
   if(resultPoints)
     {
@@ -20,7 +20,10 @@
 // used in a given function must be all in point data or all in cell data.
 // The resulting array will be stored as a field data array.  The result
 // array can either be stored in a new array or it can overwrite an existing
-// array.
+// array. The function is evaluated for blocks of tuples at once (see
+// vtkFunctionParser::EvaluateBlock()), and the blocks are evaluated in
+// parallel with vtkSMPTools when all the arrays are vtkDataArrayTemplate
+// instances.
 //
 // The functions that this array calculator understands is:
 // <pre>
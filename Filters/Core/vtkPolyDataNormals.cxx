@@ -26,6 +26,12 @@
 #include "vtkPolygon.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataNormals);
 
@@ -49,6 +55,470 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Computes the normal of each polygon of the mesh.
+class vtkPolyDataNormalsPolyNormals
+{
+public:
+  vtkPolyDataNormalsPolyNormals(vtkPolyData *mesh, vtkPoints *points,
+                                vtkFloatArray *polyNormals)
+    : Mesh(mesh), Points(points), PolyNormals(polyNormals->GetPointer(0))
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *normal = this->PolyNormals + 3 * cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+      }
+  }
+
+private:
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+};
+
+//----------------------------------------------------------------------------
+// Returns the index of the first occurence of cellId in cells, or ncells if
+// it is not there. The cells using a point are listed in increasing order by
+// vtkPolyData::BuildLinks, so they are searched by bisection.
+inline int vtkPolyDataNormalsFindCell(const vtkIdType *cells, int ncells,
+                                      vtkIdType cellId)
+{
+  const vtkIdType *found = std::lower_bound(cells, cells + ncells, cellId);
+  return (found != cells + ncells && *found == cellId) ?
+    static_cast<int>(found - cells) : ncells;
+}
+
+//----------------------------------------------------------------------------
+// Start moving around the "cycle" of points using the point. Label each
+// subregion of cells connected to this point that are connected (and not
+// separated by a feature edge) with a given region number. regions[i]
+// receives the region of the i-th cell using the point (the region of its
+// first occurence if a cell uses the point several times). Returns the
+// number of regions: for each N regions, N-1 duplicate (split) points are
+// needed. Only reads the mesh so that all points can be processed
+// concurrently.
+int vtkPolyDataNormalsMarkRegions(vtkPolyData *mesh, const float *polyNormals,
+                                  double cosAngle, vtkIdType ptId,
+                                  int *regions, vtkIdList *cellIds)
+{
+  // Get the cells using this point and make sure that we have to do something
+  unsigned short ncells;
+  vtkIdType *cells;
+  mesh->GetPointCells(ptId, ncells, cells);
+  if ( ncells <= 1 )
+    {
+    return 1; //point does not need to be further disconnected
+    }
+
+  // Start by initializing the cells as unvisited
+  int i, j;
+  for (i=0; i<ncells; i++)
+    {
+    regions[i] = -1;
+    }
+
+  // Loop over all cells and mark the region that each is in.
+  //
+  vtkIdType numPts;
+  vtkIdType *pts;
+  int numRegions = 0;
+  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
+  int neiIdx;
+  for (j=0; j<ncells; j++) //for all cells connected to point
+    {
+    if ( regions[vtkPolyDataNormalsFindCell(cells, j, cells[j])] < 0 )
+      {
+      regions[j] = numRegions;
+      //okay, mark all the cells connected to this seed cell and using ptId
+      mesh->GetCellPoints(cells[j],numPts,pts);
+
+      //find the two edges
+      for (spot=0; spot < numPts; spot++)
+        {
+        if ( pts[spot] == ptId )
+          {
+          break;
+          }
+        }
+
+      if ( spot == 0 )
+        {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[numPts-1];
+        }
+      else if ( spot == (numPts-1) )
+        {
+        neiPt[0] = pts[spot-1];
+        neiPt[1] = pts[0];
+        }
+      else
+        {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[spot-1];
+        }
+
+      for (i=0; i<2; i++) //for each of the two edges of the seed cell
+        {
+        cellId = cells[j];
+        nei = neiPt[i];
+        while ( cellId >= 0 ) //while we can grow this region
+          {
+          mesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+          if ( cellIds->GetNumberOfIds() == 1 &&
+               regions[(neiIdx=vtkPolyDataNormalsFindCell(cells, ncells,
+                  (neiCellId=cellIds->GetId(0))))] < 0 )
+            {
+            const float *thisNormal = polyNormals + 3 * cellId;
+            const float *neiNormal = polyNormals + 3 * neiCellId;
+
+            if ( static_cast<double>(thisNormal[0]) * neiNormal[0] +
+                 static_cast<double>(thisNormal[1]) * neiNormal[1] +
+                 static_cast<double>(thisNormal[2]) * neiNormal[2] >
+                 cosAngle )
+              {
+              //visit and arrange to visit next edge neighbor
+              regions[neiIdx] = numRegions;
+              cellId = neiCellId;
+              mesh->GetCellPoints(cellId,numPts,pts);
+
+              for (spot=0; spot < numPts; spot++)
+                {
+                if ( pts[spot] == ptId )
+                  {
+                  break;
+                  }
+                }
+
+              if (spot == 0)
+                {
+                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+                }
+              else if (spot == (numPts-1))
+                {
+                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+                }
+              else
+                {
+                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+                }
+
+              }//if not separated by edge angle
+            else
+              {
+              cellId = -1; //separated by edge angle
+              }
+            }//if can move to edge neighbor
+          else
+            {
+            cellId = -1;//separated by previous visit, boundary, or non-manifold
+            }
+          }//while visit wave is propagating
+        }//for each of the two edges of the starting cell
+      numRegions++;
+      }//if cell is unvisited
+    }//for all cells connected to point ptId
+
+  // Cells using the point more than once share the region of their first
+  // occurence.
+  for (j=0; j<ncells; j++)
+    {
+    regions[j] = regions[vtkPolyDataNormalsFindCell(cells, j + 1, cells[j])];
+    }
+
+  return numRegions;
+}
+
+//----------------------------------------------------------------------------
+// Base class of the functors splitting the mesh along feature edges.
+class vtkPolyDataNormalsSplitBase
+{
+public:
+  vtkPolyDataNormalsSplitBase(vtkPolyData *oldMesh, vtkFloatArray *polyNormals,
+                              double cosAngle)
+    : OldMesh(oldMesh), PolyNormals(polyNormals->GetPointer(0)),
+      CosAngle(cosAngle)
+  {
+  }
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+protected:
+  int MarkRegions(vtkIdType ptId)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    this->OldMesh->GetPointCells(ptId, ncells, cells);
+    std::vector<int>& regions = this->Regions.Local();
+    regions.resize(ncells + 1);
+    return vtkPolyDataNormalsMarkRegions(this->OldMesh, this->PolyNormals,
+      this->CosAngle, ptId, &regions[0], this->CellIds.Local());
+  }
+
+  vtkPolyData *OldMesh;
+  const float *PolyNormals;
+  double CosAngle;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<std::vector<int> > Regions;
+};
+
+//----------------------------------------------------------------------------
+// Counts the regions around each point.
+class vtkPolyDataNormalsCountRegions : public vtkPolyDataNormalsSplitBase
+{
+public:
+  vtkPolyDataNormalsCountRegions(vtkPolyData *oldMesh,
+                                 vtkFloatArray *polyNormals, double cosAngle,
+                                 int *numRegions)
+    : vtkPolyDataNormalsSplitBase(oldMesh, polyNormals, cosAngle),
+      NumRegions(numRegions)
+  {
+  }
+
+  void Initialize()
+  {
+    this->vtkPolyDataNormalsSplitBase::Initialize();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      this->NumRegions[ptId] = this->MarkRegions(ptId);
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  int *NumRegions;
+};
+
+//----------------------------------------------------------------------------
+// Records the region of each cell around the points that have to be
+// split, and maps the split points to the point they duplicate.
+class vtkPolyDataNormalsLabelRegions : public vtkPolyDataNormalsSplitBase
+{
+public:
+  vtkPolyDataNormalsLabelRegions(vtkPolyData *oldMesh,
+                                 vtkFloatArray *polyNormals, double cosAngle,
+                                 const vtkIdType *labelOffsets, int *labels,
+                                 const vtkIdType *splitIds, vtkIdType *map)
+    : vtkPolyDataNormalsSplitBase(oldMesh, polyNormals, cosAngle),
+      LabelOffsets(labelOffsets), Labels(labels), SplitIds(splitIds), Map(map)
+  {
+  }
+
+  void Initialize()
+  {
+    this->vtkPolyDataNormalsSplitBase::Initialize();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      vtkIdType numLabels =
+        this->LabelOffsets[ptId + 1] - this->LabelOffsets[ptId];
+      if (numLabels == 0)
+        {
+        continue;
+        }
+      int numRegions = this->MarkRegions(ptId);
+      const int *regions = &this->Regions.Local()[0];
+      std::copy(regions, regions + numLabels,
+                this->Labels + this->LabelOffsets[ptId]);
+      for (int r = 1; r < numRegions; r++)
+        {
+        this->Map[this->SplitIds[ptId] + r - 1] = ptId;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  const vtkIdType *LabelOffsets;
+  int *Labels;
+  const vtkIdType *SplitIds;
+  vtkIdType *Map;
+};
+
+//----------------------------------------------------------------------------
+// For all cells not in the first region around a split point, the point
+// is replaced with a new point, which is a duplicate of the first point,
+// but disconnected topologically.
+class vtkPolyDataNormalsReplacePoints
+{
+public:
+  vtkPolyDataNormalsReplacePoints(vtkPolyData *oldMesh, vtkPolyData *newMesh,
+                                  const vtkIdType *labelOffsets,
+                                  const int *labels, const vtkIdType *splitIds)
+    : OldMesh(oldMesh), NewMesh(newMesh), LabelOffsets(labelOffsets),
+      Labels(labels), SplitIds(splitIds)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkIdType npts, *pts;
+    unsigned short ncells;
+    vtkIdType *cells;
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      this->NewMesh->GetCellPoints(cellId, npts, pts);
+      for (vtkIdType i = 0; i < npts; i++)
+        {
+        vtkIdType ptId = pts[i];
+        if (this->LabelOffsets[ptId + 1] == this->LabelOffsets[ptId])
+          {
+          continue;
+          }
+        this->OldMesh->GetPointCells(ptId, ncells, cells);
+        int region = this->Labels[this->LabelOffsets[ptId] +
+          vtkPolyDataNormalsFindCell(cells, ncells, cellId)];
+        if (region > 0)
+          {
+          pts[i] = this->SplitIds[ptId] + region - 1;
+          }
+        }
+      }
+  }
+
+private:
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *LabelOffsets;
+  const int *Labels;
+  const vtkIdType *SplitIds;
+};
+
+//----------------------------------------------------------------------------
+// Accumulates the normals of the polygons at their points and normalizes
+// the result. Each input point gathers the contributions of the cells
+// using it (or one of its split copies), in increasing cell order, so the
+// sums do not depend on the number of threads.
+class vtkPolyDataNormalsPointNormals
+{
+public:
+  vtkPolyDataNormalsPointNormals(vtkPolyData *oldMesh, vtkPolyData *newMesh,
+                                 vtkFloatArray *polyNormals,
+                                 vtkFloatArray *pointNormals,
+                                 const vtkIdType *splitIds,
+                                 const vtkIdType *map, double flipDirection)
+    : OldMesh(oldMesh), NewMesh(newMesh),
+      PolyNormals(polyNormals->GetPointer(0)),
+      PointNormals(pointNormals->GetPointer(0)), SplitIds(splitIds), Map(map),
+      FlipDirection(flipDirection)
+  {
+    this->NumberOfPoints = oldMesh->GetNumberOfPoints();
+    this->NumberOfNewPoints = pointNormals->GetNumberOfTuples();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      vtkIdType firstSplit = 0, lastSplit = 0;
+      if (this->SplitIds)
+        {
+        firstSplit = this->SplitIds[ptId];
+        lastSplit = ptId + 1 < this->NumberOfPoints ?
+          this->SplitIds[ptId + 1] : this->NumberOfNewPoints;
+        }
+      this->Zero(ptId);
+      for (vtkIdType id = firstSplit; id < lastSplit; id++)
+        {
+        this->Zero(id);
+        }
+
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      for (int i = 0; i < ncells; i++)
+        {
+        if (i > 0 && cells[i] == cells[i - 1])
+          {
+          continue;
+          }
+        const float *polyNormal = this->PolyNormals + 3 * cells[i];
+        this->NewMesh->GetCellPoints(cells[i], npts, pts);
+        for (vtkIdType j = 0; j < npts; j++)
+          {
+          if (pts[j] == ptId ||
+              (pts[j] >= this->NumberOfPoints && this->Map[pts[j]] == ptId))
+            {
+            float *normal = this->PointNormals + 3 * pts[j];
+            for (int k = 0; k < 3; k++)
+              {
+              normal[k] = static_cast<float>(
+                static_cast<double>(normal[k]) + polyNormal[k]);
+              }
+            }
+          }
+        }
+
+      this->Normalize(ptId);
+      for (vtkIdType id = firstSplit; id < lastSplit; id++)
+        {
+        this->Normalize(id);
+        }
+      }
+  }
+
+private:
+  void Zero(vtkIdType id) const
+  {
+    float *normal = this->PointNormals + 3 * id;
+    normal[0] = normal[1] = normal[2] = 0.0f;
+  }
+
+  void Normalize(vtkIdType id) const
+  {
+    float *normal = this->PointNormals + 3 * id;
+    double vertNormal[3] = { normal[0], normal[1], normal[2] };
+    double length = vtkMath::Norm(vertNormal);
+    if (length != 0.0)
+      {
+      for (int j = 0; j < 3; j++)
+        {
+        normal[j] = static_cast<float>(
+          vertNormal[j] / length * this->FlipDirection);
+        }
+      }
+  }
+
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const float *PolyNormals;
+  float *PointNormals;
+  const vtkIdType *SplitIds;
+  const vtkIdType *Map;
+  double FlipDirection;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfNewPoints;
+};
+}
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -65,12 +535,10 @@ int vtkPolyDataNormals::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  int j;
   vtkIdType npts = 0;
   vtkIdType i;
   vtkIdType *pts = 0;
   vtkIdType numNewPts;
-  double polyNormal[3], vertNormal[3], length;
   double flipDirection=1.0;
   vtkIdType numPolys, numStrips;
   vtkIdType cellId;
@@ -317,43 +785,78 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  // The polygons are processed by blocks, between which progress is
+  // reported and the execution may be aborted.
+  vtkPolyDataNormalsPolyNormals polyNormals(this->NewMesh, inPts,
+                                            this->PolyNormals);
+  vtkIdType blockSize = std::max(numPolys / 10, static_cast<vtkIdType>(10000));
+  for (cellId = 0; cellId < numPolys; cellId += blockSize)
     {
-    if ((cellId % 1000) == 0)
+    this->UpdateProgress(0.333 + 0.167 * cellId / numPolys);
+    if (this->GetAbortExecute())
       {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-        {
-        break;
-        }
+      break;
       }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
+    vtkSMPTools::For(cellId, std::min(cellId + blockSize, numPolys),
+                     polyNormals);
     }
+  this->UpdateProgress(0.5);
 
   // Split mesh if sharp features
+  std::vector<vtkIdType> splitIds;
   if ( this->Splitting )
     {
     //  Traverse all nodes; evaluate loops and feature edges.  If feature
     //  edges found, split mesh creating new nodes.  Update polygon
     // connectivity.
     //
-      this->CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
+    this->CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
+
+    // The regions around each point are found concurrently. The split
+    // points are numbered in point order, then the cells of the regions
+    // but the first one are made to use them.
+    std::vector<int> numRegions(numPts);
+    vtkPolyDataNormalsCountRegions countRegions(this->OldMesh,
+      this->PolyNormals, this->CosAngle, &numRegions[0]);
+    vtkSMPTools::For(0, numPts, countRegions);
+
+    splitIds.resize(numPts);
+    std::vector<vtkIdType> labelOffsets(numPts + 1);
+    unsigned short ncells;
+    vtkIdType *cells;
+    numNewPts = numPts;
+    labelOffsets[0] = 0;
+    for (ptId=0; ptId < numPts; ptId++)
+      {
+      splitIds[ptId] = numNewPts;
+      labelOffsets[ptId + 1] = labelOffsets[ptId];
+      if ( numRegions[ptId] > 1 )
+        {
+        numNewPts += numRegions[ptId] - 1;
+        this->OldMesh->GetPointCells(ptId, ncells, cells);
+        labelOffsets[ptId + 1] += ncells;
+        }
+      }
+
     //  Splitting will create new points.  We have to create index array
     // to map new points into old points.
     //
     this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
+    this->Map->SetNumberOfIds(numNewPts);
     for (i=0; i < numPts; i++)
       {
       this->Map->SetId(i,i);
       }
 
-    for (ptId=0; ptId < numPts; ptId++)
-      {
-      this->MarkAndSplit(ptId);
-      }//for all input points
+    std::vector<int> labels(labelOffsets[numPts] + 1);
+    vtkPolyDataNormalsLabelRegions labelRegions(this->OldMesh,
+      this->PolyNormals, this->CosAngle, &labelOffsets[0], &labels[0],
+      &splitIds[0], this->Map->GetPointer(0));
+    vtkSMPTools::For(0, numPts, labelRegions);
+
+    vtkPolyDataNormalsReplacePoints replacePoints(this->OldMesh,
+      this->NewMesh, &labelOffsets[0], &labels[0], &splitIds[0]);
+    vtkSMPTools::For(0, numPolys, replacePoints);
 
     numNewPts = this->Map->GetNumberOfIds();
 
@@ -395,7 +898,6 @@ int vtkPolyDataNormals::RequestData(
       newPts->SetPoint(ptId,inPts->GetPoint(oldId));
       outPD->CopyData(pd,oldId,ptId);
       }
-    this->Map->Delete();
     } //splitting
 
   else //no splitting, so no new points
@@ -425,43 +927,19 @@ int vtkPolyDataNormals::RequestData(
   newNormals->SetNumberOfComponents(3);
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
-  n[0] = n[1] = n[2] = 0.0;
-  for (i=0; i < numNewPts; i++)
-    {
-    newNormals->SetTuple(i,n);
-    }
 
   if (this->ComputePointNormals)
     {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-          cellId++ )
-      {
-      this->PolyNormals->GetTuple(cellId, polyNormal);
-
-      for (i=0; i < npts; i++)
-        {
-        newNormals->GetTuple(pts[i], vertNormal);
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] + polyNormal[j];
-          }
-        newNormals->SetTuple(pts[i],n);
-        }
-      }
+    vtkPolyDataNormalsPointNormals pointNormals(this->OldMesh, this->NewMesh,
+      this->PolyNormals, newNormals,
+      this->Splitting ? &splitIds[0] : NULL,
+      this->Splitting ? this->Map->GetPointer(0) : NULL, flipDirection);
+    vtkSMPTools::For(0, numPts, pointNormals);
+    }
 
-    for (i=0; i < numNewPts; i++)
-      {
-      newNormals->GetTuple(i, vertNormal);
-      length = vtkMath::Norm(vertNormal);
-      if (length != 0.0)
-        {
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] / length * flipDirection;
-          }
-        }
-      newNormals->SetTuple(i,n);
-      }
+  if ( this->Splitting )
+    {
+    this->Map->Delete();
     }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -577,167 +1055,6 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
   return;
 }
 
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
-{
-  int i,j;
-
-  // Get the cells using this point and make sure that we have to do something
-  unsigned short ncells;
-  vtkIdType *cells;
-  this->OldMesh->GetPointCells(ptId,ncells,cells);
-  if ( ncells <= 1 )
-    {
-    return; //point does not need to be further disconnected
-    }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i=0; i<ncells; i++)
-    {
-    this->Visited[cells[i]] = -1;
-    }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  vtkIdType *pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j=0; j<ncells; j++) //for all cells connected to point
-    {
-    if ( this->Visited[cells[j]] < 0 ) //for all unvisited cells
-      {
-      this->Visited[cells[j]] = numRegions;
-      //okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j],numPts,pts);
-
-      //find the two edges
-      for (spot=0; spot < numPts; spot++)
-        {
-        if ( pts[spot] == ptId )
-          {
-          break;
-          }
-        }
-
-      if ( spot == 0 )
-        {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[numPts-1];
-        }
-      else if ( spot == (numPts-1) )
-        {
-        neiPt[0] = pts[spot-1];
-        neiPt[1] = pts[0];
-        }
-      else
-        {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[spot-1];
-        }
-
-      for (i=0; i<2; i++) //for each of the two edges of the seed cell
-        {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while ( cellId >= 0 ) //while we can grow this region
-          {
-          this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,this->CellIds);
-          if ( this->CellIds->GetNumberOfIds() == 1 &&
-               this->Visited[(neiCellId=this->CellIds->GetId(0))] < 0 )
-            {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if ( vtkMath::Dot(thisNormal,neiNormal) > CosAngle )
-              {
-              //visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId,numPts,pts);
-
-              for (spot=0; spot < numPts; spot++)
-                {
-                if ( pts[spot] == ptId )
-                  {
-                  break;
-                  }
-                }
-
-              if (spot == 0)
-                {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
-                }
-              else if (spot == (numPts-1))
-                {
-                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
-                }
-              else
-                {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
-                }
-
-              }//if not separated by edge angle
-            else
-              {
-              cellId = -1; //separated by edge angle
-              }
-            }//if can move to edge neighbor
-          else
-            {
-            cellId = -1;//separated by previous visit, boundary, or non-manifold
-            }
-          }//while visit wave is propagating
-        }//for each of the two edges of the starting cell
-      numRegions++;
-      }//if cell is unvisited
-    }//for all cells connected to point ptId
-
-  if ( numRegions <=1 )
-    {
-    return; //a single region, no splitting ever required
-    }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j=0; j<ncells; j++)
-    {
-    if (this->Visited[cells[j]] > 0 ) //replace point if splitting needed
-      {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-
-      this->Map->InsertId(replacementPoint, ptId);
-
-      this->NewMesh->GetCellPoints(cells[j],numPts,pts);
-      for (i=0; i < numPts; i++)
-        {
-        if ( pts[i] == ptId )
-          {
-          pts[i] = replacementPoint; // this is very nasty! direct write!
-          break;
-          }
-        }//replace ptId with split point
-      }//if not in first regions and requiring splitting
-    }//for all cells connected to ptId
-
-  return;
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -168,11 +168,6 @@ private:
   // checked and properly ordered polygons.
   void TraverseAndOrder(void);
 
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
-
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&);  // Not implemented.
   void operator=(const vtkPolyDataNormals&);  // Not implemented.
@@ -24,10 +24,15 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
+#include <vtksys/hash_map.hxx> // per-thread quadrics
 #include <vtksys/hash_set.hxx> // keep track of inserted triangles
 
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricClustering);
 
 //----------------------------------------------------------------------------
@@ -38,6 +43,180 @@ struct vtkQuadricClusteringIdTypeHash {
 class vtkQuadricClusteringCellSet : public vtksys::hash_set<vtkIdType, vtkQuadricClusteringIdTypeHash> {};
 typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
 
+//----------------------------------------------------------------------------
+// Sparse set of bin quadrics accumulated by one thread.
+struct vtkQuadricClusteringBinQuadric
+{
+  vtkQuadricClusteringBinQuadric()
+  {
+    for (int i = 0; i < 9; i++)
+      {
+      this->Quadric[i] = 0.0;
+      }
+  }
+  double Quadric[9];
+};
+typedef vtksys::hash_map<vtkIdType, vtkQuadricClusteringBinQuadric,
+                         vtkQuadricClusteringIdTypeHash>
+  vtkQuadricClusteringBinMap;
+
+//----------------------------------------------------------------------------
+// Hashes the input points into their bins.
+class vtkQuadricClusteringHashPoints
+{
+public:
+  vtkQuadricClusteringHashPoints(vtkQuadricClustering *self, vtkPoints *points,
+                                 vtkIdType *binIds)
+    : Self(self), Points(points), BinIds(binIds)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      this->Points->GetPoint(ptId, x);
+      this->BinIds[ptId] = this->Self->HashPoint(x);
+      }
+  }
+
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+  vtkIdType *BinIds;
+};
+
+//----------------------------------------------------------------------------
+// Computes the quadrics of the (fan triangulated) polygons and sums them
+// per bin, in a separate bin map for each thread.
+class vtkQuadricClusteringPolygonQuadrics
+{
+public:
+  vtkQuadricClusteringPolygonQuadrics(vtkQuadricClustering *self,
+                                      vtkPoints *points,
+                                      const vtkIdType *connectivity,
+                                      const vtkIdType *cellLocations,
+                                      const vtkIdType *pointBinIds)
+    : Self(self), Points(points), Connectivity(connectivity),
+      CellLocations(cellLocations), PointBinIds(pointBinIds)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkQuadricClusteringBinMap &bins = this->Bins.Local();
+    double pts0[3], pts1[3], pts2[3], quadric4x4[4][4], quadric[9];
+    vtkIdType binIds[3];
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      const vtkIdType *cell = this->Connectivity + this->CellLocations[cellId];
+      vtkIdType numPts = cell[0];
+      const vtkIdType *ptIds = cell + 1;
+      binIds[0] = this->PointBinIds[ptIds[0]];
+      this->Points->GetPoint(ptIds[0], pts0);
+      for (vtkIdType j=0; j < numPts-2; j++)
+        {
+        binIds[1] = this->PointBinIds[ptIds[j+1]];
+        binIds[2] = this->PointBinIds[ptIds[j+2]];
+        if (this->Self->UseInternalTriangles == 0 &&
+            (binIds[0] == binIds[1] || binIds[0] == binIds[2] ||
+             binIds[1] == binIds[2]))
+          {
+          continue;
+          }
+        this->Points->GetPoint(ptIds[j+1], pts1);
+        this->Points->GetPoint(ptIds[j+2], pts2);
+        vtkTriangle::ComputeQuadric(pts0, pts1, pts2, quadric4x4);
+        quadric[0] = quadric4x4[0][0];
+        quadric[1] = quadric4x4[0][1];
+        quadric[2] = quadric4x4[0][2];
+        quadric[3] = quadric4x4[0][3];
+        quadric[4] = quadric4x4[1][1];
+        quadric[5] = quadric4x4[1][2];
+        quadric[6] = quadric4x4[1][3];
+        quadric[7] = quadric4x4[2][2];
+        quadric[8] = quadric4x4[2][3];
+        for (int i = 0; i < 3; i++)
+          {
+          double *q = bins[binIds[i]].Quadric;
+          for (int k = 0; k < 9; k++)
+            {
+            q[k] += (quadric[k] * 100000000.0);
+            }
+          }
+        }
+      }
+  }
+
+  // Adds the quadrics of all threads to the bins that are (or are not yet)
+  // made of triangle quadrics. Points and segments supercede triangles.
+  void Merge()
+  {
+    vtkSMPThreadLocal<vtkQuadricClusteringBinMap>::iterator itr;
+    for (itr = this->Bins.begin(); itr != this->Bins.end(); ++itr)
+      {
+      vtkQuadricClusteringBinMap::iterator binItr;
+      for (binItr = itr->begin(); binItr != itr->end(); ++binItr)
+        {
+        vtkQuadricClustering::PointQuadric &bin =
+          this->Self->QuadricArray[binItr->first];
+        if (bin.Dimension > 2)
+          {
+          bin.Dimension = 2;
+          this->Self->InitializeQuadric(bin.Quadric);
+          }
+        if (bin.Dimension == 2)
+          {
+          for (int k = 0; k < 9; k++)
+            {
+            bin.Quadric[k] += binItr->second.Quadric[k];
+            }
+          }
+        }
+      }
+  }
+
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+  const vtkIdType *Connectivity;
+  const vtkIdType *CellLocations;
+  const vtkIdType *PointBinIds;
+  vtkSMPThreadLocal<vtkQuadricClusteringBinMap> Bins;
+};
+
+//----------------------------------------------------------------------------
+// Computes the representative point of the used bins into the (float)
+// output points.
+class vtkQuadricClusteringRepresentativePoints
+{
+public:
+  vtkQuadricClusteringRepresentativePoints(vtkQuadricClustering *self,
+                                           float *points)
+    : Self(self), Points(points)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    double newPt[3];
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      vtkQuadricClustering::PointQuadric &bin = this->Self->QuadricArray[i];
+      if (bin.VertexId != -1)
+        {
+        this->Self->ComputeRepresentativePoint(bin.Quadric, i, newPt);
+        float *x = this->Points + 3*bin.VertexId;
+        x[0] = static_cast<float>(newPt[0]);
+        x[1] = static_cast<float>(newPt[1]);
+        x[2] = static_cast<float>(newPt[2]);
+        }
+      }
+  }
+
+  vtkQuadricClustering *Self;
+  float *Points;
+};
+
 
 //----------------------------------------------------------------------------
 // Construct with default NumberOfDivisions to 50, DivisionSpacing to 1
@@ -74,6 +253,7 @@ vtkQuadricClustering::vtkQuadricClustering()
   this->UseInputPoints = 0;
 
   this->PreventDuplicateCells = 1;
+  this->ParallelClustering = 0;
   this->CellSet = NULL;
   this->NumberOfBins = 0;
 
@@ -373,6 +553,12 @@ void vtkQuadricClustering::AddPolygons(vtkCellArray *polys, vtkPoints *points,
                                        int geometryFlag,
                                        vtkPolyData *input, vtkPolyData *output)
 {
+  if (this->ParallelClustering && geometryFlag)
+    {
+    this->AddPolygonsInParallel(polys, points, input, output);
+    return;
+    }
+
   vtkIdType *ptIds = 0;
   vtkIdType numPts = 0;
   double pts0[3], pts1[3], pts2[3];
@@ -409,6 +595,64 @@ void vtkQuadricClustering::AddPolygons(vtkCellArray *polys, vtkPoints *points,
     }//for all polygons
 }
 
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::AddPolygonsInParallel(vtkCellArray *polys,
+                                                 vtkPoints *points,
+                                                 vtkPolyData *input,
+                                                 vtkPolyData *output)
+{
+  vtkIdType numCells = polys->GetNumberOfCells();
+  vtkIdType numPoints = points->GetNumberOfPoints();
+  if (numCells == 0)
+    {
+    return;
+    }
+
+  // Locate the cells in the connectivity array so that they can be
+  // visited in any order.
+  const vtkIdType *connectivity = polys->GetPointer();
+  std::vector<vtkIdType> cellLocations(numCells);
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    cellLocations[cellId] = loc;
+    loc += connectivity[loc] + 1;
+    }
+
+  std::vector<vtkIdType> pointBinIds(numPoints > 0 ? numPoints : 1);
+  vtkQuadricClusteringHashPoints hashPoints(this, points, &pointBinIds[0]);
+  vtkSMPTools::For(0, numPoints, hashPoints);
+
+  vtkQuadricClusteringPolygonQuadrics polygonQuadrics(
+    this, points, connectivity, &cellLocations[0], &pointBinIds[0]);
+  vtkSMPTools::For(0, numCells, polygonQuadrics);
+  polygonQuadrics.Merge();
+  this->UpdateProgress(.7);
+
+  // The triangles are added to the output in the order of the input cells.
+  vtkIdType binIds[3];
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    const vtkIdType *cell = connectivity + cellLocations[cellId];
+    vtkIdType numPts = cell[0];
+    const vtkIdType *ptIds = cell + 1;
+    binIds[0] = pointBinIds[ptIds[0]];
+    for (vtkIdType j=0; j < numPts-2; j++)
+      {
+      binIds[1] = pointBinIds[ptIds[j+1]];
+      binIds[2] = pointBinIds[ptIds[j+2]];
+      if (this->UseInternalTriangles == 0 &&
+          (binIds[0] == binIds[1] || binIds[0] == binIds[2] ||
+           binIds[1] == binIds[2]))
+        {
+        continue;
+        }
+      this->AddTriangleGeometry(binIds, input, output);
+      }
+    ++this->InCellCount;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::AddStrips(vtkCellArray *strips, vtkPoints *points,
                                      int geometryFlag,
@@ -511,92 +755,100 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
 
   if (geometryFlag)
     {
-    vtkIdType triPtIds[3];
-    // Now add the triangle to the geometry.
-    for (int i = 0; i < 3; i++)
+    this->AddTriangleGeometry(binIds, input, output);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::AddTriangleGeometry(vtkIdType *binIds,
+                                               vtkPolyData *input,
+                                               vtkPolyData *output)
+{
+  vtkIdType triPtIds[3];
+  // Now add the triangle to the geometry.
+  for (int i = 0; i < 3; i++)
+    {
+    // Get the vertex from each bin.
+    if (this->QuadricArray[binIds[i]].VertexId == -1)
       {
-      // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
-        {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
-        this->NumberOfBinsUsed++;
-        }
-      triPtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
+      this->NumberOfBinsUsed++;
       }
-    // This comparison could just as well be on triPtIds.
-    if (binIds[0] != binIds[1] && binIds[0] != binIds[2] &&
-        binIds[1] != binIds[2])
+    triPtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+    }
+  // This comparison could just as well be on triPtIds.
+  if (binIds[0] != binIds[1] && binIds[0] != binIds[2] &&
+      binIds[1] != binIds[2])
+    {
+    if ( this->PreventDuplicateCells )
       {
-      if ( this->PreventDuplicateCells )
+      vtkIdType minIdx = ( binIds[0]<binIds[1] ? (binIds[0]<binIds[2] ? 0 : 2) :
+                           (binIds[1]<binIds[2] ? 1 : 2) );
+      vtkIdType midIdx = 0;
+      vtkIdType maxIdx = 0;
+      switch ( minIdx )
         {
-        vtkIdType minIdx = ( binIds[0]<binIds[1] ? (binIds[0]<binIds[2] ? 0 : 2) :
-                             (binIds[1]<binIds[2] ? 1 : 2) );
-        vtkIdType midIdx = 0;
-        vtkIdType maxIdx = 0;
-        switch ( minIdx )
-          {
-          case 0:
-            if ( binIds[1] > binIds[2] )
-              {
-              maxIdx = 1;
-              midIdx = 2;
-              }
-            else
-              {
-              maxIdx = 2;
-              midIdx = 1;
-              }
-            break;
-          case 1:
-            if ( binIds[0] > binIds[2] )
-              {
-              maxIdx = 0;
-              midIdx = 2;
-              }
-            else
-              {
-              maxIdx = 2;
-              midIdx = 0;
-              }
-            break;
-          case 2:
-            if ( binIds[0] > binIds[1] )
-              {
-              maxIdx = 0;
-              midIdx = 1;
-              }
-            else
-              {
-              maxIdx = 1;
-              midIdx = 0;
-              }
-            break;
-          }
-        // TODO: this arithmetic overflows with the TestQuadricLODActor test.
-        vtkIdType idx = binIds[minIdx] + this->NumberOfBins*binIds[midIdx] +
-                        this->NumberOfBins*this->NumberOfBins*binIds[maxIdx];
-        if ( this->CellSet->find(idx) == this->CellSet->end() )
-          {
-          this->CellSet->insert(idx);
-          this->OutputTriangleArray->InsertNextCell(3, triPtIds);
-          if (this->CopyCellData && input)
+        case 0:
+          if ( binIds[1] > binIds[2] )
+            {
+            maxIdx = 1;
+            midIdx = 2;
+            }
+          else
+            {
+            maxIdx = 2;
+            midIdx = 1;
+            }
+          break;
+        case 1:
+          if ( binIds[0] > binIds[2] )
+            {
+            maxIdx = 0;
+            midIdx = 2;
+            }
+          else
             {
-            output->GetCellData()->
-              CopyData(input->GetCellData(), this->InCellCount,this->OutCellCount++);
-            }//if cell data
-          }//if not a duplicate
+            maxIdx = 2;
+            midIdx = 0;
+            }
+          break;
+        case 2:
+          if ( binIds[0] > binIds[1] )
+            {
+            maxIdx = 0;
+            midIdx = 1;
+            }
+          else
+            {
+            maxIdx = 1;
+            midIdx = 0;
+            }
+          break;
         }
-      else //don't check for duplicates
+      // TODO: this arithmetic overflows with the TestQuadricLODActor test.
+      vtkIdType idx = binIds[minIdx] + this->NumberOfBins*binIds[midIdx] +
+                      this->NumberOfBins*this->NumberOfBins*binIds[maxIdx];
+      if ( this->CellSet->find(idx) == this->CellSet->end() )
         {
+        this->CellSet->insert(idx);
         this->OutputTriangleArray->InsertNextCell(3, triPtIds);
         if (this->CopyCellData && input)
           {
           output->GetCellData()->
             CopyData(input->GetCellData(), this->InCellCount,this->OutCellCount++);
           }//if cell data
-        }//don't check for duplicates
-      }//if not duplicate vertices
-    }//if this should be inserted
+        }//if not a duplicate
+      }
+    else //don't check for duplicates
+      {
+      this->OutputTriangleArray->InsertNextCell(3, triPtIds);
+      if (this->CopyCellData && input)
+        {
+        output->GetCellData()->
+          CopyData(input->GetCellData(), this->InCellCount,this->OutCellCount++);
+        }//if cell data
+      }//don't check for duplicates
+    }//if not duplicate vertices
 }
 
 //----------------------------------------------------------------------------
@@ -920,17 +1172,14 @@ void vtkQuadricClustering::EndAppend()
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
   vtkIdType numBuckets;
-  int abortExecute=0;
   vtkPoints *outputPoints;
-  double newPt[3];
   numBuckets = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] *
                 this->NumberOfDivisions[2];
-  double step = (double)numBuckets / 10.0;
-  if (step < 1000.0)
+  vtkIdType step = numBuckets / 10;
+  if (step < 1000)
     {
-    step = 1000.0;
+    step = 1000;
     }
-  double cstep = 0;
 
   // Check for mis use of the Append methods.
   if (this->OutputTriangleArray == NULL || this->OutputLines == NULL)
@@ -946,24 +1195,23 @@ void vtkQuadricClustering::EndAppend()
     this->CellSet = NULL;
     }
 
-  // Compute the representative points for each bin
+  // Compute the representative points for each bin, by blocks of bins
+  // between which progress is reported and the execution may be aborted.
   outputPoints = vtkPoints::New();
-  for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++ )
-    {
-    if (cstep > step)
-      {
-      cstep = 0;
-      vtkDebugMacro(<<"Finding point in bin #" << i);
-      this->UpdateProgress (0.8+0.2*i/numBuckets);
-      abortExecute = this->GetAbortExecute();
-      }
-    ++cstep;
-
-    if (this->QuadricArray[i].VertexId != -1)
+  outputPoints->SetDataTypeToFloat();
+  outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+  vtkQuadricClusteringRepresentativePoints representativePoints(
+    this, static_cast<float*>(outputPoints->GetVoidPointer(0)));
+  for (vtkIdType i = 0; i < numBuckets; i += step)
+    {
+    vtkDebugMacro(<<"Finding point in bin #" << i);
+    this->UpdateProgress (0.8+0.2*i/numBuckets);
+    if (this->GetAbortExecute())
       {
-      this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
-      outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
+      break;
       }
+    vtkSMPTools::For(i, i + step < numBuckets ? i + step : numBuckets,
+                     representativePoints);
     }
 
   // Set up the output data object.
@@ -1580,5 +1828,7 @@ void vtkQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Prevent Duplicate Cells : "
      << (this->PreventDuplicateCells ? "On\n" : "Off\n");
+  os << indent << "Parallel Clustering : "
+     << (this->ParallelClustering ? "On\n" : "Off\n");
 }
 
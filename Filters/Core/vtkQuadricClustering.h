@@ -214,6 +214,18 @@ public:
   vtkGetMacro(PreventDuplicateCells,int);
   vtkBooleanMacro(PreventDuplicateCells,int);
 
+  // Description:
+  // When this flag is on, the quadrics of the input polygons are computed
+  // concurrently with vtkSMPTools: each thread accumulates the quadrics of
+  // its triangles into its own sparse set of bins, and these are merged
+  // into the bin grid once all polygons have been visited. The output
+  // cells are the same as in serial mode, but the bin points may differ by
+  // round-off because the quadrics are summed in a different order. This
+  // is off by default.
+  vtkSetMacro(ParallelClustering,int);
+  vtkGetMacro(ParallelClustering,int);
+  vtkBooleanMacro(ParallelClustering,int);
+
 protected:
   vtkQuadricClustering();
   ~vtkQuadricClustering();
@@ -240,6 +252,18 @@ protected:
   void AddTriangle(vtkIdType *binIds, double *pt0, double *pt1, double *pt2,
                    int geometeryFlag, vtkPolyData *input, vtkPolyData *output);
 
+  // Description:
+  // Add polygons with the quadrics computed in parallel (see
+  // ParallelClustering), then add the triangles to the output.
+  void AddPolygonsInParallel(vtkCellArray *polys, vtkPoints *points,
+                             vtkPolyData *input, vtkPolyData *output);
+
+  // Description:
+  // Add a triangle whose quadric has already been accumulated to the
+  // output.
+  void AddTriangleGeometry(vtkIdType *binIds, vtkPolyData *input,
+                           vtkPolyData *output);
+
   // Description:
   // Add edges to the quadric array.  If geometry flag is on then
   // edges are added to the output.
@@ -295,6 +319,7 @@ protected:
 
   // Set this to eliminate duplicate cells
   int PreventDuplicateCells;
+  int ParallelClustering;
   vtkQuadricClusteringCellSet *CellSet; //PIMPLd stl set for tracking inserted cells
   vtkIdType NumberOfBins;
 
@@ -332,6 +357,10 @@ protected:
     unsigned char Dimension;
     double Quadric[9];
   };
+
+  friend class vtkQuadricClusteringHashPoints;
+  friend class vtkQuadricClusteringPolygonQuadrics;
+  friend class vtkQuadricClusteringRepresentativePoints;
   //ETX
 
   PointQuadric* QuadricArray;
@@ -53,10 +53,281 @@
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+//----------------------------------------------------------------------------
+// Sum the area weighted error quadrics of the triangles using each point.
+// The quadric of a triangle is computed again for each of its points rather
+// than stored for the whole mesh, and the triangles are visited in increasing
+// id order, so that the sums are the same as when each triangle adds its
+// quadric to its points.
+class vtkQuadricDecimationPointQuadrics
+{
+public:
+  vtkQuadricDecimation *Self;
+  int QuadricSize;
+  vtkSMPThreadLocal<std::vector<double> > QEM;
+  vtkSMPThreadLocal<vtkIdType> NumberOfFailures;
+
+  vtkQuadricDecimationPointQuadrics(vtkQuadricDecimation *self) :
+    Self(self), QuadricSize(11 + 4 * self->NumberOfComponents)
+  {
+  }
+
+  void Initialize()
+  {
+    this->QEM.Local().resize(this->QuadricSize);
+    this->NumberOfFailures.Local() = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double *QEM = &this->QEM.Local()[0];
+    vtkIdType &numberOfFailures = this->NumberOfFailures.Local();
+    unsigned short ncells;
+    vtkIdType *cells;
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      double *quadric = this->Self->ErrorQuadrics[ptId].Quadric;
+      this->Self->Mesh->GetPointCells(ptId, ncells, cells);
+      for (unsigned short c = 0; c < ncells; c++)
+        {
+        if (!this->TriangleQuadric(cells[c], QEM))
+          {
+          numberOfFailures++;
+          }
+        for (int i = 0; i < this->QuadricSize; i++)
+          {
+          quadric[i] += QEM[i];
+          }
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  // Compute the quadric of a triangle. Return false if the attribute
+  // matrix could not be factored.
+  bool TriangleQuadric(vtkIdType cellId, double *QEM) const
+  {
+    vtkPolyData *input = this->Self->Mesh;
+    vtkPointData *pd = input->GetPointData();
+    const int *attributeComponents = this->Self->AttributeComponents;
+    const double *attributeScale = this->Self->AttributeScale;
+    vtkIdType npts, *pts;
+    double point0[3], point1[3], point2[3];
+    double n[3];
+    double tempP1[3], tempP2[3],  d, triArea2;
+    double data[16];
+    double *A[4], x[4];
+    int index[4];
+    int i;
+    bool factored = true;
+    A[0] = data;
+    A[1] = data+4;
+    A[2] = data+8;
+    A[3] = data+12;
+
+    input->GetCellPoints(cellId, npts, pts);
+    input->GetPoint(pts[0], point0);
+    input->GetPoint(pts[1], point1);
+    input->GetPoint(pts[2], point2);
+    for (i = 0; i < 3; i++)
+      {
+      tempP1[i] = point1[i] - point0[i];
+      tempP2[i] = point2[i] - point0[i];
+      }
+    vtkMath::Cross(tempP1, tempP2, n);
+    triArea2 = vtkMath::Normalize(n);
+    triArea2 = triArea2 * 0.5;
+    d = -vtkMath::Dot(n, point0);
+
+    // set the geometric part of the QEM
+    QEM[0] = n[0] * n[0];
+    QEM[1] = n[0] * n[1];
+    QEM[2] = n[0] * n[2];
+    QEM[3] = d * n[0];
+
+    QEM[4] = n[1] * n[1];
+    QEM[5] = n[1] * n[2];
+    QEM[6] = d * n[1];
+
+    QEM[7] = n[2] * n[2];
+    QEM[8] = d * n[2];
+
+    QEM[9] = d * d;
+    QEM[10] = 1;
+
+    for (i = 11; i < this->QuadricSize; i++)
+      {
+      QEM[i] = 0.0;
+      }
+
+    if (this->Self->AttributeErrorMetric)
+      {
+      for (i = 0; i < 3; i++)
+        {
+        A[0][i] = point0[i];
+        A[1][i] = point1[i];
+        A[2][i] = point2[i];
+        A[3][i] = n[i];
+        }
+      A[0][3] =  A[1][3] = A[2][3] = 1;
+      A[3][3] = 0;
+
+      // should handle poorly condition matrix better
+      if (vtkMath::LUFactorLinearSystem(A, index, 4))
+        {
+        for (i = 0; i < this->Self->NumberOfComponents; i++)
+          {
+          vtkDataArray *array;
+          int component;
+          double scale;
+          if (i < attributeComponents[0])
+            {
+            array = pd->GetScalars();
+            component = i;
+            scale = attributeScale[0];
+            }
+          else if (i < attributeComponents[1])
+            {
+            array = pd->GetVectors();
+            component = i - attributeComponents[0];
+            scale = attributeScale[1];
+            }
+          else if (i < attributeComponents[2])
+            {
+            array = pd->GetNormals();
+            component = i - attributeComponents[1];
+            scale = attributeScale[2];
+            }
+          else if (i < attributeComponents[3])
+            {
+            array = pd->GetTCoords();
+            component = i - attributeComponents[2];
+            scale = attributeScale[3];
+            }
+          else
+            {
+            array = pd->GetTensors();
+            component = i - attributeComponents[3];
+            scale = attributeScale[4];
+            }
+          x[0] = array->GetComponent(pts[0], component) * scale;
+          x[1] = array->GetComponent(pts[1], component) * scale;
+          x[2] = array->GetComponent(pts[2], component) * scale;
+          x[3] = 0;
+          vtkMath::LUSolveLinearSystem(A, index, x, 4);
+
+          // add in the contribution of this element into the QEM
+          QEM[0] += x[0] * x[0];
+          QEM[1] += x[0] * x[1];
+          QEM[2] += x[0] * x[2];
+          QEM[3] += x[3] * x[0];
+
+          QEM[4] += x[1] * x[1];
+          QEM[5] += x[1] * x[2];
+          QEM[6] += x[3] * x[1];
+
+          QEM[7] += x[2] * x[2];
+          QEM[8] += x[3] * x[2];
+
+          QEM[9] += x[3] * x[3];
+
+          QEM[11+i*4] = -x[0];
+          QEM[12+i*4] = -x[1];
+          QEM[13+i*4] = -x[2];
+          QEM[14+i*4] = -x[3];
+          }
+        }
+      else
+        {
+        factored = false;
+        }
+      }
+
+    for (i = 0; i < this->QuadricSize; i++)
+      {
+      QEM[i] *= triArea2;
+      }
+    return factored;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Compute the cost and target point of a set of edges.
+class vtkQuadricDecimationEdgeCosts
+{
+public:
+  struct Scratch
+  {
+    std::vector<double> Quad;
+    std::vector<double> B;
+    std::vector<double> Data;
+    std::vector<double*> A;
+  };
+
+  vtkQuadricDecimation *Self;
+  const vtkIdType *EdgeIds;
+  double *Costs;
+  double *Targets;
+  int Size;
+  vtkSMPThreadLocal<Scratch> TLScratch;
+
+  vtkQuadricDecimationEdgeCosts(vtkQuadricDecimation *self,
+                                const vtkIdType *edgeIds, double *costs,
+                                double *targets) :
+    Self(self), EdgeIds(edgeIds), Costs(costs), Targets(targets),
+    Size(3 + self->NumberOfComponents)
+  {
+  }
+
+  void Initialize()
+  {
+    Scratch &scratch = this->TLScratch.Local();
+    scratch.Quad.resize(11 + 4 * this->Self->NumberOfComponents);
+    scratch.B.resize(this->Size);
+    scratch.Data.resize(this->Size * this->Size);
+    scratch.A.resize(this->Size);
+    for (int i = 0; i < this->Size; i++)
+      {
+      scratch.A[i] = &scratch.Data[i * this->Size];
+      }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    Scratch &scratch = this->TLScratch.Local();
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      vtkIdType edgeId = this->EdgeIds ? this->EdgeIds[i] : i;
+      double *x = this->Targets + i * this->Size;
+      if (this->Self->AttributeErrorMetric)
+        {
+        this->Costs[i] = this->Self->ComputeCost2(
+          edgeId, x, &scratch.Quad[0], &scratch.A[0], &scratch.B[0]);
+        }
+      else
+        {
+        this->Costs[i] = this->Self->ComputeCost(edgeId, x, &scratch.Quad[0]);
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
@@ -86,6 +357,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
   this->TensorsWeight = 0.1;
 
   this->ActualReduction = 0.0;
+  this->BatchSize = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -289,24 +561,16 @@ int vtkQuadricDecimation::RequestData(
 
   vtkDebugMacro(<<"Computing Costs");
   // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
-    {
-    if (this->AttributeErrorMetric)
-      {
-      cost = this->ComputeCost2(i, x);
-      }
-    else
-      {
-      cost = this->ComputeCost(i, x);
-      }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
-    }
+  this->ComputeEdgeCosts(NULL, this->Edges->GetNumberOfEdges());
   this->UpdateProgress(0.20);
 
   // Okay collapse edges until desired reduction is reached
   this->ActualReduction = 0.0;
   this->NumberOfEdgeCollapses = 0;
+  if (this->BatchSize > 1)
+    {
+    numDeletedTris = this->CollapseEdgeBatches(numTris);
+    }
   edgeId = this->EdgeCosts->Pop(0,cost);
 
   int abort = 0;
@@ -346,7 +610,7 @@ int vtkQuadricDecimation::RequestData(
     // Merge the quadrics of the two points.
     this->AddQuadric(endPtIds[1], endPtIds[0]);
 
-    this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+    this->UpdateEdgeData(endPtIds[0], endPtIds[1], NULL);
 
     // Update the output triangles.
     numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
@@ -408,161 +672,34 @@ int vtkQuadricDecimation::RequestData(
 //----------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
 {
-  vtkPolyData *input = this->Mesh;
-  double *QEM;
   vtkIdType ptId;
-  int i, j;
-  vtkCellArray *polys;
-  vtkIdType npts, *pts=NULL;
-  double point0[3], point1[3], point2[3];
-  double n[3];
-  double tempP1[3], tempP2[3],  d, triArea2;
-  double data[16];
-  double *A[4], x[4];
-  int index[4];
-  A[0] = data;
-  A[1] = data+4;
-  A[2] = data+8;
-  A[3] = data+12;
-
-  // allocate local QEM sparce matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
+  int i;
+  int quadricSize = 11 + 4 * this->NumberOfComponents;
 
   // clear and allocate global QEM array
   for (ptId = 0; ptId < numPts; ptId++)
     {
-    this->ErrorQuadrics[ptId].Quadric =
-      new double[11 + 4 * this->NumberOfComponents];
-    for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
+    this->ErrorQuadrics[ptId].Quadric = new double[quadricSize];
+    for (i = 0; i < quadricSize; i++)
       {
       this->ErrorQuadrics[ptId].Quadric[i] = 0.0;
       }
     }
 
-  polys = input->GetPolys();
-  // compute the QEM for each face
-  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
-    {
-    input->GetPoint(pts[0], point0);
-    input->GetPoint(pts[1], point1);
-    input->GetPoint(pts[2], point2);
-    for (i = 0; i < 3; i++)
-      {
-      tempP1[i] = point1[i] - point0[i];
-      tempP2[i] = point2[i] - point0[i];
-      }
-    vtkMath::Cross(tempP1, tempP2, n);
-    triArea2 = vtkMath::Normalize(n);
-    //triArea2 = (triArea2 * triArea2 * 0.25);
-    triArea2 = triArea2 * 0.5;
-    // I am unsure whether this should be squared or not??
-    d = -vtkMath::Dot(n, point0);
-    // could possible add in angle weights??
-
-    // set the geometric part of the QEM
-    QEM[0] = n[0] * n[0];
-    QEM[1] = n[0] * n[1];
-    QEM[2] = n[0] * n[2];
-    QEM[3] = d * n[0];
+  // add the QEM of each face to all its points
+  vtkQuadricDecimationPointQuadrics pointQuadrics(this);
+  vtkSMPTools::For(0, numPts, pointQuadrics);
 
-    QEM[4] = n[1] * n[1];
-    QEM[5] = n[1] * n[2];
-    QEM[6] = d * n[1];
-
-    QEM[7] = n[2] * n[2];
-    QEM[8] = d * n[2];
-
-    QEM[9] = d * d;
-    QEM[10] = 1;
-
-    if (this->AttributeErrorMetric)
-      {
-      for (i = 0; i < 3; i++)
-        {
-        A[0][i] = point0[i];
-        A[1][i] = point1[i];
-        A[2][i] = point2[i];
-        A[3][i] = n[i];
-        }
-      A[0][3] =  A[1][3] = A[2][3] = 1;
-      A[3][3] = 0;
-
-      // should handle poorly condition matrix better
-      if (vtkMath::LUFactorLinearSystem(A, index, 4))
-        {
-        for (i = 0; i < this->NumberOfComponents; i++)
-          {
-          x[3] = 0;
-          if (i < this->AttributeComponents[0])
-            {
-            x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *  this->AttributeScale[0];
-            x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *  this->AttributeScale[0];
-            x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *  this->AttributeScale[0];
-            }
-          else if (i < this->AttributeComponents[1])
-            {
-            x[0] = input->GetPointData()->GetVectors()->GetComponent(pts[0], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            x[1] = input->GetPointData()->GetVectors()->GetComponent(pts[1], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            x[2] = input->GetPointData()->GetVectors()->GetComponent(pts[2], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            }
-          else if (i < this->AttributeComponents[2])
-            {
-            x[0] = input->GetPointData()->GetNormals()->GetComponent(pts[0], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            x[1] = input->GetPointData()->GetNormals()->GetComponent(pts[1], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            x[2] = input->GetPointData()->GetNormals()->GetComponent(pts[2], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            }
-          else if (i < this->AttributeComponents[3])
-            {
-            x[0] = input->GetPointData()->GetTCoords()->GetComponent(pts[0], i - this->AttributeComponents[2]) *  this->AttributeScale[3];
-            x[1] = input->GetPointData()->GetTCoords()->GetComponent(pts[1], i - this->AttributeComponents[2])*  this->AttributeScale[3];
-            x[2] = input->GetPointData()->GetTCoords()->GetComponent(pts[2], i - this->AttributeComponents[2])*  this->AttributeScale[3];
-            }
-          else if (i < this->AttributeComponents[4])
-            {
-            x[0] = input->GetPointData()->GetTensors()->GetComponent(pts[0], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            x[1] = input->GetPointData()->GetTensors()->GetComponent(pts[1], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            x[2] = input->GetPointData()->GetTensors()->GetComponent(pts[2], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            }
-          vtkMath::LUSolveLinearSystem(A, index, x, 4);
-
-          // add in the contribution of this element into the QEM
-          QEM[0] += x[0] * x[0];
-          QEM[1] += x[0] * x[1];
-          QEM[2] += x[0] * x[2];
-          QEM[3] += x[3] * x[0];
-
-          QEM[4] += x[1] * x[1];
-          QEM[5] += x[1] * x[2];
-          QEM[6] += x[3] * x[1];
-
-          QEM[7] += x[2] * x[2];
-          QEM[8] += x[3] * x[2];
-
-          QEM[9] += x[3] * x[3];
-
-          QEM[11+i*4] = -x[0];
-          QEM[12+i*4] = -x[1];
-          QEM[13+i*4] = -x[2];
-          QEM[14+i*4] = -x[3];
-          }
-        }
-      else
-        {
-        vtkErrorMacro(<<"Unable to factor attribute matrix!");
-        }
-      }
-
-      // add the QEM to all point of the face
-    for (i = 0; i < 3; i++)
+  vtkSMPThreadLocal<vtkIdType>::iterator itr;
+  for (itr = pointQuadrics.NumberOfFailures.begin();
+       itr != pointQuadrics.NumberOfFailures.end(); ++itr)
+    {
+    if (*itr > 0)
       {
-      for (j = 0; j < 11 + 4 * this->NumberOfComponents; j++)
-        {
-        this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * triArea2;
-        }
+      vtkErrorMacro(<<"Unable to factor attribute matrix!");
+      break;
       }
-    }//for all triangles
-
-  delete [] QEM;
+    }
 }
 
 
@@ -703,11 +840,11 @@ void vtkQuadricDecimation::FindAffectedEdges(vtkIdType p1Id, vtkIdType p2Id,
 }
 
 // FIXME: memory allocation clean up
-void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
+void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id,
+                                          vtkIdList *deferredEdges)
 {
   vtkIdList *changedEdges = vtkIdList::New();
   vtkIdType i, edgeId, edge[2];
-  double cost;
 
   // Find all edges with exactly either of these 2 endpoints.
   this->FindAffectedEdges(pt0Id, pt1Id, changedEdges);
@@ -735,16 +872,7 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->EndPoint1List->InsertId(edgeId, edge[1]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
         // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric)
-          {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-          }
-        else
-          {
-          cost = this->ComputeCost(edgeId, this->TempX);
-          }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
+        this->UpdateEdgeCost(edgeId, deferredEdges);
         }
       }
     else if (edge[1] == pt1Id)
@@ -756,39 +884,226 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->EndPoint1List->InsertId(edgeId, edge[0]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
         // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric)
+        this->UpdateEdgeCost(edgeId, deferredEdges);
+        }
+      }
+    else
+      { // This edge already has one point as the merged point.
+      this->UpdateEdgeCost(changedEdges->GetId(i), deferredEdges);
+      }
+    }
+
+  changedEdges->Delete();
+  return;
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::UpdateEdgeCost(vtkIdType edgeId,
+                                          vtkIdList *deferredEdges)
+{
+  if (deferredEdges)
+    {
+    deferredEdges->InsertNextId(edgeId);
+    return;
+    }
+
+  double cost;
+  if (this->AttributeErrorMetric)
+    {
+    cost = this->ComputeCost2(edgeId, this->TempX);
+    }
+  else
+    {
+    cost = this->ComputeCost(edgeId, this->TempX);
+    }
+  this->EdgeCosts->Insert(cost, edgeId);
+  this->TargetPoints->InsertTuple(edgeId, this->TempX);
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::ComputeEdgeCosts(const vtkIdType *edgeIds,
+                                            vtkIdType numEdges)
+{
+  int numComponents = 3 + this->NumberOfComponents;
+  std::vector<double> costs(numEdges > 0 ? numEdges : 1);
+  std::vector<double> targets(numEdges > 0 ? numEdges * numComponents : 1);
+
+  vtkQuadricDecimationEdgeCosts edgeCosts(this, edgeIds, &costs[0],
+                                          &targets[0]);
+  vtkSMPTools::For(0, numEdges, edgeCosts);
+
+  // The queue is filled serially, in the order of the edges.
+  for (vtkIdType i = 0; i < numEdges; i++)
+    {
+    vtkIdType edgeId = edgeIds ? edgeIds[i] : i;
+    this->EdgeCosts->Insert(costs[i], edgeId);
+    this->TargetPoints->InsertTuple(edgeId, &targets[i * numComponents]);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkQuadricDecimation::CollapseEdgeBatches(vtkIdType numTris)
+{
+  vtkIdType numPts = this->Mesh->GetNumberOfPoints();
+  vtkIdType numDeletedTris = 0;
+  vtkIdType edgeId, endPtIds[2], npts, *pts, *cells;
+  unsigned short ncells;
+  double cost;
+  int i, j, k;
+  int abort = 0;
+
+  // A point is part of the current batch when its mark is the batch number.
+  std::vector<int> marks(numPts, 0);
+  int batch = 0;
+  std::vector<vtkIdType> selected;
+  std::vector<std::pair<vtkIdType, double> > skipped;
+  std::vector<vtkIdType> neighborhood;
+  vtkIdList *deferredEdges = vtkIdList::New();
+  double *x = new double [3+this->NumberOfComponents];
+
+  int exhausted = 0;
+  while ( !abort && !exhausted &&
+          this->ActualReduction < this->TargetReduction )
+    {
+    ++batch;
+    selected.clear();
+    skipped.clear();
+
+    // Do not collapse (much) more than needed: a collapse usually deletes
+    // two triangles.
+    double remaining = (this->TargetReduction - this->ActualReduction) *
+      numTris / 2.0;
+    vtkIdType maxBatchSize = static_cast<vtkIdType>(ceil(remaining));
+    if (maxBatchSize > this->BatchSize)
+      {
+      maxBatchSize = this->BatchSize;
+      }
+    if (maxBatchSize < 1)
+      {
+      maxBatchSize = 1;
+      }
+
+    while ( static_cast<vtkIdType>(selected.size()) < maxBatchSize )
+      {
+      edgeId = this->EdgeCosts->Pop(0, cost);
+      if (edgeId < 0 || cost >= VTK_DOUBLE_MAX)
+        {
+        if (edgeId >= 0)
           {
-          cost = this->ComputeCost2(edgeId, this->TempX);
+          this->EdgeCosts->Insert(cost, edgeId);
           }
-        else
+        exhausted = 1;
+        break;
+        }
+
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+
+      // Gather the points whose position or quadric the collapse uses.
+      neighborhood.clear();
+      int overlaps = 0;
+      for (i = 0; i < 2 && !overlaps; i++)
+        {
+        this->Mesh->GetPointCells(endPtIds[i], ncells, cells);
+        for (j = 0; j < ncells && !overlaps; j++)
           {
-          cost = this->ComputeCost(edgeId, this->TempX);
+          this->Mesh->GetCellPoints(cells[j], npts, pts);
+          for (k = 0; k < npts; k++)
+            {
+            if (marks[pts[k]] == batch)
+              {
+              overlaps = 1;
+              break;
+              }
+            neighborhood.push_back(pts[k]);
+            }
           }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
         }
-      }
-    else
-      { // This edge already has one point as the merged point.
-      if (this->AttributeErrorMetric)
+      if (overlaps)
         {
-        cost = this->ComputeCost2(changedEdges->GetId(i), this->TempX);
+        skipped.push_back(std::make_pair(edgeId, cost));
+        continue;
         }
-      else
+
+      // check for a poorly placed point
+      this->TargetPoints->GetTuple(edgeId, x);
+      if ( !this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
         {
-        cost = this->ComputeCost(changedEdges->GetId(i), this->TempX);
+        vtkDebugMacro(<<"Poor placement detected " << edgeId << " " <<  cost);
+        // return the point to the queue but with the max cost so that
+        // when it is recomputed it will be reconsidered
+        this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
+        continue;
         }
-      this->EdgeCosts->Insert(cost, changedEdges->GetId(i));
-      this->TargetPoints->InsertTuple(changedEdges->GetId(i), this->TempX);
+
+      for (size_t n = 0; n < neighborhood.size(); n++)
+        {
+        marks[neighborhood[n]] = batch;
+        }
+      marks[endPtIds[0]] = marks[endPtIds[1]] = batch;
+      selected.push_back(edgeId);
+      }
+
+    // Edges that were not collapsed in this batch go back in the queue.
+    for (size_t n = 0; n < skipped.size(); n++)
+      {
+      this->EdgeCosts->Insert(skipped[n].second, skipped[n].first);
+      }
+
+    if (selected.empty())
+      {
+      break;
       }
+
+    deferredEdges->Reset();
+    for (size_t n = 0; n < selected.size(); n++)
+      {
+      edgeId = selected[n];
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      this->TargetPoints->GetTuple(edgeId, x);
+
+      this->NumberOfEdgeCollapses++;
+
+      // Set the new coordinates of point0.
+      this->SetPointAttributeArray(endPtIds[0], x);
+
+      // Merge the quadrics of the two points.
+      this->AddQuadric(endPtIds[1], endPtIds[0]);
+
+      this->UpdateEdgeData(endPtIds[0], endPtIds[1], deferredEdges);
+
+      // Update the output triangles.
+      numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
+      }
+    this->ActualReduction = (double) numDeletedTris / numTris;
+
+    // The collapses of the batch do not share points, so the costs of the
+    // affected edges can now be computed independently.
+    this->ComputeEdgeCosts(deferredEdges->GetPointer(0),
+                           deferredEdges->GetNumberOfIds());
+
+    vtkDebugMacro(<<"Collapsed " << selected.size() << " edges in batch "
+                  << batch);
+    this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
+    abort = this->GetAbortExecute();
     }
 
-  changedEdges->Delete();
-  return;
+  deferredEdges->Delete();
+  delete [] x;
+
+  return numDeletedTris;
 }
 
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
+{
+  return this->ComputeCost(edgeId, x, this->TempQuad);
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x,
+                                         double *tempQuad)
 {
   static const double errorNumber = 1e-10;
   double temp[3], A[3][3], b[3];
@@ -805,20 +1120,20 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
     {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    tempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
     }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
+  A[0][0] = tempQuad[0];
+  A[0][1] = A[1][0] = tempQuad[1];
+  A[0][2] = A[2][0] = tempQuad[2];
+  A[1][1] = tempQuad[4];
+  A[1][2] = A[2][1] = tempQuad[5];
+  A[2][2] = tempQuad[7];
 
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
+  b[0] = -tempQuad[3];
+  b[1] = -tempQuad[6];
+  b[2] = -tempQuad[8];
 
   norm = vtkMath::Norm(A[0]);
   normTemp = vtkMath::Norm(A[1]);
@@ -872,7 +1187,7 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
   // Compute the cost
   // x'*quad*x
-  index = this->TempQuad;
+  index = tempQuad;
   for (i = 0; i < 4; i++)
     {
     cost += (*index++)*newPoint[i]*newPoint[i];
@@ -888,6 +1203,15 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
+{
+  return this->ComputeCost2(edgeId, x, this->TempQuad, this->TempA,
+                            this->TempB);
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x,
+                                          double *tempQuad, double **tempA,
+                                          double *tempB)
 {
   // this function is so ugly because the functionality of converting an QEM
   // into a dence matrix was not extracted into a separate function and
@@ -903,29 +1227,29 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
     {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    tempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
     }
 
   // copy the temp quad into TempA
   // converting from the sparce matrix format into a dence
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  tempA[0][0] = tempQuad[0];
+  tempA[0][1] = tempA[1][0] = tempQuad[1];
+  tempA[0][2] = tempA[2][0] = tempQuad[2];
+  tempA[1][1] = tempQuad[4];
+  tempA[1][2] = tempA[2][1] = tempQuad[5];
+  tempA[2][2] = tempQuad[7];
 
-  this->TempB[0] = -this->TempQuad[3];
-  this->TempB[1] = -this->TempQuad[6];
-  this->TempB[2] = -this->TempQuad[8];
+  tempB[0] = -tempQuad[3];
+  tempB[1] = -tempQuad[6];
+  tempB[2] = -tempQuad[8];
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
     {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
-    this->TempB[i] = -this->TempQuad[11+4*(i-3)+3];
+    tempA[0][i] = tempA[i][0] = tempQuad[11+4*(i-3)];
+    tempA[1][i] = tempA[i][1] = tempQuad[11+4*(i-3)+1];
+    tempA[2][i] = tempA[i][2] = tempQuad[11+4*(i-3)+2];
+    tempB[i] = -tempQuad[11+4*(i-3)+3];
     }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
@@ -934,38 +1258,38 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       {
       if (i == j)
         {
-        this->TempA[i][j] = this->TempQuad[10];
+        tempA[i][j] = tempQuad[10];
         }
       else
         {
-        this->TempA[i][j] = 0;
+        tempA[i][j] = 0;
         }
       }
     }
 
   for (i = 0; i < 3 + this->NumberOfComponents; i++)
     {
-    x[i] = this->TempB[i];
+    x[i] = tempB[i];
     }
 
   // solve A*x = b
   // this clobers A
   // need to develop a quality of the solution test??
-  solveOk = vtkMath::SolveLinearSystem(this->TempA, x, 3 +  this->NumberOfComponents);
+  solveOk = vtkMath::SolveLinearSystem(tempA, x, 3 +  this->NumberOfComponents);
 
   // need to copy back into A
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  tempA[0][0] = tempQuad[0];
+  tempA[0][1] = tempA[1][0] = tempQuad[1];
+  tempA[0][2] = tempA[2][0] = tempQuad[2];
+  tempA[1][1] = tempQuad[4];
+  tempA[1][2] = tempA[2][1] = tempQuad[5];
+  tempA[2][2] = tempQuad[7];
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
     {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
+    tempA[0][i] = tempA[i][0] = tempQuad[11+4*(i-3)];
+    tempA[1][i] = tempA[i][1] = tempQuad[11+4*(i-3)+1];
+    tempA[2][i] = tempA[i][2] = tempQuad[11+4*(i-3)+2];
     }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++)
@@ -974,11 +1298,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       {
       if (i == j)
         {
-        this->TempA[i][j] = this->TempQuad[10];
+        tempA[i][j] = tempQuad[10];
         }
       else
         {
-        this->TempA[i][j] = 0;
+        tempA[i][j] = 0;
         }
       }
     }
@@ -1011,7 +1335,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       temp2[i] = 0;
       for (j = 0; j < 3 + this->NumberOfComponents; ++j)
         {
-        temp2[i] += this->TempA[i][j]*v[j];
+        temp2[i] += tempA[i][j]*v[j];
         }
       }
 
@@ -1029,13 +1353,13 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
         temp[i] = 0;
         for (j = 0; j < 3 + this->NumberOfComponents; ++j)
           {
-          temp[i] += this->TempA[i][j]*pt1[j];
+          temp[i] += tempA[i][j]*pt1[j];
           }
         }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
         {
-        temp[i] = this->TempB[i] - temp[i];
+        temp[i] = tempB[i] - temp[i];
         }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
@@ -1069,18 +1393,18 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
   // x'*A*x - 2*b*x + d
   for (i = 0; i < 3+this->NumberOfComponents; i++)
     {
-    cost += this->TempA[i][i]*x[i]*x[i];
+    cost += tempA[i][i]*x[i]*x[i];
     for (j = i+1; j < 3+this->NumberOfComponents; j++)
       {
-      cost += 2.0*this->TempA[i][j]*x[i]*x[j];
+      cost += 2.0*tempA[i][j]*x[i]*x[j];
       }
     }
   for (i = 0; i < 3+this->NumberOfComponents; i++)
     {
-    cost -=  2.0 * this->TempB[i]*x[i];
+    cost -=  2.0 * tempB[i]*x[i];
     }
 
-  cost += this->TempQuad[9];
+  cost += tempQuad[9];
 
   return cost;
 }
@@ -1353,6 +1677,7 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Target Reduction: " << this->TargetReduction << "\n";
+  os << indent << "Batch Size: " << this->BatchSize << "\n";
   os << indent << "Actual Reduction: " << this->ActualReduction << "\n";
 
   os << indent << "Attribute Error Metric: "
@@ -120,6 +120,18 @@ public:
   vtkGetMacro(TCoordsWeight, double);
   vtkGetMacro(TensorsWeight, double);
 
+  // Description:
+  // Set/Get the maximum number of edges collapsed per batch. By default
+  // (BatchSize of 1) the cheapest edge is collapsed and the costs of its
+  // neighboring edges are updated before the next edge is chosen. With a
+  // larger BatchSize, up to BatchSize of the cheapest edges whose
+  // neighborhoods do not overlap are collapsed together, and the costs of
+  // all the edges they affect are then recomputed in parallel with
+  // vtkSMPTools. This is much faster on large meshes, at the price of a
+  // slightly different (less greedy) order of collapses.
+  vtkSetClampMacro(BatchSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(BatchSize, int);
+
   // Description:
   // Get the actual reduction. This value is only valid after the
   // filter has executed.
@@ -159,6 +171,14 @@ protected:
   double ComputeCost(vtkIdType edgeId, double *x);
   double ComputeCost2(vtkIdType edgeId, double *x);
 
+  // Description:
+  // Same as above, but using the given temporary storage instead of the
+  // TempQuad, TempA and TempB members, so that the costs of several edges
+  // can be computed concurrently.
+  double ComputeCost(vtkIdType edgeId, double *x, double *tempQuad);
+  double ComputeCost2(vtkIdType edgeId, double *x, double *tempQuad,
+                      double **tempA, double *tempB);
+
   // Description:
   // Find all edges that will have an endpoint change ids because of an edge
   // collapse.  p1Id and p2Id are the endpoints of the edge.  p2Id is the
@@ -173,7 +193,26 @@ protected:
   int TrianglePlaneCheck(const double t0[3], const double t1[3],
                          const double t2[3],  const double *x);
   void ComputeNumberOfComponents(void);
-  void UpdateEdgeData(vtkIdType ptoId, vtkIdType pt1Id);
+
+  // Description:
+  // Update the edges affected by the collapse of edge (pt0Id, pt1Id). If
+  // deferredEdges is not NULL, the edges whose cost has to be recomputed
+  // are appended to it instead of being put back in the priority queue.
+  void UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id,
+                      vtkIdList *deferredEdges);
+  void UpdateEdgeCost(vtkIdType edgeId, vtkIdList *deferredEdges);
+
+  // Description:
+  // Compute the costs and target points of the given edges in parallel and
+  // put them in the priority queue. If edgeIds is NULL, the edges
+  // 0..numEdges-1 are processed.
+  void ComputeEdgeCosts(const vtkIdType *edgeIds, vtkIdType numEdges);
+
+  // Description:
+  // Collapse edges in batches of independent edges (see BatchSize) until
+  // the target reduction is reached. Return the number of triangles
+  // deleted.
+  vtkIdType CollapseEdgeBatches(vtkIdType numTris);
 
   // Description:
   // Helper function to set and get the point and it's attributes as an array
@@ -201,6 +240,8 @@ protected:
   double TCoordsWeight;
   double TensorsWeight;
 
+  int BatchSize;
+
   int               NumberOfEdgeCollapses;
   vtkEdgeTable     *Edges;
   vtkIdList        *EndPoint1List;
@@ -215,6 +256,9 @@ protected:
   {
     double *Quadric;
   };
+
+  friend class vtkQuadricDecimationPointQuadrics;
+  friend class vtkQuadricDecimationEdgeCosts;
   //ETX
 
   ErrorQuadric *ErrorQuadrics;
@@ -25,9 +25,14 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
 // The following code defines a helper class for performing mesh smoothing
@@ -127,6 +132,7 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelSmoothing = 0;
 
   // optional second input
   this->SetNumberOfInputPorts(2);
@@ -152,12 +158,369 @@ vtkPolyData *vtkSmoothPolyDataFilter::GetSource()
 #define VTK_FEATURE_EDGE_VERTEX 2
 #define VTK_BOUNDARY_EDGE_VERTEX 3
 
-// Special structure for marking vertices
-typedef struct _vtkMeshVertex
+// Marks a polygon edge that is classified from a neighbor polygon.
+#define VTK_VISITED_EDGE 4
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Classifies the edges of the polygons of the mesh. The edge starting at
+// the point i of a polygon is stored at the position of that point in the
+// connectivity array. An edge used by several polygons is classified from
+// the first one and marked VTK_VISITED_EDGE in the others, as the serial
+// traversal of the polygons skips the edges it has already seen.
+class vtkSmoothPolyDataClassifyEdges
+{
+public:
+  vtkSmoothPolyDataClassifyEdges(vtkPolyData *mesh, vtkPoints *points,
+                                 int featureEdgeSmoothing,
+                                 double cosFeatureAngle, char *edgeTypes)
+    : Mesh(mesh), Points(points), FeatureEdgeSmoothing(featureEdgeSmoothing),
+      CosFeatureAngle(cosFeatureAngle), EdgeTypes(edgeTypes)
+  {
+  }
+
+  void Initialize()
   {
-  char      type;
-  vtkIdList *edges; // connected edges (list of connected point ids)
-} vtkMeshVertex, *vtkMeshVertexPtr;
+    this->Neighbors.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkIdType *connectivity = this->Mesh->GetPolys()->GetPointer();
+    vtkIdList *neighbors = this->Neighbors.Local();
+    vtkIdType npts, *pts, numNeiPts, *neiPts, nei;
+    double normal[3], neiNormal[3];
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      char *edgeTypes = this->EdgeTypes + (pts - connectivity);
+      for (vtkIdType i = 0; i < npts; i++)
+        {
+        this->Mesh->GetCellEdgeNeighbors(cellId, pts[i], pts[(i+1)%npts],
+                                         neighbors);
+        vtkIdType numNei = neighbors->GetNumberOfIds();
+
+        char edge = VTK_SIMPLE_VERTEX;
+        if ( numNei == 0 )
+          {
+          edge = VTK_BOUNDARY_EDGE_VERTEX;
+          }
+        else if ( numNei >= 2 )
+          {
+          // check to make sure that this edge hasn't been marked already
+          vtkIdType j;
+          for (j=0; j < numNei; j++)
+            {
+            if ( neighbors->GetId(j) < cellId )
+              {
+              break;
+              }
+            }
+          if ( j >= numNei )
+            {
+            edge = VTK_FEATURE_EDGE_VERTEX;
+            }
+          }
+        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
+          {
+          if ( this->FeatureEdgeSmoothing )
+            {
+            vtkPolygon::ComputeNormal(this->Points,npts,pts,normal);
+            this->Mesh->GetCellPoints(nei,numNeiPts,neiPts);
+            vtkPolygon::ComputeNormal(this->Points,numNeiPts,neiPts,
+                                      neiNormal);
+            if ( vtkMath::Dot(normal,neiNormal) <= this->CosFeatureAngle )
+              {
+              edge = VTK_FEATURE_EDGE_VERTEX;
+              }
+            }
+          }
+        else // a visited edge
+          {
+          edge = VTK_VISITED_EDGE;
+          }
+        edgeTypes[i] = edge;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  int FeatureEdgeSmoothing;
+  double CosFeatureAngle;
+  char *EdgeTypes;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+};
+
+//----------------------------------------------------------------------------
+// Finds the type and the connected vertices of each point. The classified
+// edges using a point are visited in the order of the polygons and of
+// their points, so the result is the one of a serial traversal of the
+// polygons. Without Edges, stores the type of each point and the number of
+// connected vertices of the movable ones in Offsets[i+1]. With Edges, the
+// connected vertices of point i are stored in Edges[Offsets[i]] ..
+// Edges[Offsets[i+1]-1].
+class vtkSmoothPolyDataBuildEdges
+{
+public:
+  vtkSmoothPolyDataBuildEdges(vtkPolyData *mesh, const char *edgeTypes,
+                              vtkPoints *points, const char *lineTypes,
+                              const vtkIdType *lineEdges,
+                              int boundarySmoothing, double cosEdgeAngle,
+                              char *types, vtkIdType *offsets,
+                              vtkIdType *edges)
+    : Mesh(mesh), EdgeTypes(edgeTypes), Points(points), LineTypes(lineTypes),
+      LineEdges(lineEdges), BoundarySmoothing(boundarySmoothing),
+      CosEdgeAngle(cosEdgeAngle), Types(types), Offsets(offsets),
+      Edges(edges)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      if ( this->Edges && this->Offsets[ptId+1] == this->Offsets[ptId] )
+        {
+        continue;
+        }
+      this->Visit(ptId);
+      }
+  }
+
+private:
+  // The connected vertices of a point, as they are found.
+  struct Vertex
+  {
+    vtkIdType PtId;
+    char Type;
+    vtkIdType NumberOfEdges;
+    vtkIdType FirstEdges[2];
+    vtkIdType *Edges;
+  };
+
+  void Visit(vtkIdType ptId) const
+  {
+    Vertex vertex;
+    vertex.PtId = ptId;
+    vertex.Type = this->LineTypes[ptId];
+    vertex.NumberOfEdges = 0;
+    vertex.Edges = this->Edges ? this->Edges + this->Offsets[ptId] : 0;
+    if ( vertex.Type == VTK_FEATURE_EDGE_VERTEX )
+      {
+      this->InsertEdge(vertex, this->LineEdges[2*ptId]);
+      this->InsertEdge(vertex, this->LineEdges[2*ptId+1]);
+      }
+
+    if ( this->Mesh )
+      {
+      const vtkIdType *connectivity = this->Mesh->GetPolys()->GetPointer();
+      unsigned short ncells;
+      vtkIdType *cells, npts, *pts;
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      for (unsigned short c = 0; c < ncells; c++)
+        {
+        if ( c > 0 && cells[c] == cells[c-1] )
+          {
+          continue; // the point is used more than once by the cell
+          }
+        this->Mesh->GetCellPoints(cells[c], npts, pts);
+        const char *edgeTypes = this->EdgeTypes + (pts - connectivity);
+        for (vtkIdType i = 0; i < npts; i++)
+          {
+          vtkIdType p1 = pts[i];
+          vtkIdType p2 = pts[(i+1)%npts];
+          if ( edgeTypes[i] == VTK_VISITED_EDGE )
+            {
+            continue;
+            }
+          if ( p1 == ptId )
+            {
+            this->InsertEdge(vertex, p2, edgeTypes[i]);
+            }
+          if ( p2 == ptId )
+            {
+            this->InsertEdge(vertex, p1, edgeTypes[i]);
+            }
+          }
+        }
+      }
+
+    if ( this->Edges )
+      {
+      return;
+      }
+
+    //post-process edge vertices to make sure we can smooth them
+    if ( vertex.Type == VTK_FEATURE_EDGE_VERTEX ||
+         vertex.Type == VTK_BOUNDARY_EDGE_VERTEX )
+      { //see how many edges; if two, what the angle is
+      if ( !this->BoundarySmoothing &&
+           vertex.Type == VTK_BOUNDARY_EDGE_VERTEX )
+        {
+        vertex.Type = VTK_FIXED_VERTEX;
+        }
+      else if ( vertex.NumberOfEdges != 2 )
+        {
+        vertex.Type = VTK_FIXED_VERTEX;
+        }
+      else //check angle between edges
+        {
+        double x1[3], x2[3], x3[3], l1[3], l2[3];
+        this->Points->GetPoint(vertex.FirstEdges[0],x1);
+        this->Points->GetPoint(ptId,x2);
+        this->Points->GetPoint(vertex.FirstEdges[1],x3);
+        for (int k=0; k<3; k++)
+          {
+          l1[k] = x2[k] - x1[k];
+          l2[k] = x3[k] - x2[k];
+          }
+        if ( vtkMath::Normalize(l1) >= 0.0 &&
+             vtkMath::Normalize(l2) >= 0.0 &&
+             vtkMath::Dot(l1,l2) < this->CosEdgeAngle)
+          {
+          vertex.Type = VTK_FIXED_VERTEX;
+          }
+        }
+      }
+
+    this->Types[ptId] = vertex.Type;
+    this->Offsets[ptId+1] =
+      vertex.Type != VTK_FIXED_VERTEX ? vertex.NumberOfEdges : 0;
+  }
+
+  // Applies an edge of the given type from the point to p.
+  void InsertEdge(Vertex &vertex, vtkIdType p, char edge) const
+  {
+    if ( edge && vertex.Type == VTK_SIMPLE_VERTEX )
+      {
+      vertex.Type = edge;
+      vertex.NumberOfEdges = 0;
+      this->InsertEdge(vertex, p);
+      }
+    else if ( (edge && vertex.Type == VTK_BOUNDARY_EDGE_VERTEX) ||
+              (edge && vertex.Type == VTK_FEATURE_EDGE_VERTEX) ||
+              (!edge && vertex.Type == VTK_SIMPLE_VERTEX ) )
+      {
+      this->InsertEdge(vertex, p);
+      if ( vertex.Type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+        {
+        vertex.Type = VTK_BOUNDARY_EDGE_VERTEX;
+        }
+      }
+  }
+
+  void InsertEdge(Vertex &vertex, vtkIdType p) const
+  {
+    if ( vertex.NumberOfEdges < 2 )
+      {
+      vertex.FirstEdges[vertex.NumberOfEdges] = p;
+      }
+    // The edges found while a point is simple are discarded if it turns
+    // out to be on an edge.
+    if ( vertex.Edges && (vertex.Type != VTK_SIMPLE_VERTEX ||
+                          this->Types[vertex.PtId] == VTK_SIMPLE_VERTEX) )
+      {
+      vertex.Edges[vertex.NumberOfEdges] = p;
+      }
+    vertex.NumberOfEdges++;
+  }
+
+  vtkPolyData *Mesh;
+  const char *EdgeTypes;
+  vtkPoints *Points;
+  const char *LineTypes;
+  const vtkIdType *LineEdges;
+  int BoundarySmoothing;
+  double CosEdgeAngle;
+  char *Types;
+  vtkIdType *Offsets;
+  vtkIdType *Edges;
+};
+
+//----------------------------------------------------------------------------
+// One Laplacian smoothing pass computing NewX from OldX. Only the movable
+// vertices are written; the buffers hold the same fixed vertices. Keeps
+// track of the largest displacement for the convergence test.
+class vtkSmoothPolyDataIteration
+{
+public:
+  vtkSmoothPolyDataIteration(const vtkIdType *offsets, const vtkIdType *edges,
+                             const double *oldX, double *newX, double factor)
+    : Offsets(offsets), Edges(edges), OldX(oldX), NewX(newX), Factor(factor)
+  {
+  }
+
+  void Initialize()
+  {
+    this->LocalMaxDist.Local() = 0.0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double deltaX[3], dist;
+    double &maxDist = this->LocalMaxDist.Local();
+    int k;
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      vtkIdType npts = this->Offsets[i+1] - this->Offsets[i];
+      if ( npts <= 0 )
+        {
+        continue;
+        }
+      const vtkIdType *edges = this->Edges + this->Offsets[i];
+      const double *x = this->OldX + 3*i;
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+      for (vtkIdType j=0; j<npts; j++)
+        {
+        const double *y = this->OldX + 3*edges[j];
+        for (k=0; k<3; k++)
+          {
+          deltaX[k] += (y[k] - x[k]) / npts;
+          }
+        }//for all connected points
+
+      double *xNew = this->NewX + 3*i;
+      for (k=0; k<3; k++)
+        {
+        xNew[k] = x[k] + this->Factor * deltaX[k];
+        }
+      if ( (dist = vtkMath::Norm(deltaX)) > maxDist )
+        {
+        maxDist = dist;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+    this->MaxDist = 0.0;
+    vtkSMPThreadLocal<double>::iterator itr;
+    for (itr = this->LocalMaxDist.begin(); itr != this->LocalMaxDist.end();
+         ++itr)
+      {
+      if ( *itr > this->MaxDist )
+        {
+        this->MaxDist = *itr;
+        }
+      }
+  }
+
+  const vtkIdType *Offsets;
+  const vtkIdType *Edges;
+  const double *OldX;
+  double *NewX;
+  double Factor;
+  double MaxDist;
+  vtkSMPThreadLocal<double> LocalMaxDist;
+};
+}
 
 int vtkSmoothPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -185,9 +548,8 @@ int vtkSmoothPolyDataFilter::RequestData(
   int j, k;
   vtkIdType npts = 0;
   vtkIdType *pts = 0;
-  vtkIdType p1, p2;
   double x[3], y[3], deltaX[3], xNew[3], conv, maxDist, dist, factor;
-  double x1[3], x2[3], x3[3], l1[3], l2[3];
+  double x1[3], x2[3], x3[3];
   double CosFeatureAngle; //Cosine of angle between adjacent polys
   double CosEdgeAngle; // Cosine of angle between adjacent edges
   double closestPt[3], dist2, *w = NULL;
@@ -198,7 +560,6 @@ int vtkSmoothPolyDataFilter::RequestData(
   vtkTriangleFilter *toTris=NULL;
   vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
   vtkPoints *newPts;
-  vtkMeshVertexPtr Verts;
   vtkCellLocator *cellLocator=NULL;
 
   // Check input
@@ -241,12 +602,9 @@ int vtkSmoothPolyDataFilter::RequestData(
   // using a subset of the attached vertices.
   //
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-  for (i=0; i<numPts; i++)
-    {
-    Verts[i].type = VTK_SIMPLE_VERTEX; //can smooth
-    Verts[i].edges = NULL;
-    }
+  std::vector<char> lineTypes(numPts, VTK_SIMPLE_VERTEX); //can smooth
+  // the two connected vertices of the feature edge vertices of the lines
+  std::vector<vtkIdType> lineEdges(2*numPts);
 
   inPts = input->GetPoints();
   conv = this->Convergence * input->GetLength();
@@ -257,7 +615,7 @@ int vtkSmoothPolyDataFilter::RequestData(
     {
     for (j=0; j<npts; j++)
       {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
+      lineTypes[pts[j]] = VTK_FIXED_VERTEX;
       }
     }
   this->UpdateProgress(0.10);
@@ -268,33 +626,27 @@ int vtkSmoothPolyDataFilter::RequestData(
     {
     for (j=0; j<npts; j++)
       {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
+      if ( lineTypes[pts[j]] == VTK_SIMPLE_VERTEX )
         {
         if ( j == (npts-1) ) //end-of-line marked FIXED
           {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
+          lineTypes[pts[j]] = VTK_FIXED_VERTEX;
           }
         else if ( j == 0 ) //beginning-of-line marked FIXED
           {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0],x2);
-          inPts->GetPoint(pts[1],x3);
+          lineTypes[pts[0]] = VTK_FIXED_VERTEX;
           }
         else //is edge vertex (unless already edge vertex!)
           {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[j+1]);
+          lineTypes[pts[j]] = VTK_FEATURE_EDGE_VERTEX;
+          lineEdges[2*pts[j]] = pts[j-1];
+          lineEdges[2*pts[j]+1] = pts[j+1];
           }
         } //if simple vertex
 
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
+      else if ( lineTypes[pts[j]] == VTK_FEATURE_EDGE_VERTEX )
         { //multiply connected, becomes fixed!
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = NULL;
+        lineTypes[pts[j]] = VTK_FIXED_VERTEX;
         }
 
       } //for all points in this line
@@ -307,19 +659,10 @@ int vtkSmoothPolyDataFilter::RequestData(
   inStrips=input->GetStrips();
   numStrips = inStrips->GetNumberOfCells();
 
+  inMesh = Mesh = NULL;
+  std::vector<char> edgeTypes;
   if ( numPolys > 0 || numStrips > 0 )
     { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
     inMesh = vtkPolyData::New();
     inMesh->SetPoints(inPts);
     inMesh->SetPolys(inPolys);
@@ -335,176 +678,65 @@ int vtkSmoothPolyDataFilter::RequestData(
       }
 
     Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
     this->UpdateProgress(0.375);
 
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-    cellId++)
+    vtkCellArray *polys = Mesh->GetPolys();
+    edgeTypes.resize(polys->GetNumberOfConnectivityEntries());
+    if ( !edgeTypes.empty() )
       {
-      for (i=0; i < npts; i++)
-        {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == NULL )
-          {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-          }
-        if ( Verts[p2].edges == NULL )
-          {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
-          }
-
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
-
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-          {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-
-        else if ( numNei >= 2 )
-          {
-          // check to make sure that this edge hasn't been marked already
-          for (j=0; j < numNei; j++)
-            {
-            if ( neighbors->GetId(j) < cellId )
-              {
-              break;
-              }
-            }
-          if ( j >= numNei )
-            {
-            edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-          {
-          vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-          Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-          vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
-
-          if ( this->FeatureEdgeSmoothing &&
-          vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle )
-            {
-            edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        else // a visited edge; skip rest of analysis
-          {
-          continue;
-          }
-
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-          {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-          }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-          {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-            {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
-            }
-          }
-
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-          {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-          }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-          {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-            {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
-            }
-          }
-        }
+      vtkSmoothPolyDataClassifyEdges classifyEdges(
+        Mesh, inPts, this->FeatureEdgeSmoothing, CosFeatureAngle,
+        &edgeTypes[0]);
+      vtkSMPTools::For(0, polys->GetNumberOfCells(), classifyEdges);
       }
-
-    inMesh->Delete();
-    if (toTris) {toTris->Delete();}
-
-    neighbors->Delete();
     }//if strips or polys
 
+  // Build a compressed table of the connected vertices of the movable
+  // points, traversed by every iteration: count them, then store them.
+  std::vector<char> types(numPts);
+  std::vector<vtkIdType> edgeOffsets(numPts+1);
+  vtkSmoothPolyDataBuildEdges countEdges(
+    Mesh, edgeTypes.empty() ? NULL : &edgeTypes[0], inPts, &lineTypes[0],
+    &lineEdges[0], this->BoundarySmoothing, CosEdgeAngle, &types[0],
+    &edgeOffsets[0], NULL);
+  vtkSMPTools::For(0, numPts, countEdges);
+  edgeOffsets[0] = 0;
+  for (i=0; i<numPts; i++)
+    {
+    edgeOffsets[i+1] += edgeOffsets[i];
+    }
+  std::vector<vtkIdType> edgeIds(edgeOffsets[numPts] > 0 ?
+                                 edgeOffsets[numPts] : 1);
+  vtkSmoothPolyDataBuildEdges fillEdges(
+    Mesh, edgeTypes.empty() ? NULL : &edgeTypes[0], inPts, &lineTypes[0],
+    &lineEdges[0], this->BoundarySmoothing, CosEdgeAngle, &types[0],
+    &edgeOffsets[0], &edgeIds[0]);
+  vtkSMPTools::For(0, numPts, fillEdges);
+  const vtkIdType *offsets = &edgeOffsets[0];
+  const vtkIdType *edges = &edgeIds[0];
+
+  if (inMesh) {inMesh->Delete();}
+  if (toTris) {toTris->Delete();}
+
   this->UpdateProgress(0.50);
 
-  //post-process edge vertices to make sure we can smooth them
   for (i=0; i<numPts; i++)
     {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
+    switch ( types[i] )
       {
-      numSimple++;
-      }
-
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
-      {
-      numFixed++;
-      }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-    Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-      { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-        {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
-        }
-
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
-        {
-        Verts[i].type = VTK_FIXED_VERTEX;
+      case VTK_SIMPLE_VERTEX:
+        numSimple++;
+        break;
+      case VTK_FIXED_VERTEX:
         numFixed++;
-        }
-
-      else //check angle between edges
-        {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
-
-        for (k=0; k<3; k++)
-          {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
-          }
-        if ( vtkMath::Normalize(l1) >= 0.0 &&
-             vtkMath::Normalize(l2) >= 0.0 &&
-             vtkMath::Dot(l1,l2) < CosEdgeAngle)
-          {
-          numFixed++;
-          Verts[i].type = VTK_FIXED_VERTEX;
-          }
-        else
-          {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
-            {
-            numFEdges++;
-            }
-          else
-            {
-            numBEdges++;
-            }
-          }
-        }//if along edge
-      }//if edge vertex
-    }//for all points
+        break;
+      case VTK_FEATURE_EDGE_VERTEX:
+        numFEdges++;
+        break;
+      default:
+        numBEdges++;
+      }
+    }
 
   vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
                 << numFEdges << " feature edge vertices\n\t"
@@ -561,74 +793,116 @@ int vtkSmoothPolyDataFilter::RequestData(
       }
     }
 
+
   factor = this->RelaxationFactor;
-  for ( maxDist=VTK_DOUBLE_MAX, iterationNumber=0;
-  maxDist > conv && iterationNumber < this->NumberOfIterations;
-  iterationNumber++ )
+  if ( this->ParallelSmoothing && !source )
     {
+    // Every vertex of an iteration is computed from the previous positions,
+    // alternating between two buffers.
+    std::vector<double> buffers[2];
+    buffers[0].resize(3*numPts);
+    for (i=0; i<numPts; i++)
+      {
+      newPts->GetPoint(i, &buffers[0][3*i]);
+      }
+    buffers[1] = buffers[0];
+    int current = 0;
 
-    if ( iterationNumber && !(iterationNumber % 5) )
+    for ( maxDist=VTK_DOUBLE_MAX, iterationNumber=0;
+    maxDist > conv && iterationNumber < this->NumberOfIterations;
+    iterationNumber++ )
       {
-      this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
-      if (this->GetAbortExecute())
+      if ( iterationNumber && !(iterationNumber % 5) )
         {
-        break;
+        this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
+        if (this->GetAbortExecute())
+          {
+          break;
+          }
         }
+
+      vtkSmoothPolyDataIteration iteration(offsets, edges,
+                                           &buffers[current][0],
+                                           &buffers[1-current][0], factor);
+      vtkSMPTools::For(0, numPts, iteration);
+      maxDist = iteration.MaxDist;
+      current = 1 - current;
       }
 
-    maxDist=0.0;
     for (i=0; i<numPts; i++)
       {
-      if ( Verts[i].type != VTK_FIXED_VERTEX && Verts[i].edges != NULL &&
-      (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-        {
-        newPts->GetPoint(i, x); //use current points
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-        for (j=0; j<npts; j++)
-          {
-          newPts->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-            {
-            deltaX[k] += (y[k] - x[k]) / npts;
-            }
-          }//for all connected points
+      newPts->SetPoint(i, &buffers[current][3*i]);
+      }
+    }
+  else
+    {
+    for ( maxDist=VTK_DOUBLE_MAX, iterationNumber=0;
+    maxDist > conv && iterationNumber < this->NumberOfIterations;
+    iterationNumber++ )
+      {
 
-        for (k=0;k<3;k++)
+      if ( iterationNumber && !(iterationNumber % 5) )
+        {
+        this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
+        if (this->GetAbortExecute())
           {
-          xNew[k] = x[k] + factor * deltaX[k];
+          break;
           }
+        }
 
-        // Constrain point to surface
-        if ( source )
+      maxDist=0.0;
+      for (i=0; i<numPts; i++)
+        {
+        if ( (npts = offsets[i+1] - offsets[i]) > 0 )
           {
-          vtkSmoothPoint *sPtr = this->SmoothPoints->GetSmoothPoint(i);
-          vtkCell *cell=NULL;
+          newPts->GetPoint(i, x); //use current points
+          deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+          for (j=0; j<npts; j++)
+            {
+            newPts->GetPoint(edges[offsets[i]+j], y);
+            for (k=0; k<3; k++)
+              {
+              deltaX[k] += (y[k] - x[k]) / npts;
+              }
+            }//for all connected points
 
-          if ( sPtr->cellId >= 0 ) //in cell
+          for (k=0;k<3;k++)
             {
-            cell = source->GetCell(sPtr->cellId);
+            xNew[k] = x[k] + factor * deltaX[k];
             }
 
-          if ( !cell || cell->EvaluatePosition(xNew, closestPt,
-          sPtr->subId, sPtr->p, dist2, w) == 0)
-            { // not in cell anymore
-            cellLocator->FindClosestPoint(xNew, closestPt, sPtr->cellId,
-                                          sPtr->subId, dist2);
-            }
-          for (k=0; k<3; k++)
+          // Constrain point to surface
+          if ( source )
             {
-            xNew[k] = closestPt[k];
+            vtkSmoothPoint *sPtr = this->SmoothPoints->GetSmoothPoint(i);
+            vtkCell *cell=NULL;
+
+            if ( sPtr->cellId >= 0 ) //in cell
+              {
+              cell = source->GetCell(sPtr->cellId);
+              }
+
+            if ( !cell || cell->EvaluatePosition(xNew, closestPt,
+            sPtr->subId, sPtr->p, dist2, w) == 0)
+              { // not in cell anymore
+              cellLocator->FindClosestPoint(xNew, closestPt, sPtr->cellId,
+                                            sPtr->subId, dist2);
+              }
+            for (k=0; k<3; k++)
+              {
+              xNew[k] = closestPt[k];
+              }
             }
-          }
 
-        newPts->SetPoint(i,xNew);
-        if ( (dist = vtkMath::Norm(deltaX)) > maxDist )
-          {
-          maxDist = dist;
-          }
-        }//if can move point
-      }//for all points
-    } //for not converged or within iteration count
+          newPts->SetPoint(i,xNew);
+          if ( (dist = vtkMath::Norm(deltaX)) > maxDist )
+            {
+            maxDist = dist;
+            }
+          }//if can move point
+        }//for all points
+      } //for not converged or within iteration count
+    }
 
   vtkDebugMacro(<<"Performed " << iterationNumber << " smoothing passes");
   if ( source )
@@ -686,16 +960,6 @@ int vtkSmoothPolyDataFilter::RequestData(
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-    {
-    if ( Verts[i].edges != NULL )
-      {
-      Verts[i].edges->Delete();
-      Verts[i].edges = NULL;
-      }
-    }
-  delete [] Verts;
 
   return 1;
 }
@@ -738,4 +1002,5 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Smoothing: " << (this->ParallelSmoothing ? "On\n" : "Off\n");
 }
@@ -75,6 +75,14 @@
 // second input: the Source. If defined, the input mesh is constrained to
 // lie on the surface defined by the Source ivar.
 //
+// By default each vertex is moved in place, so that later vertices of an
+// iteration see the already smoothed positions of earlier ones. If the ivar
+// ParallelSmoothing is on, every vertex of an iteration is instead computed
+// from the positions of the previous iteration, which lets the vertices be
+// smoothed concurrently with vtkSMPTools. The two updates give different
+// points for the same number of iterations: they only approach the same
+// surface as the iterations increase, the parallel one more slowly.
+//
 // .SECTION Caveats
 //
 // The Laplacian operation reduces high frequency information in the geometry
@@ -178,6 +186,18 @@ public:
   vtkSetMacro(OutputPointsPrecision,int);
   vtkGetMacro(OutputPointsPrecision,int);
 
+  // Description:
+  // Turn on/off parallel smoothing. When on, each iteration computes the
+  // new vertex positions from the positions of the previous iteration only,
+  // and processes the vertices with vtkSMPTools. The points are not
+  // identical to the ones of the default in-place update after the same
+  // number of iterations, and more iterations may be needed to reach the
+  // Convergence; they do not depend on the number of threads.
+  // This option is ignored when a Source is defined. Off by default.
+  vtkSetMacro(ParallelSmoothing,int);
+  vtkGetMacro(ParallelSmoothing,int);
+  vtkBooleanMacro(ParallelSmoothing,int);
+
 protected:
   vtkSmoothPolyDataFilter();
   ~vtkSmoothPolyDataFilter() {}
@@ -195,6 +215,7 @@ protected:
   int GenerateErrorScalars;
   int GenerateErrorVectors;
   int OutputPointsPrecision;
+  int ParallelSmoothing;
 
   vtkSmoothPoints *SmoothPoints;
 private:
@@ -25,6 +25,7 @@ vtkStreamerBase::vtkStreamerBase()
 {
   this->NumberOfPasses = 1;
   this->CurrentIndex = 0;
+  this->Restart = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -71,10 +72,19 @@ int vtkStreamerBase::RequestData(vtkInformation *request,
   if (!this->ExecutePass(inputVector, outputVector))
     {
     request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+    this->Restart = 0;
     return 0;
     }
 
-  this->CurrentIndex++;
+  if (this->Restart)
+    {
+    this->Restart = 0;
+    this->CurrentIndex = 0;
+    }
+  else
+    {
+    this->CurrentIndex++;
+    }
 
   if (  this->CurrentIndex < this->NumberOfPasses )
     {
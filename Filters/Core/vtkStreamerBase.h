@@ -25,7 +25,9 @@
 // ExecutePass() during each pass. CurrentIndex can be used to obtain
 // the index for the current pass. Finally, PostExecute() is called
 // after the last pass and can be used to cleanup any internal data
-// structures and create the actual output.
+// structures and create the actual output. ExecutePass() may call
+// RestartStreaming() to discard the passes done so far and start again
+// from the first one, for example after changing NumberOfPasses.
 
 
 #ifndef _vtkStreamerBase_h
@@ -81,8 +83,17 @@ protected:
     return 1;
   }
 
+  // Description:
+  // Call from ExecutePass() to start streaming again from the first pass
+  // instead of moving on to the next one.
+  void RestartStreaming()
+  {
+    this->Restart = 1;
+  }
+
   unsigned int NumberOfPasses;
   unsigned int CurrentIndex;
+  int Restart;
 
 private:
   vtkStreamerBase(const vtkStreamerBase &); // Not implemented.
@@ -24,9 +24,13 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkWindowedSincPolyDataFilter);
 
 // Construct object with number of iterations 20; passband .1;
@@ -57,12 +61,470 @@ vtkWindowedSincPolyDataFilter::vtkWindowedSincPolyDataFilter()
 #define VTK_FEATURE_EDGE_VERTEX 2
 #define VTK_BOUNDARY_EDGE_VERTEX 3
 
-// Special structure for marking vertices
-typedef struct _vtkMeshVertex
+// Marks a polygon edge that is classified from a neighbor polygon.
+#define VTK_VISITED_EDGE 4
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Classifies the edges of the polygons of the mesh. The edge starting at
+// the point i of a polygon is stored at the position of that point in the
+// connectivity array. An edge used by several polygons is classified from
+// the first one and marked VTK_VISITED_EDGE in the others, as the serial
+// traversal of the polygons skips the edges it has already seen.
+class vtkWindowedSincClassifyEdges
+{
+public:
+  vtkWindowedSincClassifyEdges(vtkPolyData *mesh, vtkPoints *points,
+                               int featureEdgeSmoothing,
+                               int nonManifoldSmoothing,
+                               double cosFeatureAngle, char *edgeTypes)
+    : Mesh(mesh), Points(points), FeatureEdgeSmoothing(featureEdgeSmoothing),
+      NonManifoldSmoothing(nonManifoldSmoothing),
+      CosFeatureAngle(cosFeatureAngle), EdgeTypes(edgeTypes)
+  {
+  }
+
+  void Initialize()
+  {
+    this->Neighbors.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkIdType *connectivity = this->Mesh->GetPolys()->GetPointer();
+    vtkIdList *neighbors = this->Neighbors.Local();
+    vtkIdType npts, *pts, numNeiPts, *neiPts, nei;
+    double normal[3], neiNormal[3];
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      char *edgeTypes = this->EdgeTypes + (pts - connectivity);
+      for (vtkIdType i = 0; i < npts; i++)
+        {
+        this->Mesh->GetCellEdgeNeighbors(cellId, pts[i], pts[(i+1)%npts],
+                                         neighbors);
+        vtkIdType numNei = neighbors->GetNumberOfIds();
+
+        char edge = VTK_SIMPLE_VERTEX;
+        if ( numNei == 0 )
+          {
+          edge = VTK_BOUNDARY_EDGE_VERTEX;
+          }
+        else if ( numNei >= 2 )
+          {
+          // non-manifold case, check nonmanifold smoothing state
+          if ( !this->NonManifoldSmoothing )
+            {
+            // check to make sure that this edge hasn't been marked already
+            vtkIdType j;
+            for (j=0; j < numNei; j++)
+              {
+              if ( neighbors->GetId(j) < cellId )
+                {
+                break;
+                }
+              }
+            if ( j >= numNei )
+              {
+              edge = VTK_FEATURE_EDGE_VERTEX;
+              }
+            }
+          }
+        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
+          {
+          if ( this->FeatureEdgeSmoothing )
+            {
+            vtkPolygon::ComputeNormal(this->Points,npts,pts,normal);
+            this->Mesh->GetCellPoints(nei,numNeiPts,neiPts);
+            vtkPolygon::ComputeNormal(this->Points,numNeiPts,neiPts,
+                                      neiNormal);
+            if ( vtkMath::Dot(normal,neiNormal) <= this->CosFeatureAngle )
+              {
+              edge = VTK_FEATURE_EDGE_VERTEX;
+              }
+            }
+          }
+        else // a visited edge
+          {
+          edge = VTK_VISITED_EDGE;
+          }
+        edgeTypes[i] = edge;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  int FeatureEdgeSmoothing;
+  int NonManifoldSmoothing;
+  double CosFeatureAngle;
+  char *EdgeTypes;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+};
+
+//----------------------------------------------------------------------------
+// Finds the type and the connected vertices of each point. The classified
+// edges using a point are visited in the order of the polygons and of
+// their points, so the result is the one of a serial traversal of the
+// polygons. Without Edges, stores the type and the number of connected
+// vertices of each point in Offsets[i+1]. With Edges, the connected
+// vertices of point i are stored in Edges[Offsets[i]] ..
+// Edges[Offsets[i+1]-1]. The fixed points keep their connected vertices,
+// their Laplacian is used by their neighbors.
+class vtkWindowedSincBuildEdges
+{
+public:
+  vtkWindowedSincBuildEdges(vtkPolyData *mesh, const char *edgeTypes,
+                            vtkPoints *points, const char *lineTypes,
+                            const vtkIdType *lineEdges, int boundarySmoothing,
+                            double cosEdgeAngle, char *types,
+                            vtkIdType *offsets, vtkIdType *edges)
+    : Mesh(mesh), EdgeTypes(edgeTypes), Points(points), LineTypes(lineTypes),
+      LineEdges(lineEdges), BoundarySmoothing(boundarySmoothing),
+      CosEdgeAngle(cosEdgeAngle), Types(types), Offsets(offsets),
+      Edges(edges)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+      if ( this->Edges && this->Offsets[ptId+1] == this->Offsets[ptId] )
+        {
+        continue;
+        }
+      this->Visit(ptId);
+      }
+  }
+
+private:
+  // The connected vertices of a point, as they are found.
+  struct Vertex
+  {
+    vtkIdType PtId;
+    char Type;
+    vtkIdType NumberOfEdges;
+    vtkIdType FirstEdges[2];
+    vtkIdType *Edges;
+  };
+
+  void Visit(vtkIdType ptId) const
+  {
+    Vertex vertex;
+    vertex.PtId = ptId;
+    vertex.Type = this->LineTypes[ptId];
+    vertex.NumberOfEdges = 0;
+    vertex.Edges = this->Edges ? this->Edges + this->Offsets[ptId] : 0;
+    if ( vertex.Type == VTK_FEATURE_EDGE_VERTEX )
+      {
+      this->InsertEdge(vertex, this->LineEdges[2*ptId]);
+      this->InsertEdge(vertex, this->LineEdges[2*ptId+1]);
+      }
+
+    if ( this->Mesh )
+      {
+      const vtkIdType *connectivity = this->Mesh->GetPolys()->GetPointer();
+      unsigned short ncells;
+      vtkIdType *cells, npts, *pts;
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      for (unsigned short c = 0; c < ncells; c++)
+        {
+        if ( c > 0 && cells[c] == cells[c-1] )
+          {
+          continue; // the point is used more than once by the cell
+          }
+        this->Mesh->GetCellPoints(cells[c], npts, pts);
+        const char *edgeTypes = this->EdgeTypes + (pts - connectivity);
+        for (vtkIdType i = 0; i < npts; i++)
+          {
+          vtkIdType p1 = pts[i];
+          vtkIdType p2 = pts[(i+1)%npts];
+          if ( edgeTypes[i] == VTK_VISITED_EDGE )
+            {
+            continue;
+            }
+          if ( p1 == ptId )
+            {
+            this->InsertEdge(vertex, p2, edgeTypes[i]);
+            }
+          if ( p2 == ptId )
+            {
+            this->InsertEdge(vertex, p1, edgeTypes[i]);
+            }
+          }
+        }
+      }
+
+    if ( this->Edges )
+      {
+      return;
+      }
+
+    //post-process edge vertices to make sure we can smooth them
+    if ( vertex.Type == VTK_FEATURE_EDGE_VERTEX ||
+         vertex.Type == VTK_BOUNDARY_EDGE_VERTEX )
+      { //see how many edges; if two, what the angle is
+      if ( !this->BoundarySmoothing &&
+           vertex.Type == VTK_BOUNDARY_EDGE_VERTEX )
+        {
+        vertex.Type = VTK_FIXED_VERTEX;
+        }
+      else if ( vertex.NumberOfEdges != 2 )
+        {
+        // can only smooth edges on 2-manifold surfaces
+        vertex.Type = VTK_FIXED_VERTEX;
+        }
+      else //check angle between edges
+        {
+        double x1[3], x2[3], x3[3], l1[3], l2[3];
+        this->Points->GetPoint(vertex.FirstEdges[0],x1);
+        this->Points->GetPoint(ptId,x2);
+        this->Points->GetPoint(vertex.FirstEdges[1],x3);
+        for (int k=0; k<3; k++)
+          {
+          l1[k] = x2[k] - x1[k];
+          l2[k] = x3[k] - x2[k];
+          }
+        if ((vtkMath::Normalize(l1) >= 0.0) && (vtkMath::Normalize(l2) >= 0.0)
+            && (vtkMath::Dot(l1,l2) < this->CosEdgeAngle))
+          {
+          vertex.Type = VTK_FIXED_VERTEX;
+          }
+        }
+      }
+
+    this->Types[ptId] = vertex.Type;
+    this->Offsets[ptId+1] = vertex.NumberOfEdges;
+  }
+
+  // Applies an edge of the given type from the point to p.
+  void InsertEdge(Vertex &vertex, vtkIdType p, char edge) const
+  {
+    if ( edge && vertex.Type == VTK_SIMPLE_VERTEX )
+      {
+      vertex.Type = edge;
+      vertex.NumberOfEdges = 0;
+      this->InsertEdge(vertex, p);
+      }
+    else if ( (edge && vertex.Type == VTK_BOUNDARY_EDGE_VERTEX) ||
+              (edge && vertex.Type == VTK_FEATURE_EDGE_VERTEX) ||
+              (!edge && vertex.Type == VTK_SIMPLE_VERTEX ) )
+      {
+      this->InsertEdge(vertex, p);
+      if ( vertex.Type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+        {
+        vertex.Type = VTK_BOUNDARY_EDGE_VERTEX;
+        }
+      }
+  }
+
+  void InsertEdge(Vertex &vertex, vtkIdType p) const
+  {
+    if ( vertex.NumberOfEdges < 2 )
+      {
+      vertex.FirstEdges[vertex.NumberOfEdges] = p;
+      }
+    // The edges found while a point is simple are discarded if it turns
+    // out to be on an edge.
+    if ( vertex.Edges && (vertex.Type != VTK_SIMPLE_VERTEX ||
+                          this->Types[vertex.PtId] == VTK_SIMPLE_VERTEX) )
+      {
+      vertex.Edges[vertex.NumberOfEdges] = p;
+      }
+    vertex.NumberOfEdges++;
+  }
+
+  vtkPolyData *Mesh;
+  const char *EdgeTypes;
+  vtkPoints *Points;
+  const char *LineTypes;
+  const vtkIdType *LineEdges;
+  int BoundarySmoothing;
+  double CosEdgeAngle;
+  char *Types;
+  vtkIdType *Offsets;
+  vtkIdType *Edges;
+};
+
+//----------------------------------------------------------------------------
+// Point update of the first iteration: computes x1 = x0 - 0.5 L(x0) and
+// initializes the accumulated result x3 = c0 x0 + c1 x1.
+class vtkWindowedSincFirstIteration
+{
+public:
+  vtkWindowedSincFirstIteration(const char *types,
+                                const vtkIdType *offsets,
+                                const vtkIdType *edges, const float *x0,
+                                float *x1, float *x3, const double *c)
+    : Types(types), Offsets(offsets), Edges(edges), X0(x0), X1(x1), X3(x3),
+      C(c)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
   {
-  char      type;
-  vtkIdList *edges; // connected edges (list of connected point ids)
-} vtkMeshVertex, *vtkMeshVertexPtr;
+    double x[3], y[3], deltaX[3];
+    int k;
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      vtkIdType npts = this->Offsets[i+1] - this->Offsets[i];
+      const float *x0 = this->X0 + 3*i;
+      float *x1 = this->X1 + 3*i;
+      float *x3 = this->X3 + 3*i;
+      if ( npts > 0 )
+        {
+        // point is allowed to move
+        const vtkIdType *edges = this->Edges + this->Offsets[i];
+        for (k=0; k<3; k++)
+          {
+          x[k] = x0[k];
+          }
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative of the laplacian
+        for (vtkIdType j=0; j<npts; j++) //for all connected points
+          {
+          const float *p = this->X0 + 3*edges[j];
+          for (k=0; k<3; k++)
+            {
+            y[k] = p[k];
+            deltaX[k] += (x[k] - y[k]) / npts;
+            }
+          }
+        // x1 = x0 - 0.5 x1
+        for (k=0; k<3; k++)
+          {
+          deltaX[k] = x[k] - 0.5*deltaX[k];
+          x1[k] = static_cast<float>(deltaX[k]);
+          }
+
+        // calculate x3 = c0 x0 + c1 x1
+        if (this->Types[i] == VTK_FIXED_VERTEX)
+          {
+          for (k=0; k<3; k++)
+            {
+            x3[k] = x0[k];
+            }
+          }
+        else
+          {
+          for (k=0; k<3; k++)
+            {
+            x3[k] = static_cast<float>(this->C[0]*x[k] +
+                                       this->C[1]*deltaX[k]);
+            }
+          }
+        }//if can move point
+      else
+        {
+        // point is not allowed to move, just use the old point...
+        // (zero out the Laplacian)
+        for (k=0; k<3; k++)
+          {
+          x1[k] = 0.0f;
+          x3[k] = x0[k];
+          }
+        }
+      }
+  }
+
+  const char *Types;
+  const vtkIdType *Offsets;
+  const vtkIdType *Edges;
+  const float *X0;
+  float *X1;
+  float *X3;
+  const double *C;
+};
+
+//----------------------------------------------------------------------------
+// Point update of the following iterations: x2 = (x1 - x0) + (x1 - L(x1))
+// and x3 = x3 + cj x2. x0 and x1 are only read, so every point can be
+// updated independently.
+class vtkWindowedSincIteration
+{
+public:
+  vtkWindowedSincIteration(const char *types, const vtkIdType *offsets,
+                           const vtkIdType *edges, const float *x0,
+                           const float *x1, float *x2, float *x3, double c)
+    : Types(types), Offsets(offsets), Edges(edges), X0(x0), X1(x1), X2(x2),
+      X3(x3), C(c)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    double p_x0[3], p_x1[3], y[3], deltaX[3];
+    int k;
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      vtkIdType npts = this->Offsets[i+1] - this->Offsets[i];
+      float *x2 = this->X2 + 3*i;
+      if ( npts > 0 )
+        {
+        // point is allowed to move
+        const vtkIdType *edges = this->Edges + this->Offsets[i];
+        for (k=0; k<3; k++)
+          {
+          p_x0[k] = this->X0[3*i+k];
+          p_x1[k] = this->X1[3*i+k];
+          }
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative laplacian of x1
+        for (vtkIdType j=0; j<npts; j++)
+          {
+          const float *p = this->X1 + 3*edges[j];
+          for (k=0; k<3; k++)
+            {
+            y[k] = p[k];
+            deltaX[k] += (p_x1[k] - y[k]) / npts;
+            }
+          }//for all connected points
+
+        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+        for (k=0; k<3; k++)
+          {
+          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          x2[k] = static_cast<float>(deltaX[k]);
+          }
+
+        // smooth the vertex (x3 = x3 + cj x2)
+        if (this->Types[i] != VTK_FIXED_VERTEX)
+          {
+          float *x3 = this->X3 + 3*i;
+          for (k=0; k<3; k++)
+            {
+            x3[k] = static_cast<float>(x3[k] + this->C * deltaX[k]);
+            }
+          }
+        }//if can move point
+      else
+        {
+        // point is not allowed to move (its x1 was zeroed out by the
+        // previous iteration)
+        x2[0] = x2[1] = x2[2] = 0.0f;
+        }
+      }
+  }
+
+  const char *Types;
+  const vtkIdType *Offsets;
+  const vtkIdType *Edges;
+  const float *X0;
+  const float *X1;
+  float *X2;
+  float *X3;
+  double C;
+};
+}
 
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -83,9 +545,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   int j, k;
   vtkIdType npts = 0;
   vtkIdType *pts = 0;
-  vtkIdType p1, p2;
-  double x[3], y[3], deltaX[3], xNew[3];
-  double x1[3], x2[3], x3[3], l1[3], l2[3];
+  double x1[3], x2[3], x3[3];
   double CosFeatureAngle; //Cosine of angle between adjacent polys
   double CosEdgeAngle; // Cosine of angle between adjacent edges
   int iterationNumber;
@@ -95,10 +555,9 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkTriangleFilter *toTris=NULL;
   vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
   vtkPoints *newPts[4];
-  vtkMeshVertexPtr Verts;
 
   // variables specific to windowed sinc interpolation
-  double theta_pb, k_pb, sigma, p_x0[3], p_x1[3], p_x3[3];
+  double theta_pb, k_pb, sigma;
   double *w, *c, *cprime;
   int zero, one, two, three;
 
@@ -149,12 +608,9 @@ int vtkWindowedSincPolyDataFilter::RequestData(
 // using a subset of the attached vertices.
 //
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-  for (i=0; i<numPts; i++)
-    {
-    Verts[i].type = VTK_SIMPLE_VERTEX; //can smooth
-    Verts[i].edges = NULL;
-    }
+  std::vector<char> lineTypes(numPts, VTK_SIMPLE_VERTEX); //can smooth
+  // the two connected vertices of the feature edge vertices of the lines
+  std::vector<vtkIdType> lineEdges(2*numPts);
 
   inPts = input->GetPoints();
 
@@ -164,7 +620,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     {
     for (j=0; j<npts; j++)
       {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
+      lineTypes[pts[j]] = VTK_FIXED_VERTEX;
       }
     }
 
@@ -176,34 +632,27 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     {
     for (j=0; j<npts; j++)
       {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
+      if ( lineTypes[pts[j]] == VTK_SIMPLE_VERTEX )
         {
         if ( j == (npts-1) ) //end-of-line marked FIXED
           {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
+          lineTypes[pts[j]] = VTK_FIXED_VERTEX;
           }
         else if ( j == 0 ) //beginning-of-line marked FIXED
           {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0],x2);
-          inPts->GetPoint(pts[1],x3);
+          lineTypes[pts[0]] = VTK_FIXED_VERTEX;
           }
         else //is edge vertex (unless already edge vertex!)
           {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          //Verts[pts[j]].edges = new vtkIdList(2,2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[j+1]);
+          lineTypes[pts[j]] = VTK_FEATURE_EDGE_VERTEX;
+          lineEdges[2*pts[j]] = pts[j-1];
+          lineEdges[2*pts[j]+1] = pts[j+1];
           }
         } //if simple vertex
 
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
+      else if ( lineTypes[pts[j]] == VTK_FEATURE_EDGE_VERTEX )
         { //multiply connected, becomes fixed!
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = NULL;
+        lineTypes[pts[j]] = VTK_FIXED_VERTEX;
         }
 
       } //for all points in this line
@@ -217,22 +666,14 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   inStrips=input->GetStrips();
   numStrips = inStrips->GetNumberOfCells();
 
+  Mesh = NULL;
+  std::vector<char> edgeTypes;
   if ( numPolys > 0 || numStrips > 0 )
     { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
     inMesh = vtkPolyData::New();
     inMesh->SetPoints(inPts);
     inMesh->SetPolys(inPolys);
     Mesh = inMesh;
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
 
     if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
       { // convert data to triangles
@@ -244,185 +685,64 @@ int vtkWindowedSincPolyDataFilter::RequestData(
       }
 
     Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
 
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-         cellId++)
+    vtkCellArray *polys = Mesh->GetPolys();
+    edgeTypes.resize(polys->GetNumberOfConnectivityEntries());
+    if ( !edgeTypes.empty() )
       {
-      for (i=0; i < npts; i++)
-        {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == NULL )
-          {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-          // Verts[p1].edges = new vtkIdList(6,6);
-          }
-        if ( Verts[p2].edges == NULL )
-          {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
-          // Verts[p2].edges = new vtkIdList(6,6);
-          }
-
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
-
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-          {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-
-        else if ( numNei >= 2 )
-          {
-          // non-manifold case, check nonmanifold smoothing state
-          if (!this->NonManifoldSmoothing)
-            {
-            // check to make sure that this edge hasn't been marked already
-            for (j=0; j < numNei; j++)
-              {
-              if ( neighbors->GetId(j) < cellId )
-                {
-                break;
-                }
-              }
-            if ( j >= numNei )
-              {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-              }
-            }
-          }
-
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-          {
-          if (this->FeatureEdgeSmoothing)
-            {
-            vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-            Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-            vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
-
-            if ( vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle )
-              {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-              }
-            }
-          }
-        else // a visited edge; skip rest of analysis
-          {
-          continue;
-          }
-
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-          {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-          }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-          {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-            {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
-            }
-          }
-
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-          {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-          }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-          {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-            {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
-            }
-          }
-        }
+      vtkWindowedSincClassifyEdges classifyEdges(
+        Mesh, inPts, this->FeatureEdgeSmoothing, this->NonManifoldSmoothing,
+        CosFeatureAngle, &edgeTypes[0]);
+      vtkSMPTools::For(0, polys->GetNumberOfCells(), classifyEdges);
       }
-
-    //    delete inMesh; // delete this later, windowed sinc smoothing needs it
-    if (toTris)
-      {
-      toTris->Delete();
-      }
-    neighbors->Delete();
     }//if strips or polys
 
+  // Build a compressed table of the connected vertices so the point updates
+  // below can be done in parallel: count them, then store them.
+  std::vector<char> types(numPts);
+  std::vector<vtkIdType> edgeOffsets(numPts+1);
+  vtkWindowedSincBuildEdges countEdges(
+    Mesh, edgeTypes.empty() ? NULL : &edgeTypes[0], inPts, &lineTypes[0],
+    &lineEdges[0], this->BoundarySmoothing, CosEdgeAngle, &types[0],
+    &edgeOffsets[0], NULL);
+  vtkSMPTools::For(0, numPts, countEdges);
+  edgeOffsets[0] = 0;
+  for (i=0; i<numPts; i++)
+    {
+    edgeOffsets[i+1] += edgeOffsets[i];
+    }
+  std::vector<vtkIdType> edgeIds(edgeOffsets[numPts] > 0 ?
+                                 edgeOffsets[numPts] : 1);
+  vtkWindowedSincBuildEdges fillEdges(
+    Mesh, edgeTypes.empty() ? NULL : &edgeTypes[0], inPts, &lineTypes[0],
+    &lineEdges[0], this->BoundarySmoothing, CosEdgeAngle, &types[0],
+    &edgeOffsets[0], &edgeIds[0]);
+  vtkSMPTools::For(0, numPts, fillEdges);
+
+  if (toTris)
+    {
+    toTris->Delete();
+    }
+
   this->UpdateProgress(0.50);
 
-  //post-process edge vertices to make sure we can smooth them
   for (i=0; i<numPts; i++)
     {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
-      {
-      numSimple++;
-      }
-
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
+    switch ( types[i] )
       {
-      numFixed++;
-      }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-    Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-      { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-        {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
-        }
-
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
-        {
-        // can only smooth edges on 2-manifold surfaces
-        Verts[i].type = VTK_FIXED_VERTEX;
+      case VTK_SIMPLE_VERTEX:
+        numSimple++;
+        break;
+      case VTK_FIXED_VERTEX:
         numFixed++;
-        }
-
-      else //check angle between edges
-        {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
-
-        for (k=0; k<3; k++)
-          {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
-          }
-        if ((vtkMath::Normalize(l1) >= 0.0) && (vtkMath::Normalize(l2) >= 0.0)
-            && (vtkMath::Dot(l1,l2) < CosEdgeAngle))
-          {
-          numFixed++;
-          Verts[i].type = VTK_FIXED_VERTEX;
-          }
-        else
-          {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
-            {
-            numFEdges++;
-            }
-          else
-            {
-            numBEdges++;
-            }
-          }
-        }//if along edge
-      }//if edge vertex
-    }//for all points
+        break;
+      case VTK_FEATURE_EDGE_VERTEX:
+        numFEdges++;
+        break;
+      default:
+        numBEdges++;
+      }
+    }
 
   vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
                 << numFEdges << " feature edge vertices\n\t"
@@ -490,9 +810,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   c = new double[this->NumberOfIterations+1];
   cprime = new double[this->NumberOfIterations+1];
 
-  double zerovector[3];
-  zerovector[0] = zerovector[1] = zerovector[2] = 0.0;
-
   //
   // Calculate the weights and the Chebychev coefficients c.
   //
@@ -578,54 +895,17 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     vtkErrorMacro(<< "An optimal offset for the smoothing filter could not be found.  Unpredictable smoothing/shrinkage may result.");
     }
 
-  // first iteration
-  for (i=0; i<numPts; i++)
+  float *coords[4];
+  for (i=0; i<4; i++)
     {
-    if ( Verts[i].edges != NULL &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-      {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-        {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-          {
-          deltaX[k] += (x[k] - y[k]) / npts;
-          }
-        }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-        {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-        }
-      newPts[one]->SetPoint(i, deltaX);
+    coords[i] = static_cast<float*>(newPts[i]->GetVoidPointer(0));
+    }
 
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-        {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-        }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-        {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-        }
-      else
-        {
-        newPts[three]->SetPoint(i, deltaX);
-        }
-      }//if can move point
-    else
-      {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-    }//for all points
+  // first iteration
+  vtkWindowedSincFirstIteration firstIteration(
+    &types[0], &edgeOffsets[0], &edgeIds[0], coords[zero], coords[one],
+    coords[three], c);
+  vtkSMPTools::For(0, numPts, firstIteration);
 
   // for the rest of the iterations
   for ( iterationNumber=2;
@@ -641,53 +921,10 @@ int vtkWindowedSincPolyDataFilter::RequestData(
         }
       }
 
-    for (i=0; i<numPts; i++)
-      {
-      if ( Verts[i].edges != NULL &&
-           (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-        {
-        // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
-          {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-            {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
-            }
-          }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
-        for (k=0; k<3; k++)
-          {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
-          }
-        newPts[two]->SetPoint(i, deltaX);
-
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
-          {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
-          }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
-          {
-          newPts[three]->SetPoint(i,xNew);
-          }
-        }//if can move point
-      else
-        {
-        // point is not allowed to move, just use the old point...
-        // (zero out the Laplacian)
-        newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
-        }
-      }//for all points
+    vtkWindowedSincIteration iteration(
+      &types[0], &edgeOffsets[0], &edgeIds[0], coords[zero], coords[one],
+      coords[two], coords[three], c[iterationNumber]);
+    vtkSMPTools::For(0, numPts, iteration);
 
     // update the pointers. three is always three. all other pointers
     // shift by one and wrap.
@@ -780,14 +1017,10 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   output->SetStrips(input->GetStrips());
 
   // finally delete the constructed (local) mesh
-  inMesh->Delete();
-
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
+  if (inMesh)
     {
-    if ( Verts[i].edges != NULL ) {Verts[i].edges->Delete();}
+    inMesh->Delete();
     }
-  delete [] Verts;
 
   return 1;
 }
@@ -22,6 +22,7 @@
 #include "vtkDoubleArray.h"
 #include "vtkGradientFilter.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkSmartPointer.h"
 #include "vtkStdString.h"
 #include "vtkStructuredGrid.h"
@@ -64,6 +65,19 @@ namespace
     return false;
   }
 
+//-----------------------------------------------------------------------------
+// values averaged from the cells to the points only match up to round-off
+  bool AreValuesWithinRoundOff(double v1, double v2)
+  {
+    if(fabs(v1-v2) <= Tolerance*(1.+fabs(v1)+fabs(v2)))
+      {
+      return true;
+      }
+    std::cout << fabs(v1-v2) << " (fabs(v1-v2)) should be within round-off"
+              << std::endl;
+    return false;
+  }
+
 //-----------------------------------------------------------------------------
   void CreateCellData(vtkDataSet* grid, int numberOfComponents, int offset,
                       const char* arrayName)
@@ -148,7 +162,9 @@ namespace
 //-----------------------------------------------------------------------------
 // we assume that the gradients are correct and so we can compute the "real"
 // vorticity from it
-  int IsVorticityCorrect(vtkDoubleArray* gradients, vtkDoubleArray* vorticity)
+  int IsVorticityCorrect(vtkDoubleArray* gradients, vtkDoubleArray* vorticity,
+                         bool (*areEqual)(double, double) =
+                         ArePointsWithinTolerance)
   {
     if(gradients->GetNumberOfComponents() != 9 ||
        vorticity->GetNumberOfComponents() != 3)
@@ -160,19 +176,19 @@ namespace
       {
       double* g = gradients->GetTuple(i);
       double* v = vorticity->GetTuple(i);
-      if(!ArePointsWithinTolerance(v[0], g[7]-g[5]))
+      if(!areEqual(v[0], g[7]-g[5]))
         {
         vtkGenericWarningMacro("Bad vorticity[0] value " << v[0] << " " <<
                                g[7]-g[5] << " difference is " << (v[0]-g[7]+g[5]));
         return 0;
         }
-      else if(!ArePointsWithinTolerance(v[1], g[2]-g[6]))
+      else if(!areEqual(v[1], g[2]-g[6]))
         {
         vtkGenericWarningMacro("Bad vorticity[1] value " << v[1] << " " <<
                                g[2]-g[6] << " difference is " << (v[1]-g[2]+g[6]));
         return 0;
         }
-      else if(!ArePointsWithinTolerance(v[2], g[3]-g[1]))
+      else if(!areEqual(v[2], g[3]-g[1]))
         {
         vtkGenericWarningMacro("Bad vorticity[2] value " << v[2] << " " <<
                                g[3]-g[1] << " difference is " << (v[2]-g[3]+g[1]));
@@ -186,7 +202,9 @@ namespace
 //-----------------------------------------------------------------------------
 // we assume that the gradients are correct and so we can compute the "real"
 // vorticity from it
-  int IsQCriterionCorrect(vtkDoubleArray* gradients, vtkDoubleArray* qCriterion)
+  int IsQCriterionCorrect(vtkDoubleArray* gradients, vtkDoubleArray* qCriterion,
+                          bool (*areEqual)(double, double) =
+                          ArePointsWithinTolerance)
   {
     if(gradients->GetNumberOfComponents() != 9 ||
        qCriterion->GetNumberOfComponents() != 1)
@@ -209,7 +227,7 @@ namespace
                            (g[6]+g[2])*(g[6]+g[2]) +
                            (g[7]+g[5])*(g[7]+g[5]) ) );
 
-      if(!ArePointsWithinTolerance(qc, t1 - t2))
+      if(!areEqual(qc, t1 - t2))
         {
         vtkGenericWarningMacro("Bad Q-criterion value " << qc << " " <<
                                t1-t2 << " difference is " << (qc-t1+t2));
@@ -272,6 +290,53 @@ namespace
       return EXIT_FAILURE;
       }
 
+    // the cached derivative operators must give the same gradients,
+    // including when they are reused by a second execution
+    VTK_CREATE(vtkGradientFilter, cachedGradients);
+    cachedGradients->SetInputData(grid);
+    cachedGradients->SetInputScalars(
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, fieldName);
+    cachedGradients->SetResultArrayName(resultName);
+    cachedGradients->CacheDerivativeOperatorsOn();
+    for(int execution=0;execution<2;execution++)
+      {
+      cachedGradients->Modified();
+      cachedGradients->Update();
+      vtkDoubleArray* gradCachedArray = vtkDoubleArray::SafeDownCast(
+        vtkDataSet::SafeDownCast(
+          cachedGradients->GetOutput())->GetPointData()->GetArray(resultName));
+      if(!IsGradientCorrect(gradCachedArray, offset))
+        {
+        return EXIT_FAILURE;
+        }
+      }
+
+    // moving the points must rebuild the cached operators: scale a copy
+    // of the grid after a cached execution and recompute the field on it
+    vtkSmartPointer<vtkDataSet> scaledGrid;
+    scaledGrid.TakeReference(grid->NewInstance());
+    scaledGrid->DeepCopy(grid);
+    cachedGradients->SetInputData(scaledGrid);
+    cachedGradients->Update();
+    vtkPoints* points = vtkPointSet::SafeDownCast(scaledGrid)->GetPoints();
+    double point[3];
+    for(vtkIdType i=0;i<points->GetNumberOfPoints();i++)
+      {
+      points->GetPoint(i, point);
+      points->SetPoint(i, 2.*point[0], 3.*point[1], 0.5*point[2]);
+      }
+    points->Modified();
+    scaledGrid->GetPointData()->Initialize();
+    CreatePointData(scaledGrid, numberOfComponents, offset, fieldName);
+    cachedGradients->Update();
+    vtkDoubleArray* gradScaledArray = vtkDoubleArray::SafeDownCast(
+      vtkDataSet::SafeDownCast(
+        cachedGradients->GetOutput())->GetPointData()->GetArray(resultName));
+    if(!IsGradientCorrect(gradScaledArray, offset))
+      {
+      return EXIT_FAILURE;
+      }
+
     if(numberOfComponents == 3)
       {
       // now check on the vorticity calculations
@@ -318,6 +383,42 @@ namespace
         {
         return EXIT_FAILURE;
         }
+
+      // the faster approximation computes the vorticity and Q-criterion at
+      // the cells and then converts them to the points like the gradients
+      VTK_CREATE(vtkGradientFilter, fasterVorticity);
+      fasterVorticity->SetInputData(grid);
+      fasterVorticity->SetInputScalars(
+        vtkDataObject::FIELD_ASSOCIATION_POINTS, fieldName);
+      fasterVorticity->SetResultArrayName(resultName);
+      fasterVorticity->SetFasterApproximation(1);
+      fasterVorticity->SetComputeVorticity(1);
+      fasterVorticity->SetComputeQCriterion(1);
+      fasterVorticity->Update();
+
+      vtkPointData* fasterPointData = vtkDataSet::SafeDownCast(
+        fasterVorticity->GetOutput())->GetPointData();
+      vtkDoubleArray* gradFasterArray = vtkDoubleArray::SafeDownCast(
+        fasterPointData->GetArray(resultName));
+      vtkDoubleArray* vorticityFasterArray = vtkDoubleArray::SafeDownCast(
+        fasterPointData->GetArray("Vorticity"));
+      vtkDoubleArray* qCriterionFasterArray = vtkDoubleArray::SafeDownCast(
+        fasterPointData->GetArray("Q-criterion"));
+      if(!vorticityFasterArray || !qCriterionFasterArray ||
+         vorticityFasterArray->GetNumberOfTuples() != grid->GetNumberOfPoints() ||
+         qCriterionFasterArray->GetNumberOfTuples() != grid->GetNumberOfPoints())
+        {
+        vtkGenericWarningMacro("Bad faster approximation vorticity arrays.");
+        return EXIT_FAILURE;
+        }
+      if(!IsGradientCorrect(gradFasterArray, offset) ||
+         !IsVorticityCorrect(gradFasterArray, vorticityFasterArray,
+                             AreValuesWithinRoundOff) ||
+         !IsQCriterionCorrect(gradFasterArray, qCriterionFasterArray,
+                              AreValuesWithinRoundOff))
+        {
+        return EXIT_FAILURE;
+        }
       }
 
     return EXIT_SUCCESS;
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataStreamer.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Streams the contour of a wavelet with a memory limit and checks that the
+// number of pieces has been increased until each piece fits, and that the
+// appended output matches the one streamed with that number of pieces.
+
+#include <vtkPolyDataStreamer.h>
+
+#include <vtkContourFilter.h>
+#include <vtkPolyData.h>
+#include <vtkRTAnalyticSource.h>
+
+#include <vtkNew.h>
+
+int TestPolyDataStreamer(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-32, 31, -32, 31, -32, 31);
+
+  vtkNew<vtkContourFilter> contour;
+  contour->SetInputConnection(wavelet->GetOutputPort());
+  contour->SetValue(0, 151.3);
+  contour->Update();
+  vtkIdType numCells = contour->GetOutput()->GetNumberOfCells();
+
+  vtkNew<vtkPolyDataStreamer> reference;
+  reference->SetInputConnection(contour->GetOutputPort());
+  reference->SetNumberOfStreamDivisions(1);
+  reference->Update();
+  vtkPolyData *output =
+    vtkPolyData::SafeDownCast(reference->GetOutputDataObject(0));
+  if (reference->GetActualNumberOfStreamDivisions() != 1 ||
+      output->GetNumberOfCells() != numCells)
+    {
+    std::cout << "Unexpected output without a memory limit." << std::endl;
+    return EXIT_FAILURE;
+    }
+  unsigned long size = reference->GetUpstreamMemorySize();
+
+  // Stream a pipeline that never produced the whole data, the sources keep
+  // the capacity of their arrays from one execution to the next.
+  vtkNew<vtkRTAnalyticSource> streamedWavelet;
+  streamedWavelet->SetWholeExtent(-32, 31, -32, 31, -32, 31);
+
+  vtkNew<vtkContourFilter> streamedContour;
+  streamedContour->SetInputConnection(streamedWavelet->GetOutputPort());
+  streamedContour->SetValue(0, 151.3);
+
+  vtkNew<vtkPolyDataStreamer> streamer;
+  streamer->SetInputConnection(streamedContour->GetOutputPort());
+  streamer->SetNumberOfStreamDivisions(1);
+  streamer->SetMemoryLimit(size / 4);
+  streamer->Update();
+
+  int divisions = streamer->GetActualNumberOfStreamDivisions();
+  if (divisions < 4)
+    {
+    std::cout << "Expected at least 4 stream divisions for a quarter of "
+              << size << " KiB, got " << divisions << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (streamer->GetNumberOfStreamDivisions() != 1)
+    {
+    std::cout << "The requested number of stream divisions was changed to "
+              << streamer->GetNumberOfStreamDivisions() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (streamer->GetUpstreamMemorySize() > streamer->GetMemoryLimit())
+    {
+    std::cout << "The last piece uses " << streamer->GetUpstreamMemorySize()
+              << " KiB, more than the limit." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  reference->SetNumberOfStreamDivisions(divisions);
+  reference->Update();
+  numCells = output->GetNumberOfCells();
+  output = vtkPolyData::SafeDownCast(streamer->GetOutputDataObject(0));
+  if (output->GetNumberOfCells() != numCells)
+    {
+    std::cout << "Expected " << numCells << " cells, got "
+              << output->GetNumberOfCells() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The number of divisions found is reused.
+  streamedWavelet->Modified();
+  streamer->Update();
+  if (streamer->GetActualNumberOfStreamDivisions() != divisions)
+    {
+    std::cout << "The number of stream divisions changed from " << divisions
+              << " to " << streamer->GetActualNumberOfStreamDivisions()
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSet.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Clips a wavelet large enough to be split into several batches of cells
+// and checks that the edge points shared by the batches have been merged,
+// and that clipping in small batches gives the same output as one batch.
+
+#include <vtkTableBasedClipDataSet.h>
+
+#include <vtkAppendFilter.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkImageDataToPointSet.h>
+#include <vtkMergePoints.h>
+#include <vtkPoints.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <vtkNew.h>
+
+namespace
+{
+vtkIdType CountDuplicatePoints(vtkUnstructuredGrid *output)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkMergePoints> locator;
+  locator->InitPointInsertion(points.GetPointer(), output->GetBounds());
+
+  vtkIdType duplicates = 0;
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); i++)
+    {
+    vtkIdType id;
+    if (!locator->InsertUniquePoint(output->GetPoint(i), id))
+      {
+      duplicates++;
+      }
+    }
+  return duplicates;
+}
+
+bool SameOutput(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    double pa[3], pb[3];
+    a->GetPoint(i, pa);
+    b->GetPoint(i, pb);
+    if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2])
+      {
+      return false;
+      }
+    }
+  vtkIdTypeArray *ca = a->GetCells()->GetData();
+  vtkIdTypeArray *cb = b->GetCells()->GetData();
+  if (ca->GetNumberOfTuples() != cb->GetNumberOfTuples())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < ca->GetNumberOfTuples(); i++)
+    {
+    if (ca->GetValue(i) != cb->GetValue(i))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+bool CheckClip(vtkAlgorithmOutput *input, const char *name,
+               vtkIdType &numPoints, vtkIdType &numCells)
+{
+  vtkNew<vtkTableBasedClipDataSet> clipper;
+  clipper->SetInputConnection(input);
+  clipper->SetValue(151.3);
+  clipper->Update();
+
+  vtkUnstructuredGrid *output = clipper->GetOutput();
+  numPoints = output->GetNumberOfPoints();
+  numCells = output->GetNumberOfCells();
+  if (numCells == 0)
+    {
+    std::cout << name << ": no cells in the output." << std::endl;
+    return false;
+    }
+
+  vtkIdType duplicates = CountDuplicatePoints(output);
+  if (duplicates != 0)
+    {
+    std::cout << name << ": " << duplicates << " duplicate points out of "
+              << numPoints << std::endl;
+    return false;
+    }
+
+  // Force many batches, whatever the number of threads, so that their
+  // points are merged.
+  vtkNew<vtkTableBasedClipDataSet> batchClipper;
+  batchClipper->SetInputConnection(input);
+  batchClipper->SetValue(151.3);
+  batchClipper->SetBatchSize(997);
+  batchClipper->Update();
+  if (!SameOutput(output, batchClipper->GetOutput()))
+    {
+    std::cout << name << ": clipping in batches of 997 cells changed the "
+              << "output." << std::endl;
+    return false;
+    }
+
+  return true;
+}
+}
+
+int TestTableBasedClipDataSet(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-32, 31, -32, 31, -32, 31);
+
+  vtkNew<vtkImageDataToPointSet> image2points;
+  image2points->SetInputConnection(wavelet->GetOutputPort());
+
+  vtkNew<vtkAppendFilter> image2grid;
+  image2grid->SetInputConnection(wavelet->GetOutputPort());
+
+  vtkIdType imagePoints, imageCells;
+  vtkIdType structuredPoints, structuredCells;
+  vtkIdType unstructuredPoints, unstructuredCells;
+  if (!CheckClip(wavelet->GetOutputPort(), "vtkImageData",
+                 imagePoints, imageCells) ||
+      !CheckClip(image2points->GetOutputPort(), "vtkStructuredGrid",
+                 structuredPoints, structuredCells) ||
+      !CheckClip(image2grid->GetOutputPort(), "vtkUnstructuredGrid",
+                 unstructuredPoints, unstructuredCells))
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (imagePoints != structuredPoints || imageCells != structuredCells)
+    {
+    std::cout << "Image and structured grid clips differ: "
+              << imagePoints << "/" << imageCells << " vs "
+              << structuredPoints << "/" << structuredCells << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -21,11 +21,14 @@
 #include "vtkGradientFilter.h"
 
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellDataToPointData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -34,11 +37,16 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <list>
+#include <utility>
 #include <vector>
 
 //-----------------------------------------------------------------------------
@@ -74,19 +82,9 @@ namespace
   }
 
   // Functions for unstructured grids and polydatas
-  template<class data_type>
-  void ComputePointGradientsUG(
-    vtkDataSet *structure, data_type *array, data_type *gradients,
-    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion);
-
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
-    double parametricCoord[3]);
-
-  template<class data_type>
-  void ComputeCellGradientsUG(
-    vtkDataSet *structure, data_type *array, data_type *gradients,
-    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion);
+    double parametricCoord[3], std::vector<double>& weights);
 
   // Functions for image data and structured grids
   template<class Grid, class data_type>
@@ -128,6 +126,599 @@ namespace
   }
 } // end anonymous namespace
 
+//-----------------------------------------------------------------------------
+// The derivative operators of the points or of the cells of a data set.
+// The gradient of a field at entity e (a point or a cell) is the sum of the
+// values of the field at the points Ids[k] multiplied by the weights
+// Weights[3*k] to Weights[3*k+2], for k in [Offsets[e], Offsets[e+1]).
+// The operators only depend on the geometry and topology of the data set,
+// so they can be reused for all the components of all the arrays.
+class vtkGradientFilterOperators
+{
+public:
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Ids;
+  std::vector<double> Weights;
+
+  // Description:
+  // Return true if the operators were computed for the structure of input.
+  bool IsValid(vtkDataSet* input)
+  {
+    if (this->Offsets.empty())
+      {
+      return false;
+      }
+    std::vector<std::pair<vtkObject*, unsigned long> > structure;
+    vtkGradientFilterOperators::GetStructure(input, structure);
+    return structure == this->Structure;
+  }
+
+  // Description:
+  // Record the structure of input the operators are computed for.
+  void SetStructure(vtkDataSet* input)
+  {
+    vtkGradientFilterOperators::GetStructure(input, this->Structure);
+  }
+
+  void Clear()
+  {
+    std::vector<vtkIdType>().swap(this->Offsets);
+    std::vector<vtkIdType>().swap(this->Ids);
+    std::vector<double>().swap(this->Weights);
+    this->Structure.clear();
+  }
+
+private:
+  // The objects holding the points and cells of input, with their
+  // modification times. Data sets that are neither a vtkPolyData nor a
+  // vtkUnstructuredGrid are identified by their own modification time.
+  static void GetStructure(
+    vtkDataSet* input, std::vector<std::pair<vtkObject*, unsigned long> >& s)
+  {
+    s.clear();
+    vtkGradientFilterOperators::AddCount(s, input->GetNumberOfPoints());
+    vtkGradientFilterOperators::AddCount(s, input->GetNumberOfCells());
+    if (vtkUnstructuredGrid* grid = vtkUnstructuredGrid::SafeDownCast(input))
+      {
+      vtkGradientFilterOperators::AddObject(s, grid->GetPoints());
+      vtkGradientFilterOperators::AddCells(s, grid->GetCells());
+      vtkGradientFilterOperators::AddObject(s, grid->GetCellTypesArray());
+      vtkGradientFilterOperators::AddObject(s, grid->GetFaces());
+      }
+    else if (vtkPolyData* polyData = vtkPolyData::SafeDownCast(input))
+      {
+      vtkGradientFilterOperators::AddObject(s, polyData->GetPoints());
+      vtkGradientFilterOperators::AddCells(s, polyData->GetVerts());
+      vtkGradientFilterOperators::AddCells(s, polyData->GetLines());
+      vtkGradientFilterOperators::AddCells(s, polyData->GetPolys());
+      vtkGradientFilterOperators::AddCells(s, polyData->GetStrips());
+      }
+    else
+      {
+      vtkGradientFilterOperators::AddObject(s, input);
+      }
+  }
+
+  static void AddObject(
+    std::vector<std::pair<vtkObject*, unsigned long> >& s, vtkObject* object)
+  {
+    s.push_back(std::make_pair(object, object ? object->GetMTime() : 0));
+  }
+
+  static void AddCount(
+    std::vector<std::pair<vtkObject*, unsigned long> >& s, vtkIdType count)
+  {
+    s.push_back(std::make_pair(static_cast<vtkObject*>(NULL),
+                               static_cast<unsigned long>(count)));
+  }
+
+  static void AddCells(
+    std::vector<std::pair<vtkObject*, unsigned long> >& s, vtkCellArray* cells)
+  {
+    vtkGradientFilterOperators::AddObject(s, cells);
+    vtkGradientFilterOperators::AddObject(s, cells ? cells->GetData() : NULL);
+  }
+
+  std::vector<std::pair<vtkObject*, unsigned long> > Structure;
+};
+
+namespace
+{
+//-----------------------------------------------------------------------------
+// One vtkGenericCell per cell type, so that a thread processing cells of
+// different types does not instantiate a new cell each time the type
+// changes. The cells are not copied.
+class vtkGradientFilterCells
+{
+public:
+  vtkGradientFilterCells()
+  {
+  }
+  vtkGradientFilterCells(const vtkGradientFilterCells&)
+  {
+  }
+  vtkGradientFilterCells& operator=(const vtkGradientFilterCells&)
+  {
+    return *this;
+  }
+  ~vtkGradientFilterCells()
+  {
+    for (size_t i = 0; i < this->Cells.size(); i++)
+      {
+      if (this->Cells[i])
+        {
+        this->Cells[i]->Delete();
+        }
+      }
+  }
+
+  vtkCell* GetCell(vtkDataSet* input, vtkIdType cellId)
+  {
+    size_t type = static_cast<size_t>(input->GetCellType(cellId));
+    if (type >= this->Cells.size())
+      {
+      this->Cells.resize(type + 1, NULL);
+      }
+    if (!this->Cells[type])
+      {
+      this->Cells[type] = vtkGenericCell::New();
+      }
+    input->GetCell(cellId, this->Cells[type]);
+    return this->Cells[type];
+  }
+
+private:
+  std::vector<vtkGenericCell*> Cells;
+};
+
+//-----------------------------------------------------------------------------
+// Buffers used by a thread to compute the operator of a point or a cell.
+struct vtkGradientFilterScratch
+{
+  vtkGradientFilterCells Cells;
+  std::vector<double> Identity;
+  std::vector<double> Derivatives;
+  std::vector<double> Weights;
+  // The operator of the current point or cell.
+  std::vector<vtkIdType> OperatorIds;
+  std::vector<double> OperatorWeights;
+  std::vector<double> Gradient;
+};
+
+//-----------------------------------------------------------------------------
+// Compute the derivatives of the interpolation functions of cell at
+// parametric coordinates pcoords, three per point of the cell. Returns NULL
+// if the cell has no points.
+const double* vtkGradientFilterCellDerivatives(
+  vtkCell* cell, int subId, double pcoords[3],
+  vtkGradientFilterScratch& scratch)
+{
+  int numPts = cell->GetNumberOfPoints();
+  if (numPts <= 0)
+    {
+    return NULL;
+    }
+  // The derivatives of the identity are the derivatives of the
+  // interpolation functions: point i is component i.
+  scratch.Identity.assign(numPts * numPts, 0.0);
+  for (int i = 0; i < numPts; i++)
+    {
+    scratch.Identity[i * numPts + i] = 1.0;
+    }
+  // vtkPolyhedron::Derivatives() clears dim*dim values.
+  scratch.Derivatives.resize(numPts * numPts + 3 * numPts);
+  cell->Derivatives(subId, pcoords, &scratch.Identity[0], numPts,
+                    &scratch.Derivatives[0]);
+  return &scratch.Derivatives[0];
+}
+
+//-----------------------------------------------------------------------------
+// Computes the derivative operator of a point or a cell in
+// vtkGradientFilterScratch::OperatorIds and OperatorWeights.
+class vtkGradientFilterOperatorBuilder
+{
+public:
+  vtkGradientFilterOperatorBuilder(vtkDataSet* input) : DataSet(input)
+  {
+  }
+  virtual ~vtkGradientFilterOperatorBuilder()
+  {
+  }
+
+  virtual vtkIdType GetNumberOfEntities() = 0;
+  virtual void Build(vtkIdType id, vtkGradientFilterScratch& scratch) = 0;
+
+  // Description:
+  // Build what GetCell() builds on demand, which is not thread safe.
+  void Initialize()
+  {
+    if (this->DataSet->GetNumberOfCells() > 0)
+      {
+      vtkSmartPointer<vtkGenericCell> cell =
+        vtkSmartPointer<vtkGenericCell>::New();
+      this->DataSet->GetCell(0, cell);
+      }
+  }
+
+protected:
+  vtkDataSet* DataSet;
+};
+
+//-----------------------------------------------------------------------------
+// The operator of a point is the average over the cells using the point of
+// the derivatives of their interpolation functions at the point.
+class vtkGradientFilterPointOperatorBuilder
+  : public vtkGradientFilterOperatorBuilder
+{
+public:
+  // Description:
+  // Build the links from the points to the cells using them.
+  vtkGradientFilterPointOperatorBuilder(vtkDataSet* input)
+    : vtkGradientFilterOperatorBuilder(input)
+  {
+    vtkIdType numPts = input->GetNumberOfPoints();
+    vtkIdType numCells = input->GetNumberOfCells();
+    vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+    this->LinkOffsets.assign(numPts + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+      {
+      std::vector<vtkIdType> next(this->LinkOffsets);
+      for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+        {
+        input->GetCellPoints(cellId, ptIds);
+        vtkIdType npts = ptIds->GetNumberOfIds();
+        vtkIdType* pts = ptIds->GetPointer(0);
+        for (vtkIdType i = 0; i < npts; i++)
+          {
+          // A degenerate cell is linked once to its repeated points.
+          if (std::find(pts, pts + i, pts[i]) != pts + i)
+            {
+            continue;
+            }
+          if (pass == 0)
+            {
+            this->LinkOffsets[pts[i] + 1]++;
+            }
+          else
+            {
+            this->Links[next[pts[i]]++] = cellId;
+            }
+          }
+        }
+      if (pass == 0)
+        {
+        for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+          {
+          this->LinkOffsets[ptId + 1] += this->LinkOffsets[ptId];
+          }
+        this->Links.resize(this->LinkOffsets[numPts]);
+        }
+      }
+  }
+
+  virtual vtkIdType GetNumberOfEntities()
+  {
+    return this->DataSet->GetNumberOfPoints();
+  }
+
+  virtual void Build(vtkIdType ptId, vtkGradientFilterScratch& scratch)
+  {
+    std::vector<vtkIdType>& ids = scratch.OperatorIds;
+    std::vector<double>& weights = scratch.OperatorWeights;
+    ids.clear();
+    weights.clear();
+    vtkIdType firstLink = this->LinkOffsets[ptId];
+    vtkIdType numCells = this->LinkOffsets[ptId + 1] - firstLink;
+    if (numCells == 0)
+      {
+      return;
+      }
+    double x[3];
+    this->DataSet->GetPoint(ptId, x);
+    for (vtkIdType link = firstLink; link < firstLink + numCells; link++)
+      {
+      vtkCell* cell =
+        scratch.Cells.GetCell(this->DataSet, this->Links[link]);
+      int subId;
+      double pcoords[3];
+      if (!GetCellParametricData(ptId, x, cell, subId, pcoords,
+                                 scratch.Weights))
+        {
+        continue;
+        }
+      const double* derivs =
+        vtkGradientFilterCellDerivatives(cell, subId, pcoords, scratch);
+      if (!derivs)
+        {
+        continue;
+        }
+      // The points shared by several cells appear once in the operator.
+      int numCellPts = cell->GetNumberOfPoints();
+      for (int i = 0; i < numCellPts; i++)
+        {
+        vtkIdType id = cell->GetPointId(i);
+        size_t k = std::find(ids.begin(), ids.end(), id) - ids.begin();
+        if (k == ids.size())
+          {
+          ids.push_back(id);
+          weights.resize(weights.size() + 3, 0.0);
+          }
+        for (int j = 0; j < 3; j++)
+          {
+          weights[3 * k + j] += derivs[3 * i + j] / numCells;
+          }
+        }
+      }
+  }
+
+private:
+  // The cells using point ptId are Links[LinkOffsets[ptId]] to
+  // Links[LinkOffsets[ptId + 1] - 1].
+  std::vector<vtkIdType> LinkOffsets;
+  std::vector<vtkIdType> Links;
+};
+
+//-----------------------------------------------------------------------------
+// The operator of a cell is the derivatives of its interpolation functions
+// at its parametric center.
+class vtkGradientFilterCellOperatorBuilder
+  : public vtkGradientFilterOperatorBuilder
+{
+public:
+  vtkGradientFilterCellOperatorBuilder(vtkDataSet* input)
+    : vtkGradientFilterOperatorBuilder(input)
+  {
+  }
+
+  virtual vtkIdType GetNumberOfEntities()
+  {
+    return this->DataSet->GetNumberOfCells();
+  }
+
+  virtual void Build(vtkIdType cellId, vtkGradientFilterScratch& scratch)
+  {
+    scratch.OperatorIds.clear();
+    scratch.OperatorWeights.clear();
+    vtkCell* cell = scratch.Cells.GetCell(this->DataSet, cellId);
+    double pcoords[3];
+    int subId = cell->GetParametricCenter(pcoords);
+    const double* derivs =
+      vtkGradientFilterCellDerivatives(cell, subId, pcoords, scratch);
+    if (!derivs)
+      {
+      return;
+      }
+    int numPts = cell->GetNumberOfPoints();
+    for (int i = 0; i < numPts; i++)
+      {
+      scratch.OperatorIds.push_back(cell->GetPointId(i));
+      }
+    scratch.OperatorWeights.assign(derivs, derivs + 3 * numPts);
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Computes the operators of all the points or cells of a data set in
+// parallel. Each range of entities processed by a thread is kept in a
+// chunk, and Reduce() concatenates the chunks in order.
+class vtkGradientFilterBuildOperators
+{
+public:
+  vtkGradientFilterBuildOperators(vtkGradientFilterOperatorBuilder* builder,
+                                  vtkGradientFilterOperators* operators)
+    : Builder(builder), Operators(operators)
+  {
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGradientFilterScratch& scratch = this->Scratch.Local();
+    std::list<Chunk>& chunks = this->Chunks.Local();
+    chunks.push_back(Chunk());
+    Chunk& chunk = chunks.back();
+    chunk.Begin = begin;
+    chunk.Counts.reserve(end - begin);
+    for (vtkIdType id = begin; id < end; id++)
+      {
+      this->Builder->Build(id, scratch);
+      chunk.Counts.push_back(
+        static_cast<vtkIdType>(scratch.OperatorIds.size()));
+      chunk.Ids.insert(chunk.Ids.end(), scratch.OperatorIds.begin(),
+                       scratch.OperatorIds.end());
+      chunk.Weights.insert(chunk.Weights.end(),
+                           scratch.OperatorWeights.begin(),
+                           scratch.OperatorWeights.end());
+      }
+  }
+
+  void Reduce()
+  {
+    std::vector<Chunk*> chunks;
+    size_t numIds = 0;
+    vtkSMPThreadLocal<std::list<Chunk> >::iterator iter;
+    for (iter = this->Chunks.begin(); iter != this->Chunks.end(); ++iter)
+      {
+      for (std::list<Chunk>::iterator chunk = iter->begin();
+           chunk != iter->end(); ++chunk)
+        {
+        chunks.push_back(&*chunk);
+        numIds += chunk->Ids.size();
+        }
+      }
+    std::sort(chunks.begin(), chunks.end(), Chunk::IsBefore);
+
+    vtkGradientFilterOperators* operators = this->Operators;
+    operators->Offsets.assign(1, 0);
+    operators->Offsets.reserve(this->Builder->GetNumberOfEntities() + 1);
+    operators->Ids.clear();
+    operators->Ids.reserve(numIds);
+    operators->Weights.clear();
+    operators->Weights.reserve(3 * numIds);
+    for (size_t c = 0; c < chunks.size(); c++)
+      {
+      Chunk* chunk = chunks[c];
+      for (size_t i = 0; i < chunk->Counts.size(); i++)
+        {
+        operators->Offsets.push_back(
+          operators->Offsets.back() + chunk->Counts[i]);
+        }
+      operators->Ids.insert(operators->Ids.end(), chunk->Ids.begin(),
+                            chunk->Ids.end());
+      operators->Weights.insert(operators->Weights.end(),
+                                chunk->Weights.begin(), chunk->Weights.end());
+      // Release the memory of the chunk as soon as it is copied.
+      Chunk().Swap(*chunk);
+      }
+  }
+
+private:
+  struct Chunk
+  {
+    vtkIdType Begin;
+    std::vector<vtkIdType> Counts;
+    std::vector<vtkIdType> Ids;
+    std::vector<double> Weights;
+
+    void Swap(Chunk& other)
+    {
+      std::swap(this->Begin, other.Begin);
+      this->Counts.swap(other.Counts);
+      this->Ids.swap(other.Ids);
+      this->Weights.swap(other.Weights);
+    }
+
+    static bool IsBefore(const Chunk* a, const Chunk* b)
+    {
+      return a->Begin < b->Begin;
+    }
+  };
+
+  vtkGradientFilterOperatorBuilder* Builder;
+  vtkGradientFilterOperators* Operators;
+  vtkSMPThreadLocal<vtkGradientFilterScratch> Scratch;
+  vtkSMPThreadLocal<std::list<Chunk> > Chunks;
+};
+
+//-----------------------------------------------------------------------------
+// Computes the gradients (and optionally the vorticity and the Q criterion)
+// at the points or cells of a data set, in parallel. The operators are
+// read from Operators if it is not NULL, otherwise they are computed by
+// Builder for each point or cell.
+template<class data_type>
+class vtkGradientFilterComputeGradients
+{
+public:
+  vtkGradientFilterComputeGradients(
+    vtkGradientFilterOperatorBuilder* builder,
+    const vtkGradientFilterOperators* operators, data_type* array,
+    data_type* gradients, int numberOfInputComponents, data_type* vorticity,
+    data_type* qCriterion)
+    : Builder(builder), Operators(operators), Array(array),
+      Gradients(gradients), NumberOfInputComponents(numberOfInputComponents),
+      Vorticity(vorticity), QCriterion(qCriterion)
+  {
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGradientFilterScratch& scratch = this->Scratch.Local();
+    int numComp = this->NumberOfInputComponents;
+    std::vector<double>& g = scratch.Gradient;
+    g.resize(3 * numComp);
+    for (vtkIdType id = begin; id < end; id++)
+      {
+      const vtkIdType* ids = NULL;
+      const double* weights = NULL;
+      vtkIdType numIds = 0;
+      if (this->Operators)
+        {
+        vtkIdType offset = this->Operators->Offsets[id];
+        numIds = this->Operators->Offsets[id + 1] - offset;
+        if (numIds > 0)
+          {
+          ids = &this->Operators->Ids[offset];
+          weights = &this->Operators->Weights[3 * offset];
+          }
+        }
+      else
+        {
+        this->Builder->Build(id, scratch);
+        numIds = static_cast<vtkIdType>(scratch.OperatorIds.size());
+        if (numIds > 0)
+          {
+          ids = &scratch.OperatorIds[0];
+          weights = &scratch.OperatorWeights[0];
+          }
+        }
+
+      std::fill(g.begin(), g.end(), 0.0);
+      for (vtkIdType k = 0; k < numIds; k++)
+        {
+        const data_type* values = this->Array + ids[k] * numComp;
+        const double* w = weights + 3 * k;
+        for (int comp = 0; comp < numComp; comp++)
+          {
+          double value = static_cast<double>(values[comp]);
+          g[3 * comp] += w[0] * value;
+          g[3 * comp + 1] += w[1] * value;
+          g[3 * comp + 2] += w[2] * value;
+          }
+        }
+
+      data_type* gradient = this->Gradients + 3 * numComp * id;
+      for (int i = 0; i < 3 * numComp; i++)
+        {
+        gradient[i] = static_cast<data_type>(g[i]);
+        }
+      if (this->Vorticity)
+        {
+        ComputeVorticityFromGradient(gradient, this->Vorticity + 3 * id);
+        }
+      if (this->QCriterion)
+        {
+        ComputeQCriterionFromGradient(gradient, this->QCriterion + id);
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  vtkGradientFilterOperatorBuilder* Builder;
+  const vtkGradientFilterOperators* Operators;
+  data_type* Array;
+  data_type* Gradients;
+  int NumberOfInputComponents;
+  data_type* Vorticity;
+  data_type* QCriterion;
+  vtkSMPThreadLocal<vtkGradientFilterScratch> Scratch;
+};
+
+//-----------------------------------------------------------------------------
+template<class data_type>
+void ComputeGradientsUG(
+  vtkGradientFilterOperatorBuilder* builder,
+  const vtkGradientFilterOperators* operators, vtkIdType numberOfEntities,
+  data_type *array, data_type *gradients, int numberOfInputComponents,
+  data_type* vorticity, data_type* qCriterion)
+{
+  vtkGradientFilterComputeGradients<data_type> computeGradients(
+    builder, operators, array, gradients, numberOfInputComponents,
+    vorticity, qCriterion);
+  vtkSMPTools::For(0, numberOfEntities, computeGradients);
+}
+} // end anonymous namespace
+
 //-----------------------------------------------------------------------------
 vtkGradientFilter::vtkGradientFilter()
 {
@@ -137,6 +728,9 @@ vtkGradientFilter::vtkGradientFilter()
   this->FasterApproximation = 0;
   this->ComputeVorticity = 0;
   this->ComputeQCriterion = 0;
+  this->CacheDerivativeOperators = 0;
+  this->PointOperators = new vtkGradientFilterOperators;
+  this->CellOperators = new vtkGradientFilterOperators;
   this->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS_THEN_CELLS,
                         vtkDataSetAttributes::SCALARS);
 }
@@ -147,6 +741,8 @@ vtkGradientFilter::~vtkGradientFilter()
   this->SetResultArrayName(NULL);
   this->SetVorticityArrayName(NULL);
   this->SetQCriterionArrayName(NULL);
+  delete this->PointOperators;
+  delete this->CellOperators;
 }
 
 //-----------------------------------------------------------------------------
@@ -163,6 +759,8 @@ void vtkGradientFilter::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "FasterApproximation:" << this->FasterApproximation << endl;
   os << indent << "ComputeVorticity:" << this->ComputeVorticity << endl;
   os << indent << "ComputeQCriterion:" << this->ComputeQCriterion << endl;
+  os << indent << "CacheDerivativeOperators:"
+     << this->CacheDerivativeOperators << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -355,14 +953,54 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
       }
     }
 
+  // The derivative operators of the points, or of the cells when the
+  // gradients are computed at the cells. They are computed on the fly
+  // unless they are cached.
+  bool pointOperators =
+    fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS &&
+    !this->FasterApproximation;
+  vtkGradientFilterOperators* operators = NULL;
+  if (this->CacheDerivativeOperators)
+    {
+    operators = pointOperators ? this->PointOperators : this->CellOperators;
+    }
+  else
+    {
+    this->PointOperators->Clear();
+    this->CellOperators->Clear();
+    }
+  vtkGradientFilterOperatorBuilder* builder = NULL;
+  if (!operators || !operators->IsValid(input))
+    {
+    if (pointOperators)
+      {
+      builder = new vtkGradientFilterPointOperatorBuilder(input);
+      }
+    else
+      {
+      builder = new vtkGradientFilterCellOperatorBuilder(input);
+      }
+    builder->Initialize();
+    if (operators)
+      {
+      vtkGradientFilterBuildOperators buildOperators(builder, operators);
+      vtkSMPTools::For(0, builder->GetNumberOfEntities(), buildOperators);
+      operators->SetStructure(input);
+      delete builder;
+      builder = NULL;
+      }
+    }
+  vtkIdType numberOfEntities = pointOperators ?
+    input->GetNumberOfPoints() : input->GetNumberOfCells();
+
   if (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
     {
     if (!this->FasterApproximation)
       {
       switch (array->GetDataType())
         {
-        vtkTemplateMacro(ComputePointGradientsUG(
-                           input,
+        vtkTemplateMacro(ComputeGradientsUG(
+                           builder, operators, numberOfEntities,
                            static_cast<VTK_TT *>(array->GetVoidPointer(0)),
                            static_cast<VTK_TT *>(gradients->GetVoidPointer(0)),
                            numberOfInputComponents,
@@ -392,12 +1030,22 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
       cellGradients->SetName(gradients->GetName());
       cellGradients->SetNumberOfComponents(3*array->GetNumberOfComponents());
       cellGradients->SetNumberOfTuples(input->GetNumberOfCells());
+      // The vorticity and Q criterion are computed at the cells too.
+      if(vorticity)
+        {
+        vorticity->SetNumberOfTuples(input->GetNumberOfCells());
+        }
+      if(qCriterion)
+        {
+        qCriterion->SetNumberOfTuples(input->GetNumberOfCells());
+        }
 
       switch (array->GetDataType())
         {
         vtkTemplateMacro(
-          ComputeCellGradientsUG(
-            input, static_cast<VTK_TT *>(array->GetVoidPointer(0)),
+          ComputeGradientsUG(
+            builder, operators, numberOfEntities,
+            static_cast<VTK_TT *>(array->GetVoidPointer(0)),
             static_cast<VTK_TT *>(cellGradients->GetVoidPointer(0)),
             numberOfInputComponents,
             (vorticity == NULL ? NULL :
@@ -428,9 +1076,15 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
       vtkDataArray *pointGradients
         = cd2pd->GetOutput()->GetPointData()->GetArray(gradients->GetName());
       output->GetPointData()->AddArray(pointGradients);
+      if(vorticity)
+        {
+        output->GetPointData()->AddArray(
+          cd2pd->GetOutput()->GetPointData()->GetArray(vorticity->GetName()));
+        }
       if(qCriterion)
         {
-        output->GetPointData()->AddArray(qCriterion);
+        output->GetPointData()->AddArray(
+          cd2pd->GetOutput()->GetPointData()->GetArray(qCriterion->GetName()));
         }
       cd2pd->Delete();
       dummy->Delete();
@@ -456,8 +1110,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
 
     switch (pointScalars->GetDataType())
       {
-      vtkTemplateMacro(ComputeCellGradientsUG(
-                         input,
+      vtkTemplateMacro(ComputeGradientsUG(
+                         builder, operators, numberOfEntities,
                          static_cast<VTK_TT *>(pointScalars->GetVoidPointer(0)),
                          static_cast<VTK_TT *>(gradients->GetVoidPointer(0)),
                          numberOfInputComponents,
@@ -479,6 +1133,7 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
     pointScalars->UnRegister(this);
     }
 
+  delete builder;
   gradients->Delete();
 
   return 1;
@@ -611,98 +1266,10 @@ int vtkGradientFilter::ComputeRegularGridGradient(
 }
 
 namespace {
-//-----------------------------------------------------------------------------
-  template<class data_type>
-  void ComputePointGradientsUG(
-    vtkDataSet *structure, data_type *array, data_type *gradients,
-    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion)
-  {
-    vtkIdList* currentPoint = vtkIdList::New();
-    currentPoint->SetNumberOfIds(1);
-    vtkIdList* cellsOnPoint = vtkIdList::New();
-
-    vtkIdType numpts = structure->GetNumberOfPoints();
-    std::vector<data_type> g(3*numberOfInputComponents);
-
-    int numberOfOutputComponents = 3*numberOfInputComponents;
-
-    for (vtkIdType point = 0; point < numpts; point++)
-      {
-      currentPoint->SetId(0, point);
-      double pointcoords[3];
-      structure->GetPoint(point, pointcoords);
-      // Get all cells touching this point.
-      structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
-      vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
-      vtkIdType numValidCellNeighbors = 0;
-
-      for(int i=0;i<numberOfInputComponents*3;i++)
-        {
-        g[i] = 0;
-        }
-
-      // Iterate on all cells and find all points connected to current point
-      // by an edge.
-      for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
-        {
-        vtkCell *cell = structure->GetCell(cellsOnPoint->GetId(neighbor));
-        int subId;
-        double parametricCoord[3];
-        if(GetCellParametricData(point, pointcoords, cell,
-                                 subId, parametricCoord))
-          {
-          numValidCellNeighbors++;
-          for(int InputComponent=0;InputComponent<numberOfInputComponents;InputComponent++)
-            {
-            int NumberOfCellPoints = cell->GetNumberOfPoints();
-            std::vector<double> values(NumberOfCellPoints);
-            // Get values of Array at cell points.
-            for (int i = 0; i < NumberOfCellPoints; i++)
-              {
-              values[i] = static_cast<double>(
-                array[cell->GetPointId(i)*numberOfInputComponents+InputComponent]);
-              }
-
-            double derivative[3];
-            // Get derivative of cell at point.
-            cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
-
-            g[InputComponent*3] += static_cast<data_type>(derivative[0]);
-            g[InputComponent*3+1] += static_cast<data_type>(derivative[1]);
-            g[InputComponent*3+2] += static_cast<data_type>(derivative[2]);
-            } // iterating over Components
-          } // if(GetCellParametricData())
-        } // iterating over neighbors
-
-      if (numCellNeighbors > 0)
-        {
-        for(int i=0;i<3*numberOfInputComponents;i++)
-          {
-          g[i] /= numCellNeighbors;
-          }
-        }
-
-      if(vorticity)
-        {
-        ComputeVorticityFromGradient(&g[0], vorticity+3*point);
-        }
-      if(qCriterion)
-        {
-        ComputeQCriterionFromGradient(&g[0], qCriterion+point);
-        }
-      for(int i=0;i<numberOfOutputComponents;i++)
-        {
-        gradients[point*numberOfOutputComponents+i] = g[i];
-        }
-      }  // iterating over points in grid
-
-    currentPoint->Delete();
-    cellsOnPoint->Delete();
-  }
-
 //-----------------------------------------------------------------------------
   int GetCellParametricData(vtkIdType pointId, double pointCoord[3],
-                            vtkCell *cell, int &subId, double parametricCoord[3])
+                            vtkCell *cell, int &subId, double parametricCoord[3],
+                            std::vector<double>& weights)
   {
     // Watch out for degenerate cells.  They make the derivative calculation
     // fail.
@@ -723,64 +1290,14 @@ namespace {
 
     double dummy;
     int numpoints = cell->GetNumberOfPoints();
-    std::vector<double> values(numpoints);
+    weights.resize(numpoints + 1);
     // Get parametric position of point.
     cell->EvaluatePosition(pointCoord, NULL, subId, parametricCoord,
-                           dummy, &values[0]/*Really another dummy.*/);
+                           dummy, &weights[0]/*Really another dummy.*/);
 
     return 1;
   }
 
-//-----------------------------------------------------------------------------
-  template<class data_type>
-    void ComputeCellGradientsUG(
-      vtkDataSet *structure, data_type *array, data_type *gradients,
-      int numberOfInputComponents, data_type* vorticity, data_type* qCriterion)
-  {
-    vtkIdType numcells = structure->GetNumberOfCells();
-    std::vector<double> values(8);
-    for (vtkIdType cellid = 0; cellid < numcells; cellid++)
-      {
-      vtkCell *cell = structure->GetCell(cellid);
-
-      int subId;
-      double cellCenter[3];
-      subId = cell->GetParametricCenter(cellCenter);
-
-      int numpoints = cell->GetNumberOfPoints();
-      if(static_cast<size_t>(numpoints) > values.size())
-        {
-        values.resize(numpoints);
-        }
-      double derivative[3];
-      for(int inputComponent=0;inputComponent<numberOfInputComponents;
-          inputComponent++)
-        {
-        for (int i = 0; i < numpoints; i++)
-          {
-          values[i] = static_cast<double>(
-            array[cell->GetPointId(i)*numberOfInputComponents+inputComponent]);
-          }
-
-        cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
-        gradients[cellid*3*numberOfInputComponents+inputComponent*3] =
-          static_cast<data_type>(derivative[0]);
-        gradients[cellid*3*numberOfInputComponents+inputComponent*3+1] =
-          static_cast<data_type>(derivative[1]);
-        gradients[cellid*3*numberOfInputComponents+inputComponent*3+2] =
-          static_cast<data_type>(derivative[2]);
-        }
-      if(vorticity)
-        {
-        ComputeVorticityFromGradient(gradients+3*cellid*numberOfInputComponents, vorticity+3*cellid);
-        }
-      if(qCriterion)
-        {
-        ComputeQCriterionFromGradient(gradients+3*cellid*numberOfInputComponents, qCriterion+cellid);
-        }
-      }
-  }
-
 //-----------------------------------------------------------------------------
   template<class Grid, class data_type>
   void ComputeGradientsSG(Grid output, data_type* array, data_type* gradients,
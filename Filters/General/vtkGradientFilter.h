@@ -29,6 +29,14 @@
 // output tuple will be {du/dx, du/dy, du/dz, dv/dx, dv/dy, dv/dz, dw/dx,
 // dw/dy, dw/dz} for an input array {u, v, w}. There are also the options
 // to additionally compute the vorticity and Q criterion of a vector field.
+//
+// For grids that are not a vtkImageData, vtkRectilinearGrid or
+// vtkStructuredGrid, the gradients are computed in parallel with
+// vtkSMPTools from the derivative operators of the points or cells: the
+// derivatives of the interpolation functions of the cells, which only
+// depend on the mesh and are shared by all the components of the array.
+// These operators can be cached (see CacheDerivativeOperators) to compute
+// the gradients of several arrays or time steps on a static mesh.
 
 #ifndef vtkGradientFilter_h
 #define vtkGradientFilter_h
@@ -36,6 +44,10 @@
 #include "vtkFiltersGeneralModule.h" // For export macro
 #include "vtkDataSetAlgorithm.h"
 
+//BTX
+class vtkGradientFilterOperators;
+//ETX
+
 class VTKFILTERSGENERAL_EXPORT vtkGradientFilter : public vtkDataSetAlgorithm
 {
 public:
@@ -101,6 +113,19 @@ public:
   vtkGetMacro(ComputeQCriterion, int);
   vtkBooleanMacro(ComputeQCriterion, int);
 
+  // Description:
+  // When this flag is on (default is off), the derivative operators of the
+  // points (or of the cells for cell data and FasterApproximation) of an
+  // unstructured input are kept after an execution and reused as long as
+  // the points and cells of the input are not modified. This saves most of
+  // the work when computing the gradients of several arrays, or of the
+  // time steps of a static mesh, at the cost of an id and three doubles
+  // per pair of points sharing a cell. Turning it off releases the
+  // operators on the next execution.
+  vtkSetMacro(CacheDerivativeOperators, int);
+  vtkGetMacro(CacheDerivativeOperators, int);
+  vtkBooleanMacro(CacheDerivativeOperators, int);
+
 protected:
   vtkGradientFilter();
   ~vtkGradientFilter();
@@ -164,6 +189,18 @@ protected:
   // 3 components.  By default ComputeVorticity is off.
   int ComputeVorticity;
 
+  // Description:
+  // Flag to indicate that the derivative operators of unstructured inputs
+  // are kept between executions. By default CacheDerivativeOperators is off.
+  int CacheDerivativeOperators;
+
+  //BTX
+  // Description:
+  // The cached derivative operators of the points and of the cells.
+  vtkGradientFilterOperators* PointOperators;
+  vtkGradientFilterOperators* CellOperators;
+  //ETX
+
 private:
   vtkGradientFilter(const vtkGradientFilter &); // Not implemented
   void operator=(const vtkGradientFilter &);    // Not implemented
@@ -16,6 +16,7 @@
 
 #include "vtkAppendPolyData.h"
 #include "vtkCellData.h"
+#include "vtkExecutive.h"
 #include "vtkFloatArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -23,8 +24,37 @@
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <cmath>
+#include <set>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataStreamer);
 
+namespace
+{
+//----------------------------------------------------------------------------
+void vtkPolyDataStreamerGetUpstreamAlgorithms(
+  vtkAlgorithm* algorithm, std::set<vtkAlgorithm*>& visited,
+  std::vector<vtkAlgorithm*>& algorithms)
+{
+  if (!algorithm || !visited.insert(algorithm).second)
+    {
+    return;
+    }
+  algorithms.push_back(algorithm);
+
+  for (int port = 0; port < algorithm->GetNumberOfInputPorts(); ++port)
+    {
+    int numConnections = algorithm->GetNumberOfInputConnections(port);
+    for (int i = 0; i < numConnections; ++i)
+      {
+      vtkPolyDataStreamerGetUpstreamAlgorithms(
+        algorithm->GetInputAlgorithm(port, i), visited, algorithms);
+      }
+    }
+}
+}
+
 //----------------------------------------------------------------------------
 vtkPolyDataStreamer::vtkPolyDataStreamer()
 {
@@ -32,7 +62,13 @@ vtkPolyDataStreamer::vtkPolyDataStreamer()
   this->SetNumberOfOutputPorts(1);
 
   this->NumberOfPasses = 2;
+  this->NumberOfStreamDivisions = 2;
   this->ColorByPiece = 0;
+  this->MemoryLimit = 0;
+  this->MaximumNumberOfStreamDivisions = 1024;
+  this->MemoryLimitStreamDivisions = 0;
+  this->Probing = 0;
+  this->ExceededMemorySize = 0;
 
   this->Append = vtkAppendPolyData::New();
 }
@@ -44,18 +80,6 @@ vtkPolyDataStreamer::~vtkPolyDataStreamer()
   this->Append = 0;
 }
 
-//----------------------------------------------------------------------------
-void vtkPolyDataStreamer::SetNumberOfStreamDivisions(int num)
-{
-  if (this->NumberOfPasses == (unsigned int)num)
-    {
-    return;
-    }
-
-  this->Modified();
-  this->NumberOfPasses = num;
-}
-
 //----------------------------------------------------------------------------
 int vtkPolyDataStreamer::RequestUpdateExtent(
   vtkInformation *vtkNotUsed(request),
@@ -71,6 +95,27 @@ int vtkPolyDataStreamer::RequestUpdateExtent(
   int outNumPieces = outInfo->Get(
     vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
 
+  // Choose the number of pieces before the first one is requested.
+  if (this->CurrentIndex == 0)
+    {
+    this->NumberOfPasses = this->NumberOfStreamDivisions;
+    this->Probing = 0;
+    if (this->MemoryLimit > 0)
+      {
+      if (this->MemoryLimitStreamDivisions > 0 &&
+          this->MemoryLimitStreamDivisionsTime > this->GetMTime())
+        {
+        this->NumberOfPasses = this->MemoryLimitStreamDivisions;
+        }
+      else if (this->UpstreamCanProducePieces())
+        {
+        // Estimate the memory used from a piece of the finest split.
+        this->NumberOfPasses = this->MaximumNumberOfStreamDivisions;
+        this->Probing = 1;
+        }
+      }
+    }
+
   inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
               outPiece * this->NumberOfPasses + this->CurrentIndex);
   inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
@@ -79,6 +124,100 @@ int vtkPolyDataStreamer::RequestUpdateExtent(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyDataStreamer::GetUpstreamData(std::vector<vtkDataObject*>& data)
+{
+  std::set<vtkAlgorithm*> visited;
+  std::vector<vtkAlgorithm*> algorithms;
+  for (int i = 0; i < this->GetNumberOfInputConnections(0); ++i)
+    {
+    vtkPolyDataStreamerGetUpstreamAlgorithms(
+      this->GetInputAlgorithm(0, i), visited, algorithms);
+    }
+
+  for (size_t i = 0; i < algorithms.size(); ++i)
+    {
+    vtkExecutive* executive = algorithms[i]->GetExecutive();
+    for (int port = 0; port < algorithms[i]->GetNumberOfOutputPorts(); ++port)
+      {
+      vtkInformation* info = executive->GetOutputInformation(port);
+      vtkDataObject* output =
+        info ? info->Get(vtkDataObject::DATA_OBJECT()) : 0;
+      if (output)
+        {
+        data.push_back(output);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPolyDataStreamer::UpstreamCanProducePieces()
+{
+  std::set<vtkAlgorithm*> visited;
+  std::vector<vtkAlgorithm*> algorithms;
+  for (int i = 0; i < this->GetNumberOfInputConnections(0); ++i)
+    {
+    vtkPolyDataStreamerGetUpstreamAlgorithms(
+      this->GetInputAlgorithm(0, i), visited, algorithms);
+    }
+
+  for (size_t i = 0; i < algorithms.size(); ++i)
+    {
+    vtkAlgorithm* algorithm = algorithms[i];
+    int numConnections = 0;
+    for (int port = 0; port < algorithm->GetNumberOfInputPorts(); ++port)
+      {
+      numConnections += algorithm->GetNumberOfInputConnections(port);
+      }
+    if (numConnections > 0)
+      {
+      continue;
+      }
+    vtkExecutive* executive = algorithm->GetExecutive();
+    for (int port = 0; port < algorithm->GetNumberOfOutputPorts(); ++port)
+      {
+      vtkInformation* info = executive->GetOutputInformation(port);
+      if (info &&
+          (info->Get(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST()) ||
+           info->Get(vtkAlgorithm::CAN_PRODUCE_SUB_EXTENT())))
+        {
+        return true;
+        }
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkPolyDataStreamer::ComputeStreamDivisions(unsigned long size)
+{
+  double divisions = ceil(static_cast<double>(this->NumberOfPasses) *
+                          size / this->MemoryLimit);
+  if (divisions > this->MaximumNumberOfStreamDivisions)
+    {
+    return static_cast<unsigned int>(this->MaximumNumberOfStreamDivisions);
+    }
+  if (divisions < this->NumberOfStreamDivisions)
+    {
+    return static_cast<unsigned int>(this->NumberOfStreamDivisions);
+    }
+  return static_cast<unsigned int>(divisions);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPolyDataStreamer::GetUpstreamMemorySize()
+{
+  std::vector<vtkDataObject*> data;
+  this->GetUpstreamData(data);
+  unsigned long size = 0;
+  for (size_t i = 0; i < data.size(); ++i)
+    {
+    size += data[i]->GetActualMemorySize();
+    }
+  return size;
+}
+
 //----------------------------------------------------------------------------
 int vtkPolyDataStreamer::ExecutePass(
   vtkInformationVector **inputVector,
@@ -91,6 +230,46 @@ int vtkPolyDataStreamer::ExecutePass(
   vtkPolyData *input = vtkPolyData::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+  if (this->Probing)
+    {
+    // The piece was only requested to estimate the memory used.
+    unsigned long size = this->GetUpstreamMemorySize();
+    this->MemoryLimitStreamDivisions = this->ComputeStreamDivisions(size);
+    this->MemoryLimitStreamDivisionsTime.Modified();
+    vtkDebugMacro("Piece " << this->CurrentIndex << " of "
+                  << this->NumberOfPasses << " uses " << size
+                  << " KiB, streaming with "
+                  << this->MemoryLimitStreamDivisions << " pieces.");
+    this->Probing = 0;
+    this->RestartStreaming();
+    return 1;
+    }
+
+  if (this->MemoryLimit > 0 && this->NumberOfPasses <
+      static_cast<unsigned int>(this->MaximumNumberOfStreamDivisions))
+    {
+    unsigned long size = this->GetUpstreamMemorySize();
+    // The estimate is off when the data is not evenly spread: split more.
+    // Stop splitting if the previous split did not make the pieces
+    // smaller, the sources probably cannot produce pieces.
+    if (size > this->MemoryLimit &&
+        (this->ExceededMemorySize == 0 || size < this->ExceededMemorySize))
+      {
+      unsigned int numberOfPasses = this->ComputeStreamDivisions(size);
+      vtkDebugMacro("Piece " << this->CurrentIndex << " of "
+                    << this->NumberOfPasses << " uses " << size
+                    << " KiB, restarting with " << numberOfPasses
+                    << " pieces.");
+
+      this->ExceededMemorySize = size;
+      this->MemoryLimitStreamDivisions = numberOfPasses;
+      this->MemoryLimitStreamDivisionsTime.Modified();
+      this->Append->RemoveAllInputConnections(0);
+      this->RestartStreaming();
+      return 1;
+      }
+    }
+
   vtkPolyData *copy  = vtkPolyData::New();
   copy->ShallowCopy(input);
   this->Append->AddInputData(copy);
@@ -131,6 +310,7 @@ int vtkPolyDataStreamer::PostExecute(
   output->ShallowCopy(this->Append->GetOutput());
   this->Append->RemoveAllInputConnections(0);
   this->Append->GetOutput()->Initialize();
+  this->ExceededMemorySize = 0;
 
   return 1;
 }
@@ -140,8 +320,12 @@ void vtkPolyDataStreamer::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
-  os << indent << "NumberOfStreamDivisions: " << this->NumberOfPasses << endl;
+  os << indent << "NumberOfStreamDivisions: "
+     << this->NumberOfStreamDivisions << endl;
   os << indent << "ColorByPiece: " << this->ColorByPiece << endl;
+  os << indent << "MemoryLimit: " << this->MemoryLimit << endl;
+  os << indent << "MaximumNumberOfStreamDivisions: "
+     << this->MaximumNumberOfStreamDivisions << endl;
 }
 
 //----------------------------------------------------------------------------
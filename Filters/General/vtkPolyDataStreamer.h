@@ -21,6 +21,19 @@
 // these do not fit in the memory, it is possible to make the vtkPolyDataMapper
 // stream. Since the mapper will render each piece separately, all the
 // polygons do not have to stored in memory.
+//
+// When MemoryLimit is set, vtkPolyDataStreamer chooses the number of
+// pieces itself. It first requests a single piece of the finest split
+// allowed, MaximumNumberOfStreamDivisions, and scales the memory used by
+// the data objects of the upstream pipeline for it to the number of pieces
+// that fit the limit. A piece that still exceeds the limit, because the
+// data is not evenly spread, makes streaming start again with
+// proportionally more pieces. The number of pieces is kept for the next
+// updates, until the streamer is modified, so the cost of finding it is
+// only paid once. The appended output is not counted in the limit.
+// Splitting only reduces the memory used if the sources of the pipeline
+// can produce pieces: without such a source, NumberOfStreamDivisions is
+// used.
 // .SECTION Note
 // The output may be slightly different if the pipeline does not handle
 // ghost cells properly (i.e. you might see seames between the pieces).
@@ -32,8 +45,14 @@
 
 #include "vtkFiltersGeneralModule.h" // For export macro
 #include "vtkStreamerBase.h"
+#include "vtkTimeStamp.h" // For MemoryLimitStreamDivisionsTime
+
+//BTX
+#include <vector> // For GetUpstreamData
+//ETX
 
 class vtkAppendPolyData;
+class vtkDataObject;
 
 class VTKFILTERSGENERAL_EXPORT vtkPolyDataStreamer : public vtkStreamerBase
 {
@@ -44,11 +63,17 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
-  // Set the number of pieces to divide the problem into.
-  void SetNumberOfStreamDivisions(int num);
-  int GetNumberOfStreamDivisions()
+  // Set the number of pieces to divide the problem into. With a
+  // MemoryLimit, this is the minimum number of pieces.
+  vtkSetClampMacro(NumberOfStreamDivisions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfStreamDivisions, int);
+
+  // Description:
+  // Get the number of pieces the problem was divided into by the last
+  // update.
+  int GetActualNumberOfStreamDivisions()
   {
-    return this->NumberOfPasses;
+    return static_cast<int>(this->NumberOfPasses);
   }
 
   // Description:
@@ -58,6 +83,25 @@ public:
   vtkGetMacro(ColorByPiece, int);
   vtkBooleanMacro(ColorByPiece, int);
 
+  // Description:
+  // The maximum memory, in kibibytes, that the upstream pipeline may use
+  // while a piece is processed. When non zero, the number of stream
+  // divisions is chosen so that each piece fits. 0 (the default)
+  // disables the limit.
+  vtkSetMacro(MemoryLimit, unsigned long);
+  vtkGetMacro(MemoryLimit, unsigned long);
+
+  // Description:
+  // The number of stream divisions is never increased beyond this value to
+  // satisfy MemoryLimit, and the memory used is estimated from a piece of
+  // that many. Default is 1024.
+  vtkSetClampMacro(MaximumNumberOfStreamDivisions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfStreamDivisions, int);
+
+  // Description:
+  // Return the memory size, in kibibytes, of the data objects produced by
+  // all the algorithms upstream of the input.
+  unsigned long GetUpstreamMemorySize();
 
 protected:
   vtkPolyDataStreamer();
@@ -75,7 +119,42 @@ protected:
   virtual int PostExecute(vtkInformationVector **inputVector,
                           vtkInformationVector *outputVector);
 
+  //BTX
+  // Description:
+  // Collect the output data objects of all the algorithms upstream of the
+  // input.
+  void GetUpstreamData(std::vector<vtkDataObject*>& data);
+  //ETX
+
+  // Description:
+  // Return whether a source of the pipeline upstream of the input can
+  // produce pieces.
+  bool UpstreamCanProducePieces();
+
+  // Description:
+  // Return the number of stream divisions that makes the pieces fit
+  // MemoryLimit, when the upstream pipeline uses \a size KiB for a piece
+  // of NumberOfPasses.
+  unsigned int ComputeStreamDivisions(unsigned long size);
+
+  int NumberOfStreamDivisions;
   int ColorByPiece;
+  unsigned long MemoryLimit;
+  int MaximumNumberOfStreamDivisions;
+
+  // The number of stream divisions chosen for MemoryLimit, 0 until it is
+  // found, and when it was found: it is chosen again once the streamer is
+  // modified.
+  unsigned int MemoryLimitStreamDivisions;
+  vtkTimeStamp MemoryLimitStreamDivisionsTime;
+
+  // Set while the piece requested is the one used to estimate the memory.
+  int Probing;
+
+  // The size of the last piece that exceeded MemoryLimit, used to stop
+  // splitting when the pipeline does not produce smaller pieces.
+  unsigned long ExceededMemorySize;
+
 private:
   vtkPolyDataStreamer(const vtkPolyDataStreamer&);  // Not implemented.
   void operator=(const vtkPolyDataStreamer&);  // Not implemented.
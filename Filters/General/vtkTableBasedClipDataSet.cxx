@@ -57,9 +57,13 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkSMPSort.h"
+#include "vtkSMPTools.h"
 
 #include "vtkTableBasedClipCases.h"
 
+#include <vector>
+
 vtkStandardNewMacro( vtkTableBasedClipDataSet );
 vtkCxxSetObjectMacro( vtkTableBasedClipDataSet, ClipFunction, vtkImplicitFunction );
 
@@ -467,6 +471,8 @@ class vtkTableBasedClipperShapeList
     int            GetTotalNumberOfShapes() const;
     int            GetNumberOfLists() const;
     int            GetList(int, const int *& ) const;
+    int            GetList(int, int *& );
+    void           AddShape( const int * );
   protected:
     int         ** list;
     int            currentList;
@@ -576,6 +582,7 @@ class vtkTableBasedClipperCentroidPointList
     int            GetNumberOfLists() const;
     int            GetList( int,
                    const TableBasedClipperCentroidPointEntry *& ) const;
+    int            GetList( int, TableBasedClipperCentroidPointEntry *& );
 
   protected:
     TableBasedClipperCentroidPointEntry ** list;
@@ -586,6 +593,17 @@ class vtkTableBasedClipperCentroidPointList
 };
 
 
+// An edge point created by one of several batches of cells, keyed by the
+// ids of the (ordered) end points of the edge.
+struct TableBasedClipperEdgeKey
+{
+  int      ptIds[2];
+  double   percent;
+  int      batch;
+  int      local;
+};
+
+
 struct TableBasedClipperCommonPointsStructure
 {
   bool        hasPtsList;
@@ -633,6 +651,18 @@ class  vtkTableBasedClipperVolumeFromVolume :
     void     AddVertex(int z, int v0)
              { this->vertices.AddVertex( z, v0 ); }
 
+    // Description:
+    // Append the shapes of batches that clipped consecutive ranges of cells
+    // of the same input, merging the edge points they have in common.
+    void     Merge( std::vector< vtkTableBasedClipperVolumeFromVolume * > & );
+
+    int      GetNumberOfEdgePoints() const
+             { return pt_list.GetTotalNumberOfPoints(); }
+    int      GetNumberOfCentroidPoints() const
+             { return centroid_list.GetTotalNumberOfPoints(); }
+    void     GetEdgeKeys( int batch, TableBasedClipperEdgeKey * keys ) const;
+    void     RemapPointIds( const int * edgeIds, int centroidOffset );
+
   protected:
     vtkTableBasedClipperCentroidPointList centroid_list;
     vtkTableBasedClipperHexList     hexes;
@@ -715,6 +745,19 @@ int  vtkTableBasedClipperCentroidPointList::GetList
   return ( listId == currentList ? currentPoint : pointsPerList );
 }
 
+int  vtkTableBasedClipperCentroidPointList::GetList
+   ( int listId, TableBasedClipperCentroidPointEntry *& outlist )
+{
+  if ( listId < 0 || listId > currentList )
+    {
+    outlist = NULL;
+    return 0;
+    }
+
+  outlist = list[ listId ];
+  return ( listId == currentList ? currentPoint : pointsPerList );
+}
+
 int  vtkTableBasedClipperCentroidPointList::GetNumberOfLists() const
 {
     return currentList + 1;
@@ -816,6 +859,55 @@ int  vtkTableBasedClipperShapeList::GetList
   return ( listId == currentList ? currentShape : shapesPerList );
 }
 
+int  vtkTableBasedClipperShapeList::GetList( int listId, int *& outlist )
+{
+  if ( listId < 0 || listId > currentList )
+    {
+    outlist = NULL;
+    return 0;
+    }
+
+  outlist = list[ listId ];
+  return ( listId == currentList ? currentShape : shapesPerList );
+}
+
+void vtkTableBasedClipperShapeList::AddShape( const int * shape )
+{
+  if ( currentShape >= shapesPerList )
+    {
+    if (  ( currentList + 1 ) >= listSize  )
+      {
+      int ** tmpList = new int * [ 2 * listSize ];
+
+      for ( int i = 0; i < listSize; i ++ )
+        {
+        tmpList[i] = list[i];
+        }
+
+      for ( int i = listSize; i < listSize * 2; i ++ )
+        {
+        tmpList[i] = NULL;
+        }
+
+      listSize *= 2;
+      delete [] list;
+      list = tmpList;
+      }
+
+    currentList ++;
+    list[ currentList ] = new int[  ( shapeSize + 1 ) * shapesPerList  ];
+    currentShape = 0;
+    }
+
+  // the cell id followed by the point ids
+  int idx = ( shapeSize + 1 ) * currentShape;
+  for ( int i = 0; i <= shapeSize; i ++ )
+    {
+    list[ currentList ][ idx + i ] = shape[i];
+    }
+  currentShape ++;
+}
+
 int  vtkTableBasedClipperShapeList::GetNumberOfLists() const
 {
     return currentList + 1;
@@ -1582,429 +1674,652 @@ void vtkTableBasedClipperVolumeFromVolume::
   delete [] ptLookup;
 }
 
-inline void GetPoint( double * pt, const double * X, const double * Y,
-                      const double * Z, const int * dims, const int & index )
+// Orders the edge keys by their end points and then by their position in
+// batch order, so that the first of equal keys comes from the earliest batch.
+inline bool operator < ( const TableBasedClipperEdgeKey & a,
+                         const TableBasedClipperEdgeKey & b )
 {
-  int cellI = index % dims[0];
-  int cellJ = ( index / dims[0] ) % dims[1];
-  int cellK = index / ( dims[0] * dims[1] );
-  pt[0] = X[ cellI ];
-  pt[1] = Y[ cellJ ];
-  pt[2] = Z[ cellK ];
+  if ( a.ptIds[0] != b.ptIds[0] )
+    {
+    return a.ptIds[0] < b.ptIds[0];
+    }
+  if ( a.ptIds[1] != b.ptIds[1] )
+    {
+    return a.ptIds[1] < b.ptIds[1];
+    }
+  if ( a.batch != b.batch )
+    {
+    return a.batch < b.batch;
+    }
+  return a.local < b.local;
 }
-// ============================================================================
-// =============== vtkTableBasedClipperVolumeFromVolume ( end ) ===============
-// ============================================================================
 
 
-//-----------------------------------------------------------------------------
-// Construct with user-specified implicit function; InsideOut turned off; value
-// set to 0.0; and generate clip scalars turned off.
-vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
+// ---- vtkTableBasedClipperGatherEdgeKeys (begin)
+// Gathers the edge keys of each batch, stored one run after another.
+class vtkTableBasedClipperGatherEdgeKeys
 {
-  this->Locator      = NULL;
-  this->ClipFunction = cf;
-
-  // setup a callback to report progress
-  this->InternalProgressObserver = vtkCallbackCommand::New();
-  this->InternalProgressObserver->SetCallback
-        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
-  this->InternalProgressObserver->SetClientData( this );
+public:
+  vtkTableBasedClipperGatherEdgeKeys
+    ( std::vector< vtkTableBasedClipperVolumeFromVolume * > & batches,
+      const std::vector< vtkIdType > & offsets,
+      TableBasedClipperEdgeKey * keys )
+    : Batches( batches ), Offsets( offsets ), Keys( keys )
+  {
+  }
 
-  this->Value     = 0.0;
-  this->InsideOut = 0;
-  this->MergeTolerance        = 0.01;
-  this->UseValueAsOffset      = true;
-  this->GenerateClipScalars   = 0;
-  this->GenerateClippedOutput = 0;
+  void operator () ( vtkIdType begin, vtkIdType end ) const
+  {
+    for ( vtkIdType b = begin; b < end; b ++ )
+      {
+      this->Batches[b]->GetEdgeKeys
+        ( static_cast< int >( b ), this->Keys + this->Offsets[b] );
+      }
+  }
 
-  this->OutputPointsPrecision = DEFAULT_PRECISION;
+protected:
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > & Batches;
+  const std::vector< vtkIdType > & Offsets;
+  TableBasedClipperEdgeKey       * Keys;
 
-  this->SetNumberOfOutputPorts( 2 );
-  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
-  this->GetExecutive()->SetOutputData( 1, output2 );
-  output2->Delete();
-  output2 = NULL;
+private:
+  void operator = ( const vtkTableBasedClipperGatherEdgeKeys & ); // Not implemented.
+};
+// ---- vtkTableBasedClipperGatherEdgeKeys (end)
 
-  // process active point scalars by default
-  this->SetInputArrayToProcess
-        ( 0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
-          vtkDataSetAttributes::SCALARS );
-}
 
-//-----------------------------------------------------------------------------
-vtkTableBasedClipDataSet::~vtkTableBasedClipDataSet()
+// ---- vtkTableBasedClipperRemapBatches (begin)
+// Renumbers the edge and centroid points referenced by each batch.
+class vtkTableBasedClipperRemapBatches
 {
-  if ( this->Locator )
-    {
-    this->Locator->UnRegister( this );
-    this->Locator = NULL;
-    }
-  this->SetClipFunction( NULL );
-  this->InternalProgressObserver->Delete();
-  this->InternalProgressObserver = NULL;
-}
+public:
+  vtkTableBasedClipperRemapBatches
+    ( std::vector< vtkTableBasedClipperVolumeFromVolume * > & batches,
+      const std::vector< vtkIdType > & edgeOffsets,
+      const std::vector< int > & centroidOffsets, const int * edgeIds )
+    : Batches( batches ), EdgeOffsets( edgeOffsets ),
+      CentroidOffsets( centroidOffsets ), EdgeIds( edgeIds )
+  {
+  }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::InternalProgressCallbackFunction
-   ( vtkObject * arg, unsigned long, void * clientdata, void * )
-{
-  reinterpret_cast < vtkTableBasedClipDataSet * > ( clientdata )
-    ->InternalProgressCallback(  static_cast < vtkAlgorithm * > ( arg )  );
-}
+  void operator () ( vtkIdType begin, vtkIdType end ) const
+  {
+    for ( vtkIdType b = begin; b < end; b ++ )
+      {
+      this->Batches[b]->RemapPointIds
+        (  this->EdgeIds ? this->EdgeIds + this->EdgeOffsets[b] : NULL,
+           this->CentroidOffsets[b]  );
+      }
+  }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::InternalProgressCallback
-   ( vtkAlgorithm * algorithm )
-{
-  double progress = algorithm->GetProgress();
-  this->UpdateProgress( progress );
+protected:
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > & Batches;
+  const std::vector< vtkIdType > & EdgeOffsets;
+  const std::vector< int >       & CentroidOffsets;
+  const int                      * EdgeIds;
 
-  if ( this->AbortExecute )
+private:
+  void operator = ( const vtkTableBasedClipperRemapBatches & ); // Not implemented.
+};
+// ---- vtkTableBasedClipperRemapBatches (end)
+
+
+void vtkTableBasedClipperVolumeFromVolume::GetEdgeKeys
+  ( int batch, TableBasedClipperEdgeKey * keys ) const
+{
+  int local  = 0;
+  int nLists = pt_list.GetNumberOfLists();
+  for ( int i = 0; i < nLists; i ++ )
     {
-    algorithm->SetAbortExecute( 1 );
+    const TableBasedClipperPointEntry * pe_list = NULL;
+    int nPts = pt_list.GetList( i, pe_list );
+    for ( int j = 0; j < nPts; j ++, keys ++ )
+      {
+      keys->ptIds[0] = pe_list[j].ptIds[0];
+      keys->ptIds[1] = pe_list[j].ptIds[1];
+      keys->percent  = pe_list[j].percent;
+      keys->batch    = batch;
+      keys->local    = local ++;
+      }
     }
 }
 
-//-----------------------------------------------------------------------------
-unsigned long vtkTableBasedClipDataSet::GetMTime()
+void vtkTableBasedClipperVolumeFromVolume::RemapPointIds
+  ( const int * edgeIds, int centroidOffset )
 {
-  unsigned long time;
-  unsigned long mTime = this->Superclass::GetMTime();
+  int i, j, k, l;
 
-  if ( this->ClipFunction != NULL )
+  for ( i = 0; i < nshapes; i ++ )
     {
-    time  = this->ClipFunction->GetMTime();
-    mTime = ( time > mTime ? time : mTime );
+    int nlists    = shapes[i]->GetNumberOfLists();
+    int shapesize = shapes[i]->GetShapeSize();
+
+    for ( j = 0; j < nlists; j ++ )
+      {
+      int * list;
+      int listSize = shapes[i]->GetList( j, list );
+
+      for ( k = 0; k < listSize; k ++ )
+        {
+        list ++; // skip the cell id entry
+
+        for ( l = 0; l < shapesize; l ++, list ++ )
+          {
+          if ( *list < 0 )
+            {
+            *list -= centroidOffset;
+            }
+          else
+          if ( *list >= numPrevPts )
+            {
+            *list  = numPrevPts + edgeIds[ *list - numPrevPts ];
+            }
+          }
+        }
+      }
     }
 
-  if ( this->Locator != NULL )
+  int nLists = centroid_list.GetNumberOfLists();
+  for ( i = 0; i < nLists; i ++ )
     {
-    time  = this->Locator->GetMTime();
-    mTime = ( time > mTime ? time : mTime );
+    TableBasedClipperCentroidPointEntry * ce_list = NULL;
+    int nPts = centroid_list.GetList( i, ce_list );
+    for ( j = 0; j < nPts; j ++ )
+      {
+      TableBasedClipperCentroidPointEntry & ce = ce_list[j];
+      for ( k = 0; k < ce.nPts; k ++ )
+        {
+        if ( ce.ptIds[k] < 0 )
+          {
+          ce.ptIds[k] -= centroidOffset;
+          }
+        else
+        if ( ce.ptIds[k] >= numPrevPts )
+          {
+          ce.ptIds[k]  = numPrevPts + edgeIds[ ce.ptIds[k] - numPrevPts ];
+          }
+        }
+      }
     }
-
-  return mTime;
 }
 
-vtkUnstructuredGrid *vtkTableBasedClipDataSet::GetClippedOutput()
+void vtkTableBasedClipperVolumeFromVolume::Merge
+  ( std::vector< vtkTableBasedClipperVolumeFromVolume * > & batches )
 {
-  if ( !this->GenerateClippedOutput )
+  int i, j, k, b;
+  int numBatches = static_cast< int >( batches.size() );
+
+  std::vector< vtkIdType > keyOffsets( numBatches + 1, 0 );
+  std::vector< int >       centroidOffsets( numBatches + 1, 0 );
+  for ( b = 0; b < numBatches; b ++ )
     {
-    return NULL;
+    keyOffsets[ b + 1 ] = keyOffsets[b] + batches[b]->GetNumberOfEdgePoints();
+    centroidOffsets[ b + 1 ] = centroidOffsets[b] +
+                               batches[b]->GetNumberOfCentroidPoints();
     }
 
-  return vtkUnstructuredGrid::SafeDownCast
-        (  this->GetExecutive()->GetOutputData( 1 )  );
-}
+  //
+  // Sort the edge points of all the batches by their end points.
+  //
+  vtkIdType numKeys = keyOffsets[ numBatches ];
+  std::vector< TableBasedClipperEdgeKey > keys( numKeys );
+  std::vector< int > edgeIds( numKeys );
+  if ( numKeys > 0 )
+    {
+    vtkTableBasedClipperGatherEdgeKeys gatherer( batches, keyOffsets, &keys[0] );
+    vtkSMPTools::For( 0, numBatches, 1, gatherer );
+    vtkSMPSort::Sort( &keys[0], &keys[0] + numKeys );
+
+    //
+    // The first key of a run of equal keys comes from the earliest batch,
+    // which is where a serial pass would have created the point. Make every
+    // key (indexed by its position in batch order) refer to that one.
+    //
+    std::vector< vtkIdType > owners( numKeys );
+    vtkIdType first = 0;
+    for ( vtkIdType s = 0; s < numKeys; s ++ )
+      {
+      if ( keys[s].ptIds[0] != keys[ first ].ptIds[0] ||
+           keys[s].ptIds[1] != keys[ first ].ptIds[1] )
+        {
+        first = s;
+        }
+      owners[ keyOffsets[ keys[s].batch ] + keys[s].local ] = first;
+      }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::SetLocator
-   ( vtkIncrementalPointLocator * locator )
-{
-  if ( this->Locator == locator)
-    {
-    return;
+    //
+    // Number the unique edge points in batch order, which is the order a
+    // serial pass over the cells would have added them in.
+    //
+    int numEdgePts = 0;
+    for ( vtkIdType p = 0; p < numKeys; p ++ )
+      {
+      const TableBasedClipperEdgeKey & owner = keys[ owners[p] ];
+      vtkIdType ownerPos = keyOffsets[ owner.batch ] + owner.local;
+      if ( ownerPos == p )
+        {
+        edgeIds[p] = numEdgePts ++;
+        pt_list.AddPoint( owner.ptIds[0], owner.ptIds[1], owner.percent );
+        }
+      else
+        {
+        edgeIds[p] = edgeIds[ ownerPos ];
+        }
+      }
     }
 
-  if ( this->Locator )
-    {
-    this->Locator->UnRegister( this );
-    this->Locator = NULL;
-    }
+  vtkTableBasedClipperRemapBatches remapper( batches, keyOffsets,
+    centroidOffsets, numKeys > 0 ? &edgeIds[0] : NULL );
+  vtkSMPTools::For( 0, numBatches, 1, remapper );
 
-  if ( locator )
+  //
+  // Append the (renumbered) shapes and centroid points in batch order.
+  //
+  for ( i = 0; i < nshapes; i ++ )
     {
-    locator->Register( this );
+    int shapesize = shapes[i]->GetShapeSize();
+    for ( b = 0; b < numBatches; b ++ )
+      {
+      int nlists = batches[b]->shapes[i]->GetNumberOfLists();
+      for ( j = 0; j < nlists; j ++ )
+        {
+        const int * list;
+        int listSize = batches[b]->shapes[i]->GetList( j, list );
+        for ( k = 0; k < listSize; k ++, list += shapesize + 1 )
+          {
+          shapes[i]->AddShape( list );
+          }
+        }
+      }
     }
 
-  this->Locator = locator;
-  this->Modified();
-}
-
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::CreateDefaultLocator()
-{
-  if ( this->Locator == NULL )
+  for ( b = 0; b < numBatches; b ++ )
     {
-    this->Locator = vtkMergePoints::New();
-    this->Locator->Register( this );
-    this->Locator->Delete();
+    int nLists = batches[b]->centroid_list.GetNumberOfLists();
+    for ( i = 0; i < nLists; i ++ )
+      {
+      TableBasedClipperCentroidPointEntry * ce_list = NULL;
+      int nPts = batches[b]->centroid_list.GetList( i, ce_list );
+      for ( j = 0; j < nPts; j ++ )
+        {
+        centroid_list.AddPoint( ce_list[j].nPts, ce_list[j].ptIds );
+        }
+      }
     }
 }
 
-//-----------------------------------------------------------------------------
-int vtkTableBasedClipDataSet::FillInputPortInformation
-  ( int, vtkInformation * info )
+inline void GetPoint( double * pt, const double * X, const double * Y,
+                      const double * Z, const int * dims, const int & index )
 {
-  info->Set( vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet" );
-  return 1;
+  int cellI = index % dims[0];
+  int cellJ = ( index / dims[0] ) % dims[1];
+  int cellK = index / ( dims[0] * dims[1] );
+  pt[0] = X[ cellI ];
+  pt[1] = Y[ cellJ ];
+  pt[2] = Z[ cellK ];
 }
+// ============================================================================
+// =============== vtkTableBasedClipperVolumeFromVolume ( end ) ===============
+// ============================================================================
 
-//-----------------------------------------------------------------------------
-int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request ),
-    vtkInformationVector ** inputVector, vtkInformationVector * outputVector )
-{
-  // input and output information objects
-  vtkInformation * inputInf = inputVector[0]->GetInformationObject( 0 );
-  vtkInformation * outInfor = outputVector->GetInformationObject( 0 );
 
-  // Get the input of which we have to create a copy since the clipper requires
-  // that InterpolateAllocate() be invoked for the output based on its input in
-  // terms of the point data. If the input and output arrays are different,
-  // vtkCell3D's Clip will fail. The last argument of InterpolateAllocate makes
-  // sure that arrays are shallow-copied from theInput to cpyInput.
-  vtkDataSet * theInput = vtkDataSet::SafeDownCast
-                          (  inputInf->Get( vtkDataObject::DATA_OBJECT() )  );
-  vtkSmartPointer< vtkDataSet > cpyInput;
-  cpyInput.TakeReference( theInput->NewInstance() );
-  cpyInput->CopyStructure( theInput  );
-  cpyInput->GetCellData()->PassData( theInput->GetCellData() );
-  cpyInput->GetPointData()
-          ->InterpolateAllocate( theInput->GetPointData(), 0, 0, 1 );
+// ============================================================================
+// ================= vtkTableBasedClipperClipCells (begin) ====================
+// ============================================================================
 
-  // get the output (the remaining and the clipped parts)
-  vtkUnstructuredGrid * outputUG = vtkUnstructuredGrid::SafeDownCast
-                        (  outInfor->Get( vtkDataObject::DATA_OBJECT() )  );
 
-  inputInf = NULL;
-  outInfor = NULL;
-  theInput = NULL;
-  vtkDebugMacro( << "Clipping dataset" << endl );
+// Minimum number of cells per batch. Small inputs and single-threaded SMP
+// back-ends clip the cells in a single batch, which needs no merge at all.
+#define TABLE_BASED_CLIPPER_MIN_BATCH_SIZE 16384
 
 
-  int  i;
-  vtkIdType  numbPnts = cpyInput->GetNumberOfPoints();
+// ---- vtkTableBasedClipperStructuredCells (begin)
+// Clips a range of the (hexahedral or quadrilateral) cells of a rectilinear
+// or structured grid, given its point dimensions.
+class vtkTableBasedClipperStructuredCells
+{
+public:
+  vtkTableBasedClipperStructuredCells( vtkAlgorithm * self, int insideOut,
+    vtkDataArray * clipAray, double isoValue, int * dims )
+    : Self( self ), InsideOut( insideOut ), ClipAray( clipAray ),
+      IsoValue( isoValue )
+  {
+    this->Dims[0] = dims[0];
+    this->Dims[1] = dims[1];
+    this->Dims[2] = dims[2];
+  }
 
-  // handling exceptions
-  if ( numbPnts < 1 )
-    {
-    vtkDebugMacro( << "No data to clip" << endl );
-    outputUG = NULL;
-    return 1;
-    }
+  void Execute( vtkTableBasedClipperVolumeFromVolume * visItVFV,
+                int batch, vtkIdType first, vtkIdType last );
 
-  if ( !this->ClipFunction && this->GenerateClipScalars )
-    {
-    vtkErrorMacro( << "Cannot generate clip scalars "
-                   << "if no clip function defined" << endl );
-    outputUG = NULL;
-    return 1;
-    }
+protected:
+  vtkAlgorithm * Self;
+  int            InsideOut;
+  vtkDataArray * ClipAray;
+  double         IsoValue;
+  int            Dims[3];
+};
 
 
-  vtkDataArray   * clipAray = NULL;
-  vtkDoubleArray * pScalars = NULL;
+void vtkTableBasedClipperStructuredCells::Execute
+  ( vtkTableBasedClipperVolumeFromVolume * visItVFV, int vtkNotUsed( batch ),
+    vtkIdType first, vtkIdType last )
+{
+  int            i, j;
+  int            isTwoDim = int( this->Dims[2] <= 1 );
+  double         isoValue = this->IsoValue;
+  vtkDataArray * clipAray = this->ClipAray;
 
-  // check whether the cells are clipped with input scalars or a clip function
-  if ( this->ClipFunction )
+  int   shiftLUT[3][8] = {
+                           { 0, 1, 1, 0, 0, 1, 1, 0 },
+                           { 0, 0, 1, 1, 0, 0, 1, 1 },
+                           { 0, 0, 0, 0, 1, 1, 1, 1 }
+                         };
+  int   cellDims[3] = { this->Dims[0] - 1, this->Dims[1] - 1, this->Dims[2] - 1 };
+  int   cyStride    = cellDims[0];
+  int   czStride    = cellDims[0] * cellDims[1];
+  int   pyStride    = this->Dims[0];
+  int   pzStride    = this->Dims[0] * this->Dims[1];
+
+  for ( i = first; i < last; i ++ )
     {
-    pScalars = vtkDoubleArray::New();
-    pScalars->SetNumberOfTuples( numbPnts );
-    pScalars->SetName( "ClipDataSetScalars" );
+    int    caseIndx = 0;
+    int    nCellPts = isTwoDim ? 4 : 8;
+    int    theCellI =   i % cellDims[0];
+    int    theCellJ = ( i / cyStride ) % cellDims[1];
+    int    theCellK = ( i / czStride );
+    double grdDiffs[8];
 
-    // enable clipDataSetScalars to be passed to the output
-    if ( this->GenerateClipScalars )
+    for ( j = nCellPts - 1; j >= 0; j -- )
       {
-      cpyInput->GetPointData()->SetScalars( pScalars );
+      grdDiffs[j] = clipAray->GetComponent
+                              (  ( theCellK + shiftLUT[2][j] ) * pzStride +
+                                 ( theCellJ + shiftLUT[1][j] ) * pyStride +
+                                 ( theCellI + shiftLUT[0][j] ),  0
+                              ) - isoValue;
+      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+      caseIndx  <<= (  1 - ( !j )  );
       }
 
-    for ( i = 0; i < numbPnts; i ++ )
-      {
-      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
-      pScalars->SetTuple1( i, s );
-      }
+    int             nOutputs;
+    int             intrpIds[4];
+    unsigned char * thisCase = NULL;
 
-    clipAray = pScalars;
-    }
-  else //using input scalars
-    {
-    clipAray = this->GetInputArrayToProcess( 0, inputVector );
-    if ( !clipAray )
+    if ( isTwoDim )
       {
-      vtkErrorMacro( << "no input scalars." << endl );
-      return 1;
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
+               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
       }
-    }
-
-
-  int    gridType = cpyInput->GetDataObjectType();
-  double isoValue = ( !this->ClipFunction || this->UseValueAsOffset )
-                    ?  this->Value  :  0.0;
-  if ( gridType == VTK_IMAGE_DATA || gridType == VTK_STRUCTURED_POINTS )
-    {
-    int   numbDims;
-    int * dataDims = vtkImageData::SafeDownCast( cpyInput )->GetDimensions();
-    for ( numbDims = 3, i = 0; i < 3; i ++ )
+    else
       {
-      numbDims -= (  ( dataDims[i] <= 1 ) ? 1 : 0  );
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
+               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
       }
-    dataDims = NULL;
 
-    if ( numbDims == 3 )
+    for ( j = 0; j < nOutputs; j++ )
       {
-      this->ClipImageData( cpyInput.GetPointer(), clipAray, isoValue, outputUG );
-      }
-    }
-  else
-  if ( gridType == VTK_POLY_DATA )
-    {
-    this->ClipPolyData( cpyInput.GetPointer(), clipAray, isoValue, outputUG );
-    }
-  else
-  if ( gridType == VTK_RECTILINEAR_GRID )
-    {
-    this->ClipRectilinearGridData( cpyInput.GetPointer(), clipAray,
-                                   isoValue, outputUG );
-    }
-  else
-  if ( gridType == VTK_STRUCTURED_GRID )
-    {
-    this->ClipStructuredGridData( cpyInput.GetPointer(), clipAray,
-                                  isoValue, outputUG );
-    }
-  else
-  if ( gridType == VTK_UNSTRUCTURED_GRID )
-    {
-    this->ClipUnstructuredGridData( cpyInput.GetPointer(), clipAray,
-                                    isoValue, outputUG );
-    }
-  else
-    {
-    this->ClipDataSet( cpyInput.GetPointer(), clipAray, outputUG );
-    }
+      int      intrpIdx = -1;
+      int      theColor = -1;
+      unsigned char theShape = *thisCase ++;
 
-  outputUG->Squeeze();
+      nCellPts = 0;
+      switch ( theShape )
+        {
+        case ST_HEX:
+          nCellPts = 8;
+          theColor = *thisCase ++;
+          break;
 
-  if ( pScalars )
-    {
-    pScalars->Delete();
-    }
-  pScalars = NULL;
-  outputUG = NULL;
-  clipAray = NULL;
+        case ST_WDG:
+          nCellPts = 6;
+          theColor = *thisCase ++;
+          break;
 
-  return 1;
-}
+        case ST_PYR:
+          nCellPts = 5;
+          theColor = *thisCase ++;
+          break;
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipDataSet( vtkDataSet * pDataSet,
-     vtkDataArray * clipAray, vtkUnstructuredGrid * unstruct )
-{
-  vtkClipDataSet * clipData = vtkClipDataSet::New();
-  clipData->SetInputData( pDataSet );
-  clipData->SetValue( this->Value );
-  clipData->SetInsideOut( this->InsideOut );
-  clipData->SetClipFunction( this->ClipFunction );
-  clipData->SetUseValueAsOffset( this->UseValueAsOffset );
-  clipData->SetGenerateClipScalars( this->GenerateClipScalars );
+        case ST_TET:
+          nCellPts = 4;
+          theColor = *thisCase ++;
+          break;
 
-  if ( !this->ClipFunction )
-    {
-    pDataSet->GetPointData()->SetScalars( clipAray );
-    }
+        case ST_QUA:
+          nCellPts = 4;
+          theColor = *thisCase ++;
+          break;
 
-  clipData->Update();
-  unstruct->ShallowCopy( clipData->GetOutput() );
+        case ST_TRI:
+          nCellPts = 3;
+          theColor = *thisCase ++;
+          break;
 
-  clipData->Delete();
-  clipData = NULL;
-}
+        case ST_LIN:
+          nCellPts = 2;
+          theColor = *thisCase ++;
+          break;
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipImageData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
-{
-  int                  i, j;
-  int                  dataDims[3];
-  double               spacings[3];
-  double               tmpValue = 0.0;
-  double             * dataBBox = NULL;
-  vtkImageData       * volImage = NULL;
-  vtkDoubleArray     * pxCoords = NULL;
-  vtkDoubleArray     * pyCoords = NULL;
-  vtkDoubleArray     * pzCoords = NULL;
-  vtkRectilinearGrid * rectGrid = NULL;
+        case ST_VTX:
+          nCellPts = 1;
+          theColor = *thisCase ++;
+          break;
 
-  volImage = vtkImageData::SafeDownCast( inputGrd );
-  volImage->GetDimensions( dataDims );
-  volImage->GetSpacing( spacings );
-  dataBBox = volImage->GetBounds();
+        case ST_PNT:
+          intrpIdx = *thisCase ++;
+          theColor = *thisCase ++;
+          nCellPts = *thisCase ++;
+          break;
 
-  pxCoords = vtkDoubleArray::New();
-  pyCoords = vtkDoubleArray::New();
-  pzCoords = vtkDoubleArray::New();
-  vtkDoubleArray * tmpArays[3] = { pxCoords, pyCoords, pzCoords };
-  for ( j = 0; j < 3; j ++ )
-    {
-    tmpArays[j]->SetNumberOfComponents( 1 );
-    tmpArays[j]->SetNumberOfTuples( dataDims[j] );
-    for ( tmpValue  = dataBBox[ j << 1 ], i = 0; i < dataDims[j]; i ++,
-          tmpValue += spacings[j] )
-      {
-      tmpArays[j]->SetComponent( i, 0, tmpValue );
-      }
-    tmpArays[j] = NULL;
-    }
+        default:
+          vtkErrorWithObjectMacro( this->Self, << "An invalid output shape was found in "
+                                               << "the ClipCases." << endl );
+        }
 
-  rectGrid = vtkRectilinearGrid::New();
-  rectGrid->SetDimensions( dataDims );
-  rectGrid->SetXCoordinates( pxCoords );
-  rectGrid->SetYCoordinates( pyCoords );
-  rectGrid->SetZCoordinates( pzCoords );
-  rectGrid->GetPointData()->ShallowCopy( volImage->GetPointData() );
-  rectGrid->GetCellData()->ShallowCopy( volImage->GetCellData() );
+      if ( (!this->InsideOut && theColor == COLOR0 ) ||
+           ( this->InsideOut && theColor == COLOR1 )
+         )
+        {
+        // We don't want this one; it's the wrong side.
+        thisCase += nCellPts;
+        continue;
+        }
 
-  this->ClipRectilinearGridData( rectGrid, clipAray, isoValue, outputUG );
+      int   shapeIds[8];
+      for ( int p = 0; p < nCellPts; p ++ )
+        {
+        unsigned char pntIndex = *thisCase ++;
 
-  pxCoords->Delete();
-  pyCoords->Delete();
-  pzCoords->Delete();
-  rectGrid->Delete();
-  pxCoords = NULL;
-  pyCoords = NULL;
-  pzCoords = NULL;
-  rectGrid = NULL;
-  volImage = NULL;
-  dataBBox = NULL;
+        if ( pntIndex <= P7 )
+          {
+          // We know pt P0 must be >P0 since we already
+          // assume P0 == 0.  This is why we do not
+          // bother subtracting P0 from pt here.
+          shapeIds[p] =
+                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
+                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
+                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
+                      );
+          }
+        else
+        if ( pntIndex >= EA && pntIndex <= EL )
+          {
+          int pt1Index = vtkTableBasedClipperTriangulationTables::
+                         HexVerticesFromEdges[ pntIndex - EA ][0];
+          int pt2Index = vtkTableBasedClipperTriangulationTables::
+                         HexVerticesFromEdges[ pntIndex - EA ][1];
+
+          if ( pt2Index < pt1Index )
+            {
+            int temp = pt2Index;
+            pt2Index = pt1Index;
+            pt1Index = temp;
+            }
+
+          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+
+          int    pntIndx1 =
+                 (   (  theCellI + shiftLUT[0][ pt1Index ]  ) +
+                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
+                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
+                 );
+          int    pntIndx2 =
+                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
+                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
+                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
+                 );
+
+          /* We may have physically (though not logically) degenerate cells
+          // if p1Weight == 0 or p1Weight == 1. We could pretty easily and
+          // mostly safely clamp percent to the range [1e-4, 1 - 1e-4].
+          if( p1Weight == 1.0)
+            {
+            shapeIds[p] = pntIndx1;
+            }
+          else
+          if( p1Weight == 0.0 )
+            {
+            shapeIds[p] = pntIndx2;
+            }
+          else
+
+            {
+            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
+            }
+          */
+
+          // Turning on the above code segment, the alternative, would cause
+          // a bug with a synthetic Wavelet dataset (vtkImageData) when the
+          // the clipping plane (x/y/z axis) is positioned exactly at (0,0,0).
+          // The problem occurs in the form of an open 'box', as opposed to an
+          // expected closed one. This is due to the use of hash instead of a
+          // point-locator based detection of duplicate points.
+          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
+          }
+        else
+        if ( pntIndex >= N0 && pntIndex <= N3 )
+          {
+          shapeIds[p] = intrpIds[ pntIndex - N0 ];
+          }
+        else
+          {
+          vtkErrorWithObjectMacro( this->Self, << "An invalid output point value "
+                                               << "was found in the ClipCases." << endl );
+          }
+        }
+
+      switch ( theShape )
+        {
+        case ST_HEX:
+          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
+                               shapeIds[2], shapeIds[3], shapeIds[4],
+                               shapeIds[5], shapeIds[6], shapeIds[7] );
+          break;
+
+        case ST_WDG:
+          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
+                                 shapeIds[3], shapeIds[4], shapeIds[5] );
+          break;
+
+        case ST_PYR:
+          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
+                                   shapeIds[2], shapeIds[3], shapeIds[4] );
+          break;
+
+        case ST_TET:
+          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
+                               shapeIds[2], shapeIds[3] );
+          break;
+
+        case ST_QUA:
+          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
+                                shapeIds[2], shapeIds[3] );
+          break;
+
+        case ST_TRI:
+          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
+          break;
+
+        case ST_LIN:
+          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
+          break;
+
+        case ST_VTX:
+          visItVFV->AddVertex( i, shapeIds[0] );
+          break;
+
+        case ST_PNT:
+          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
+                                           ( nCellPts, shapeIds );
+          break;
+        }
+      }
+
+    thisCase = NULL;
+    }
 }
+// ---- vtkTableBasedClipperStructuredCells (end)
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+
+// ---- vtkTableBasedClipperUnstructuredCells (begin)
+// Clips a range of the cells of an unstructured grid. The ids of the cells
+// that can not be handled by the clip tables are collected per batch.
+class vtkTableBasedClipperUnstructuredCells
 {
-  vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
-  int           numCells = polyData->GetNumberOfCells();
+public:
+  vtkTableBasedClipperUnstructuredCells( vtkAlgorithm * self, int insideOut,
+    vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * input,
+    int numBatches )
+    : Specials( numBatches ), Self( self ), InsideOut( insideOut ),
+      ClipAray( clipAray ), IsoValue( isoValue ), Input( input )
+  {
+  }
 
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-     this->OutputPointsPrecision, polyData->GetNumberOfPoints(),
-     int(   pow(  double( numCells ),  double( 0.6667f )  )   ) * 5 + 100    );
+  void Execute( vtkTableBasedClipperVolumeFromVolume * visItVFV,
+                int batch, vtkIdType first, vtkIdType last );
 
-  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
-  specials->SetPoints( polyData->GetPoints() );
-  specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
-  specials->Allocate( numCells );
+  std::vector< std::vector< vtkIdType > > Specials;
 
-  vtkIdType   i, j;
-  vtkIdType   numbPnts = 0;
-  int         numCants = 0;  // number of cells not clipped by this filter
+protected:
+  vtkAlgorithm        * Self;
+  int                   InsideOut;
+  vtkDataArray        * ClipAray;
+  double                IsoValue;
+  vtkUnstructuredGrid * Input;
+};
 
-  for ( i = 0; i < numCells; i ++ )
+
+void vtkTableBasedClipperUnstructuredCells::Execute
+  ( vtkTableBasedClipperVolumeFromVolume * visItVFV, int batch,
+    vtkIdType first, vtkIdType last )
+{
+  vtkIdType             i, j;
+  vtkIdType             numbPnts = 0;
+  double                isoValue = this->IsoValue;
+  vtkDataArray        * clipAray = this->ClipAray;
+  vtkUnstructuredGrid * unstruct = this->Input;
+
+  for ( i = first; i < last; i ++ )
     {
-    int         cellType = polyData->GetCellType( i );
-    bool        bCanClip = false;
+    int         cellType = unstruct->GetCellType( i );
     vtkIdType * pntIndxs = NULL;
-    polyData->GetCellPoints( i, numbPnts, pntIndxs );
+    unstruct->GetCellPoints( i, numbPnts, pntIndxs );
 
+    bool     bCanClip = false;
     switch ( cellType )
       {
       case VTK_TETRA:
       case VTK_PYRAMID:
       case VTK_WEDGE:
       case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
       case VTK_TRIANGLE:
       case VTK_QUAD:
+      case VTK_PIXEL:
       case VTK_LINE:
       case VTK_VERTEX:
            bCanClip = true;
@@ -2017,22 +2332,23 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
 
     if ( bCanClip )
       {
-      double    grdDiffs[8];
-      int       caseIndx = 0;
+      int    caseIndx = 0;
+      double grdDiffs[8];
 
-      for ( j = numbPnts - 1; j >= 0; j -- )
+      for ( j = numbPnts-1; j >= 0; j -- )
         {
         grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
         caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
         caseIndx  <<= (  1 - ( !j )  );
         }
 
-      int             startIdx = 0;
-      int             nOutputs = 0;
-      typedef int     EDGEIDXS[2];
-      EDGEIDXS      * edgeVtxs = NULL;
-      unsigned char * thisCase = NULL;
+      int               startIdx = 0;
+      int               nOutputs = 0;
+      typedef const int EDGEIDXS[2];
+      EDGEIDXS        * edgeVtxs = NULL;
+      unsigned char   * thisCase = NULL;
 
+      // start index, split case, number of output, and vertices from edges
       switch ( cellType )
         {
         case VTK_TETRA:
@@ -2067,6 +2383,14 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
                      vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
           break;
 
+        case VTK_VOXEL:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
+          edgeVtxs = ( EDGEIDXS * )
+                     vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+          break;
+
         case VTK_TRIANGLE:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
@@ -2083,12 +2407,20 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
                      vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
           break;
 
-        case VTK_LINE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+        case VTK_PIXEL:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
+          edgeVtxs = ( EDGEIDXS * )
+                     vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+          break;
+
+        case VTK_LINE:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
+          edgeVtxs = ( EDGEIDXS * )
+                     vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
           break;
 
         case VTK_VERTEX:
@@ -2099,14 +2431,15 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
           break;
         }
 
-      int  intrpIds[4];
+      int   intrpIds[4];
       for ( j = 0; j < nOutputs; j ++ )
         {
         int      nCellPts = 0;
-        int      intrpIdx = -1;
         int      theColor = -1;
+        int      intrpIdx = -1;
         unsigned char theShape = *thisCase ++;
 
+        // number of points and color
         switch ( theShape )
           {
           case ST_HEX:
@@ -2123,6 +2456,7 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
             nCellPts = 5;
             theColor = *thisCase ++;
             break;
+
           case ST_TET:
             nCellPts = 4;
             theColor = *thisCase ++;
@@ -2155,8 +2489,8 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
             break;
 
           default:
-            vtkErrorMacro( << "An invalid output shape was found in "
-                           << "the ClipCases." << endl );
+            vtkErrorWithObjectMacro( this->Self, << "An invalid output shape was found "
+                                                 << "in the ClipCases." << endl );
           }
 
         if ( (!this->InsideOut && theColor == COLOR0 ) ||
@@ -2175,13 +2509,16 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
 
           if ( pntIndex <= P7 )
             {
+            // We know pt P0 must be >P0 since we already
+            // assume P0 == 0.  This is why we do not
+            // bother subtracting P0 from pt here.
             shapeIds[p] = pntIndxs[ pntIndex ];
             }
           else
           if ( pntIndex >= EA && pntIndex <= EL )
             {
-            int pt1Index = edgeVtxs[ pntIndex - EA ][0];
-            int pt2Index = edgeVtxs[ pntIndex - EA ][1];
+            int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
+            int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
             if ( pt2Index < pt1Index )
               {
               int temp = pt2Index;
@@ -2204,8 +2541,8 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
             }
           else
             {
-            vtkErrorMacro( << "An invalid output point value "
-                           << "was found in the ClipCases." << endl );
+            vtkErrorWithObjectMacro( this->Self, << "An invalid output point value was found "
+                                                 << "in the ClipCases." << endl );
             }
           }
 
@@ -2250,7 +2587,8 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
             break;
 
           case ST_PNT:
-            intrpIds[intrpIdx] = visItVFV->AddCentroidPoint( nCellPts, shapeIds );
+            intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
+                                             ( nCellPts, shapeIds );
             break;
           }
         }
@@ -2260,726 +2598,534 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
       }
     else
       {
-      if ( numCants == 0 )
-        {
-        specials->GetCellData()
-                ->CopyAllocate( polyData->GetCellData(), numCells );
-        }
-
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
-      specials->GetCellData()
-              ->CopyData( polyData->GetCellData(), i, numCants );
-      numCants ++;
+      // polyhedra and the other cells that can not be clipped by the tables
+      // are handed to vtkClipDataSet once all the batches are done
+      this->Specials[ batch ].push_back( i );
       }
 
     pntIndxs = NULL;
     }
+}
+// ---- vtkTableBasedClipperUnstructuredCells (end)
 
 
-  int         toDelete = 0;
-  double    * theCords = NULL;
-  vtkPoints * inputPts = polyData->GetPoints();
-  if ( inputPts->GetDataType() == VTK_DOUBLE )
-    {
-    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
-    }
-  else
-    {
-    toDelete = 1;
-    numbPnts = inputPts->GetNumberOfPoints();
-    theCords = new double [ numbPnts * 3 ];
-    for ( i = 0; i < numbPnts; i ++ )
+// ---- vtkTableBasedClipperBatches (begin)
+// Runs a cell clipper over contiguous batches of cells, one
+// vtkTableBasedClipperVolumeFromVolume per batch.
+template < class CellClipper >
+class vtkTableBasedClipperBatches
+{
+public:
+  vtkTableBasedClipperBatches( CellClipper & clipper,
+    std::vector< vtkTableBasedClipperVolumeFromVolume * > & batches,
+    vtkIdType numCells, vtkIdType batchSize )
+    : Clipper( clipper ), Batches( batches ), NumCells( numCells ),
+      BatchSize( batchSize )
+  {
+  }
+
+  void operator () ( vtkIdType begin, vtkIdType end ) const
+  {
+    for ( vtkIdType b = begin; b < end; b ++ )
       {
-      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+      vtkIdType first = b * this->BatchSize;
+      vtkIdType last  = first + this->BatchSize;
+      this->Clipper.Execute( this->Batches[b], static_cast< int >( b ), first,
+                             ( last < this->NumCells ? last : this->NumCells ) );
       }
-    }
-  inputPts = NULL;
+  }
 
+protected:
+  CellClipper & Clipper;
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > & Batches;
+  vtkIdType     NumCells;
+  vtkIdType     BatchSize;
 
-  if ( numCants > 0 )
+private:
+  void operator = ( const vtkTableBasedClipperBatches & ); // Not implemented.
+};
+// ---- vtkTableBasedClipperBatches (end)
+
+
+// Number of batches the cells are split into. Unless a batch size is given,
+// a few per thread so that the SMP back-end can balance the load of unevenly
+// cut batches.
+static int vtkTableBasedClipperGetNumberOfBatches( vtkIdType numCells,
+                                                   vtkIdType batchSize )
+{
+  if ( batchSize > 0 )
     {
-    vtkUnstructuredGrid * vtkUGrid  = vtkUnstructuredGrid::New();
-    this->ClipDataSet( specials, clipAray, vtkUGrid );
+    return numCells > batchSize ?
+      static_cast< int >( ( numCells + batchSize - 1 ) / batchSize ) : 1;
+    }
 
-    vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
-    visItVFV->ConstructDataSet( polyData, visItGrd, theCords );
+  vtkIdType numBatches = numCells / TABLE_BASED_CLIPPER_MIN_BATCH_SIZE;
+  vtkIdType maxBatches = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+  if ( maxBatches <= 4 || numBatches < 1 )
+    {
+    return 1;
+    }
 
-    vtkAppendFilter * appender = vtkAppendFilter::New();
-    appender->AddInputData( vtkUGrid );
-    appender->AddInputData( visItGrd );
-    appender->Update();
+  return static_cast< int >
+         ( numBatches < maxBatches ? numBatches : maxBatches );
+}
 
-    outputUG->ShallowCopy( appender->GetOutput() );
 
-    appender->Delete();
-    vtkUGrid->Delete();
-    visItGrd->Delete();
-    appender = NULL;
-    vtkUGrid = NULL;
-    visItGrd = NULL;
+// Clips all the cells with the given cell clipper. The batches are processed
+// concurrently and their edge points are then merged such that the returned
+// vtkTableBasedClipperVolumeFromVolume is exactly the one a single serial
+// pass over the cells would have produced.
+template < class CellClipper >
+vtkTableBasedClipperVolumeFromVolume * vtkTableBasedClipperClipCells
+  ( CellClipper & clipper, int precision, vtkIdType numPts,
+    vtkIdType numCells, int numBatches )
+{
+  vtkIdType batchSize = ( numCells + numBatches - 1 ) / numBatches;
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > batches( numBatches );
+  for ( int b = 0; b < numBatches; b ++ )
+    {
+    batches[b] = new vtkTableBasedClipperVolumeFromVolume( precision,
+      static_cast< int >( numPts ),
+      int(   pow(  double( batchSize ), double( 0.6667f )  )   ) * 5 + 100    );
     }
-  else
+
+  vtkTableBasedClipperBatches< CellClipper > functor
+    ( clipper, batches, numCells, batchSize );
+  vtkSMPTools::For( 0, numBatches, 1, functor );
+
+  if ( numBatches == 1 )
     {
-    visItVFV->ConstructDataSet( polyData, outputUG, theCords );
+    return batches[0];
     }
 
+  vtkTableBasedClipperVolumeFromVolume * visItVFV = new
+  vtkTableBasedClipperVolumeFromVolume
+    ( precision, static_cast< int >( numPts ), 1 );
+  visItVFV->Merge( batches );
 
-  specials->Delete();
-  delete visItVFV;
-  if ( toDelete )
+  for ( int b = 0; b < numBatches; b ++ )
     {
-    delete [] theCords;
+    delete batches[b];
+    batches[b] = NULL;
     }
-  specials = NULL;
-  visItVFV = NULL;
-  theCords = NULL;
-  polyData = NULL;
+
+  return visItVFV;
 }
+// ============================================================================
+// ================= vtkTableBasedClipperClipCells ( end ) ====================
+// ============================================================================
+
+
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+// Construct with user-specified implicit function; InsideOut turned off; value
+// set to 0.0; and generate clip scalars turned off.
+vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
 {
-  vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
-
-  int   i, j;
-  int   numCells = 0;
-  int   isTwoDim = 0;
-  int   rectDims[3];
-  rectGrid->GetDimensions( rectDims );
-  isTwoDim = int( rectDims[2] <= 1 );
-  numCells = rectGrid->GetNumberOfCells();
+  this->Locator      = NULL;
+  this->ClipFunction = cf;
 
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, rectGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+  // setup a callback to report progress
+  this->InternalProgressObserver = vtkCallbackCommand::New();
+  this->InternalProgressObserver->SetCallback
+        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
+  this->InternalProgressObserver->SetClientData( this );
 
-  int   shiftLUT[3][8] = {
-                           { 0, 1, 1, 0, 0, 1, 1, 0 },
-                           { 0, 0, 1, 1, 0, 0, 1, 1 },
-                           { 0, 0, 0, 0, 1, 1, 1, 1 }
-                         };
-  int   cellDims[3] = { rectDims[0] - 1, rectDims[1] - 1, rectDims[2] - 1 };
-  int   cyStride    = cellDims[0];
-  int   czStride    = cellDims[0] * cellDims[1];
-  int   pyStride    = rectDims[0];
-  int   pzStride    = rectDims[0] * rectDims[1];
+  this->Value     = 0.0;
+  this->InsideOut = 0;
+  this->MergeTolerance        = 0.01;
+  this->UseValueAsOffset      = true;
+  this->GenerateClipScalars   = 0;
+  this->GenerateClippedOutput = 0;
 
-  for ( i = 0; i < numCells; i ++ )
-    {
-    int    caseIndx = 0;
-    int    nCellPts = isTwoDim ? 4 : 8;
-    int    theCellI =   i % cellDims[0];
-    int    theCellJ = ( i / cyStride ) % cellDims[1];
-    int    theCellK = ( i / czStride );
-    double grdDiffs[8];
+  this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->BatchSize             = 0;
 
-    for ( j = nCellPts - 1; j >= 0; j -- )
-      {
-      grdDiffs[j] = clipAray->GetComponent
-                              (  ( theCellK + shiftLUT[2][j] ) * pzStride +
-                                 ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                                 ( theCellI + shiftLUT[0][j] ),  0
-                              ) - isoValue;
-      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx  <<= (  1 - ( !j )  );
-      }
+  this->SetNumberOfOutputPorts( 2 );
+  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
+  this->GetExecutive()->SetOutputData( 1, output2 );
+  output2->Delete();
+  output2 = NULL;
 
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = NULL;
+  // process active point scalars by default
+  this->SetInputArrayToProcess
+        ( 0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+          vtkDataSetAttributes::SCALARS );
+}
 
-    if ( isTwoDim )
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-      }
-    else
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-      }
+//-----------------------------------------------------------------------------
+vtkTableBasedClipDataSet::~vtkTableBasedClipDataSet()
+{
+  if ( this->Locator )
+    {
+    this->Locator->UnRegister( this );
+    this->Locator = NULL;
+    }
+  this->SetClipFunction( NULL );
+  this->InternalProgressObserver->Delete();
+  this->InternalProgressObserver = NULL;
+}
 
-    for ( j = 0; j < nOutputs; j++ )
-      {
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::InternalProgressCallbackFunction
+   ( vtkObject * arg, unsigned long, void * clientdata, void * )
+{
+  reinterpret_cast < vtkTableBasedClipDataSet * > ( clientdata )
+    ->InternalProgressCallback(  static_cast < vtkAlgorithm * > ( arg )  );
+}
 
-      nCellPts = 0;
-      switch ( theShape )
-        {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::InternalProgressCallback
+   ( vtkAlgorithm * algorithm )
+{
+  double progress = algorithm->GetProgress();
+  this->UpdateProgress( progress );
 
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
+  if ( this->AbortExecute )
+    {
+    algorithm->SetAbortExecute( 1 );
+    }
+}
 
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
+//-----------------------------------------------------------------------------
+unsigned long vtkTableBasedClipDataSet::GetMTime()
+{
+  unsigned long time;
+  unsigned long mTime = this->Superclass::GetMTime();
 
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
+  if ( this->ClipFunction != NULL )
+    {
+    time  = this->ClipFunction->GetMTime();
+    mTime = ( time > mTime ? time : mTime );
+    }
 
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-        }
-
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-        {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-        }
-
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-        {
-        unsigned char pntIndex = *thisCase ++;
-
-        if ( pntIndex <= P7 )
-          {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-          }
-        else
-        if ( pntIndex >= EA && pntIndex <= EL )
-          {
-          int pt1Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][0];
-          int pt2Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][1];
-
-          if ( pt2Index < pt1Index )
-            {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-            }
-
-          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          /* We may have physically (though not logically) degenerate cells
-          // if p1Weight == 0 or p1Weight == 1. We could pretty easily and
-          // mostly safely clamp percent to the range [1e-4, 1 - 1e-4].
-          if( p1Weight == 1.0)
-            {
-            shapeIds[p] = pntIndx1;
-            }
-          else
-          if( p1Weight == 0.0 )
-            {
-            shapeIds[p] = pntIndx2;
-            }
-          else
-
-            {
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-            }
-          */
-
-          // Turning on the above code segment, the alternative, would cause
-          // a bug with a synthetic Wavelet dataset (vtkImageData) when the
-          // the clipping plane (x/y/z axis) is positioned exactly at (0,0,0).
-          // The problem occurs in the form of an open 'box', as opposed to an
-          // expected closed one. This is due to the use of hash instead of a
-          // point-locator based detection of duplicate points.
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-          }
-        else
-        if ( pntIndex >= N0 && pntIndex <= N3 )
-          {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-          }
-        else
-          {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-          }
-        }
-
-      switch ( theShape )
-        {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
-
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
-
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
-
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
-
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
-
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
+  if ( this->Locator != NULL )
+    {
+    time  = this->Locator->GetMTime();
+    mTime = ( time > mTime ? time : mTime );
+    }
 
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-        }
-      }
+  return mTime;
+}
 
-    thisCase = NULL;
+vtkUnstructuredGrid *vtkTableBasedClipDataSet::GetClippedOutput()
+{
+  if ( !this->GenerateClippedOutput )
+    {
+    return NULL;
     }
 
+  return vtkUnstructuredGrid::SafeDownCast
+        (  this->GetExecutive()->GetOutputData( 1 )  );
+}
 
-  int            toDelete    = 0;
-  double       * theCords[3] = { NULL, NULL, NULL };
-  vtkDataArray * theArays[3] = { NULL, NULL, NULL };
-
-  if ( rectGrid->GetXCoordinates()->GetDataType() == VTK_DOUBLE &&
-       rectGrid->GetYCoordinates()->GetDataType() == VTK_DOUBLE &&
-       rectGrid->GetZCoordinates()->GetDataType() == VTK_DOUBLE
-     )
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::SetLocator
+   ( vtkIncrementalPointLocator * locator )
+{
+  if ( this->Locator == locator)
     {
-    theCords[0] = static_cast < double * >
-                  (  rectGrid->GetXCoordinates()->GetVoidPointer( 0 )  );
-    theCords[1] = static_cast < double * >
-                  (  rectGrid->GetYCoordinates()->GetVoidPointer( 0 )  );
-    theCords[2] = static_cast < double * >
-                  (  rectGrid->GetZCoordinates()->GetVoidPointer( 0 )  );
+    return;
     }
-  else
+
+  if ( this->Locator )
     {
-    toDelete    = 1;
-    theArays[0] = rectGrid->GetXCoordinates();
-    theArays[1] = rectGrid->GetYCoordinates();
-    theArays[2] = rectGrid->GetZCoordinates();
-    for ( j = 0; j < 3; j ++ )
-      {
-      theCords[j] = new double [ rectDims[j] ];
-      for ( i = 0; i < rectDims[j]; i ++ )
-        {
-        theCords[j][i] = theArays[j]->GetComponent( i, 0 );
-        }
-      theArays[j] = NULL;
-      }
+    this->Locator->UnRegister( this );
+    this->Locator = NULL;
     }
 
-  visItVFV->ConstructDataSet
-            ( rectGrid,
-              outputUG, rectDims, theCords[0], theCords[1], theCords[2] );
-
-  delete visItVFV;
-  visItVFV = NULL;
-  rectGrid = NULL;
-
-  for ( i = 0; i < 3; i ++ )
+  if ( locator )
     {
-    if ( toDelete )
-      {
-      delete [] theCords[i];
-      }
-    theCords[i] = NULL;
+    locator->Register( this );
     }
+
+  this->Locator = locator;
+  this->Modified();
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+void vtkTableBasedClipDataSet::CreateDefaultLocator()
 {
-  vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
-
-  int   i, j;
-  int   isTwoDim    = 0;
-  int   numCells    = 0;
-  int   gridDims[3] = { 0, 0, 0 };
-  strcGrid->GetDimensions( gridDims );
-  isTwoDim = int( gridDims[2] <= 1 );
-  numCells = strcGrid->GetNumberOfCells();
-
-  vtkTableBasedClipperVolumeFromVolume  *  visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, strcGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
-
-
-  int   shiftLUT[3][8] = {
-                           { 0, 1, 1, 0, 0, 1, 1, 0 },
-                           { 0, 0, 1, 1, 0, 0, 1, 1 },
-                           { 0, 0, 0, 0, 1, 1, 1, 1 }
-                         };
-  int   numbPnts    = 0;
-  int   cellDims[3] = { gridDims[0] - 1, gridDims[1] - 1, gridDims[2] - 1 };
-  int   cyStride    = cellDims[0];
-  int   czStride    = cellDims[0] * cellDims[1];
-  int   pyStride    = gridDims[0];
-  int   pzStride    = gridDims[0] * gridDims[1];
-
-  for ( i = 0; i < numCells; i ++ )
+  if ( this->Locator == NULL )
     {
-    int    caseIndx = 0;
-    int    theCellI = i % cellDims[0];
-    int    theCellJ = ( i / cyStride ) % cellDims[1];
-    int    theCellK = ( i / czStride );
-    double grdDiffs[8];
-
-    numbPnts = isTwoDim ? 4 : 8;
-
-    for ( j = numbPnts - 1; j >= 0; j -- )
-      {
-      int pntIndex = ( theCellI + shiftLUT[0][j] ) +
-                     ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                     ( theCellK + shiftLUT[2][j] ) * pzStride;
-
-      grdDiffs[j]  = clipAray->GetComponent( pntIndex, 0 ) - isoValue;
-      caseIndx    += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx   <<= (  1 - ( !j )  );
-      }
-
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = NULL;
-
-    if ( isTwoDim )
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-      }
-    else
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-      }
-
-    for ( j = 0; j < nOutputs; j ++ )
-      {
-      int      nCellPts = 0;
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
-
-      switch ( theShape )
-        {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-        }
+    this->Locator = vtkMergePoints::New();
+    this->Locator->Register( this );
+    this->Locator->Delete();
+    }
+}
 
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-        {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-        }
+//-----------------------------------------------------------------------------
+int vtkTableBasedClipDataSet::FillInputPortInformation
+  ( int, vtkInformation * info )
+{
+  info->Set( vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet" );
+  return 1;
+}
 
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-        {
-        unsigned char pntIndex = *thisCase ++;
+//-----------------------------------------------------------------------------
+int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request ),
+    vtkInformationVector ** inputVector, vtkInformationVector * outputVector )
+{
+  // input and output information objects
+  vtkInformation * inputInf = inputVector[0]->GetInformationObject( 0 );
+  vtkInformation * outInfor = outputVector->GetInformationObject( 0 );
 
-        if ( pntIndex <= P7 )
-          {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-          }
-        else
-        if ( pntIndex >= EA && pntIndex <= EL )
-          {
-          int  pt1Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][0];
-          int  pt2Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][1];
+  // Get the input of which we have to create a copy since the clipper requires
+  // that InterpolateAllocate() be invoked for the output based on its input in
+  // terms of the point data. If the input and output arrays are different,
+  // vtkCell3D's Clip will fail. The last argument of InterpolateAllocate makes
+  // sure that arrays are shallow-copied from theInput to cpyInput.
+  vtkDataSet * theInput = vtkDataSet::SafeDownCast
+                          (  inputInf->Get( vtkDataObject::DATA_OBJECT() )  );
+  vtkSmartPointer< vtkDataSet > cpyInput;
+  cpyInput.TakeReference( theInput->NewInstance() );
+  cpyInput->CopyStructure( theInput  );
+  cpyInput->GetCellData()->PassData( theInput->GetCellData() );
+  cpyInput->GetPointData()
+          ->InterpolateAllocate( theInput->GetPointData(), 0, 0, 1 );
 
-          if ( pt2Index < pt1Index )
-            {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-            }
+  // get the output (the remaining and the clipped parts)
+  vtkUnstructuredGrid * outputUG = vtkUnstructuredGrid::SafeDownCast
+                        (  outInfor->Get( vtkDataObject::DATA_OBJECT() )  );
 
-          double pt1ToPt2 = grdDiffs[ pt2Index] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+  inputInf = NULL;
+  outInfor = NULL;
+  theInput = NULL;
+  vtkDebugMacro( << "Clipping dataset" << endl );
 
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ] ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
 
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-          }
-        else
-        if ( pntIndex >= N0 && pntIndex <= N3 )
-          {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-          }
-        else
-          {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-          }
-        }
+  int  i;
+  vtkIdType  numbPnts = cpyInput->GetNumberOfPoints();
 
-      switch ( theShape )
-        {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
+  // handling exceptions
+  if ( numbPnts < 1 )
+    {
+    vtkDebugMacro( << "No data to clip" << endl );
+    outputUG = NULL;
+    return 1;
+    }
 
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
+  if ( !this->ClipFunction && this->GenerateClipScalars )
+    {
+    vtkErrorMacro( << "Cannot generate clip scalars "
+                   << "if no clip function defined" << endl );
+    outputUG = NULL;
+    return 1;
+    }
 
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
 
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
+  vtkDataArray   * clipAray = NULL;
+  vtkDoubleArray * pScalars = NULL;
 
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
+  // check whether the cells are clipped with input scalars or a clip function
+  if ( this->ClipFunction )
+    {
+    pScalars = vtkDoubleArray::New();
+    pScalars->SetNumberOfTuples( numbPnts );
+    pScalars->SetName( "ClipDataSetScalars" );
 
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
+    // enable clipDataSetScalars to be passed to the output
+    if ( this->GenerateClipScalars )
+      {
+      cpyInput->GetPointData()->SetScalars( pScalars );
+      }
 
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
+    for ( i = 0; i < numbPnts; i ++ )
+      {
+      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
+      pScalars->SetTuple1( i, s );
+      }
 
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
+    clipAray = pScalars;
+    }
+  else //using input scalars
+    {
+    clipAray = this->GetInputArrayToProcess( 0, inputVector );
+    if ( !clipAray )
+      {
+      vtkErrorMacro( << "no input scalars." << endl );
+      return 1;
+      }
+    }
 
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-        }
+
+  int    gridType = cpyInput->GetDataObjectType();
+  double isoValue = ( !this->ClipFunction || this->UseValueAsOffset )
+                    ?  this->Value  :  0.0;
+  if ( gridType == VTK_IMAGE_DATA || gridType == VTK_STRUCTURED_POINTS )
+    {
+    int   numbDims;
+    int * dataDims = vtkImageData::SafeDownCast( cpyInput )->GetDimensions();
+    for ( numbDims = 3, i = 0; i < 3; i ++ )
+      {
+      numbDims -= (  ( dataDims[i] <= 1 ) ? 1 : 0  );
       }
+    dataDims = NULL;
 
-    thisCase = NULL;
+    if ( numbDims == 3 )
+      {
+      this->ClipImageData( cpyInput.GetPointer(), clipAray, isoValue, outputUG );
+      }
     }
-
-  int         toDelete = 0;
-  double    * theCords = NULL;
-  vtkPoints * inputPts = strcGrid->GetPoints();
-  if ( inputPts->GetDataType() == VTK_DOUBLE )
+  else
+  if ( gridType == VTK_POLY_DATA )
     {
-    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
+    this->ClipPolyData( cpyInput.GetPointer(), clipAray, isoValue, outputUG );
     }
   else
+  if ( gridType == VTK_RECTILINEAR_GRID )
     {
-    toDelete = 1;
-    numbPnts = inputPts->GetNumberOfPoints();
-    theCords = new double [ numbPnts * 3 ];
-    for ( i = 0; i < numbPnts; i ++ )
-      {
-      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
-      }
+    this->ClipRectilinearGridData( cpyInput.GetPointer(), clipAray,
+                                   isoValue, outputUG );
+    }
+  else
+  if ( gridType == VTK_STRUCTURED_GRID )
+    {
+    this->ClipStructuredGridData( cpyInput.GetPointer(), clipAray,
+                                  isoValue, outputUG );
+    }
+  else
+  if ( gridType == VTK_UNSTRUCTURED_GRID )
+    {
+    this->ClipUnstructuredGridData( cpyInput.GetPointer(), clipAray,
+                                    isoValue, outputUG );
+    }
+  else
+    {
+    this->ClipDataSet( cpyInput.GetPointer(), clipAray, outputUG );
     }
-  inputPts = NULL;
 
-  visItVFV->ConstructDataSet( strcGrid, outputUG, theCords );
+  outputUG->Squeeze();
+
+  if ( pScalars )
+    {
+    pScalars->Delete();
+    }
+  pScalars = NULL;
+  outputUG = NULL;
+  clipAray = NULL;
 
+  return 1;
+}
 
-  delete visItVFV;
-  if ( toDelete )
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipDataSet( vtkDataSet * pDataSet,
+     vtkDataArray * clipAray, vtkUnstructuredGrid * unstruct )
+{
+  vtkClipDataSet * clipData = vtkClipDataSet::New();
+  clipData->SetInputData( pDataSet );
+  clipData->SetValue( this->Value );
+  clipData->SetInsideOut( this->InsideOut );
+  clipData->SetClipFunction( this->ClipFunction );
+  clipData->SetUseValueAsOffset( this->UseValueAsOffset );
+  clipData->SetGenerateClipScalars( this->GenerateClipScalars );
+
+  if ( !this->ClipFunction )
     {
-    delete [] theCords;
+    pDataSet->GetPointData()->SetScalars( clipAray );
     }
-  visItVFV = NULL;
-  theCords = NULL;
-  strcGrid = NULL;
+
+  clipData->Update();
+  unstruct->ShallowCopy( clipData->GetOutput() );
+
+  clipData->Delete();
+  clipData = NULL;
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
+void vtkTableBasedClipDataSet::ClipImageData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
-  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
+  int                  i, j;
+  int                  dataDims[3];
+  double               spacings[3];
+  double               tmpValue = 0.0;
+  double             * dataBBox = NULL;
+  vtkImageData       * volImage = NULL;
+  vtkDoubleArray     * pxCoords = NULL;
+  vtkDoubleArray     * pyCoords = NULL;
+  vtkDoubleArray     * pzCoords = NULL;
+  vtkRectilinearGrid * rectGrid = NULL;
 
-  vtkIdType   i, j;
-  vtkIdType   numbPnts = 0;
-  int         numCants = 0; // number of cells not clipped by this filter
-  int         numCells = unstruct->GetNumberOfCells();
+  volImage = vtkImageData::SafeDownCast( inputGrd );
+  volImage->GetDimensions( dataDims );
+  volImage->GetSpacing( spacings );
+  dataBBox = volImage->GetBounds();
+
+  pxCoords = vtkDoubleArray::New();
+  pyCoords = vtkDoubleArray::New();
+  pzCoords = vtkDoubleArray::New();
+  vtkDoubleArray * tmpArays[3] = { pxCoords, pyCoords, pzCoords };
+  for ( j = 0; j < 3; j ++ )
+    {
+    tmpArays[j]->SetNumberOfComponents( 1 );
+    tmpArays[j]->SetNumberOfTuples( dataDims[j] );
+    for ( tmpValue  = dataBBox[ j << 1 ], i = 0; i < dataDims[j]; i ++,
+          tmpValue += spacings[j] )
+      {
+      tmpArays[j]->SetComponent( i, 0, tmpValue );
+      }
+    tmpArays[j] = NULL;
+    }
+
+  rectGrid = vtkRectilinearGrid::New();
+  rectGrid->SetDimensions( dataDims );
+  rectGrid->SetXCoordinates( pxCoords );
+  rectGrid->SetYCoordinates( pyCoords );
+  rectGrid->SetZCoordinates( pzCoords );
+  rectGrid->GetPointData()->ShallowCopy( volImage->GetPointData() );
+  rectGrid->GetCellData()->ShallowCopy( volImage->GetCellData() );
+
+  this->ClipRectilinearGridData( rectGrid, clipAray, isoValue, outputUG );
+
+  pxCoords->Delete();
+  pyCoords->Delete();
+  pzCoords->Delete();
+  rectGrid->Delete();
+  pxCoords = NULL;
+  pyCoords = NULL;
+  pzCoords = NULL;
+  rectGrid = NULL;
+  volImage = NULL;
+  dataBBox = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
+  int           numCells = polyData->GetNumberOfCells();
 
-  // volume from volume
   vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
   vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, unstruct->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+     this->OutputPointsPrecision, polyData->GetNumberOfPoints(),
+     int(   pow(  double( numCells ),  double( 0.6667f )  )   ) * 5 + 100    );
 
-  // the stuffs that can not be clipped by this filter
   vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
-  specials->SetPoints( unstruct->GetPoints() );
-  specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
+  specials->SetPoints( polyData->GetPoints() );
+  specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
   specials->Allocate( numCells );
 
+  vtkIdType   i, j;
+  vtkIdType   numbPnts = 0;
+  int         numCants = 0;  // number of cells not clipped by this filter
+
   for ( i = 0; i < numCells; i ++ )
     {
-    int         cellType = unstruct->GetCellType( i );
+    int         cellType = polyData->GetCellType( i );
+    bool        bCanClip = false;
     vtkIdType * pntIndxs = NULL;
-    unstruct->GetCellPoints( i, numbPnts, pntIndxs );
+    polyData->GetCellPoints( i, numbPnts, pntIndxs );
 
-    bool     bCanClip = false;
     switch ( cellType )
       {
       case VTK_TETRA:
       case VTK_PYRAMID:
       case VTK_WEDGE:
       case VTK_HEXAHEDRON:
-      case VTK_VOXEL:
       case VTK_TRIANGLE:
       case VTK_QUAD:
-      case VTK_PIXEL:
       case VTK_LINE:
       case VTK_VERTEX:
            bCanClip = true;
@@ -2992,23 +3138,22 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
 
     if ( bCanClip )
       {
-      int    caseIndx = 0;
-      double grdDiffs[8];
+      double    grdDiffs[8];
+      int       caseIndx = 0;
 
-      for ( j = numbPnts-1; j >= 0; j -- )
+      for ( j = numbPnts - 1; j >= 0; j -- )
         {
         grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
         caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
         caseIndx  <<= (  1 - ( !j )  );
         }
 
-      int               startIdx = 0;
-      int               nOutputs = 0;
-      typedef const int EDGEIDXS[2];
-      EDGEIDXS        * edgeVtxs = NULL;
-      unsigned char   * thisCase = NULL;
-
-      // start index, split case, number of output, and vertices from edges
+      int             startIdx = 0;
+      int             nOutputs = 0;
+      typedef int     EDGEIDXS[2];
+      EDGEIDXS      * edgeVtxs = NULL;
+      unsigned char * thisCase = NULL;
+
       switch ( cellType )
         {
         case VTK_TETRA:
@@ -3043,14 +3188,6 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
                      vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
           break;
 
-        case VTK_VOXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
-          break;
-
         case VTK_TRIANGLE:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
@@ -3067,14 +3204,6 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
                      vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
           break;
 
-        case VTK_PIXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
-          break;
-
         case VTK_LINE:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
@@ -3091,15 +3220,14 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
           break;
         }
 
-      int   intrpIds[4];
+      int  intrpIds[4];
       for ( j = 0; j < nOutputs; j ++ )
         {
         int      nCellPts = 0;
-        int      theColor = -1;
         int      intrpIdx = -1;
+        int      theColor = -1;
         unsigned char theShape = *thisCase ++;
 
-        // number of points and color
         switch ( theShape )
           {
           case ST_HEX:
@@ -3116,7 +3244,6 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             nCellPts = 5;
             theColor = *thisCase ++;
             break;
-
           case ST_TET:
             nCellPts = 4;
             theColor = *thisCase ++;
@@ -3149,8 +3276,8 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             break;
 
           default:
-            vtkErrorMacro( << "An invalid output shape was found "
-                           << "in the ClipCases." << endl );
+            vtkErrorMacro( << "An invalid output shape was found in "
+                           << "the ClipCases." << endl );
           }
 
         if ( (!this->InsideOut && theColor == COLOR0 ) ||
@@ -3169,16 +3296,13 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
 
           if ( pntIndex <= P7 )
             {
-            // We know pt P0 must be >P0 since we already
-            // assume P0 == 0.  This is why we do not
-            // bother subtracting P0 from pt here.
             shapeIds[p] = pntIndxs[ pntIndex ];
             }
           else
           if ( pntIndex >= EA && pntIndex <= EL )
             {
-            int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
-            int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
+            int pt1Index = edgeVtxs[ pntIndex - EA ][0];
+            int pt2Index = edgeVtxs[ pntIndex - EA ][1];
             if ( pt2Index < pt1Index )
               {
               int temp = pt2Index;
@@ -3201,8 +3325,8 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             }
           else
             {
-            vtkErrorMacro( << "An invalid output point value was found "
-                           << "in the ClipCases." << endl );
+            vtkErrorMacro( << "An invalid output point value "
+                           << "was found in the ClipCases." << endl );
             }
           }
 
@@ -3247,8 +3371,7 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             break;
 
           case ST_PNT:
-            intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                             ( nCellPts, shapeIds );
+            intrpIds[intrpIdx] = visItVFV->AddCentroidPoint( nCellPts, shapeIds );
             break;
           }
         }
@@ -3256,34 +3379,269 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
       edgeVtxs = NULL;
       thisCase = NULL;
       }
-    else if (cellType == VTK_POLYHEDRON)
+    else
       {
       if ( numCants == 0 )
         {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
+        specials->GetCellData()
+                ->CopyAllocate( polyData->GetCellData(), numCells );
         }
-      vtkIdType nfaces, *facePtIds;
-      unstruct->GetFaceStream(i, nfaces, facePtIds);
-      specials->InsertNextCell(cellType, nfaces, facePtIds);
+
+      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
       specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
+              ->CopyData( polyData->GetCellData(), i, numCants );
       numCants ++;
       }
-    else
+
+    pntIndxs = NULL;
+    }
+
+
+  int         toDelete = 0;
+  double    * theCords = NULL;
+  vtkPoints * inputPts = polyData->GetPoints();
+  if ( inputPts->GetDataType() == VTK_DOUBLE )
+    {
+    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
+    }
+  else
+    {
+    toDelete = 1;
+    numbPnts = inputPts->GetNumberOfPoints();
+    theCords = new double [ numbPnts * 3 ];
+    for ( i = 0; i < numbPnts; i ++ )
+      {
+      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+      }
+    }
+  inputPts = NULL;
+
+
+  if ( numCants > 0 )
+    {
+    vtkUnstructuredGrid * vtkUGrid  = vtkUnstructuredGrid::New();
+    this->ClipDataSet( specials, clipAray, vtkUGrid );
+
+    vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
+    visItVFV->ConstructDataSet( polyData, visItGrd, theCords );
+
+    vtkAppendFilter * appender = vtkAppendFilter::New();
+    appender->AddInputData( vtkUGrid );
+    appender->AddInputData( visItGrd );
+    appender->Update();
+
+    outputUG->ShallowCopy( appender->GetOutput() );
+
+    appender->Delete();
+    vtkUGrid->Delete();
+    visItGrd->Delete();
+    appender = NULL;
+    vtkUGrid = NULL;
+    visItGrd = NULL;
+    }
+  else
+    {
+    visItVFV->ConstructDataSet( polyData, outputUG, theCords );
+    }
+
+
+  specials->Delete();
+  delete visItVFV;
+  if ( toDelete )
+    {
+    delete [] theCords;
+    }
+  specials = NULL;
+  visItVFV = NULL;
+  theCords = NULL;
+  polyData = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
+
+  int   i, j;
+  int   numCells = 0;
+  int   rectDims[3];
+  rectGrid->GetDimensions( rectDims );
+  numCells = rectGrid->GetNumberOfCells();
+
+  vtkTableBasedClipperStructuredCells clipCell
+    ( this, this->InsideOut, clipAray, isoValue, rectDims );
+  vtkTableBasedClipperVolumeFromVolume   * visItVFV =
+  vtkTableBasedClipperClipCells
+    ( clipCell, this->OutputPointsPrecision, rectGrid->GetNumberOfPoints(),
+      numCells,
+      vtkTableBasedClipperGetNumberOfBatches( numCells, this->BatchSize ) );
+
+
+  int            toDelete    = 0;
+  double       * theCords[3] = { NULL, NULL, NULL };
+  vtkDataArray * theArays[3] = { NULL, NULL, NULL };
+
+  if ( rectGrid->GetXCoordinates()->GetDataType() == VTK_DOUBLE &&
+       rectGrid->GetYCoordinates()->GetDataType() == VTK_DOUBLE &&
+       rectGrid->GetZCoordinates()->GetDataType() == VTK_DOUBLE
+     )
+    {
+    theCords[0] = static_cast < double * >
+                  (  rectGrid->GetXCoordinates()->GetVoidPointer( 0 )  );
+    theCords[1] = static_cast < double * >
+                  (  rectGrid->GetYCoordinates()->GetVoidPointer( 0 )  );
+    theCords[2] = static_cast < double * >
+                  (  rectGrid->GetZCoordinates()->GetVoidPointer( 0 )  );
+    }
+  else
+    {
+    toDelete    = 1;
+    theArays[0] = rectGrid->GetXCoordinates();
+    theArays[1] = rectGrid->GetYCoordinates();
+    theArays[2] = rectGrid->GetZCoordinates();
+    for ( j = 0; j < 3; j ++ )
+      {
+      theCords[j] = new double [ rectDims[j] ];
+      for ( i = 0; i < rectDims[j]; i ++ )
+        {
+        theCords[j][i] = theArays[j]->GetComponent( i, 0 );
+        }
+      theArays[j] = NULL;
+      }
+    }
+
+  visItVFV->ConstructDataSet
+            ( rectGrid,
+              outputUG, rectDims, theCords[0], theCords[1], theCords[2] );
+
+  delete visItVFV;
+  visItVFV = NULL;
+  rectGrid = NULL;
+
+  for ( i = 0; i < 3; i ++ )
+    {
+    if ( toDelete )
+      {
+      delete [] theCords[i];
+      }
+    theCords[i] = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
+
+  int   i;
+  int   numCells    = 0;
+  int   gridDims[3] = { 0, 0, 0 };
+  strcGrid->GetDimensions( gridDims );
+  numCells = strcGrid->GetNumberOfCells();
+
+  vtkTableBasedClipperStructuredCells clipCell
+    ( this, this->InsideOut, clipAray, isoValue, gridDims );
+  vtkTableBasedClipperVolumeFromVolume  *  visItVFV =
+  vtkTableBasedClipperClipCells
+    ( clipCell, this->OutputPointsPrecision, strcGrid->GetNumberOfPoints(),
+      numCells,
+      vtkTableBasedClipperGetNumberOfBatches( numCells, this->BatchSize ) );
+
+  int   numbPnts    = 0;
+
+  int         toDelete = 0;
+  double    * theCords = NULL;
+  vtkPoints * inputPts = strcGrid->GetPoints();
+  if ( inputPts->GetDataType() == VTK_DOUBLE )
+    {
+    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
+    }
+  else
+    {
+    toDelete = 1;
+    numbPnts = inputPts->GetNumberOfPoints();
+    theCords = new double [ numbPnts * 3 ];
+    for ( i = 0; i < numbPnts; i ++ )
+      {
+      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+      }
+    }
+  inputPts = NULL;
+
+  visItVFV->ConstructDataSet( strcGrid, outputUG, theCords );
+
+
+  delete visItVFV;
+  if ( toDelete )
+    {
+    delete [] theCords;
+    }
+  visItVFV = NULL;
+  theCords = NULL;
+  strcGrid = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
+
+  vtkIdType   i;
+  vtkIdType   numbPnts = 0;
+  int         numCants = 0; // number of cells not clipped by this filter
+  int         numCells = unstruct->GetNumberOfCells();
+  int         numBatch =
+              vtkTableBasedClipperGetNumberOfBatches( numCells, this->BatchSize );
+
+  // volume from volume
+  vtkTableBasedClipperUnstructuredCells clipCell
+    ( this, this->InsideOut, clipAray, isoValue, unstruct, numBatch );
+  vtkTableBasedClipperVolumeFromVolume   * visItVFV =
+  vtkTableBasedClipperClipCells
+    ( clipCell, this->OutputPointsPrecision, unstruct->GetNumberOfPoints(),
+      numCells, numBatch );
+
+  // the stuffs that can not be clipped by this filter, gathered in the
+  // original cell order
+  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
+  specials->SetPoints( unstruct->GetPoints() );
+  specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
+  specials->Allocate( numCells );
+
+  for ( int b = 0; b < numBatch; b ++ )
+    {
+    std::vector< vtkIdType > & cellIds = clipCell.Specials[b];
+    for ( size_t c = 0; c < cellIds.size(); c ++ )
       {
+      i = cellIds[c];
+      int         cellType = unstruct->GetCellType( i );
+      vtkIdType * pntIndxs = NULL;
+
       if ( numCants == 0 )
         {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
+        specials->GetCellData()
+                ->CopyAllocate( unstruct->GetCellData(), numCells );
+        }
+
+      if ( cellType == VTK_POLYHEDRON )
+        {
+        vtkIdType nfaces, *facePtIds;
+        unstruct->GetFaceStream( i, nfaces, facePtIds );
+        specials->InsertNextCell( cellType, nfaces, facePtIds );
+        }
+      else
+        {
+        unstruct->GetCellPoints( i, numbPnts, pntIndxs );
+        specials->InsertNextCell( cellType, numbPnts, pntIndxs );
         }
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
       specials->GetCellData()
               ->CopyData( unstruct->GetCellData(), i, numCants );
       numCants ++;
+      pntIndxs = NULL;
       }
-
-    pntIndxs = NULL;
     }
 
   int         toDelete = 0;
@@ -3382,4 +3740,6 @@ void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Batch Size: " << this->BatchSize << "\n";
 }
@@ -195,6 +195,14 @@ public:
   vtkSetClampMacro(OutputPointsPrecision, int, SINGLE_PRECISION, DEFAULT_PRECISION);
   vtkGetMacro(OutputPointsPrecision, int);
 
+  // Description:
+  // Set/Get the number of input cells clipped together in one batch. The
+  // batches are clipped concurrently and their points merged afterwards,
+  // which gives the same output whatever the batch size. With the default
+  // of 0 the batch size is chosen from the number of cells and of threads.
+  vtkSetClampMacro( BatchSize, vtkIdType, 0, VTK_ID_MAX );
+  vtkGetMacro( BatchSize, vtkIdType );
+
 protected:
   vtkTableBasedClipDataSet( vtkImplicitFunction * cf = NULL );
   ~vtkTableBasedClipDataSet();
@@ -270,6 +278,7 @@ protected:
   vtkIncrementalPointLocator * Locator;
 
   int OutputPointsPrecision;
+  vtkIdType BatchSize;
 
 private:
   vtkTableBasedClipDataSet( const vtkTableBasedClipDataSet &); // Not implemented.
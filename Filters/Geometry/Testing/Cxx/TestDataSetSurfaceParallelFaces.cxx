@@ -0,0 +1,285 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceParallelFaces.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkDataSetSurfaceFilter produces the same surface with and
+// without ParallelFaceExtraction on a grid mixing all the 3D cell types
+// handled by the parallel mode with a few other cells.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkUnstructuredGrid.h>
+
+namespace
+{
+const int GridSize = 9;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + GridSize * (j + GridSize * k);
+}
+
+void BuildGrid(vtkUnstructuredGrid *grid, bool degenerate)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < GridSize; k++)
+    {
+    for (int j = 0; j < GridSize; j++)
+      {
+      for (int i = 0; i < GridSize; i++)
+        {
+        points->InsertNextPoint(i, j, k);
+        }
+      }
+    }
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate();
+
+  for (int k = 0; k < GridSize - 1; k++)
+    {
+    for (int j = 0; j < GridSize - 1; j++)
+      {
+      for (int i = 0; i < GridSize - 1; i++)
+        {
+        vtkIdType c[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        switch ((i + 2 * j + 3 * k) % 5)
+          {
+          case 0:
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+            break;
+          case 1:
+            {
+            vtkIdType voxel[8] = {
+              c[0], c[1], c[3], c[2], c[4], c[5], c[7], c[6] };
+            grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+            }
+            break;
+          case 2:
+            {
+            vtkIdType w0[6] = { c[0], c[1], c[2], c[4], c[5], c[6] };
+            vtkIdType w1[6] = { c[0], c[2], c[3], c[4], c[6], c[7] };
+            grid->InsertNextCell(VTK_WEDGE, 6, w0);
+            grid->InsertNextCell(VTK_WEDGE, 6, w1);
+            }
+            break;
+          case 3:
+            {
+            vtkIdType tets[5][4] = {
+              { c[0], c[1], c[2], c[5] }, { c[0], c[2], c[3], c[7] },
+              { c[0], c[5], c[7], c[4] }, { c[2], c[7], c[5], c[6] },
+              { c[0], c[2], c[5], c[7] } };
+            for (int t = 0; t < 5; t++)
+              {
+              grid->InsertNextCell(VTK_TETRA, 4, tets[t]);
+              }
+            }
+            break;
+          default:
+            {
+            vtkIdType center =
+              points->InsertNextPoint(i + 0.5, j + 0.5, k + 0.5);
+            int bases[6][4] = { {0,1,2,3}, {4,7,6,5}, {0,4,5,1},
+                                {1,5,6,2}, {2,6,7,3}, {3,7,4,0} };
+            for (int p = 0; p < 6; p++)
+              {
+              vtkIdType pyramid[5] = { c[bases[p][0]], c[bases[p][1]],
+                c[bases[p][2]], c[bases[p][3]], center };
+              grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+              }
+            }
+            break;
+          }
+        }
+      }
+    }
+
+  // Prisms stacked on top of each other next to the lattice.
+  vtkIdType pentagon = points->GetNumberOfPoints();
+  for (int level = 0; level < 3; level++)
+    {
+    for (int p = 0; p < 5; p++)
+      {
+      points->InsertNextPoint(GridSize + 2 + cos(p * 1.2566),
+                              sin(p * 1.2566), level);
+      }
+    }
+  for (int level = 0; level < 2; level++)
+    {
+    vtkIdType prism[10];
+    for (int p = 0; p < 10; p++)
+      {
+      prism[p] = pentagon + 5 * level + p;
+      }
+    grid->InsertNextCell(VTK_PENTAGONAL_PRISM, 10, prism);
+    }
+  vtkIdType hexagon = points->GetNumberOfPoints();
+  for (int level = 0; level < 3; level++)
+    {
+    for (int p = 0; p < 6; p++)
+      {
+      points->InsertNextPoint(GridSize + 5 + cos(p * 1.0472),
+                              sin(p * 1.0472), level);
+      }
+    }
+  for (int level = 0; level < 2; level++)
+    {
+    vtkIdType prism[12];
+    for (int p = 0; p < 12; p++)
+      {
+      prism[p] = hexagon + 6 * level + p;
+      }
+    grid->InsertNextCell(VTK_HEXAGONAL_PRISM, 12, prism);
+    }
+
+  // Cells that do not go through the face extraction.
+  vtkIdType quad[4] = { PointId(0, 0, 0), PointId(1, 0, 0),
+                        PointId(1, 0, 1), PointId(0, 0, 1) };
+  grid->InsertNextCell(VTK_QUAD, 4, quad);
+  vtkIdType line[2] = { PointId(0, 0, 0), hexagon };
+  grid->InsertNextCell(VTK_LINE, 2, line);
+  vtkIdType vertex = pentagon;
+  grid->InsertNextCell(VTK_VERTEX, 1, &vertex);
+
+  // A hexahedron collapsed on one edge makes the filter use the face hash.
+  if (degenerate)
+    {
+    vtkIdType base = points->GetNumberOfPoints();
+    points->InsertNextPoint(0, 0, -1);
+    points->InsertNextPoint(1, 0, -1);
+    points->InsertNextPoint(1, 1, -1);
+    points->InsertNextPoint(0, 1, -1);
+    vtkIdType hex[8] = { base, base + 1, base + 2, base + 3,
+                         PointId(0, 0, 0), PointId(1, 0, 0),
+                         PointId(1, 1, 0), PointId(1, 1, 0) };
+    grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+    }
+
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); i++)
+    {
+    pointScalars->InsertNextValue(i * 0.5);
+    }
+  grid->GetPointData()->SetScalars(pointScalars.GetPointer());
+  vtkNew<vtkDoubleArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); i++)
+    {
+    cellScalars->InsertNextValue(i * 0.25);
+    }
+  grid->GetCellData()->SetScalars(cellScalars.GetPointer());
+}
+
+bool SameArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  if (a == NULL || b == NULL ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < a->GetNumberOfComponents(); c++)
+      {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool SameCells(vtkCellArray *a, vtkCellArray *b)
+{
+  return a->GetNumberOfCells() == b->GetNumberOfCells() &&
+    SameArrays(a->GetData(), b->GetData());
+}
+
+int CompareSurfaces(vtkUnstructuredGrid *grid, const char *name)
+{
+  vtkNew<vtkDataSetSurfaceFilter> hashed;
+  hashed->SetInputData(grid);
+  hashed->PassThroughCellIdsOn();
+  hashed->PassThroughPointIdsOn();
+  hashed->Update();
+
+  vtkNew<vtkDataSetSurfaceFilter> sorted;
+  sorted->SetInputData(grid);
+  sorted->PassThroughCellIdsOn();
+  sorted->PassThroughPointIdsOn();
+  sorted->ParallelFaceExtractionOn();
+  sorted->Update();
+
+  vtkPolyData *expected = hashed->GetOutput();
+  vtkPolyData *output = sorted->GetOutput();
+  std::cout << name << ": " << output->GetNumberOfPoints() << " points, "
+            << output->GetNumberOfPolys() << " polygons" << std::endl;
+  if (expected->GetNumberOfPolys() == 0)
+    {
+    std::cerr << name << ": empty surface." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!SameArrays(expected->GetPoints()->GetData(),
+                  output->GetPoints()->GetData()) ||
+      !SameArrays(expected->GetPointData()->GetArray("PointScalars"),
+                  output->GetPointData()->GetArray("PointScalars")) ||
+      !SameArrays(expected->GetPointData()->GetArray("vtkOriginalPointIds"),
+                  output->GetPointData()->GetArray("vtkOriginalPointIds")))
+    {
+    std::cerr << name << ": points differ." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!SameCells(expected->GetVerts(), output->GetVerts()) ||
+      !SameCells(expected->GetLines(), output->GetLines()) ||
+      !SameCells(expected->GetPolys(), output->GetPolys()) ||
+      !SameArrays(expected->GetCellData()->GetArray("CellScalars"),
+                  output->GetCellData()->GetArray("CellScalars")) ||
+      !SameArrays(expected->GetCellData()->GetArray("vtkOriginalCellIds"),
+                  output->GetCellData()->GetArray("vtkOriginalCellIds")))
+    {
+    std::cerr << name << ": cells differ." << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestDataSetSurfaceParallelFaces(int, char*[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  BuildGrid(grid.GetPointer(), false);
+  vtkNew<vtkUnstructuredGrid> degenerateGrid;
+  BuildGrid(degenerateGrid.GetPointer(), true);
+
+  if (CompareSurfaces(grid.GetPointer(), "Mixed cells") != EXIT_SUCCESS ||
+      CompareSurfaces(degenerateGrid.GetPointer(),
+                      "Degenerate cell") != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
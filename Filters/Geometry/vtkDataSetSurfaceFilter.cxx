@@ -30,6 +30,8 @@
 #include "vtkPolyData.h"
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPSort.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -46,6 +48,7 @@
 #include "vtkStructuredData.h"
 
 #include <algorithm>
+#include <vector>
 #include <vtksys/hash_map.hxx>
 
 #include <cassert>
@@ -99,6 +102,352 @@ protected:
   MapType Map;
 };
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Finds the external faces of the linear 3D cells of an unstructured grid
+// without the face hash. The faces of all cells are recorded in parallel
+// with their point ids rotated so that the smallest comes first (as the
+// hash stores them) and oriented canonically. Sorting the records brings
+// the copies of a shared face next to each other, and the faces used by a
+// single cell are the external ones. These are then ordered by smallest
+// point id and insertion order, which is how the hash is traversed.
+const int VTK_SURFACE_MAX_FACE_SIZE = 6;
+
+const int vtkSurfaceHexFaces[6][4] = {
+  {0,1,5,4}, {0,3,2,1}, {0,4,7,3}, {1,2,6,5}, {2,3,7,6}, {4,5,6,7} };
+const int vtkSurfaceVoxelFaces[6][4] = {
+  {0,1,5,4}, {0,2,3,1}, {0,4,6,2}, {1,3,7,5}, {2,6,7,3}, {4,5,7,6} };
+const int vtkSurfaceTetraFaces[4][3] = {
+  {0,1,3}, {0,2,1}, {0,3,2}, {1,2,3} };
+const int vtkSurfacePentaPrismFaces[7][5] = {
+  {0,1,6,5,-1}, {1,2,7,6,-1}, {2,3,8,7,-1}, {3,4,9,8,-1}, {4,0,5,9,-1},
+  {0,1,2,3,4}, {5,6,7,8,9} };
+const int vtkSurfaceHexaPrismFaces[8][6] = {
+  {0,1,7,6,-1,-1}, {1,2,8,7,-1,-1}, {2,3,9,8,-1,-1}, {3,4,10,9,-1,-1},
+  {4,5,11,10,-1,-1}, {5,0,6,11,-1,-1}, {0,1,2,3,4,5}, {6,7,8,9,10,11} };
+
+//----------------------------------------------------------------------------
+// Returns the number of faces the cell inserts in the face hash, 0 for
+// cells that do not use the hash and -1 for cells that cannot be handled.
+int vtkSurfaceGetNumberOfFaces(int cellType)
+{
+  switch (cellType)
+    {
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+      return 6;
+    case VTK_TETRA:
+      return 4;
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+      return 5;
+    case VTK_PENTAGONAL_PRISM:
+      return 7;
+    case VTK_HEXAGONAL_PRISM:
+      return 8;
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+    case VTK_PIXEL:
+    case VTK_QUAD:
+    case VTK_TRIANGLE:
+    case VTK_POLYGON:
+    case VTK_TRIANGLE_STRIP:
+    case VTK_QUADRATIC_TRIANGLE:
+    case VTK_BIQUADRATIC_TRIANGLE:
+    case VTK_QUADRATIC_QUAD:
+    case VTK_QUADRATIC_LINEAR_QUAD:
+    case VTK_BIQUADRATIC_QUAD:
+      return 0;
+    default:
+      return -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Copies the point ids of a face, in the order used by
+// UnstructuredGridExecute, rotated so that the smallest id comes first.
+// Returns the number of points or 0 if the face has repeated points.
+int vtkSurfaceGetFace(int cellType, const vtkIdType *cellPts, int faceId,
+                      vtkIdType *facePts)
+{
+  const int *verts;
+  int numPts;
+  switch (cellType)
+    {
+    case VTK_HEXAHEDRON:
+      verts = vtkSurfaceHexFaces[faceId];
+      numPts = 4;
+      break;
+    case VTK_VOXEL:
+      verts = vtkSurfaceVoxelFaces[faceId];
+      numPts = 4;
+      break;
+    case VTK_TETRA:
+      verts = vtkSurfaceTetraFaces[faceId];
+      numPts = 3;
+      break;
+    case VTK_WEDGE:
+      verts = vtkWedge::GetFaceArray(faceId);
+      numPts = verts[3] < 0 ? 3 : 4;
+      break;
+    case VTK_PYRAMID:
+      verts = vtkPyramid::GetFaceArray(faceId);
+      numPts = verts[3] < 0 ? 3 : 4;
+      break;
+    case VTK_PENTAGONAL_PRISM:
+      verts = vtkSurfacePentaPrismFaces[faceId];
+      numPts = verts[4] < 0 ? 4 : 5;
+      break;
+    case VTK_HEXAGONAL_PRISM:
+      verts = vtkSurfaceHexaPrismFaces[faceId];
+      numPts = verts[4] < 0 ? 4 : 6;
+      break;
+    default:
+      return 0;
+    }
+
+  int smallest = 0;
+  for (int i = 1; i < numPts; ++i)
+    {
+    if (cellPts[verts[i]] < cellPts[verts[smallest]])
+      {
+      smallest = i;
+      }
+    }
+  for (int i = 0; i < numPts; ++i)
+    {
+    facePts[i] = cellPts[verts[(smallest + i) % numPts]];
+    }
+
+  // The hash does not match degenerate faces consistently, so these are
+  // left to it.
+  for (int i = 1; i < numPts; ++i)
+    {
+    for (int j = 0; j < i; ++j)
+      {
+      if (facePts[i] == facePts[j])
+        {
+        return 0;
+        }
+      }
+    }
+  return numPts;
+}
+
+//----------------------------------------------------------------------------
+struct vtkSurfaceFaceRecord
+{
+  vtkIdType Ids[VTK_SURFACE_MAX_FACE_SIZE];
+  vtkIdType FaceId;
+  int NumberOfPoints;
+
+  // Orders by smallest point id, size and remaining ids so that the copies
+  // of a face are adjacent, then by insertion order.
+  bool operator<(const vtkSurfaceFaceRecord& other) const
+  {
+    if (this->Ids[0] != other.Ids[0])
+      {
+      return this->Ids[0] < other.Ids[0];
+      }
+    if (this->NumberOfPoints != other.NumberOfPoints)
+      {
+      return this->NumberOfPoints < other.NumberOfPoints;
+      }
+    for (int i = 1; i < this->NumberOfPoints; ++i)
+      {
+      if (this->Ids[i] != other.Ids[i])
+        {
+        return this->Ids[i] < other.Ids[i];
+        }
+      }
+    return this->FaceId < other.FaceId;
+  }
+
+  bool SameFace(const vtkSurfaceFaceRecord& other) const
+  {
+    if (this->NumberOfPoints != other.NumberOfPoints)
+      {
+      return false;
+      }
+    for (int i = 0; i < this->NumberOfPoints; ++i)
+      {
+      if (this->Ids[i] != other.Ids[i])
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+};
+
+//----------------------------------------------------------------------------
+struct vtkSurfaceVisibleFace
+{
+  vtkIdType SmallestId;
+  vtkIdType FaceId;
+
+  bool operator<(const vtkSurfaceVisibleFace& other) const
+  {
+    return this->SmallestId < other.SmallestId ||
+      (this->SmallestId == other.SmallestId && this->FaceId < other.FaceId);
+  }
+};
+
+//----------------------------------------------------------------------------
+class vtkSurfaceFaceEmitter
+{
+public:
+  vtkSurfaceFaceEmitter(vtkUnstructuredGrid *input, const vtkIdType *offsets,
+                        vtkSurfaceFaceRecord *records)
+    : Offsets(offsets), Records(records)
+  {
+    this->Types = input->GetCellTypesArray()->GetPointer(0);
+    this->Locations = input->GetCellLocationsArray()->GetPointer(0);
+    this->Connectivity = input->GetCells()->GetPointer();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      const vtkIdType *cellPts = this->Connectivity +
+        this->Locations[cellId] + 1;
+      vtkIdType faceId = this->Offsets[cellId];
+      for (; faceId < this->Offsets[cellId + 1]; ++faceId)
+        {
+        vtkSurfaceFaceRecord &record = this->Records[faceId];
+        int numPts = vtkSurfaceGetFace(this->Types[cellId], cellPts,
+          static_cast<int>(faceId - this->Offsets[cellId]), record.Ids);
+        record.FaceId = faceId;
+        record.NumberOfPoints = numPts;
+        if (numPts == 0)
+          {
+          // Sorts first and makes Build() give up.
+          record.Ids[0] = -1;
+          continue;
+          }
+        // Orient the face so that both copies of a shared face match.
+        if (record.Ids[numPts - 1] < record.Ids[1])
+          {
+          std::reverse(record.Ids + 1, record.Ids + numPts);
+          }
+        }
+      }
+  }
+
+private:
+  const unsigned char *Types;
+  const vtkIdType *Locations;
+  const vtkIdType *Connectivity;
+  const vtkIdType *Offsets;
+  vtkSurfaceFaceRecord *Records;
+};
+
+//----------------------------------------------------------------------------
+class vtkSurfaceExternalFaces
+{
+public:
+  vtkSurfaceExternalFaces() : Input(NULL) {}
+
+  // Whether the faces of the given cell type are handled by this class.
+  static bool IsFaceCell(int cellType)
+  {
+    return vtkSurfaceGetNumberOfFaces(cellType) > 0;
+  }
+
+  // Find the external faces of the input. Returns false when the input
+  // has to go through the face hash instead.
+  bool Build(vtkUnstructuredGrid *input)
+  {
+    if (input == NULL || input->GetCells() == NULL ||
+        input->GetCellTypesArray() == NULL)
+      {
+      return false;
+      }
+    vtkIdType numCells = input->GetNumberOfCells();
+    const unsigned char *types = input->GetCellTypesArray()->GetPointer(0);
+    this->Offsets.resize(numCells + 1);
+    this->Offsets[0] = 0;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+      int numFaces = vtkSurfaceGetNumberOfFaces(types[cellId]);
+      if (numFaces < 0)
+        {
+        return false;
+        }
+      this->Offsets[cellId + 1] = this->Offsets[cellId] + numFaces;
+      }
+    vtkIdType numFaces = this->Offsets[numCells];
+    if (numFaces == 0)
+      {
+      this->Input = input;
+      return true;
+      }
+
+    std::vector<vtkSurfaceFaceRecord> records(numFaces);
+    vtkSurfaceFaceEmitter emitter(input, &this->Offsets[0], &records[0]);
+    vtkSMPTools::For(0, numCells, emitter);
+    vtkSMPSort::Sort(&records[0], &records[0] + numFaces);
+    if (records[0].Ids[0] < 0)
+      {
+      return false;
+      }
+
+    // Keep the faces that appear only once.
+    for (vtkIdType i = 0; i < numFaces; )
+      {
+      vtkIdType next = i + 1;
+      while (next < numFaces && records[next].SameFace(records[i]))
+        {
+        ++next;
+        }
+      if (next == i + 1)
+        {
+        vtkSurfaceVisibleFace face;
+        face.SmallestId = records[i].Ids[0];
+        face.FaceId = records[i].FaceId;
+        this->Faces.push_back(face);
+        }
+      i = next;
+      }
+    if (!this->Faces.empty())
+      {
+      vtkSMPSort::Sort(&this->Faces[0], &this->Faces[0] + this->Faces.size());
+      }
+    this->Input = input;
+    return true;
+  }
+
+  vtkIdType GetNumberOfFaces() const
+  {
+    return static_cast<vtkIdType>(this->Faces.size());
+  }
+
+  // Copy the point ids of the given external face, as the face hash would
+  // have stored them, and return their number. cellId is set to the cell
+  // using the face.
+  int GetFace(vtkIdType idx, vtkIdType *facePts, vtkIdType &cellId) const
+  {
+    vtkIdType faceId = this->Faces[idx].FaceId;
+    cellId = static_cast<vtkIdType>(
+      std::upper_bound(this->Offsets.begin(), this->Offsets.end(), faceId) -
+      this->Offsets.begin()) - 1;
+    vtkIdType numCellPts, *cellPts;
+    this->Input->GetCellPoints(cellId, numCellPts, cellPts);
+    return vtkSurfaceGetFace(this->Input->GetCellType(cellId), cellPts,
+      static_cast<int>(faceId - this->Offsets[cellId]), facePts);
+  }
+
+private:
+  vtkUnstructuredGrid *Input;
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkSurfaceVisibleFace> Faces;
+};
+}
+
 vtkStandardNewMacro(vtkDataSetSurfaceFilter);
 
 //----------------------------------------------------------------------------
@@ -128,6 +477,8 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->OriginalPointIdsName = NULL;
 
   this->NonlinearSubdivisionLevel = 1;
+
+  this->ParallelFaceExtraction = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1291,6 +1642,8 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NonlinearSubdivisionLevel: "
      << this->NonlinearSubdivisionLevel << endl;
+  os << indent << "ParallelFaceExtraction: "
+     << (this->ParallelFaceExtraction ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1360,6 +1713,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     cellIter = vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
     }
 
+  // Find the external faces of the 3D cells before the other cells are
+  // processed. Cells whose faces were found this way are skipped below.
+  vtkSurfaceExternalFaces externalFaces;
+  bool useExternalFaces = this->ParallelFaceExtraction &&
+    externalFaces.Build(vtkUnstructuredGrid::SafeDownCast(input));
+
   vtkUnsignedCharArray* ghosts = input->GetPointGhostArray();
   vtkCellArray *newVerts;
   vtkCellArray *newLines;
@@ -1391,6 +1750,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
 
   // These are for the default case/
   vtkIdList *pts;
+  vtkIdList *neighborIds;
   vtkPoints *coords;
   vtkCell *face;
   int flag2D = 0;
@@ -1402,6 +1762,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   vtkIdList *outPts2;
 
   pts = vtkIdList::New();
+  neighborIds = vtkIdList::New();
   coords = vtkPoints::New();
   parametricCoords = vtkDoubleArray::New();
   parametricCoords2 = vtkDoubleArray::New();
@@ -1499,6 +1860,10 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     progressCount++;
 
     cellType = cellIter->GetCellType();
+    if (useExternalFaces && vtkSurfaceExternalFaces::IsFaceCell(cellType))
+      {
+      continue;
+      }
     switch (cellType)
       {
       case VTK_VERTEX:
@@ -1659,13 +2024,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
             }
           else //3D nonlinear cell
             {
-            vtkIdList *cellIds = vtkIdList::New();
             int numFaces = cell->GetNumberOfFaces();
             for (j=0; j < numFaces; j++)
               {
               face = cell->GetFace(j);
-              input->GetCellNeighbors(cellId, face->PointIds, cellIds);
-              if ( cellIds->GetNumberOfIds() <= 0)
+              input->GetCellNeighbors(cellId, face->PointIds, neighborIds);
+              if ( neighborIds->GetNumberOfIds() <= 0)
                 {
                 // FIXME: Face could not be consistent. vtkOrderedTriangulator is a better option
                 if (this->NonlinearSubdivisionLevel >= 1)
@@ -1702,7 +2066,6 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
                   } // subdivision level
                 } // cell has ids
               } // for faces
-            cellIds->Delete();
             } //3d cell
           } //nonlinear cell
         } // default switch case
@@ -1918,6 +2281,34 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     } // for all cells.
 
 
+  // Transfer the external faces found in parallel, in the order the hash
+  // traversal below would have produced them.
+  vtkIdType numExternalFaces =
+    useExternalFaces ? externalFaces.GetNumberOfFaces() : 0;
+  for (vtkIdType faceIdx = 0; faceIdx < numExternalFaces; ++faceIdx)
+    {
+    vtkIdType facePts[VTK_SURFACE_MAX_FACE_SIZE];
+    vtkIdType cellId;
+    int numFacePts = externalFaces.GetFace(faceIdx, facePts, cellId);
+    bool allGhosts = true;
+    for (i = 0; i < numFacePts; i++)
+      {
+      if (!ghosts || ghosts->GetValue(facePts[i]) == 0)
+        {
+        allGhosts = false;
+        }
+      facePts[i] = this->GetOutputPointId(facePts[i], input, newPts, outputPD);
+      }
+    // If all points of the polygon are ghosts, we throw it away.
+    if (allGhosts)
+      {
+      continue;
+      }
+    newPolys->InsertNextCell(numFacePts, facePts);
+    this->RecordOrigCellId(this->NumberOfNewCells, cellId);
+    outputCD->CopyData(inputCD, cellId, this->NumberOfNewCells++);
+    }
+
   // Now transfer geometry from hash to output (only triangles and quads).
   this->InitQuadHashTraversal();
   while ( (q = this->GetNextVisibleQuadFromHash()) )
@@ -1956,6 +2347,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   cell->Delete();
   coords->Delete();
   pts->Delete();
+  neighborIds->Delete();
   parametricCoords->Delete();
   parametricCoords2->Delete();
   outPts->Delete();
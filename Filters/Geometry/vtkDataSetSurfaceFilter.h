@@ -112,6 +112,18 @@ public:
   vtkSetMacro(NonlinearSubdivisionLevel, int);
   vtkGetMacro(NonlinearSubdivisionLevel, int);
 
+  // Description:
+  // If on, the external faces of the linear 3D cells of an unstructured grid
+  // (tetrahedra, hexahedra, voxels, wedges, pyramids and pentagonal and
+  // hexagonal prisms) are found in parallel by sorting the faces of all
+  // cells instead of inserting them one by one in the face hash. The output
+  // is identical to the one produced when this is off. Inputs containing
+  // other 3D cells or degenerate faces fall back to the face hash. Off by
+  // default.
+  vtkSetMacro(ParallelFaceExtraction, int);
+  vtkGetMacro(ParallelFaceExtraction, int);
+  vtkBooleanMacro(ParallelFaceExtraction, int);
+
   // Description:
   // Direct access methods that can be used to use the this class as an
   // algorithm without using it as a filter.
@@ -245,6 +257,8 @@ protected:
 
   int NonlinearSubdivisionLevel;
 
+  int ParallelFaceExtraction;
+
 private:
   vtkDataSetSurfaceFilter(const vtkDataSetSurfaceFilter&);  // Not implemented.
   void operator=(const vtkDataSetSurfaceFilter&);  // Not implemented.
@@ -588,6 +588,9 @@ void vtkGeometryFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   vtkCellData *outputCD = output->GetCellData();
   vtkCellArray *verts, *lines, *polys, *strips;
   vtkIdList *cellIds, *faceIds;
+  vtkGenericCell *cell;
+  vtkIdList *ipts, *icellIds;
+  vtkPoints *coords;
   char *cellVis;
   int faceId, *faceVerts, numFacePts;
   double x[3];
@@ -626,6 +629,11 @@ void vtkGeometryFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   // Determine nature of what we have to do
   cellIds = vtkIdList::New();
   faceIds = vtkIdList::New();
+  // Scratch objects of the nonlinear cells, reused from cell to cell.
+  cell = vtkGenericCell::New();
+  ipts = vtkIdList::New();
+  icellIds = vtkIdList::New();
+  coords = vtkPoints::New();
   if ( (!this->CellClipping) && (!this->PointClipping) &&
        (!this->ExtentClipping) )
     {
@@ -966,11 +974,7 @@ void vtkGeometryFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
         case VTK_BIQUADRATIC_QUADRATIC_WEDGE:
         case VTK_BIQUADRATIC_QUADRATIC_HEXAHEDRON:
           {
-          vtkGenericCell *cell = vtkGenericCell::New();
           input->GetCell(cellId,cell);
-          vtkIdList *ipts = vtkIdList::New();
-          vtkPoints *coords = vtkPoints::New();
-          vtkIdList *icellIds = vtkIdList::New();
 
           if ( cell->GetCellDimension() == 1 )
             {
@@ -1016,10 +1020,6 @@ void vtkGeometryFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
                 }
               }
             } //3d cell
-          icellIds->Delete();
-          coords->Delete();
-          ipts->Delete();
-          cell->Delete();
           }
           break; //done with quadratic cells
         } //switch
@@ -1070,6 +1070,10 @@ void vtkGeometryFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
 
   cellIds->Delete();
   faceIds->Delete();
+  cell->Delete();
+  ipts->Delete();
+  icellIds->Delete();
+  coords->Delete();
   delete [] cellVis;
 }
 
@@ -0,0 +1,317 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTemporalCachePrefetch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkTemporalDataSetCache reads the next time steps of the
+// playback in the background and serves them without re-executing the
+// upstream pipeline, that the pipeline updates of the main thread wait for
+// the time step being read, that the upstream events are only invoked on the
+// main thread, and that prefetching does not depend on the executive.
+
+#include "vtkAtomicTypes.h"
+#include "vtkCommand.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTemporalDataSetCache.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+
+static const int NUMBER_OF_TIME_STEPS = 10;
+
+//-------------------------------------------------------------------------
+// Produces as many points as the index of the requested time step plus one
+// and counts its executions for each time step, on the main thread or not,
+// and the executions that started while another one was running.
+class vtkTemporalPointSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTemporalPointSource *New();
+  vtkTypeMacro(vtkTemporalPointSource, vtkPolyDataAlgorithm);
+
+  vtkAtomicInt32 Executions[NUMBER_OF_TIME_STEPS];
+  vtkAtomicInt32 MainThreadExecutions[NUMBER_OF_TIME_STEPS];
+  vtkAtomicInt32 Running;
+  vtkAtomicInt32 Overlaps;
+  vtkMultiThreaderIDType MainThread;
+
+protected:
+  vtkTemporalPointSource()
+    : MainThread(vtkMultiThreader::GetCurrentThreadID())
+    {
+    this->SetNumberOfInputPorts(0);
+    }
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+                                 vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double times[NUMBER_OF_TIME_STEPS];
+    for (int i = 0; i < NUMBER_OF_TIME_STEPS; ++i)
+      {
+      times[i] = 0.5 * i;
+      }
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times,
+                 NUMBER_OF_TIME_STEPS);
+    double range[2] = { times[0], times[NUMBER_OF_TIME_STEPS - 1] };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::GetData(outInfo);
+    double time =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+    int index = static_cast<int>(2. * time + 0.5);
+    if (++this->Running > 1)
+      {
+      ++this->Overlaps;
+      }
+
+    // Pretend that reading takes some time.
+    vtksys::SystemTools::Delay(10);
+    this->UpdateProgress(0.5);
+
+    vtkNew<vtkPoints> points;
+    for (int i = 0; i <= index; ++i)
+      {
+      points->InsertNextPoint(i, 0., 0.);
+      }
+    output->SetPoints(points.GetPointer());
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+
+    ++this->Executions[index];
+    if (vtkMultiThreader::ThreadsEqual(
+          this->MainThread, vtkMultiThreader::GetCurrentThreadID()))
+      {
+      ++this->MainThreadExecutions[index];
+      }
+    --this->Running;
+    return 1;
+    }
+};
+
+vtkStandardNewMacro(vtkTemporalPointSource);
+
+//-------------------------------------------------------------------------
+// Counts the events it observes on the main thread and on other threads.
+class vtkThreadEventCounter : public vtkCommand
+{
+public:
+  static vtkThreadEventCounter *New() { return new vtkThreadEventCounter; }
+
+  virtual void Execute(vtkObject*, unsigned long, void*)
+    {
+    if (vtkMultiThreader::ThreadsEqual(
+          this->MainThread, vtkMultiThreader::GetCurrentThreadID()))
+      {
+      ++this->MainThreadEvents;
+      }
+    else
+      {
+      ++this->OtherThreadEvents;
+      }
+    }
+
+  vtkAtomicInt32 MainThreadEvents;
+  vtkAtomicInt32 OtherThreadEvents;
+  vtkMultiThreaderIDType MainThread;
+
+protected:
+  vtkThreadEventCounter()
+    : MainThread(vtkMultiThreader::GetCurrentThreadID()) {}
+};
+
+//-------------------------------------------------------------------------
+// Request time step \a index and check the output.
+static bool UpdateTimeStep(vtkTemporalDataSetCache* cache, int index)
+{
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(cache->GetExecutive());
+  sddp->SetUpdateTimeStep(0, 0.5 * index);
+  cache->Update();
+  vtkPolyData* output = vtkPolyData::SafeDownCast(cache->GetOutputDataObject(0));
+  if (!output || output->GetNumberOfPoints() != index + 1)
+    {
+    cerr << "Wrong output for time step " << index << endl;
+    return false;
+    }
+  return true;
+}
+
+// Give the prefetch thread some time to read time step \a index.
+static bool WaitForTimeStep(vtkTemporalPointSource* source, int index)
+{
+  for (int i = 0; i < 1000 && source->Executions[index] == 0; ++i)
+    {
+    vtksys::SystemTools::Delay(10);
+    }
+  if (source->Executions[index] == 0)
+    {
+    cerr << "Time step " << index << " was not prefetched" << endl;
+    return false;
+    }
+  return true;
+}
+
+//-------------------------------------------------------------------------
+int TestTemporalCachePrefetch(int, char*[])
+{
+  vtkNew<vtkThreadEventCounter> events;
+  vtkNew<vtkTemporalPointSource> source;
+  source->AddObserver(vtkCommand::StartEvent, events.GetPointer());
+  source->AddObserver(vtkCommand::EndEvent, events.GetPointer());
+  source->AddObserver(vtkCommand::ProgressEvent, events.GetPointer());
+  vtkNew<vtkTemporalDataSetCache> cache;
+  cache->SetInputConnection(source->GetOutputPort());
+  cache->SetCacheSize(NUMBER_OF_TIME_STEPS);
+  cache->SetPrefetchCount(3);
+  cache->UpdateInformation();
+
+  // Play forward: once 0 is read, 1, 2 and 3 are prefetched, and so on.
+  if (!UpdateTimeStep(cache.GetPointer(), 0))
+    {
+    return EXIT_FAILURE;
+    }
+  for (int index = 1; index <= 5; ++index)
+    {
+    if (!WaitForTimeStep(source.GetPointer(), index) ||
+        !UpdateTimeStep(cache.GetPointer(), index))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Jump to 9 once 6, 7 and 8 are prefetched, then play backward every
+  // other time step from 7: 3 and 1 are prefetched, 5 is already cached.
+  if (!WaitForTimeStep(source.GetPointer(), 8) ||
+      !UpdateTimeStep(cache.GetPointer(), 9) ||
+      !UpdateTimeStep(cache.GetPointer(), 7))
+    {
+    return EXIT_FAILURE;
+    }
+  for (int index = 5; index >= 1; index -= 2)
+    {
+    if (!WaitForTimeStep(source.GetPointer(), index) ||
+        !UpdateTimeStep(cache.GetPointer(), index))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  cache->WaitForPrefetch();
+
+  // Every time step fits in the cache, so none is read twice, and the
+  // prefetched ones are not read by the pipeline updates.
+  for (int index = 0; index < NUMBER_OF_TIME_STEPS; ++index)
+    {
+    bool prefetched = index != 0 && index != 9;
+    if (source->Executions[index] != 1 ||
+        source->MainThreadExecutions[index] != (prefetched ? 0 : 1))
+      {
+      cerr << "Time step " << index << " read "
+           << source->Executions[index] << " times, "
+           << source->MainThreadExecutions[index]
+           << " on the main thread" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The source events of the main thread updates were invoked, the ones of
+  // the prefetching were not.
+  if (events->MainThreadEvents == 0 || events->OtherThreadEvents != 0)
+    {
+    cerr << events->MainThreadEvents << " events invoked on the main thread, "
+         << events->OtherThreadEvents << " on others" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Updating the source directly while time steps are prefetched waits for
+  // the one being read, and gets the time step it asked for.
+  vtkNew<vtkTemporalPointSource> sharedSource;
+  vtkNew<vtkTemporalDataSetCache> sharedCache;
+  sharedCache->SetInputConnection(sharedSource->GetOutputPort());
+  sharedCache->SetCacheSize(NUMBER_OF_TIME_STEPS);
+  sharedCache->SetPrefetchCount(NUMBER_OF_TIME_STEPS);
+  if (!UpdateTimeStep(sharedCache.GetPointer(), 0))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkStreamingDemandDrivenPipeline* sharedSddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(
+      sharedSource->GetExecutive());
+  for (int i = 0; i < 5; ++i)
+    {
+    int index = NUMBER_OF_TIME_STEPS - 1 - (i % 2);
+    sharedSddp->SetUpdateTimeStep(0, 0.5 * index);
+    // Keep the prefetching from updating the output before it is checked.
+    sharedSddp->LockRequests();
+    sharedSddp->Update(0);
+    vtkIdType numberOfPoints = sharedSource->GetOutput()->GetNumberOfPoints();
+    sharedSddp->UnlockRequests();
+    if (numberOfPoints != index + 1)
+      {
+      cerr << "Wrong source output for time step " << index << endl;
+      return EXIT_FAILURE;
+      }
+    }
+  sharedCache->WaitForPrefetch();
+  if (sharedSource->Overlaps != 0)
+    {
+    cerr << "The source executed " << sharedSource->Overlaps
+         << " times concurrently" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A cache whose executive is created while an executive prototype is set
+  // uses a copy of it, and prefetches all the same.
+  vtkNew<vtkCompositeDataPipeline> prototype;
+  vtkNew<vtkTemporalPointSource> otherSource;
+  vtkNew<vtkTemporalDataSetCache> otherCache;
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype.GetPointer());
+  vtkExecutive* otherExecutive = otherCache->GetExecutive();
+  vtkAlgorithm::SetDefaultExecutivePrototype(NULL);
+  otherCache->SetInputConnection(otherSource->GetOutputPort());
+  otherCache->SetPrefetchCount(3);
+  if (strcmp(otherExecutive->GetClassName(), prototype->GetClassName()) != 0)
+    {
+    cerr << "The executive prototype was not used" << endl;
+    return EXIT_FAILURE;
+    }
+  if (!UpdateTimeStep(otherCache.GetPointer(), 0) ||
+      !WaitForTimeStep(otherSource.GetPointer(), 1) ||
+      !UpdateTimeStep(otherCache.GetPointer(), 1))
+    {
+    return EXIT_FAILURE;
+    }
+  otherCache->WaitForPrefetch();
+  if (otherSource->Executions[1] != 1 ||
+      otherSource->MainThreadExecutions[1] != 0)
+    {
+    cerr << "Time step 1 was not prefetched with the prototype" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -14,26 +14,83 @@
 =========================================================================*/
 #include "vtkTemporalDataSetCache.h"
 
+#include "vtkConditionVariable.h"
+#include "vtkExecutive.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimeStamp.h"
 
+#include <algorithm>
+#include <set>
 #include <vector>
 
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkTemporalDataSetCache);
 
+//---------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkTemporalDataSetCachePrefetchThreadStart(
+  void* arg)
+{
+  vtkTemporalDataSetCache* self = static_cast<vtkTemporalDataSetCache *>(
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+  self->PrefetchThread();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//---------------------------------------------------------------------------
+// Append the executives upstream of \a executive, and then \a executive,
+// to \a order. Reversed, the order lists every executive before the ones
+// it depends on, the order in which pipeline requests lock them.
+static void vtkTemporalDataSetCacheCollectExecutives(
+  vtkExecutive* executive, std::set<vtkExecutive*>& visited,
+  std::vector<vtkExecutive*>& order)
+{
+  if (!visited.insert(executive).second)
+    {
+    return;
+    }
+  for (int i = 0; i < executive->GetNumberOfInputPorts(); ++i)
+    {
+    for (int j = 0; j < executive->GetNumberOfInputConnections(i); ++j)
+      {
+      vtkExecutive* input = executive->GetInputExecutive(i, j);
+      if (input)
+        {
+        vtkTemporalDataSetCacheCollectExecutives(input, visited, order);
+        }
+      }
+    }
+  order.push_back(executive);
+}
+
 
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 vtkTemporalDataSetCache::vtkTemporalDataSetCache()
 {
   this->CacheSize = 10;
+  this->PrefetchCount = 0;
+  this->PrefetchMemoryLimit = 0;
+  this->LastTime = 0.;
+  this->LastTimeIndex = -1;
+  this->PrefetchStride = 1;
+  this->NextPrefetch = 0;
+  this->PrefetchUpdateTime = 0;
+  this->Prefetching = false;
+  this->StopPrefetchThread = false;
+  this->PrefetchThreadId = -1;
+  this->PrefetchPort = 0;
+  this->Threader = vtkMultiThreader::New();
+  this->PrefetchLock = vtkMutexLock::New();
+  this->PrefetchCondition = vtkConditionVariable::New();
   this->SetNumberOfInputPorts(1);
   this->SetNumberOfOutputPorts(1);
 }
@@ -41,6 +98,19 @@ vtkTemporalDataSetCache::vtkTemporalDataSetCache()
 //----------------------------------------------------------------------------
 vtkTemporalDataSetCache::~vtkTemporalDataSetCache()
 {
+  if (this->PrefetchThreadId >= 0)
+    {
+    this->PrefetchLock->Lock();
+    this->StopPrefetchThread = true;
+    this->PrefetchCondition->Broadcast();
+    this->PrefetchLock->Unlock();
+    this->Threader->TerminateThread(this->PrefetchThreadId);
+    }
+  this->ClearPrefetchExecutives();
+  this->Threader->Delete();
+  this->PrefetchLock->Delete();
+  this->PrefetchCondition->Delete();
+
   CacheType::iterator pos = this->Cache.begin();
   for (; pos != this->Cache.end();)
     {
@@ -54,6 +124,10 @@ int vtkTemporalDataSetCache::ProcessRequest(
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
+  // The upstream pipeline and the cache are not used by the prefetch
+  // thread during the request.
+  this->WaitForPrefetch();
+
   // create the output
   if(request->Has(vtkDemandDrivenPipeline::REQUEST_DATA_OBJECT()))
     {
@@ -103,6 +177,8 @@ void vtkTemporalDataSetCache::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "PrefetchCount: " << this->PrefetchCount << endl;
+  os << indent << "PrefetchMemoryLimit: " << this->PrefetchMemoryLimit << endl;
 }
 //----------------------------------------------------------------------------
 void vtkTemporalDataSetCache::SetCacheSize(int size)
@@ -113,6 +189,8 @@ void vtkTemporalDataSetCache::SetCacheSize(int size)
     return;
     }
 
+  this->WaitForPrefetch();
+
   // if growing the cache, there is no need to do anything
   this->CacheSize = size;
   if (this->Cache.size() <= static_cast<unsigned long>(size))
@@ -320,6 +398,8 @@ int vtkTemporalDataSetCache::RequestData(
   output->Delete();
   output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), upTime);
 
+  this->SchedulePrefetch(inInfo, upTime);
+
   // now we need to update the cache, based on the new data and the cache
   // size add the requested data to the cache first
   if(input->GetInformation()->Has(vtkDataObject::DATA_TIME_STEP()))
@@ -362,5 +442,266 @@ int vtkTemporalDataSetCache::RequestData(
         }
       }
     }
+
+  // Read the next time steps of the playback while this one is used.
+  this->StartPrefetch();
   return 1;
 }
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::SchedulePrefetch(vtkInformation* inInfo,
+                                               double upTime)
+{
+  // The prefetch thread reads the time steps to prefetch: stop it before
+  // replacing them.
+  this->WaitForPrefetch();
+  this->PrefetchLock->Lock();
+  this->PrefetchTimes.clear();
+  this->NextPrefetch = 0;
+  int numTimeSteps = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (this->PrefetchCount == 0 || numTimeSteps <= 0)
+    {
+    this->PrefetchLock->Unlock();
+    return;
+    }
+  double* timeSteps = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  double* found = std::find(timeSteps, timeSteps + numTimeSteps, upTime);
+  if (found == timeSteps + numTimeSteps)
+    {
+    this->PrefetchLock->Unlock();
+    return;
+    }
+
+  // Follow the playback: step through the input time steps as between the
+  // last two requests.
+  int index = static_cast<int>(found - timeSteps);
+  if (this->LastTimeIndex >= 0 && index != this->LastTimeIndex)
+    {
+    this->PrefetchStride = index - this->LastTimeIndex;
+    }
+  this->LastTime = upTime;
+  this->LastTimeIndex = index;
+
+  for (int i = 1; i <= this->PrefetchCount; ++i)
+    {
+    index += this->PrefetchStride;
+    if (index < 0 || index >= numTimeSteps)
+      {
+      break;
+      }
+    this->PrefetchTimes.push_back(timeSteps[index]);
+    }
+  // Nothing is read until StartPrefetch().
+  this->NextPrefetch = this->PrefetchTimes.size();
+
+  // Prefetched data is valid as long as the pipeline is not modified.
+  vtkTimeStamp stamp;
+  stamp.Modified();
+  this->PrefetchUpdateTime = stamp.GetMTime();
+  this->PrefetchLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::StartPrefetch()
+{
+  int algPort;
+  vtkAlgorithm* input = this->GetInputAlgorithm(0, 0, algPort);
+  if (this->PrefetchTimes.empty() || !input ||
+      !vtkStreamingDemandDrivenPipeline::SafeDownCast(input->GetExecutive()))
+    {
+    return;
+    }
+  if (this->PrefetchThreadId < 0)
+    {
+    this->PrefetchThreadId = this->Threader->SpawnThread(
+      vtkTemporalDataSetCachePrefetchThreadStart, this);
+    }
+
+  // The prefetch thread locks the upstream executives, so that no pipeline
+  // request runs them at the same time, and does not follow the input
+  // connections itself: they are collected here.
+  std::set<vtkExecutive*> visited;
+  std::vector<vtkExecutive*> order;
+  vtkTemporalDataSetCacheCollectExecutives(
+    input->GetExecutive(), visited, order);
+
+  this->PrefetchLock->Lock();
+  this->ClearPrefetchExecutives();
+  std::vector<vtkExecutive*>::reverse_iterator it;
+  for (it = order.rbegin(); it != order.rend(); ++it)
+    {
+    (*it)->Register(this);
+    this->PrefetchExecutives.push_back(*it);
+    }
+  this->PrefetchPort = algPort;
+  this->NextPrefetch = 0;
+  this->PrefetchCondition->Broadcast();
+  this->PrefetchLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::ClearPrefetchExecutives()
+{
+  std::vector<vtkExecutive*>::iterator it;
+  for (it = this->PrefetchExecutives.begin();
+       it != this->PrefetchExecutives.end(); ++it)
+    {
+    (*it)->UnRegister(this);
+    }
+  this->PrefetchExecutives.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::WaitForPrefetch()
+{
+  if (this->PrefetchThreadId < 0)
+    {
+    return;
+    }
+  this->PrefetchLock->Lock();
+  this->NextPrefetch = this->PrefetchTimes.size();
+  while (this->Prefetching)
+    {
+    this->PrefetchCondition->Wait(this->PrefetchLock);
+    }
+  this->PrefetchLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::PrefetchThread()
+{
+  this->PrefetchLock->Lock();
+  while (!this->StopPrefetchThread)
+    {
+    if (this->NextPrefetch >= this->PrefetchTimes.size())
+      {
+      this->PrefetchCondition->Wait(this->PrefetchLock);
+      continue;
+      }
+    double time = this->PrefetchTimes[this->NextPrefetch++];
+    this->Prefetching = true;
+    this->PrefetchLock->Unlock();
+
+    this->PrefetchTimeStep(time);
+
+    this->PrefetchLock->Lock();
+    this->Prefetching = false;
+    this->PrefetchCondition->Broadcast();
+    }
+  this->PrefetchLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::PrefetchTimeStep(double time)
+{
+  if (this->Cache.find(time) != this->Cache.end())
+    {
+    return;
+    }
+  if (!this->MakeRoomForPrefetch())
+    {
+    // Stop prefetching: the following time steps would not fit either.
+    this->PrefetchLock->Lock();
+    this->NextPrefetch = this->PrefetchTimes.size();
+    this->PrefetchLock->Unlock();
+    return;
+    }
+
+  // Keep the pipeline requests of other threads out of the upstream
+  // executives for the whole update, locking them downstream first as
+  // the requests do, and keep the algorithm events, which their observers
+  // expect on the thread driving the pipeline, from firing on this one.
+  std::vector<vtkExecutive*>::iterator it;
+  for (it = this->PrefetchExecutives.begin();
+       it != this->PrefetchExecutives.end(); ++it)
+    {
+    (*it)->LockRequests();
+    (*it)->SetBackgroundUpdate(1);
+    }
+
+  // The first executive is the one of the input. Restore the time step
+  // requested from its output afterwards, as a thread that set it may not
+  // have updated yet.
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(
+      this->PrefetchExecutives[0]);
+  vtkInformation* outInfo = sddp->GetOutputInformation(this->PrefetchPort);
+  bool hadTime =
+    outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) != 0;
+  double oldTime = hadTime ?
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) : 0.;
+
+  sddp->SetUpdateTimeStep(this->PrefetchPort, time);
+  vtkDataObject* data = NULL;
+  if (sddp->Update(this->PrefetchPort))
+    {
+    data = sddp->GetOutputData(this->PrefetchPort);
+    }
+  if (data &&
+      data->GetInformation()->Has(vtkDataObject::DATA_TIME_STEP()) &&
+      data->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP()) == time)
+    {
+    vtkDataObject* cachedData = data->NewInstance();
+    cachedData->ShallowCopy(data);
+    this->Cache[time] = std::pair<unsigned long, vtkDataObject *>
+      (this->PrefetchUpdateTime, cachedData);
+    }
+
+  if (hadTime)
+    {
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+                 oldTime);
+    }
+  else
+    {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+    }
+  std::vector<vtkExecutive*>::reverse_iterator rit;
+  for (rit = this->PrefetchExecutives.rbegin();
+       rit != this->PrefetchExecutives.rend(); ++rit)
+    {
+    (*rit)->SetBackgroundUpdate(0);
+    (*rit)->UnlockRequests();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkTemporalDataSetCache::MakeRoomForPrefetch()
+{
+  while (!this->Cache.empty())
+    {
+    unsigned long memorySize = 0;
+    CacheType::iterator pos;
+    for (pos = this->Cache.begin(); pos != this->Cache.end(); ++pos)
+      {
+      memorySize += pos->second.second->GetActualMemorySize();
+      }
+    if (this->Cache.size() < static_cast<unsigned long>(this->CacheSize) &&
+        (this->PrefetchMemoryLimit == 0 ||
+         memorySize < this->PrefetchMemoryLimit))
+      {
+      return true;
+      }
+
+    // Get rid of the least recently used data that is not about to be used.
+    CacheType::iterator oldestpos = this->Cache.end();
+    for (pos = this->Cache.begin(); pos != this->Cache.end(); ++pos)
+      {
+      if (std::find(this->PrefetchTimes.begin(), this->PrefetchTimes.end(),
+                    pos->first) == this->PrefetchTimes.end() &&
+          (this->LastTimeIndex < 0 || pos->first != this->LastTime) &&
+          (oldestpos == this->Cache.end() ||
+           pos->second.first < oldestpos->second.first))
+        {
+        oldestpos = pos;
+        }
+      }
+    if (oldestpos == this->Cache.end())
+      {
+      return false;
+      }
+    oldestpos->second.second->UnRegister(this);
+    this->Cache.erase(oldestpos);
+    }
+  return this->CacheSize > 0;
+}
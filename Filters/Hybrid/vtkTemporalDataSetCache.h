@@ -16,6 +16,14 @@
 // .SECTION Description
 // vtkTemporalDataSetCache cache time step requests of a temporal dataset,
 // when cached data is requested it is returned using a shallow copy.
+//
+// With a non-zero PrefetchCount, the time steps that playback will request
+// next are read into the cache by a background thread while the current one
+// is used downstream. The upstream pipeline then executes on that thread,
+// one time step at a time, with the requests of its executives locked: the
+// pipeline updates of other threads wait for the time step to be read. The
+// start, end and progress events of the upstream algorithms are not invoked
+// for these updates.
 // .SECTION Thanks
 // Ken Martin (Kitware) and John Bidiscombe of
 // CSCS - Swiss National Supercomputing Centre
@@ -32,6 +40,11 @@
 
 #include "vtkAlgorithm.h"
 #include <map> // used for the cache
+#include <vector> // used for the time steps to prefetch
+
+class vtkConditionVariable;
+class vtkMultiThreader;
+class vtkMutexLock;
 
 class VTKFILTERSHYBRID_EXPORT vtkTemporalDataSetCache : public vtkAlgorithm
 {
@@ -46,6 +59,33 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize,int);
 
+  // Description:
+  // Number of time steps to read into the cache ahead of the requested one,
+  // on a background thread. They follow the direction and the rate of
+  // playback, i.e. the input time steps are stepped through as between the
+  // last two requests. Prefetched time steps are then served from the cache
+  // without executing the upstream pipeline. It defaults to 0: no
+  // prefetching. The cache must be large enough to hold the prefetched time
+  // steps (see SetCacheSize()).
+  vtkSetClampMacro(PrefetchCount,int,0,VTK_INT_MAX);
+  vtkGetMacro(PrefetchCount,int);
+
+  // Description:
+  // Memory budget of the prefetching, in kibibytes: no more time steps are
+  // prefetched once the cached data uses that much. It defaults to 0: the
+  // number of prefetched time steps is only limited by the cache size.
+  vtkSetMacro(PrefetchMemoryLimit,unsigned long);
+  vtkGetMacro(PrefetchMemoryLimit,unsigned long);
+
+  // Description:
+  // Wait for the time step being prefetched, if any, and cancel the
+  // prefetching of the following ones.
+  void WaitForPrefetch();
+
+  // Description:
+  // The prefetch thread method. For internal use only.
+  void PrefetchThread();
+
 protected:
   vtkTemporalDataSetCache();
   ~vtkTemporalDataSetCache();
@@ -58,6 +98,59 @@ protected:
   CacheType Cache;
 //ETX
 
+  int PrefetchCount;
+  unsigned long PrefetchMemoryLimit;
+
+  // Description:
+  // Playback position and rate: the last requested time and its index in
+  // the input time steps, and the number of time steps between requests.
+  double LastTime;
+  int LastTimeIndex;
+  int PrefetchStride;
+
+//BTX
+  // Description:
+  // The time steps to prefetch after the last request, the index of the
+  // next one to read and the time stamp of the cache entries they make.
+  std::vector<double> PrefetchTimes;
+  size_t NextPrefetch;
+  unsigned long PrefetchUpdateTime;
+
+  // Description:
+  // The executives upstream of the cache, each before the ones it depends
+  // on, and the output port of the first one, that of the input.
+  std::vector<vtkExecutive*> PrefetchExecutives;
+  int PrefetchPort;
+//ETX
+  bool Prefetching;
+  bool StopPrefetchThread;
+  int PrefetchThreadId;
+  vtkMultiThreader* Threader;
+  vtkMutexLock* PrefetchLock;
+  vtkConditionVariable* PrefetchCondition;
+
+  // Description:
+  // Choose the time steps to prefetch after a request for time \a upTime.
+  void SchedulePrefetch(vtkInformation* inInfo, double upTime);
+
+  // Description:
+  // Start reading the time steps chosen by the last SchedulePrefetch() in
+  // the background. Called once the input is in the cache.
+  void StartPrefetch();
+
+  // Description:
+  // Release the executives of the last StartPrefetch().
+  void ClearPrefetchExecutives();
+
+  // Description:
+  // Read one time step into the cache on the prefetch thread.
+  void PrefetchTimeStep(double time);
+
+  // Description:
+  // Evict the least recently used time steps that are not to be prefetched
+  // until there is room for one more time step within CacheSize and
+  // PrefetchMemoryLimit. Return false if there is no such room.
+  bool MakeRoomForPrefetch();
 
   // Description:
   // see vtkAlgorithm for details
@@ -23,13 +23,17 @@
 #include "vtkImageData.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <sys/stat.h>
 #include <ctype.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <map>
@@ -46,12 +50,127 @@ class vtkEnSightGoldBinaryReader::FileOffsetMapInternal
     typedef std::map<MapKey, MapValue>::value_type value_type;
 
     std::map<MapKey, MapValue> Map;
+
+    // Number of time steps counted in each geometry file, so that the whole
+    // file is only scanned again when its size or modification time changes.
+    struct TimeStepCount
+    {
+      int NumberOfTimeSteps;
+      vtkTypeInt64 FileSize;
+      vtkTypeInt64 FileModifiedTime;
+    };
+    std::map<MapKey, TimeStepCount> NumberOfTimeSteps;
 };
 
 
 // This is half the precision of an int.
 #define MAXIMUM_PART_ID 65536
 
+// Number of nodes up to which the unique nodes of a polyhedron are found
+// by linear search.
+#define VTK_ENSIGHT_GOLD_BINARY_SMALL_POLYHEDRON 64
+
+namespace
+{
+// Converts the 1-based node ids of a connectivity list to point ids.
+class vtkEnSightGoldBinaryPointIds
+{
+public:
+  const int *NodeIdList;
+  vtkIdType *PointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      this->PointIds[i] = this->NodeIdList[i] - 1;
+      }
+    }
+};
+
+// Converts nfaced elements to the face streams and the unique point ids
+// (in order of first use) of vtkPolyhedron cells.  Element i starts at
+// face FaceOffsets[i] and node NodeOffsets[i] of the lists read from the
+// file; its face stream starts at FaceOffsets[i] + NodeOffsets[i] and its
+// point ids at NodeOffsets[i].
+class vtkEnSightGoldBinaryPolyhedra
+{
+public:
+  const int *NumFacesPerElement;
+  const int *NumNodesPerFace;
+  const int *NodeIdList;
+  const vtkIdType *FaceOffsets;
+  const vtkIdType *NodeOffsets;
+  vtkIdType *FaceStreams;
+  vtkIdType *PointIds;
+  vtkIdType *NumberOfPointIds;
+
+  vtkSMPThreadLocal<std::vector<int> > SortedIds;
+  vtkSMPThreadLocal<std::vector<char> > Used;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    std::vector<int>& sortedIds = this->SortedIds.Local();
+    std::vector<char>& used = this->Used.Local();
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      const int *nodeIds = this->NodeIdList + this->NodeOffsets[i];
+      vtkIdType numNodes = this->NodeOffsets[i + 1] - this->NodeOffsets[i];
+
+      vtkIdType *faceStream =
+        this->FaceStreams + this->FaceOffsets[i] + this->NodeOffsets[i];
+      const int *numNodesPerFace = this->NumNodesPerFace + this->FaceOffsets[i];
+      vtkIdType node = 0;
+      for (int j = 0; j < this->NumFacesPerElement[i]; j++)
+        {
+        *faceStream++ = numNodesPerFace[j];
+        for (int k = 0; k < numNodesPerFace[j]; k++)
+          {
+          *faceStream++ = nodeIds[node++] - 1;
+          }
+        }
+
+      // Nodes are shared by several faces: keep the first use of each.
+      // Polyhedra usually have few nodes, which are looked up among those
+      // already kept; larger ones are looked up in a sorted copy.
+      vtkIdType *pointIds = this->PointIds + this->NodeOffsets[i];
+      vtkIdType numPointIds = 0;
+      if (numNodes <= VTK_ENSIGHT_GOLD_BINARY_SMALL_POLYHEDRON)
+        {
+        for (node = 0; node < numNodes; node++)
+          {
+          vtkIdType id = nodeIds[node] - 1;
+          if (std::find(pointIds, pointIds + numPointIds, id) ==
+              pointIds + numPointIds)
+            {
+            pointIds[numPointIds++] = id;
+            }
+          }
+        }
+      else
+        {
+        sortedIds.assign(nodeIds, nodeIds + numNodes);
+        std::sort(sortedIds.begin(), sortedIds.end());
+        sortedIds.erase(std::unique(sortedIds.begin(), sortedIds.end()),
+                        sortedIds.end());
+        used.assign(sortedIds.size(), 0);
+        for (node = 0; node < numNodes; node++)
+          {
+          size_t pos = std::lower_bound(sortedIds.begin(), sortedIds.end(),
+            nodeIds[node]) - sortedIds.begin();
+          if (!used[pos])
+            {
+            used[pos] = 1;
+            pointIds[numPointIds++] = nodeIds[node] - 1;
+            }
+          }
+        }
+      this->NumberOfPointIds[i] = numPointIds;
+      }
+    }
+};
+}
+
 //----------------------------------------------------------------------------
 vtkEnSightGoldBinaryReader::vtkEnSightGoldBinaryReader()
 {
@@ -59,6 +178,7 @@ vtkEnSightGoldBinaryReader::vtkEnSightGoldBinaryReader()
 
   this->IFile = NULL;
   this->FileSize = 0;
+  this->FileModifiedTime = 0;
   this->SizeOfInt = (int)sizeof(int);
   this->Fortran = 0;
   this->NodeIdsListed = 0;
@@ -102,6 +222,7 @@ int vtkEnSightGoldBinaryReader::OpenFile(const char* filename)
     {
     // Find out how big the file is.
     this->FileSize = (vtkIdType)(fs.st_size);
+    this->FileModifiedTime = (vtkTypeInt64)(fs.st_mtime);
 
 #ifdef _WIN32
     this->IFile = new ifstream(filename, ios::in | ios::binary);
@@ -258,13 +379,33 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
     return 0;
     }
 
-  //this will close the file, so we need to reinitialize it
-  int numberOfTimeStepsInFile=this->CountTimeSteps();
+  // Counting the time steps scans the whole file and indexes every time step
+  // on the way, so only do it again when the file has changed, for instance
+  // when a running simulation appends time steps to it.
+  int numberOfTimeStepsInFile;
+  FileOffsetMapInternal::TimeStepCount& count =
+    this->FileOffsets->NumberOfTimeSteps[fileName];
+  if (count.FileSize == this->FileSize &&
+      count.FileModifiedTime == this->FileModifiedTime)
+    {
+    numberOfTimeStepsInFile = count.NumberOfTimeSteps;
+    }
+  else
+    {
+    // The offsets indexed before the change may be stale.
+    this->FileOffsets->Map.erase(fileName);
+    count.FileSize = this->FileSize;
+    count.FileModifiedTime = this->FileModifiedTime;
 
-  if (!this->InitializeFile(fileName))
-  {
-  return 0;
-  }
+    //this will close the file, so we need to reinitialize it
+    numberOfTimeStepsInFile = this->CountTimeSteps(fileName);
+    count.NumberOfTimeSteps = numberOfTimeStepsInFile;
+
+    if (!this->InitializeFile(fileName))
+      {
+      return 0;
+      }
+    }
 
 
   if (this->UseFileSets)
@@ -278,7 +419,7 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
       // if we are not at the appropriate time step yet, we keep searching
       for (; i < timeStep - 1; i++)
         {
-        if (!this->SkipTimeStep())
+        if (!this->SkipTimeStep(fileName, i))
           {
           return 0;
           }
@@ -432,12 +573,12 @@ int vtkEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int timeS
 
 
 //----------------------------------------------------------------------------
-int vtkEnSightGoldBinaryReader::CountTimeSteps()
+int vtkEnSightGoldBinaryReader::CountTimeSteps(const char* fileName)
 {
   int count=0;
   while(1)
     {
-    int result=this->SkipTimeStep();
+    int result=this->SkipTimeStep(fileName, count);
     if (result)
       {
       count++;
@@ -451,7 +592,8 @@ int vtkEnSightGoldBinaryReader::CountTimeSteps()
 }
 
 //----------------------------------------------------------------------------
-int vtkEnSightGoldBinaryReader::SkipTimeStep()
+int vtkEnSightGoldBinaryReader::SkipTimeStep(const char* fileName,
+                                             int realTimeStep)
 {
   char line[80], subLine[80];
   int lineRead;
@@ -464,6 +606,10 @@ int vtkEnSightGoldBinaryReader::SkipTimeStep()
       return 0;
       }
     }
+  if (fileName)
+    {
+    this->AddTimeStepToCache(fileName, realTimeStep, this->IFile->tellg());
+    }
 
   // Skip the 2 description lines.
   this->ReadLine(line);
@@ -1130,7 +1276,6 @@ int vtkEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   char line[80], subLine[80];
   vtkIdType i;
   int *pointIds;
-  float *xCoords, *yCoords, *zCoords;
   vtkPoints *points = vtkPoints::New();
   vtkPolyData *pd = vtkPolyData::New();
 
@@ -1224,10 +1369,6 @@ int vtkEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   this->ReadInt(&this->NumberOfMeasuredPoints);
 
   pointIds = new int[this->NumberOfMeasuredPoints];
-  xCoords = new float [this->NumberOfMeasuredPoints];
-  yCoords = new float [this->NumberOfMeasuredPoints];
-  zCoords = new float [this->NumberOfMeasuredPoints];
-  points->Allocate(this->NumberOfMeasuredPoints);
   pd->Allocate(this->NumberOfMeasuredPoints);
 
   // Extract the array of point indices. Note EnSight Manual v8.2 (pp. 559,
@@ -1240,26 +1381,25 @@ int vtkEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   this->ReadIntArray( pointIds, this->NumberOfMeasuredPoints );
 
   // Read point coordinates tuple by tuple while each tuple contains three
-  // components: (x-cord, y-cord, z-cord)
-  int  floatSize = sizeof( float );
-  for ( i = 0; i < this->NumberOfMeasuredPoints; i ++ )
+  // components: (x-cord, y-cord, z-cord).  The tuples are contiguous, so
+  // they are read at once, straight into the points.
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(this->NumberOfMeasuredPoints);
+  float *coords =
+    static_cast<vtkFloatArray*>(points->GetData())->GetPointer(0);
+  if (this->NumberOfMeasuredPoints > 0)
     {
-    this->IFile->read(  ( char * )( xCoords + i ),  floatSize  );
-    this->IFile->read(  ( char * )( yCoords + i ),  floatSize  );
-    this->IFile->read(  ( char * )( zCoords + i ),  floatSize  );
+    this->IFile->read((char*)coords,
+      3*sizeof(float)*static_cast<size_t>(this->NumberOfMeasuredPoints));
     }
 
   if ( this->ByteOrder == FILE_LITTLE_ENDIAN )
     {
-    vtkByteSwap::Swap4LERange( xCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4LERange( yCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4LERange( zCoords, this->NumberOfMeasuredPoints );
+    vtkByteSwap::Swap4LERange( coords, 3*this->NumberOfMeasuredPoints );
     }
   else
     {
-    vtkByteSwap::Swap4BERange( xCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4BERange( yCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4BERange( zCoords, this->NumberOfMeasuredPoints );
+    vtkByteSwap::Swap4BERange( coords, 3*this->NumberOfMeasuredPoints );
     }
 
   // NOTE: EnSight always employs a 1-based indexing scheme and therefore
@@ -1268,7 +1408,6 @@ int vtkEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   // This bug was noticed while fixing bug #7453.
   for (i = 0; i < this->NumberOfMeasuredPoints; i++)
     {
-    points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
     pd->InsertNextCell(VTK_VERTEX, 1, &i);
     }
 
@@ -1278,9 +1417,6 @@ int vtkEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   points->Delete();
   pd->Delete();
   delete [] pointIds;
-  delete [] xCoords;
-  delete [] yCoords;
-  delete [] zCoords;
 
   if (this->IFile)
     {
@@ -2598,7 +2734,6 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
   int *nodeIdList;
   int numElements;
   int idx, cellId, cellType;
-  float *xCoords, *yCoords, *zCoords;
 
   this->NumberOfNewOutputs++;
 
@@ -2643,30 +2778,15 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       vtkPoints *points = vtkPoints::New();
       vtkDebugMacro("num. points: " << numPts);
 
-      points->Allocate(numPts);
-
       if (this->NodeIdsListed)
         {
         this->IFile->seekg(sizeof(int)*numPts, ios::cur);
         }
 
-      xCoords = new float[numPts];
-      yCoords = new float[numPts];
-      zCoords = new float[numPts];
-      this->ReadFloatArray(xCoords, numPts);
-      this->ReadFloatArray(yCoords, numPts);
-      this->ReadFloatArray(zCoords, numPts);
-
-      for (i = 0; i < numPts; i++)
-        {
-        points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-        }
+      this->ReadCoordinates(points, numPts);
 
       output->SetPoints(points);
       points->Delete();
-      delete [] xCoords;
-      delete [] yCoords;
-      delete [] zCoords;
       }
     else if (strncmp(line, "point", 5) == 0)
       {
@@ -2858,20 +2978,22 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       nodeIdList = new int[numNodes];
       this->ReadIntArray(nodeIdList, numNodes);
 
+      std::vector<vtkIdType> pointIds(numNodes + 1);
+      if (numNodes > 0)
+        {
+        vtkEnSightGoldBinaryPointIds convert;
+        convert.NodeIdList = nodeIdList;
+        convert.PointIds = &pointIds[0];
+        vtkSMPTools::For(0, numNodes, convert);
+        }
+
       for (i = 0; i < numElements; i++)
         {
-        nodeIds = new vtkIdType[numNodesPerElement[i]];
-        for (j = 0; j < numNodesPerElement[i]; j++)
-          {
-          nodeIds[j] = nodeIdList[nodeCount] - 1;
-          nodeCount++;
-          }
         cellId = output->InsertNextCell(VTK_POLYGON,
           numNodesPerElement[i],
-          nodeIds);
+          &pointIds[nodeCount]);
         this->GetCellIds(idx, cellType)->InsertNextId(cellId);
-
-        delete [] nodeIds;
+        nodeCount += numNodesPerElement[i];
         }
 
       delete [] nodeIdList;
@@ -3118,14 +3240,6 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       vtkDebugMacro("nfaced");
       int *numFacesPerElement;
       int *numNodesPerFace;
-      int *numNodesPerElement;
-      int *nodeMarker;
-      int numPts = 0;
-      int numFaces = 0;
-      int numNodes = 0;
-      int faceCount = 0;
-      int nodeCount = 0;
-      int elementNodeCount = 0;
 
       cellType = vtkEnSightReader::NFACED;
       this->ReadInt(&numElements);
@@ -3146,44 +3260,28 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       this->ReadIntArray(numFacesPerElement, numElements);
 
       // array: number of nodes per face
+      std::vector<vtkIdType> faceOffsets(numElements + 1);
+      faceOffsets[0] = 0;
       for (i = 0; i < numElements; i++)
         {
-        numFaces += numFacesPerElement[i];
+        faceOffsets[i + 1] = faceOffsets[i] + numFacesPerElement[i];
         }
+      int numFaces = static_cast<int>(faceOffsets[numElements]);
       numNodesPerFace = new int[numFaces];
       this->ReadIntArray(numNodesPerFace, numFaces);
 
-      // array: number of nodes per element
-      // number of faces of all elements
-      numNodesPerElement = new int[numElements];
+      // number of nodes of each element, counted once per face
+      std::vector<vtkIdType> nodeOffsets(numElements + 1);
+      nodeOffsets[0] = 0;
       for (i = 0; i < numElements; i++)
         {
-        numNodesPerElement[i] = 0;
-        for (j = 0; j < numFacesPerElement[i]; j++)
+        nodeOffsets[i + 1] = nodeOffsets[i];
+        for (vtkIdType f = faceOffsets[i]; f < faceOffsets[i + 1]; f++)
           {
-          numNodesPerElement[i] += numNodesPerFace[faceCount + j];
+          nodeOffsets[i + 1] += numNodesPerFace[f];
           }
-        faceCount += numFacesPerElement[i];
-        }
-
-      //xxx begin
-      //delete [] numFacesPerElement;
-      //delete [] numNodesPerFace;
-      //xxx end
-
-      // number of nodes of all elements
-      for (i = 0; i < numElements; i++)
-        {
-        numNodes += numNodesPerElement[i];
-        }
-
-      // allocate and init markers to determine unique points
-      numPts = output->GetNumberOfPoints();
-      nodeMarker = new int[numPts];
-      for (i = 0; i < numPts; i++)
-        {
-        nodeMarker[i] = -1;
         }
+      int numNodes = static_cast<int>(nodeOffsets[numElements]);
 
       // array: node Ids of all elements
       // NOTE:  each node Id is usually referenced multiple times in a
@@ -3192,73 +3290,36 @@ int vtkEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       nodeIdList = new int[numNodes];
       this->ReadIntArray(nodeIdList, numNodes);
 
-      // yyy begin
-      int         k;              // indexing each node Id of a face
-      int         faceIdx = 0;    // indexing faces throughout all polyhedra
-      int         nodeIdx = 0;    // indexing nodes throughout all polyhedra
-      int         arayIdx = 0;    // indexing the array of Ids (info of faces)
-      vtkIdType * faceAry = NULL; // array of Ids describing a vtkPolyhedron
-      // yyy end
+      // Build the face streams and the unique point ids of the polyhedra
+      // concurrently, then insert them in order.
+      std::vector<vtkIdType> faceStreams(numFaces + numNodes + 1);
+      std::vector<vtkIdType> pointIds(numNodes + 1);
+      std::vector<vtkIdType> numPointIds(numElements + 1);
+      if (numElements > 0)
+        {
+        vtkEnSightGoldBinaryPolyhedra convert;
+        convert.NumFacesPerElement = numFacesPerElement;
+        convert.NumNodesPerFace = numNodesPerFace;
+        convert.NodeIdList = nodeIdList;
+        convert.FaceOffsets = &faceOffsets[0];
+        convert.NodeOffsets = &nodeOffsets[0];
+        convert.FaceStreams = &faceStreams[0];
+        convert.PointIds = &pointIds[0];
+        convert.NumberOfPointIds = &numPointIds[0];
+        vtkSMPTools::For(0, numElements, convert);
+        }
 
       for (i = 0; i < numElements; i++)
         {
-        elementNodeCount = 0;
-        nodeIds = new vtkIdType[numNodesPerElement[i]];
-
-        // yyy begin
-        arayIdx = 0;
-        faceAry = new vtkIdType[ numFacesPerElement[i] +
-                                 numNodesPerElement[i] ];
-        for ( j = 0; j < numFacesPerElement[i]; j ++, faceIdx ++ )
-          {
-          faceAry[ arayIdx ++ ] = numNodesPerFace[ faceIdx ];
-
-          for (  k = 0;  k < numNodesPerFace[ faceIdx ];  k ++  )
-            {
-            faceAry[ arayIdx ++ ] = nodeIdList[ nodeIdx ++ ] - 1;
-            }
-          }
-        //yyy end
-
-        for (j = 0; j < numNodesPerElement[i]; j++)
-          {
-          if (nodeMarker[nodeIdList[nodeCount] - 1] < i)
-            {
-            nodeIds[elementNodeCount] = nodeIdList[nodeCount] - 1;
-            nodeMarker[nodeIdList[nodeCount] - 1] = i;
-            elementNodeCount += 1;
-            }
-          nodeCount++;
-          }
-
-        // xxx begin
-        //cellId = output->InsertNextCell( VTK_CONVEX_POINT_SET,
-        //                                 elementNodeCount, nodeIds );
-        // xxx end
-
-        // yyy begin
-        cellId = output->InsertNextCell( VTK_POLYHEDRON, elementNodeCount,
-                                         nodeIds, numFacesPerElement[i],
-                                         faceAry );
-        delete [] faceAry;
-        faceAry = NULL;
-        //yyy end
-
+        cellId = output->InsertNextCell(VTK_POLYHEDRON, numPointIds[i],
+          &pointIds[nodeOffsets[i]], numFacesPerElement[i],
+          &faceStreams[faceOffsets[i] + nodeOffsets[i]]);
         this->GetCellIds(idx, cellType)->InsertNextId(cellId);
-
-        delete [] nodeIds;
         }
 
-      // yyy begin
       delete [] numNodesPerFace;
       delete [] numFacesPerElement;
-      numNodesPerFace    = NULL;
-      numFacesPerElement = NULL;
-      // yyy end
-
-      delete [] nodeMarker;
       delete [] nodeIdList;
-      delete [] numNodesPerElement;
       }
     else if (strncmp(line, "tetra4", 6) == 0 ||
       strncmp(line, "tetra10", 7) == 0)
@@ -3709,7 +3770,6 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
   int i;
   vtkPoints *points = vtkPoints::New();
   int numPts;
-  float *xCoords, *yCoords, *zCoords;
 
   this->NumberOfNewOutputs++;
 
@@ -3751,19 +3811,8 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
     return -1;
     }
   output->SetDimensions(dimensions);
-  points->Allocate(numPts);
 
-  xCoords = new float[numPts];
-  yCoords = new float[numPts];
-  zCoords = new float[numPts];
-  this->ReadFloatArray(xCoords, numPts);
-  this->ReadFloatArray(yCoords, numPts);
-  this->ReadFloatArray(zCoords, numPts);
-
-  for (i = 0; i < numPts; i++)
-    {
-    points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-    }
+  this->ReadCoordinates(points, numPts);
   output->SetPoints(points);
   if (iblanked)
     {
@@ -3781,9 +3830,6 @@ int vtkEnSightGoldBinaryReader::CreateStructuredGridOutput(
     }
 
   points->Delete();
-  delete [] xCoords;
-  delete [] yCoords;
-  delete [] zCoords;
 
   this->IFile->peek();
   if (this->IFile->eof())
@@ -4237,6 +4283,45 @@ int vtkEnSightGoldBinaryReader::ReadFloatArray(float *result,
   return 1;
 }
 
+// Internal function to read the x, y and z coordinate blocks of numPts
+// points.  The blocks are contiguous in C binary files and read at once.
+// Returns zero if there was an error.
+int vtkEnSightGoldBinaryReader::ReadCoordinates(vtkPoints *points,
+  int numPts)
+{
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(numPts);
+  if (numPts <= 0)
+    {
+    return 1;
+    }
+
+  std::vector<float> blocks(3*static_cast<size_t>(numPts));
+  int result;
+  if (!this->Fortran && numPts <= VTK_INT_MAX / 3)
+    {
+    result = this->ReadFloatArray(&blocks[0], 3*numPts);
+    }
+  else
+    {
+    result = this->ReadFloatArray(&blocks[0], numPts) &&
+      this->ReadFloatArray(&blocks[numPts], numPts) &&
+      this->ReadFloatArray(&blocks[2*static_cast<size_t>(numPts)], numPts);
+    }
+
+  float *coords = static_cast<vtkFloatArray*>(points->GetData())->GetPointer(0);
+  const float *x = &blocks[0];
+  const float *y = x + numPts;
+  const float *z = y + numPts;
+  for (int i = 0; i < numPts; i++)
+    {
+    *coords++ = x[i];
+    *coords++ = y[i];
+    *coords++ = z[i];
+    }
+  return result;
+}
+
 //----------------------------------------------------------------------------
 void vtkEnSightGoldBinaryReader::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -4269,8 +4354,9 @@ int vtkEnSightGoldBinaryReader::SeekToCachedTimeStep(const char* fileName,
       {
       //we need to account for the last 80 characters as where we need to seek,
       //as we need to be at the BEGIN TIMESTEP keyword and not
-      //the description line
-      this->IFile->seekg(fileOffsetIterator->second - 80l, ios::beg);
+      //the description line (Fortran records add two 4 byte markers)
+      vtkTypeInt64 lineLength = this->Fortran ? 88 : 80;
+      this->IFile->seekg(fileOffsetIterator->second - lineLength, ios::beg);
       j = i;
       break;
       }
@@ -42,6 +42,7 @@
 
 
 class vtkMultiBlockDataSet;
+class vtkPoints;
 
 class VTKIOENSIGHT_EXPORT vtkEnSightGoldBinaryReader : public vtkEnSightReader
 {
@@ -172,16 +173,24 @@ protected:
   // Returns zero if there was an error.
   int ReadFloatArray(float *result, int numFloats);
 
+  // Description:
+  // Internal function to read in the x, y and z coordinate blocks of
+  // numPts points.  Returns zero if there was an error.
+  int ReadCoordinates(vtkPoints *points, int numPts);
+
   // Description:
   // Counts the number of timesteps in the geometry file
   // This function assumes the file is already open and returns the
   // number of timesteps remaining in the file
   // The file will be closed after calling this method
-  int CountTimeSteps();
+  // If fileName is given, the offset of each time step is added to the
+  // time step cache.
+  int CountTimeSteps(const char* fileName = NULL);
 
   // Description:
-  // Read to the next time step in the geometry file.
-  int SkipTimeStep();
+  // Read to the next time step in the geometry file.  If fileName is
+  // given, the offset of the time step is cached as realTimeStep.
+  int SkipTimeStep(const char* fileName = NULL, int realTimeStep = 0);
   int SkipStructuredGrid(char line[256]);
   int SkipUnstructuredGrid(char line[256]);
   int SkipRectilinearGrid(char line[256]);
@@ -206,6 +215,9 @@ protected:
   ifstream *IFile;
   // The size of the file could be used to choose byte order.
   vtkIdType FileSize;
+  // Modification time of the open file, to notice files that were rewritten
+  // or extended since their time steps were counted.
+  vtkTypeInt64 FileModifiedTime;
 
   //BTX
   class FileOffsetMapInternal;
@@ -0,0 +1,251 @@
+// Check that reading the blocks concurrently, prefetching the next time
+// step and loading the result arrays lazily produce the same output as a
+// serial read, and that lazily-loaded arrays are only read when accessed.
+
+#include "vtkCell.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCPExodusIIResultsArrayTemplate.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkExodusIIReader.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkTestUtilities.h"
+
+typedef vtkCPExodusIIResultsArrayTemplate<double> vtkLazyArray;
+
+static void SetUpReader(vtkExodusIIReader* rdr, const char* fname,
+                        bool squeezePoints)
+{
+  static const int objectTypes[] =
+    {
+    vtkExodusIIReader::EDGE_BLOCK, vtkExodusIIReader::FACE_BLOCK,
+    vtkExodusIIReader::ELEM_BLOCK, vtkExodusIIReader::NODE_SET,
+    vtkExodusIIReader::EDGE_SET, vtkExodusIIReader::FACE_SET,
+    vtkExodusIIReader::SIDE_SET, vtkExodusIIReader::ELEM_SET
+    };
+  static const int arrayTypes[] =
+    {
+    vtkExodusIIReader::NODAL, vtkExodusIIReader::GLOBAL,
+    vtkExodusIIReader::EDGE_BLOCK, vtkExodusIIReader::FACE_BLOCK,
+    vtkExodusIIReader::ELEM_BLOCK, vtkExodusIIReader::NODE_SET,
+    vtkExodusIIReader::EDGE_SET, vtkExodusIIReader::FACE_SET,
+    vtkExodusIIReader::SIDE_SET, vtkExodusIIReader::ELEM_SET
+    };
+
+  rdr->SetFileName(fname);
+  rdr->SetSqueezePoints(squeezePoints);
+  rdr->GenerateGlobalNodeIdArrayOn();
+  rdr->GenerateGlobalElementIdArrayOn();
+  rdr->UpdateInformation();
+  for (size_t t = 0; t < sizeof(objectTypes) / sizeof(objectTypes[0]); ++t)
+    {
+    for (int i = 0; i < rdr->GetNumberOfObjects(objectTypes[t]); ++i)
+      {
+      rdr->SetObjectStatus(objectTypes[t], i, 1);
+      }
+    }
+  for (size_t t = 0; t < sizeof(arrayTypes) / sizeof(arrayTypes[0]); ++t)
+    {
+    rdr->SetAllArrayStatus(arrayTypes[t], 1);
+    }
+}
+
+// Count the lazy arrays of \a fd, failing if any of them was already read.
+static bool CountUnreadArrays(vtkFieldData* fd, int& count)
+{
+  for (int i = 0; i < fd->GetNumberOfArrays(); ++i)
+    {
+    vtkLazyArray* lazy = vtkLazyArray::SafeDownCast(fd->GetAbstractArray(i));
+    if (lazy)
+      {
+      if (lazy->IsLoaded())
+        {
+        cerr << "Array " << lazy->GetName() << " read before being accessed\n";
+        return false;
+        }
+      ++count;
+      }
+    }
+  return true;
+}
+
+static int CountUnreadArrays(vtkMultiBlockDataSet* output)
+{
+  vtkCompositeDataIterator* it = output->NewIterator();
+  int count = 0;
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (ds && (!CountUnreadArrays(ds->GetPointData(), count) ||
+               !CountUnreadArrays(ds->GetCellData(), count)))
+      {
+      count = -1;
+      break;
+      }
+    }
+  it->Delete();
+  return count;
+}
+
+static bool SameArrays(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    cerr << "Expected " << a->GetNumberOfArrays() << " arrays, got "
+         << b->GetNumberOfArrays() << "\n";
+    return false;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* x = a->GetArray(i);
+    if (!x)
+      {
+      continue;
+      }
+    vtkDataArray* y = x->GetName() ? b->GetArray(x->GetName()) : b->GetArray(i);
+    if (!y ||
+        x->GetNumberOfTuples() != y->GetNumberOfTuples() ||
+        x->GetNumberOfComponents() != y->GetNumberOfComponents())
+      {
+      cerr << "Array " << i << " differs in size\n";
+      return false;
+      }
+    for (vtkIdType j = 0; j < x->GetNumberOfTuples(); ++j)
+      {
+      for (int c = 0; c < x->GetNumberOfComponents(); ++c)
+        {
+        if (x->GetComponent(j, c) != y->GetComponent(j, c))
+          {
+          cerr << "Array " << i << " differs at " << j << "\n";
+          return false;
+          }
+        }
+      }
+    vtkLazyArray* lazy = vtkLazyArray::SafeDownCast(y);
+    if (lazy && !lazy->IsLoaded())
+      {
+      cerr << "Array " << i << " not read when accessed\n";
+      return false;
+      }
+    }
+  return true;
+}
+
+static bool SameOutput(vtkMultiBlockDataSet* a, vtkMultiBlockDataSet* b)
+{
+  vtkCompositeDataIterator* ait = a->NewIterator();
+  vtkCompositeDataIterator* bit = b->NewIterator();
+  bool same = true;
+  int numBlocks = 0;
+  for (ait->InitTraversal(), bit->InitTraversal();
+       same && !ait->IsDoneWithTraversal();
+       ait->GoToNextItem(), bit->GoToNextItem(), ++numBlocks)
+    {
+    vtkDataSet* x = vtkDataSet::SafeDownCast(ait->GetCurrentDataObject());
+    vtkDataSet* y = vtkDataSet::SafeDownCast(bit->GetCurrentDataObject());
+    if (bit->IsDoneWithTraversal() || !x || !y ||
+        x->GetNumberOfPoints() != y->GetNumberOfPoints() ||
+        x->GetNumberOfCells() != y->GetNumberOfCells())
+      {
+      cerr << "Block " << numBlocks << " differs in size\n";
+      same = false;
+      break;
+      }
+    for (vtkIdType i = 0; same && i < x->GetNumberOfPoints(); ++i)
+      {
+      double p[3];
+      double q[3];
+      x->GetPoint(i, p);
+      y->GetPoint(i, q);
+      same = p[0] == q[0] && p[1] == q[1] && p[2] == q[2];
+      }
+    for (vtkIdType i = 0; same && i < x->GetNumberOfCells(); ++i)
+      {
+      same = x->GetCellType(i) == y->GetCellType(i) &&
+        x->GetCell(i)->GetNumberOfPoints() == y->GetCell(i)->GetNumberOfPoints();
+      }
+    if (!same)
+      {
+      cerr << "Block " << numBlocks << " differs in geometry\n";
+      break;
+      }
+    same = SameArrays(x->GetPointData(), y->GetPointData()) &&
+      SameArrays(x->GetCellData(), y->GetCellData()) &&
+      SameArrays(x->GetFieldData(), y->GetFieldData());
+    }
+  if (same && numBlocks == 0)
+    {
+    cerr << "Empty output\n";
+    same = false;
+    }
+  ait->Delete();
+  bit->Delete();
+  return same;
+}
+
+static bool CompareReads(const char* fname, bool squeezePoints)
+{
+  vtkNew<vtkExodusIIReader> serial;
+  vtkNew<vtkExodusIIReader> threaded;
+  vtkNew<vtkExodusIIReader> lazy;
+  SetUpReader(serial.GetPointer(), fname, squeezePoints);
+  SetUpReader(threaded.GetPointer(), fname, squeezePoints);
+  SetUpReader(lazy.GetPointer(), fname, squeezePoints);
+
+  threaded->ThreadedReadOn();
+  threaded->PrefetchNextTimeStepOn();
+  threaded->SetCacheSize(64.);
+  lazy->ThreadedReadOn();
+  lazy->LazyLoadResultArraysOn();
+
+  int range[2];
+  serial->GetTimeStepRange(range);
+  for (int step = range[0]; step <= range[1]; ++step)
+    {
+    serial->SetTimeStep(step);
+    serial->Update();
+    threaded->SetTimeStep(step);
+    threaded->Update();
+    if (!SameOutput(serial->GetOutput(), threaded->GetOutput()))
+      {
+      cerr << "Threaded read differs at time step " << step << "\n";
+      return false;
+      }
+    lazy->SetTimeStep(step);
+    lazy->Update();
+    if (CountUnreadArrays(lazy->GetOutput()) <= 0 ||
+        !SameOutput(serial->GetOutput(), lazy->GetOutput()))
+      {
+      cerr << "Lazy read differs at time step " << step << "\n";
+      return false;
+      }
+    }
+  return true;
+}
+
+int TestExodusThreadedRead(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/edgeFaceElem.exii");
+  if (!fname)
+    {
+    cout << "Could not obtain filename for test data.\n";
+    return 1;
+    }
+
+  vtkNew<vtkExodusIIReader> rdr;
+  if (!rdr->CanReadFile(fname))
+    {
+    cout << "Cannot read \"" << fname << "\"\n";
+    delete[] fname;
+    return 1;
+    }
+
+  bool same = CompareReads(fname, true) && CompareReads(fname, false);
+  delete[] fname;
+  return same ? 0 : 1;
+}
@@ -27,6 +27,7 @@
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 
 #include "vtk_exodusII.h"
 
@@ -49,6 +50,10 @@ vtkCPExodusIIInSituReader::vtkCPExodusIIInSituReader()
     NumberOfElementBlocks(0),
     CurrentTimeStep(0)
 {
+  // The Exodus II and netCDF libraries are not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->TimeStepRange[0] = 0;
   this->TimeStepRange[1] = 0;
   this->SetNumberOfInputPorts(0);
@@ -20,6 +20,11 @@
 // Map native Exodus II results arrays into the vtkDataArray interface. Use
 // the vtkCPExodusIIInSituReader to read an Exodus II file's data into this
 // structure.
+//
+// The arrays can also be read lazily: SetExodusScalarArraysLoader() gives
+// the shape of the arrays and a vtkCPExodusIIResultsArrayLoader that fills
+// them the first time a value is accessed. vtkExodusIIReader uses this when
+// LazyLoadResultArrays is on.
 
 #ifndef vtkCPExodusIIResultsArrayTemplate_h
 #define vtkCPExodusIIResultsArrayTemplate_h
@@ -28,6 +33,23 @@
 
 #include "vtkTypeTemplate.h" // For templated vtkObject API
 #include "vtkObjectFactory.h" // for vtkStandardNewMacro
+#include "vtkAtomic.h" // For Loader
+#include "vtkSimpleCriticalSection.h" // For the load lock
+
+// Description:
+// Reads the component arrays of a vtkCPExodusIIResultsArrayTemplate the
+// first time its values are accessed.
+class vtkCPExodusIIResultsArrayLoader
+{
+public:
+  virtual ~vtkCPExodusIIResultsArrayLoader() {}
+
+  // Description:
+  // Fill \a buffer with the \a numTuples values of component \a comp. The
+  // buffer holds values of the Scalar type of the array. Return false if
+  // the values could not be read.
+  virtual bool LoadComponent(int comp, vtkIdType numTuples, void *buffer) = 0;
+};
 
 template <class Scalar>
 class vtkCPExodusIIResultsArrayTemplate:
@@ -47,6 +69,22 @@ public:
   void SetExodusScalarArrays(std::vector<Scalar*> arrays, vtkIdType numTuples);
   void SetExodusScalarArrays(std::vector<Scalar*> arrays, vtkIdType numTuples, bool save);
 
+  // Description:
+  // Set the number of components and tuples of the arrays, which are read by
+  // \a loader the first time a value is accessed. This class takes
+  // ownership of the loader and deletes it once the arrays are read. The
+  // arrays are allocated by this class and deleted with it.
+  void SetExodusScalarArraysLoader(vtkCPExodusIIResultsArrayLoader *loader,
+                                   int numComps, vtkIdType numTuples);
+
+  // Description:
+  // Return true if the arrays are in memory, i.e. they were given to
+  // SetExodusScalarArrays() or their loader has already read them.
+  bool IsLoaded()
+    {
+    return static_cast<vtkCPExodusIIResultsArrayLoader*>(this->Loader) == NULL;
+    }
+
   // Reimplemented virtuals -- see superclasses for descriptions:
   void Initialize();
   void GetTuples(vtkIdList *ptIds, vtkAbstractArray *output);
@@ -107,12 +145,29 @@ protected:
 
   std::vector<Scalar *> Arrays;
 
+  // Description:
+  // Read the arrays if SetExodusScalarArraysLoader() was used and they have
+  // not been read yet. Called by all the methods accessing the values.
+  void LoadArrays()
+    {
+    if (static_cast<vtkCPExodusIIResultsArrayLoader*>(this->Loader))
+      {
+      this->LoadArraysWithLoader();
+      }
+    }
+
 private:
   vtkCPExodusIIResultsArrayTemplate(const vtkCPExodusIIResultsArrayTemplate &); // Not implemented.
   void operator=(const vtkCPExodusIIResultsArrayTemplate &); // Not implemented.
 
   vtkIdType Lookup(const Scalar &val, vtkIdType startIndex);
+  void LoadArraysWithLoader();
   double *TempDoubleArray;
+  // Description:
+  // Set until the arrays are read. It is atomic because LoadArrays() tests
+  // it without the lock, and the arrays are published by resetting it.
+  vtkAtomic<vtkCPExodusIIResultsArrayLoader*> Loader;
+  vtkSimpleCriticalSection LoadLock;
   // Description: If Save is true then this class won't delete that memory.
   // By default Save is false.
   bool Save;
@@ -20,6 +20,8 @@
 #include "vtkVariant.h"
 #include "vtkVariantCast.h"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 // Can't use vtkStandardNewMacro on a templated class.
 template <class Scalar> vtkCPExodusIIResultsArrayTemplate<Scalar> *
@@ -44,6 +46,8 @@ template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
 
   os << indent << "TempDoubleArray: " << this->TempDoubleArray << "\n";
   os << indent << "Save: " << this->Save << "\n";
+  os << indent << "Loader: "
+     << static_cast<vtkCPExodusIIResultsArrayLoader*>(this->Loader) << "\n";
 }
 
 //------------------------------------------------------------------------------
@@ -68,6 +72,49 @@ template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
   this->Save = save;
 }
 
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
+::SetExodusScalarArraysLoader(vtkCPExodusIIResultsArrayLoader *loader,
+                              int numComps, vtkIdType numTuples)
+{
+  this->Initialize();
+  this->NumberOfComponents = numComps;
+  this->Arrays.assign(numComps, static_cast<Scalar*>(NULL));
+  this->Size = this->NumberOfComponents * numTuples;
+  this->MaxId = this->Size - 1;
+  this->TempDoubleArray = new double [this->NumberOfComponents];
+  this->Loader = loader;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
+::LoadArraysWithLoader()
+{
+  // Several threads may access an array that has not been read yet.
+  this->LoadLock.Lock();
+  vtkCPExodusIIResultsArrayLoader *loader = this->Loader;
+  if (loader)
+    {
+    const vtkIdType numTuples = this->GetNumberOfTuples();
+    for (size_t comp = 0; comp < this->Arrays.size(); ++comp)
+      {
+      Scalar *array = new Scalar[numTuples];
+      if (!loader->LoadComponent(static_cast<int>(comp), numTuples, array))
+        {
+        vtkErrorMacro("Could not read component " << comp << " of "
+                      << (this->Name ? this->Name : "(none)") << ".");
+        std::fill(array, array + numTuples, Scalar(0));
+        }
+      this->Arrays[comp] = array;
+      }
+    // Other threads use the arrays as soon as they see no loader.
+    this->Loader = NULL;
+    delete loader;
+    }
+  this->LoadLock.Unlock();
+}
+
 //------------------------------------------------------------------------------
 template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
 ::Initialize()
@@ -76,7 +123,7 @@ template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
     {
     for (size_t i = 0; i < this->Arrays.size(); ++i)
       {
-      delete this->Arrays[i];
+      delete [] this->Arrays[i];
       }
     }
   this->Arrays.clear();
@@ -85,6 +132,9 @@ template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
   delete [] this->TempDoubleArray;
   this->TempDoubleArray = NULL;
 
+  delete static_cast<vtkCPExodusIIResultsArrayLoader*>(this->Loader);
+  this->Loader = NULL;
+
   this->MaxId = -1;
   this->Size = 0;
   this->NumberOfComponents = 1;
@@ -211,6 +261,7 @@ template <class Scalar> double* vtkCPExodusIIResultsArrayTemplate<Scalar>
 template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
 ::GetTuple(vtkIdType i, double *tuple)
 {
+  this->LoadArrays();
   for (size_t comp = 0; comp < this->Arrays.size(); ++comp)
     {
     tuple[comp] = static_cast<double>(this->Arrays[comp][i]);
@@ -248,6 +299,7 @@ template <class Scalar> Scalar vtkCPExodusIIResultsArrayTemplate<Scalar>
 template <class Scalar> Scalar& vtkCPExodusIIResultsArrayTemplate<Scalar>
 ::GetValueReference(vtkIdType idx)
 {
+  this->LoadArrays();
   const vtkIdType tuple = idx / this->NumberOfComponents;
   const vtkIdType comp = idx % this->NumberOfComponents;
   return this->Arrays[comp][tuple];
@@ -257,6 +309,7 @@ template <class Scalar> Scalar& vtkCPExodusIIResultsArrayTemplate<Scalar>
 template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
 ::GetTupleValue(vtkIdType tupleId, Scalar *tuple)
 {
+  this->LoadArrays();
   for (size_t comp = 0; comp < this->Arrays.size(); ++comp)
     {
     tuple[comp] = this->Arrays[comp][tupleId];
@@ -492,7 +545,7 @@ template <class Scalar> void vtkCPExodusIIResultsArrayTemplate<Scalar>
 //------------------------------------------------------------------------------
 template <class Scalar> vtkCPExodusIIResultsArrayTemplate<Scalar>
 ::vtkCPExodusIIResultsArrayTemplate()
-  : TempDoubleArray(NULL), Save(false)
+  : TempDoubleArray(NULL), Loader(NULL), Save(false)
 {
 }
 
@@ -510,6 +563,7 @@ template <class Scalar> vtkCPExodusIIResultsArrayTemplate<Scalar>
       }
     }
   delete [] this->TempDoubleArray;
+  delete static_cast<vtkCPExodusIIResultsArrayLoader*>(this->Loader);
 }
 
 //------------------------------------------------------------------------------
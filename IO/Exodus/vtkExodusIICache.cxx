@@ -71,6 +71,7 @@ vtkExodusIICache::vtkExodusIICache()
 {
   this->Size = 0.;
   this->Capacity = 2.;
+  this->EvictionsDeferred = 0;
 }
 
 vtkExodusIICache::~vtkExodusIICache()
@@ -83,6 +84,7 @@ void vtkExodusIICache::PrintSelf( ostream& os, vtkIndent indent )
   this->Superclass::PrintSelf( os, indent );
   os << indent << "Capacity: " << this->Capacity << " MiB\n";
   os << indent << "Size: " << this->Size << " MiB\n";
+  os << indent << "EvictionsDeferred: " << this->EvictionsDeferred << "\n";
   os << indent << "Cache: " << &this->Cache << " (" << this->Cache.size() << ")\n";
   os << indent << "LRU: " << &this->LRU << "\n";
 }
@@ -149,6 +151,17 @@ int vtkExodusIICache::ReduceToSize( double newSize )
   return deletedSomething;
 }
 
+void vtkExodusIICache::DeferEvictions()
+{
+  this->EvictionsDeferred = 1;
+}
+
+void vtkExodusIICache::ResumeEvictions()
+{
+  this->EvictionsDeferred = 0;
+  this->ReduceToSize( this->Capacity );
+}
+
 void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
 {
   double vsize = value ? value->GetActualMemorySize() / 1024. : 0.;
@@ -165,7 +178,10 @@ void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
       {
       this->RecomputeSize();
       }
-    this->ReduceToSize( this->Capacity - vsize );
+    if ( ! this->EvictionsDeferred )
+      {
+      this->ReduceToSize( this->Capacity - vsize );
+      }
     it->second->Value->Delete();
     it->second->Value = value;
     it->second->Value->Register( 0 ); // Since we re-use the cache entry, the constructor's Register won't get called.
@@ -178,7 +194,10 @@ void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
     }
   else
     {
-    this->ReduceToSize( this->Capacity - vsize );
+    if ( ! this->EvictionsDeferred )
+      {
+      this->ReduceToSize( this->Capacity - vsize );
+      }
     std::pair<const vtkExodusIICacheKey,vtkExodusIICacheEntry*> entry( key, new vtkExodusIICacheEntry(value) );
     std::pair<vtkExodusIICacheSet::iterator, bool> iret = this->Cache.insert( entry );
     this->Size += vsize;
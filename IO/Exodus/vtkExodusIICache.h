@@ -151,6 +151,14 @@ public:
     */
   int ReduceToSize( double newSize );
 
+  /** Stop dropping entries when new ones are inserted, so that arrays
+    * returned by Find() or inserted by one thread stay valid while other
+    * threads insert arrays. ResumeEvictions() shrinks the cache back to its
+    * capacity, dropping the least recently used entries first.
+    */
+  void DeferEvictions();
+  void ResumeEvictions();
+
   //BTX
   /// Insert an entry into the cache (this can remove other cache entries to make space).
   void Insert( vtkExodusIICacheKey& key, vtkDataArray* value );
@@ -195,6 +203,9 @@ protected:
   /// The current size of the cache (i.e., the size of the all the arrays it currently contains) in MiB.
   double Size;
 
+  /// Nonzero between DeferEvictions() and ResumeEvictions().
+  int EvictionsDeferred;
+
   //BTX
   /** A least-recently-used (LRU) cache to hold arrays.
     * During RequestData the cache may contain more than its maximum size since
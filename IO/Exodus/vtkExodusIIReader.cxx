@@ -19,10 +19,12 @@
 #include "vtkExodusIIReader.h"
 #include "vtkExodusIICache.h"
 
+#include "vtkAtomicTypes.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellType.h"
 #include "vtkCharArray.h"
+#include "vtkCPExodusIIResultsArrayTemplate.h"
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdTypeArray.h"
@@ -31,15 +33,19 @@
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
 #include "vtkMutableDirectedGraph.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkXMLParser.h"
 #include "vtkStringArray.h"
@@ -373,6 +379,185 @@ void vtkExodusIIReaderPrivate::ArrayInfoType::Reset()
   this->ObjectTruth.clear();
 }
 
+//-----------------------------------------------------------------------------
+// The lock serializing the calls to the Exodus library, which is not thread
+// safe even across file handles. There is one per process, shared by every
+// reader and by the files of their lazily-loaded result arrays. It is
+// recursive: a reader creates lazily-loaded arrays, and evicts them from its
+// cache, while it holds the lock, and their loaders take it too.
+class vtkExodusIILibraryLock
+{
+public:
+  static vtkExodusIILibraryLock* GetInstance()
+    {
+    return &vtkExodusIILibraryLock::Instance;
+    }
+
+  void Lock()
+    {
+    // Owner is only equal to the calling thread if that thread holds the
+    // lock, as it is only set and cleared by the holder.
+    vtkMultiThreaderIDType self = vtkMultiThreader::GetCurrentThreadID();
+    if ( this->Depth > 0 && vtkMultiThreader::ThreadsEqual( this->Owner, self ) )
+      {
+      ++this->Depth;
+      return;
+      }
+    this->CriticalSection.Lock();
+    this->Owner = self;
+    this->Depth = 1;
+    }
+
+  void Unlock()
+    {
+    if ( --this->Depth == 0 )
+      {
+      this->CriticalSection.Unlock();
+      }
+    }
+
+protected:
+  vtkExodusIILibraryLock() : Depth( 0 ) { }
+  ~vtkExodusIILibraryLock() { }
+
+  static vtkExodusIILibraryLock Instance;
+
+  vtkSimpleCriticalSection CriticalSection;
+  vtkMultiThreaderIDType Owner;
+  vtkAtomicInt32 Depth;
+
+private:
+  vtkExodusIILibraryLock( const vtkExodusIILibraryLock& ); // Not implemented.
+  void operator = ( const vtkExodusIILibraryLock& ); // Not implemented.
+};
+
+vtkExodusIILibraryLock vtkExodusIILibraryLock::Instance;
+
+// Holds the library lock until the end of the scope, so that functions
+// returning early from a failed call through VTK_EXO_FUNC release it.
+class vtkExodusIILibraryLocker
+{
+public:
+  vtkExodusIILibraryLocker()
+    {
+    vtkExodusIILibraryLock::GetInstance()->Lock();
+    }
+  ~vtkExodusIILibraryLocker()
+    {
+    vtkExodusIILibraryLock::GetInstance()->Unlock();
+    }
+};
+
+//-----------------------------------------------------------------------------
+// The file read by the loaders of lazily-loaded result arrays. Those arrays
+// may be accessed long after RequestData() closed the reader's own handle,
+// so the loaders share this one. It is opened by the first load and closed
+// once no loader is left. It is accessed under the library lock.
+class vtkExodusIIResultsFile : public vtkObject
+{
+public:
+  static vtkExodusIIResultsFile* New();
+  vtkTypeMacro(vtkExodusIIResultsFile,vtkObject);
+
+  vtkStdString FileName;
+
+  void AddLoader()
+    {
+    vtkExodusIILibraryLocker locker;
+    ++this->NumberOfLoaders;
+    }
+
+  void RemoveLoader()
+    {
+    vtkExodusIILibraryLocker locker;
+    if ( --this->NumberOfLoaders == 0 && this->Exoid >= 0 )
+      {
+      ex_close( this->Exoid );
+      this->Exoid = -1;
+      }
+    }
+
+  bool ReadVariable( int timeStep, int otyp, int varIndex, int objId,
+    vtkIdType numValues, double* values )
+    {
+    vtkExodusIILibraryLocker locker;
+    if ( this->Exoid < 0 )
+      {
+      int appWordSize = 8;
+      int diskWordSize = 8;
+      float version;
+      this->Exoid = ex_open( this->FileName.c_str(), EX_READ,
+        &appWordSize, &diskWordSize, &version );
+      }
+    return this->Exoid >= 0 &&
+      ex_get_var( this->Exoid, timeStep, static_cast<ex_entity_type>( otyp ),
+        varIndex, objId, numValues, values ) >= 0;
+    }
+
+protected:
+  vtkExodusIIResultsFile() : Exoid( -1 ), NumberOfLoaders( 0 ) { }
+  ~vtkExodusIIResultsFile()
+    {
+    if ( this->Exoid >= 0 )
+      {
+      vtkExodusIILibraryLocker locker;
+      ex_close( this->Exoid );
+      }
+    }
+
+  int Exoid;
+  int NumberOfLoaders;
+
+private:
+  vtkExodusIIResultsFile( const vtkExodusIIResultsFile& ); // Not implemented.
+  void operator = ( const vtkExodusIIResultsFile& ); // Not implemented.
+};
+
+vtkStandardNewMacro(vtkExodusIIResultsFile);
+
+//-----------------------------------------------------------------------------
+// Reads the components of one result variable of a block, a set or the
+// nodes at one time step. Components past those in the file are the zeros
+// of 2-D vectors promoted to 3-D.
+class vtkExodusIIResultsLoader : public vtkCPExodusIIResultsArrayLoader
+{
+public:
+  vtkExodusIIResultsLoader( vtkExodusIIResultsFile* file, int timeStep,
+    int otyp, int objId, const std::vector<int>& varIndices )
+    : File( file ), TimeStep( timeStep ), ObjectType( otyp ), ObjectId( objId ),
+    VariableIndices( varIndices )
+    {
+    this->File->Register( 0 );
+    this->File->AddLoader();
+    }
+
+  virtual ~vtkExodusIIResultsLoader()
+    {
+    this->File->RemoveLoader();
+    this->File->UnRegister( 0 );
+    }
+
+  virtual bool LoadComponent( int comp, vtkIdType numTuples, void* buffer )
+    {
+    double* values = static_cast<double*>( buffer );
+    if ( comp >= static_cast<int>( this->VariableIndices.size() ) )
+      {
+      std::fill( values, values + numTuples, 0. );
+      return true;
+      }
+    return numTuples == 0 ||
+      this->File->ReadVariable( this->TimeStep, this->ObjectType,
+        this->VariableIndices[comp], this->ObjectId, numTuples, values );
+    }
+
+protected:
+  vtkExodusIIResultsFile* File;
+  int TimeStep;
+  int ObjectType;
+  int ObjectId;
+  std::vector<int> VariableIndices;
+};
+
 // ------------------------------------------------------- PRIVATE CLASS MEMBERS
 vtkStandardNewMacro(vtkExodusIIReaderPrivate);
 
@@ -405,6 +590,12 @@ vtkExodusIIReaderPrivate::vtkExodusIIReaderPrivate()
 
   this->SqueezePoints = 1;
 
+  this->ThreadedRead = 0;
+  this->PrefetchNextTimeStep = 0;
+  this->CacheLock = vtkExodusIILibraryLock::GetInstance();
+  this->LazyLoadResultArrays = 0;
+  this->ResultsFile = 0;
+
   this->Parser = 0;
 
   this->SIL = vtkMutableDirectedGraph::New();
@@ -418,6 +609,10 @@ vtkExodusIIReaderPrivate::~vtkExodusIIReaderPrivate()
   this->CloseFile();
   this->Cache->Delete();
   this->CacheSize = 0;
+  if ( this->ResultsFile )
+    {
+    this->ResultsFile->Delete();
+    }
   this->ClearConnectivityCaches();
   if(this->Parser)
     {
@@ -619,10 +814,14 @@ int vtkExodusIIReaderPrivate::AssembleOutputPoints(
   if ( this->SqueezePoints )
     {
     pts->SetNumberOfPoints( bsinfop->NextSqueezePoint );
+    // Blocks may be assembled concurrently from the same cached array:
+    // do not use the array's internal tuple buffer.
+    double x[3];
     std::map<vtkIdType,vtkIdType>::iterator it;
     for ( it = bsinfop->PointMap.begin(); it != bsinfop->PointMap.end(); ++ it )
       {
-      pts->SetPoint( it->second, arr->GetTuple( it->first ) );
+      arr->GetTuple( it->first, x );
+      pts->SetPoint( it->second, x );
       }
     }
   else
@@ -1474,7 +1673,10 @@ void vtkExodusIIReaderPrivate::InsertSetCellCopies(
   (void)obj;
   // First, sort the set by entry number (element, face, or edge ID)
   // so that we can refer to each block just once as we process cells.
+  // vtkSortDataArray keeps the compared component in a static variable.
+  this->CacheLock->Lock();
   vtkSortDataArray::SortArrayByComponent( refs, 0 );
+  this->CacheLock->Unlock();
   refs->Register( this ); // Don't let the cache delete this array when we fetch others...
 
   vtkIdType nrefs = refs->GetNumberOfTuples();
@@ -1618,8 +1820,76 @@ void vtkExodusIIReaderPrivate::InsertSetSides(
     }
 }
 
+//-----------------------------------------------------------------------------
+bool vtkExodusIIReaderPrivate::CanLoadLazily( vtkExodusIICacheKey key )
+{
+  if ( ! this->LazyLoadResultArrays || ! this->ResultsFile || key.Time < 0 )
+    {
+    return false;
+    }
+  switch ( key.ObjectType )
+    {
+  case vtkExodusIIReader::NODAL:
+    // Squeezing the points copies every value anyway, and the displacements
+    // are read right away to deflect the points.
+    if ( this->SqueezePoints || ( this->ApplyDisplacements &&
+        key.ArrayId == this->FindDisplacementVectorsIndex() ) )
+      {
+      return false;
+      }
+    break;
+  case vtkExodusIIReader::EDGE_BLOCK:
+  case vtkExodusIIReader::FACE_BLOCK:
+  case vtkExodusIIReader::ELEM_BLOCK:
+  case vtkExodusIIReader::NODE_SET:
+  case vtkExodusIIReader::EDGE_SET:
+  case vtkExodusIIReader::FACE_SET:
+  case vtkExodusIIReader::SIDE_SET:
+  case vtkExodusIIReader::ELEM_SET:
+    break;
+  default:
+    return false;
+    }
+  return this->ArrayInfo[key.ObjectType][key.ArrayId].StorageType == VTK_DOUBLE;
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray* vtkExodusIIReaderPrivate::NewLazyResultArray( vtkExodusIICacheKey key )
+{
+  ArrayInfoType* ainfop = &this->ArrayInfo[key.ObjectType][key.ArrayId];
+  int objId = 0;
+  vtkIdType numTuples = this->ModelParameters.num_nodes;
+  if ( key.ObjectType != vtkExodusIIReader::NODAL )
+    {
+    ObjectInfoType* oinfop = this->GetObjectInfo(
+      this->GetObjectTypeIndexFromObjectType( key.ObjectType ), key.ObjectId );
+    objId = oinfop->Id;
+    numTuples = oinfop->Size;
+    }
+  // Promote 2-component arrays to 3-component arrays when we have 2-D coordinates
+  int ncomps = ( this->ModelParameters.num_dim == 2 && ainfop->Components == 2 ) ? 3 : ainfop->Components;
+
+  vtkCPExodusIIResultsArrayTemplate<double>* arr =
+    vtkCPExodusIIResultsArrayTemplate<double>::New();
+  arr->SetName( ainfop->Name.c_str() );
+  arr->SetExodusScalarArraysLoader(
+    new vtkExodusIIResultsLoader( this->ResultsFile, key.Time + 1,
+      key.ObjectType, objId, ainfop->OriginalIndices ),
+    ncomps, numTuples );
+  return arr;
+}
+
 //-----------------------------------------------------------------------------
 vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key )
+{
+  this->CacheLock->Lock();
+  vtkDataArray* arr = this->GetCacheOrReadLocked( key );
+  this->CacheLock->Unlock();
+  return arr;
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrReadLocked( vtkExodusIICacheKey key )
 {
   vtkDataArray* arr;
   // Never cache points deflected for a mode shape animation... doubles don't make good keys.
@@ -1641,7 +1911,12 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
   int exoid = this->Exoid;
 
   // If array is NULL, try reading it from file.
-  if ( key.ObjectType == vtkExodusIIReader::GLOBAL )
+  if ( this->CanLoadLazily( key ) )
+    {
+    // Only read the values when they are first accessed.
+    arr = this->NewLazyResultArray( key );
+    }
+  else if ( key.ObjectType == vtkExodusIIReader::GLOBAL )
     {
     // need to assemble result array from smaller ones.
     // call GetCacheOrRead() for each smaller array
@@ -2029,7 +2304,7 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
       ckey.ObjectType = vtkExodusIIReader::ELEMENT_ID;
       break;
       }
-    vtkIdTypeArray* src = vtkIdTypeArray::SafeDownCast( this->GetCacheOrRead( ckey ) );
+    vtkIdTypeArray* src = vtkIdTypeArray::SafeDownCast( this->GetCacheOrReadLocked( ckey ) );
     if ( ! src )
       {
       arr = 0;
@@ -2130,7 +2405,7 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
     int obj = key.ArrayId;
     BlockSetInfoType* bsinfop = (BlockSetInfoType*) this->GetObjectInfo( otypidx, obj );
     vtkIdTypeArray* src = vtkIdTypeArray::SafeDownCast(
-      this->GetCacheOrRead( vtkExodusIICacheKey( -1, vtkExodusIIReader::NODE_ID, 0, 0 ) ) );
+      this->GetCacheOrReadLocked( vtkExodusIICacheKey( -1, vtkExodusIIReader::NODE_ID, 0, 0 ) ) );
     if ( this->SqueezePoints && src )
       {
       vtkIdTypeArray* iarr = vtkIdTypeArray::New();
@@ -2146,8 +2421,11 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
         }
       arr = iarr;
       }
-    else
+    else if ( src )
       {
+      // The cache holds src under two keys: take the reference that the
+      // FastDelete() below gives back, and keep src alive while inserting.
+      src->Register( this );
       arr = src;
       }
     }
@@ -2252,7 +2530,7 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
       ktmp = vtkExodusIICacheKey( -1, vtkExodusIIReader::NODE_MAP, 0, 0 );
       }
     // If there are no new-style maps, get the old-style map (which creates a default if nothing is stored on disk).
-    if ( nMaps < 1 || ! (iarr = vtkIdTypeArray::SafeDownCast(this->GetCacheOrRead( ktmp ))) )
+    if ( nMaps < 1 || ! (iarr = vtkIdTypeArray::SafeDownCast(this->GetCacheOrReadLocked( ktmp ))) )
       {
       iarr = vtkIdTypeArray::New();
       iarr->SetNumberOfComponents( 1 );
@@ -2595,7 +2873,12 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
     vtkDataArray* displ = 0;
     if ( this->ApplyDisplacements && key.Time >= 0 )
       {
-      displ = this->FindDisplacementVectors( key.Time );
+      int displIdx = this->FindDisplacementVectorsIndex();
+      if ( displIdx >= 0 )
+        {
+        displ = this->GetCacheOrReadLocked(
+          vtkExodusIICacheKey( key.Time, vtkExodusIIReader::NODAL, 0, displIdx ) );
+        }
       }
 
     std::vector<double> coordTmp;
@@ -3655,6 +3938,9 @@ void vtkExodusIIReaderPrivate::PrintData( ostream& os, vtkIndent indent )
   this->Cache->PrintSelf( os, inden2 );
 
   os << indent << "SqueezePoints: " << this->SqueezePoints << "\n";
+  os << indent << "ThreadedRead: " << this->ThreadedRead << "\n";
+  os << indent << "PrefetchNextTimeStep: " << this->PrefetchNextTimeStep << "\n";
+  os << indent << "LazyLoadResultArrays: " << this->LazyLoadResultArrays << "\n";
   os << indent << "ApplyDisplacements: " << this->ApplyDisplacements << "\n";
   os << indent << "DisplacementMagnitude: " << this->DisplacementMagnitude << "\n";
   os << indent << "GenerateObjectIdArray: " << this->GenerateObjectIdArray << "\n";
@@ -3664,6 +3950,7 @@ void vtkExodusIIReaderPrivate::PrintData( ostream& os, vtkIndent indent )
 
 int vtkExodusIIReaderPrivate::OpenFile( const char* filename )
 {
+  vtkExodusIILibraryLocker locker;
   if ( ! filename || ! strlen( filename ) )
     {
     vtkErrorMacro( "Exodus filename pointer was NULL or pointed to an empty string." );
@@ -3684,6 +3971,17 @@ int vtkExodusIIReaderPrivate::OpenFile( const char* filename )
     return 0;
     }
 
+  // Lazily-loaded result arrays read the file with a handle of their own.
+  if ( ! this->ResultsFile || this->ResultsFile->FileName != filename )
+    {
+    if ( this->ResultsFile )
+      {
+      this->ResultsFile->Delete();
+      }
+    this->ResultsFile = vtkExodusIIResultsFile::New();
+    this->ResultsFile->FileName = filename;
+    }
+
   int numNodesInFile;
   char dummyChar;
   float dummyFloat;
@@ -3694,6 +3992,7 @@ int vtkExodusIIReaderPrivate::OpenFile( const char* filename )
 
 int vtkExodusIIReaderPrivate::CloseFile()
 {
+  vtkExodusIILibraryLocker locker;
   if ( this->Exoid >= 0 )
     {
     VTK_EXO_FUNC( ex_close( this->Exoid ), "Could not close an open file (" << this->Exoid << ")" );
@@ -3706,6 +4005,7 @@ int vtkExodusIIReaderPrivate::CloseFile()
 
 int vtkExodusIIReaderPrivate::UpdateTimeInformation()
 {
+  vtkExodusIILibraryLocker locker;
   int exoid = this->Exoid;
   int itmp[5];
   int num_timesteps;
@@ -3799,6 +4099,7 @@ void vtkExodusIIReaderPrivate::BuildSIL()
 //-----------------------------------------------------------------------------
 int vtkExodusIIReaderPrivate::RequestInformation()
 {
+  vtkExodusIILibraryLocker locker;
   int exoid = this->Exoid;
   //int itmp[5];
   int* ids;
@@ -4238,6 +4539,51 @@ int vtkExodusIIReaderPrivate::RequestInformation()
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+// Assemble the output blocks of vtkExodusIIReaderPrivate::RequestData() and
+// read the prefetched arrays: tasks [0, Blocks.size()) assemble one block
+// each, the following ones read one entry of Prefetch each.
+class vtkExodusIIReaderAssembleBlocks
+{
+public:
+  struct Block
+  {
+    int ObjectType;
+    int Object;
+    int ConnTypeIndex;
+    vtkExodusIIReaderPrivate::BlockSetInfoType* Info;
+    vtkUnstructuredGrid* Output;
+  };
+
+  vtkExodusIIReaderPrivate* Reader;
+  vtkIdType TimeStep;
+  std::vector<Block> Blocks;
+  std::vector<vtkExodusIICacheKey> Prefetch;
+
+  vtkExodusIIReaderAssembleBlocks( vtkExodusIIReaderPrivate* reader, vtkIdType timeStep )
+    : Reader( reader ), TimeStep( timeStep )
+    {
+    }
+
+  void operator () ( vtkIdType begin, vtkIdType end )
+    {
+    vtkIdType numBlocks = static_cast<vtkIdType>( this->Blocks.size() );
+    for ( vtkIdType i = begin; i < end; ++i )
+      {
+      if ( i < numBlocks )
+        {
+        Block& block = this->Blocks[i];
+        this->Reader->AssembleOutputBlock( this->TimeStep,
+          block.ObjectType, block.Object, block.ConnTypeIndex, block.Info, block.Output );
+        }
+      else
+        {
+        this->Reader->GetCacheOrRead( this->Prefetch[i - numBlocks] );
+        }
+      }
+    }
+};
+
 int vtkExodusIIReaderPrivate::RequestData( vtkIdType timeStep, vtkMultiBlockDataSet* output )
 {
   // The work done here depends on several conditions:
@@ -4276,6 +4622,7 @@ int vtkExodusIIReaderPrivate::RequestData( vtkIdType timeStep, vtkMultiBlockData
   // multiblock dataset to hold objects of each type.
   int conntypidx;
   int nbl = 0;
+  vtkExodusIIReaderAssembleBlocks assemble( this, timeStep );
   output->SetNumberOfBlocks( num_conn_types );
   for ( conntypidx = 0; conntypidx < num_conn_types; ++conntypidx )
     {
@@ -4319,47 +4666,140 @@ int vtkExodusIIReaderPrivate::RequestData( vtkIdType timeStep, vtkMultiBlockData
       ug->FastDelete();
       //cout << " Grid: " << ug << "\n";
 
-      // Connectivity first. Either from the cache in bsinfop or read from disk.
-      // Connectivity isn't allowed to change with time.
-      this->AssembleOutputConnectivity( timeStep, otyp, obj, conntypidx, bsinfop, ug );
-
-      // Now prepare points.
-      // These shouldn't change unless the connectivity has changed.
-      this->AssembleOutputPoints( timeStep, bsinfop, ug );
-
-      // Then, add the desired arrays from cache (or disk)
-      // Point and cell arrays are handled differently because they
-      // have different problems to solve.
-      // Point arrays must use the PointMap index to subset values.
-      // Cell arrays may be used as-is.
-      this->AssembleOutputPointArrays( timeStep, bsinfop, ug );
-      this->AssembleOutputCellArrays( timeStep, otyp, obj, bsinfop, ug );
-
-      // Some arrays may be procedurally generated (e.g., the ObjectId
-      // array, global element and node number arrays). This constructs
-      // them as required.
-      this->AssembleOutputProceduralArrays( timeStep, otyp, obj, ug );
-
-      // QA and informational records in the ExodusII file are appended
-      // to each and every output unstructured grid.
-      this->AssembleOutputGlobalArrays( timeStep, otyp, obj, bsinfop, ug );
-
-      // Maps (as distinct from the global element and node arrays above)
-      // are per-cell or per-node integers. As with point arrays, the
-      // PointMap is used to subset node maps. Cell arrays are stored in
-      // ExodusII files for all elements (across all blocks of a given type)
-      // and thus must be subset for the unstructured grid of interest.
-      this->AssembleOutputPointMaps( timeStep, bsinfop, ug );
-      this->AssembleOutputCellMaps( timeStep, otyp, obj, bsinfop, ug );
+      vtkExodusIIReaderAssembleBlocks::Block block =
+        { otyp, obj, conntypidx, bsinfop, ug };
+      assemble.Blocks.push_back( block );
       ++nbl;
       }
     }
 
+  // Read the selected results of the next time step into the cache while
+  // (or, without ThreadedRead, after) the current one is assembled.
+  // Lazily-loaded results are read on access: there is nothing to prefetch.
+  if ( this->PrefetchNextTimeStep && ! this->LazyLoadResultArrays &&
+    ! this->HasModeShapes &&
+    timeStep + 1 < static_cast<vtkIdType>( this->Times.size() ) )
+    {
+    std::vector<vtkExodusIICacheKey> keys;
+    std::vector<vtkExodusIIReaderAssembleBlocks::Block>::iterator bit;
+    for ( bit = assemble.Blocks.begin(); bit != assemble.Blocks.end(); ++bit )
+      {
+      this->GetTemporalArrayKeys( timeStep + 1, bit->ObjectType, bit->Object, keys );
+      }
+    // Point arrays are shared by all the blocks.
+    std::set<vtkExodusIICacheKey> uniqueKeys( keys.begin(), keys.end() );
+    assemble.Prefetch.assign( uniqueKeys.begin(), uniqueKeys.end() );
+    }
+
+  vtkIdType numTasks = static_cast<vtkIdType>(
+    assemble.Blocks.size() + assemble.Prefetch.size() );
+  if ( this->ThreadedRead )
+    {
+    // Make sure the map entries looked up with operator[] while assembling
+    // exist, so that concurrent lookups never insert into the maps.
+    this->ArrayInfo[vtkExodusIIReader::NODAL];
+    this->ArrayInfo[vtkExodusIIReader::GLOBAL];
+    this->MapInfo[vtkExodusIIReader::NODE_MAP];
+    this->BlockInfo[vtkExodusIIReader::EDGE_BLOCK];
+    this->BlockInfo[vtkExodusIIReader::FACE_BLOCK];
+    this->BlockInfo[vtkExodusIIReader::ELEM_BLOCK];
+
+    // Arrays returned by GetCacheOrRead() to one thread must not be dropped
+    // while other threads insert arrays.
+    this->Cache->DeferEvictions();
+    vtkSMPTools::For( 0, numTasks, 1, assemble );
+    this->Cache->ResumeEvictions();
+    }
+  else
+    {
+    assemble( 0, numTasks );
+    }
+
   this->CloseFile();
 
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+void vtkExodusIIReaderPrivate::AssembleOutputBlock(
+  vtkIdType timeStep, int otyp, int obj, int conntypidx,
+  BlockSetInfoType* bsinfop, vtkUnstructuredGrid* ug )
+{
+  // Connectivity first. Either from the cache in bsinfop or read from disk.
+  // Connectivity isn't allowed to change with time.
+  this->AssembleOutputConnectivity( timeStep, otyp, obj, conntypidx, bsinfop, ug );
+
+  // Now prepare points.
+  // These shouldn't change unless the connectivity has changed.
+  this->AssembleOutputPoints( timeStep, bsinfop, ug );
+
+  // Then, add the desired arrays from cache (or disk)
+  // Point and cell arrays are handled differently because they
+  // have different problems to solve.
+  // Point arrays must use the PointMap index to subset values.
+  // Cell arrays may be used as-is.
+  this->AssembleOutputPointArrays( timeStep, bsinfop, ug );
+  this->AssembleOutputCellArrays( timeStep, otyp, obj, bsinfop, ug );
+
+  // Some arrays may be procedurally generated (e.g., the ObjectId
+  // array, global element and node number arrays). This constructs
+  // them as required.
+  this->AssembleOutputProceduralArrays( timeStep, otyp, obj, ug );
+
+  // QA and informational records in the ExodusII file are appended
+  // to each and every output unstructured grid.
+  this->AssembleOutputGlobalArrays( timeStep, otyp, obj, bsinfop, ug );
+
+  // Maps (as distinct from the global element and node arrays above)
+  // are per-cell or per-node integers. As with point arrays, the
+  // PointMap is used to subset node maps. Cell arrays are stored in
+  // ExodusII files for all elements (across all blocks of a given type)
+  // and thus must be subset for the unstructured grid of interest.
+  this->AssembleOutputPointMaps( timeStep, bsinfop, ug );
+  this->AssembleOutputCellMaps( timeStep, otyp, obj, bsinfop, ug );
+}
+
+//-----------------------------------------------------------------------------
+void vtkExodusIIReaderPrivate::GetTemporalArrayKeys(
+  vtkIdType timeStep, int otyp, int obj, std::vector<vtkExodusIICacheKey>& keys )
+{
+  std::vector<ArrayInfoType>::iterator ai;
+  int aidx = 0;
+  std::map<int,std::vector<ArrayInfoType> >::iterator ami =
+    this->ArrayInfo.find( vtkExodusIIReader::NODAL );
+  if ( ami != this->ArrayInfo.end() )
+    {
+    for ( ai = ami->second.begin(); ai != ami->second.end(); ++ai, ++aidx )
+      {
+      if ( ai->Status )
+        {
+        keys.push_back( vtkExodusIICacheKey( timeStep, vtkExodusIIReader::NODAL, 0, aidx ) );
+        }
+      }
+    }
+
+  // Displaced coordinates are cached per time step.
+  if ( this->ApplyDisplacements && this->FindDisplacementVectorsIndex() >= 0 )
+    {
+    keys.push_back( vtkExodusIICacheKey( timeStep, vtkExodusIIReader::NODAL_COORDS, 0, 0 ) );
+    }
+
+  ami = this->ArrayInfo.find( otyp );
+  if ( ami != this->ArrayInfo.end() )
+    {
+    aidx = 0;
+    for ( ai = ami->second.begin(); ai != ami->second.end(); ++ai, ++aidx )
+      {
+      if ( ai->Status && ai->ObjectTruth[obj] )
+        {
+        keys.push_back( vtkExodusIICacheKey( timeStep, otyp, obj, aidx ) );
+        }
+      }
+    }
+}
+
+
+
 int vtkExodusIIReaderPrivate::SetUpEmptyGrid( vtkMultiBlockDataSet* output )
 {
   if ( ! output )
@@ -4533,6 +4973,10 @@ void vtkExodusIIReaderPrivate::ResetSettings()
 
   this->SqueezePoints = 1;
 
+  this->ThreadedRead = 0;
+  this->PrefetchNextTimeStep = 0;
+  this->LazyLoadResultArrays = 0;
+
   this->InitialArrayInfo.clear();
   this->InitialObjectInfo.clear();
 }
@@ -5018,6 +5462,16 @@ void vtkExodusIIReaderPrivate::SetDisplacementMagnitude( double s )
 }
 
 vtkDataArray* vtkExodusIIReaderPrivate::FindDisplacementVectors( int timeStep )
+{
+  int i = this->FindDisplacementVectorsIndex();
+  if ( i >= 0 )
+    {
+    return this->GetCacheOrRead( vtkExodusIICacheKey( timeStep, vtkExodusIIReader::NODAL, 0, i ) );
+    }
+  return 0;
+}
+
+int vtkExodusIIReaderPrivate::FindDisplacementVectorsIndex()
 {
   std::map<int,std::vector<ArrayInfoType> >::iterator it = this->ArrayInfo.find( vtkExodusIIReader::NODAL );
   if ( it != this->ArrayInfo.end() )
@@ -5028,11 +5482,11 @@ vtkDataArray* vtkExodusIIReaderPrivate::FindDisplacementVectors( int timeStep )
       std::string upperName = vtksys::SystemTools::UpperCase( it->second[i].Name.substr( 0, 3 ) );
       if ( upperName == "DIS" && it->second[i].Components == this->ModelParameters.num_dim )
         {
-        return this->GetCacheOrRead( vtkExodusIICacheKey( timeStep, vtkExodusIIReader::NODAL, 0, i ) );
+        return i;
         }
       }
     }
-  return 0;
+  return -1;
 }
 
 
@@ -5043,6 +5497,10 @@ vtkCxxSetObjectMacro(vtkExodusIIReader,Metadata,vtkExodusIIReaderPrivate);
 
 vtkExodusIIReader::vtkExodusIIReader()
 {
+  // The Exodus II and netCDF libraries are not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->FileName = 0;
   this->XMLFileName = 0;
   this->Metadata = vtkExodusIIReaderPrivate::New();
@@ -5075,6 +5533,7 @@ vtkExodusIIReader::~vtkExodusIIReader()
 
 int vtkExodusIIReader::CanReadFile( const char* fname )
 {
+  vtkExodusIILibraryLocker locker;
   int exoid;
   int appWordSize = 8;
   int diskWordSize = 8;
@@ -6253,6 +6712,36 @@ bool vtkExodusIIReader::GetSqueezePoints()
   return this->Metadata->GetSqueezePoints() != 0;
 }
 
+void vtkExodusIIReader::SetThreadedRead(bool threaded)
+{
+  this->Metadata->SetThreadedRead(threaded ? 1 : 0);
+}
+
+bool vtkExodusIIReader::GetThreadedRead()
+{
+  return this->Metadata->GetThreadedRead() != 0;
+}
+
+void vtkExodusIIReader::SetPrefetchNextTimeStep(bool prefetch)
+{
+  this->Metadata->SetPrefetchNextTimeStep(prefetch ? 1 : 0);
+}
+
+bool vtkExodusIIReader::GetPrefetchNextTimeStep()
+{
+  return this->Metadata->GetPrefetchNextTimeStep() != 0;
+}
+
+void vtkExodusIIReader::SetLazyLoadResultArrays(bool lazy)
+{
+  this->Metadata->SetLazyLoadResultArrays(lazy ? 1 : 0);
+}
+
+bool vtkExodusIIReader::GetLazyLoadResultArrays()
+{
+  return this->Metadata->GetLazyLoadResultArrays() != 0;
+}
+
 void vtkExodusIIReader::ResetCache()
 {
   this->Metadata->ResetCache();
@@ -682,6 +682,39 @@ public:
   void SetSqueezePoints(bool sp);
   bool GetSqueezePoints();
 
+  // Description:
+  // Should the blocks and sets be assembled concurrently (using vtkSMPTools).
+  // Calls to the Exodus library are serialized because netCDF and HDF5 are
+  // not thread safe, but building the connectivity, squeezing the points
+  // and subsetting the arrays of each block run in parallel.
+  // Off by default.
+  void SetThreadedRead(bool threaded);
+  bool GetThreadedRead();
+  vtkBooleanMacro(ThreadedRead, bool);
+
+  // Description:
+  // Should the selected variables of the next time step be read into the
+  // cache along with the requested time step, so that stepping forward
+  // through time finds them there. With ThreadedRead, these reads overlap
+  // the assembly of the output. The cache (see SetCacheSize()) must be
+  // large enough to hold the variables of two time steps.
+  // Off by default.
+  void SetPrefetchNextTimeStep(bool prefetch);
+  bool GetPrefetchNextTimeStep();
+  vtkBooleanMacro(PrefetchNextTimeStep, bool);
+
+  // Description:
+  // Should the result variables of blocks and sets (and of nodes, when
+  // SqueezePoints is off) be returned as read-only
+  // vtkCPExodusIIResultsArrayTemplate arrays that read their values from the
+  // file only when they are first accessed. Selecting many variables then
+  // only costs I/O and memory for the ones actually used. Filters that call
+  // GetVoidPointer() on these arrays make an interleaved copy of them.
+  // Off by default.
+  void SetLazyLoadResultArrays(bool lazy);
+  bool GetLazyLoadResultArrays();
+  vtkBooleanMacro(LazyLoadResultArrays, bool);
+
 
   // Description:
   // Re-reads time information from the exodus file and updates
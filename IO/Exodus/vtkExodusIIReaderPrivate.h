@@ -15,6 +15,8 @@
 #include "vtkIOExodusModule.h" // For export macro
 class vtkExodusIIReaderParser;
 class vtkMutableDirectedGraph;
+class vtkExodusIILibraryLock;
+class vtkExodusIIResultsFile;
 
 /** This class holds metadata for an Exodus file.
   *
@@ -96,6 +98,34 @@ public:
   /// required to represent the output.
   vtkBooleanMacro(SqueezePoints,int);
 
+  /** Should RequestData() assemble the blocks and sets concurrently using
+    * vtkSMPTools. Calls to the Exodus library and accesses to the cache are
+    * serialized since netCDF and HDF5 are not thread safe; building the
+    * connectivity, squeezing the points and subsetting the arrays of each
+    * block run in parallel. Off by default.
+    */
+  vtkSetMacro(ThreadedRead,int);
+  vtkGetMacro(ThreadedRead,int);
+  vtkBooleanMacro(ThreadedRead,int);
+
+  /** Should RequestData() also read the selected result variables of the
+    * next time step into the cache. With ThreadedRead, these reads overlap
+    * the assembly of the current time step. This only helps when the cache
+    * is large enough to hold the variables of two time steps.
+    * Off by default.
+    */
+  vtkSetMacro(PrefetchNextTimeStep,int);
+  vtkGetMacro(PrefetchNextTimeStep,int);
+  vtkBooleanMacro(PrefetchNextTimeStep,int);
+
+  /** Should result variables of blocks, sets and (without SqueezePoints)
+    * nodes be returned as vtkCPExodusIIResultsArrayTemplate arrays that read
+    * their values from the file when first accessed. Off by default.
+    */
+  vtkSetMacro(LazyLoadResultArrays,int);
+  vtkGetMacro(LazyLoadResultArrays,int);
+  vtkBooleanMacro(LazyLoadResultArrays,int);
+
   /// Return the number of nodes in the output (depends on SqueezePoints)
   int GetNumberOfNodes();
 
@@ -261,6 +291,9 @@ public:
 
   vtkDataArray* FindDisplacementVectors( int timeStep );
 
+  /// Return the index of the nodal displacement array, or -1 if none.
+  int FindDisplacementVectorsIndex();
+
   const struct ex_init_params* GetModelParams() const
     { return &this->ModelParameters; }
 
@@ -407,6 +440,7 @@ public:
 
   friend class vtkExodusIIReader;
   friend class vtkPExodusIIReader;
+  friend class vtkExodusIIReaderAssembleBlocks;
 
   virtual void SetParser( vtkExodusIIReaderParser* );
   vtkGetObjectMacro(Parser,vtkExodusIIReaderParser);
@@ -604,6 +638,34 @@ protected:
     */
   vtkDataArray* GetCacheOrRead( vtkExodusIICacheKey );
 
+  /** Same as GetCacheOrRead() for callers already holding CacheLock.
+    * This is used by GetCacheOrRead() to assemble arrays from other arrays.
+    */
+  vtkDataArray* GetCacheOrReadLocked( vtkExodusIICacheKey );
+
+  /** Return true if the array for \a key can be read on demand, i.e. if
+    * LazyLoadResultArrays is on and \a key is a result variable.
+    */
+  bool CanLoadLazily( vtkExodusIICacheKey key );
+
+  /** Create the array for \a key, whose values are read from the file when
+    * first accessed. The caller owns the returned array.
+    */
+  vtkDataArray* NewLazyResultArray( vtkExodusIICacheKey key );
+
+  /** Add the connectivity, points and arrays of one block or set to its
+    * output grid. Blocks are independent so this can be called concurrently
+    * for different blocks.
+    */
+  void AssembleOutputBlock( vtkIdType timeStep, int otyp, int obj,
+    int conntypidx, BlockSetInfoType* bsinfop, vtkUnstructuredGrid* output );
+
+  /** Append the keys of the selected time-varying arrays of an output block
+    * at time step \a timeStep. Used to prefetch the next time step.
+    */
+  void GetTemporalArrayKeys( vtkIdType timeStep, int otyp, int obj,
+    std::vector<vtkExodusIICacheKey>& keys );
+
   /** Return the index of an object type (in a private list of all object types).
     * This returns a 0-based index if the object type was found and -1 if it
     * was not.
@@ -808,6 +870,22 @@ protected:
     */
   int SqueezePoints;
 
+  int ThreadedRead;
+  int PrefetchNextTimeStep;
+
+  /** The process-wide Exodus library lock. Besides the library calls of
+    * every reader and lazily-loaded array, it serializes the cache accesses
+    * made by GetCacheOrRead() when blocks are assembled concurrently.
+    */
+  vtkExodusIILibraryLock* CacheLock;
+
+  int LazyLoadResultArrays;
+
+  /** The file read by lazily-loaded result arrays, which may outlive the
+    * handle opened by RequestData().
+    */
+  vtkExodusIIResultsFile* ResultsFile;
+
   /** Pointer to owning reader... this is not registered in order to avoid
     * circular references.
     */
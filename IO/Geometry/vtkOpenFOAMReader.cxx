@@ -41,6 +41,14 @@
 #define VTK_FOAMFILE_OUTBUFSIZE (131072)
 #define VTK_FOAMFILE_INCLUDE_STACK_SIZE (10)
 
+// The maximum size in bytes of the rest of a file (uncompressed) that is
+// read into memory at once to parse a large list concurrently.
+#define VTK_FOAMFILE_MAX_OUTBUFSIZE (1073741824)
+
+// The size in bytes of the chunks of ASCII lists that are parsed
+// concurrently.
+#define VTK_FOAMFILE_LIST_CHUNKSIZE (65536)
+
 #if defined(_MSC_VER) && (_MSC_VER >= 1400)
 #define _CRT_SECURE_NO_WARNINGS 1
 #endif
@@ -54,6 +62,7 @@
 
 #include "vtkOpenFOAMReader.h"
 
+#include <algorithm>
 #include <vector>
 #include "vtksys/SystemTools.hxx"
 #include <vtksys/ios/sstream>
@@ -80,6 +89,7 @@
 #include "vtkPolygon.h"
 #include "vtkPyramid.h"
 #include "vtkQuad.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -726,13 +736,16 @@ protected:
   unsigned char *Outbuf;
   unsigned char *BufPtr;
   unsigned char *BufEndPtr;
+  int OutbufSize;
+  long FileSize;
 
   vtkFoamFileStack() :
     FileName(), File(NULL), IsCompressed(false), ZStatus(Z_OK), LineNumber(0),
 #if VTK_FOAMFILE_RECOGNIZE_LINEHEAD
         WasNewline(true),
 #endif
-        Inbuf(NULL), Outbuf(NULL), BufPtr(NULL), BufEndPtr(NULL)
+        Inbuf(NULL), Outbuf(NULL), BufPtr(NULL), BufEndPtr(NULL),
+        OutbufSize(VTK_FOAMFILE_OUTBUFSIZE), FileSize(-1)
   {
     this->Z.zalloc = Z_NULL;
     this->Z.zfree = Z_NULL;
@@ -1450,10 +1463,35 @@ public:
       // uncompressed format
       this->Superclass::IsCompressed = false;
       }
+
+    // the uncompressed size of the file. a gzipped file stores it modulo
+    // 2^32 in its last 4 bytes, so it may be wrong for huge files, which
+    // then are just not read at once by FillBuffer().
+    this->Superclass::FileSize = -1;
+    if (fseek(this->Superclass::File, this->Superclass::IsCompressed ? -4 : 0,
+        SEEK_END) == 0)
+      {
+      if (this->Superclass::IsCompressed)
+        {
+        unsigned char iSize[4];
+        if (fread(iSize, 1, 4, this->Superclass::File) == 4)
+          {
+          this->Superclass::FileSize = static_cast<long>(iSize[0]
+              | (iSize[1] << 8) | (iSize[2] << 16)
+              | (static_cast<unsigned long>(iSize[3]) << 24));
+          }
+        }
+      else
+        {
+        this->Superclass::FileSize = ftell(this->Superclass::File);
+        }
+      }
     rewind(this->Superclass::File);
 
     this->Superclass::ZStatus = Z_OK;
-    this->Superclass::Outbuf = new unsigned char[VTK_FOAMFILE_OUTBUFSIZE + 1];
+    this->Superclass::OutbufSize = VTK_FOAMFILE_OUTBUFSIZE;
+    this->Superclass::Outbuf =
+      new unsigned char[this->Superclass::OutbufSize + 1];
     this->Superclass::BufPtr = this->Superclass::Outbuf + 1;
     this->Superclass::BufEndPtr = this->Superclass::BufPtr;
     this->Superclass::LineNumber = 1;
@@ -1544,13 +1582,80 @@ public:
       }
   }
 
+  // reads the rest of the file into the buffer. returns false if it is
+  // larger than VTK_FOAMFILE_MAX_OUTBUFSIZE or its size is unknown.
+  bool FillBuffer();
+
+  // the part of the input that is already in the buffer and is yet to be
+  // read
+  const unsigned char *GetBufferBegin() const
+  {
+    return this->Superclass::BufPtr;
+  }
+  const unsigned char *GetBufferEnd() const
+  {
+    return this->Superclass::BufEndPtr;
+  }
+
+  // skip the buffered input up to ptr
+  void SkipBuffer(const unsigned char *ptr)
+  {
+    const unsigned char *bufPtr = this->Superclass::BufPtr;
+    this->Superclass::LineNumber
+        += static_cast<int>(std::count(bufPtr, ptr, '\n'));
+    this->Superclass::BufPtr = const_cast<unsigned char *>(ptr);
+  }
+
   int ReadIntValue();
   float ReadFloatValue();
 };
 
+bool vtkFoamFile::FillBuffer()
+{
+  if (this->Superclass::FileSize < 0 || this->Superclass::ZStatus != Z_OK)
+    {
+    return false;
+    }
+  const long nRead = this->Superclass::IsCompressed
+      ? static_cast<long>(this->Superclass::Z.total_out)
+      : ftell(this->Superclass::File);
+  const long restSize = this->Superclass::FileSize - nRead;
+  if (restSize <= 0)
+    {
+    // the whole file has already been read into the buffer
+    return nRead >= 0;
+    }
+  const int nBuffered = static_cast<int>(this->Superclass::BufEndPtr
+      - this->Superclass::BufPtr);
+  if (restSize > VTK_FOAMFILE_MAX_OUTBUFSIZE - nBuffered)
+    {
+    return false;
+    }
+
+  // move the buffered input to the head of a buffer that is large enough
+  // for the rest of the file
+  const int outbufSize = nBuffered + static_cast<int>(restSize);
+  unsigned char *outbuf = new unsigned char[outbufSize + 1];
+  memcpy(outbuf + 1, this->Superclass::BufPtr, nBuffered);
+  delete [] this->Superclass::Outbuf;
+  this->Superclass::Outbuf = outbuf;
+  this->Superclass::OutbufSize = outbufSize;
+  if (this->InflateNext(outbuf + 1 + nBuffered, static_cast<int>(restSize)))
+    {
+    this->Superclass::BufEndPtr += nBuffered;
+    }
+  else
+    {
+    this->Superclass::BufPtr = outbuf + 1;
+    this->Superclass::BufEndPtr = this->Superclass::BufPtr + nBuffered;
+    }
+  return true;
+}
+
 int vtkFoamFile::ReadNext()
 {
-  if (!this->InflateNext(this->Superclass::Outbuf + 1, VTK_FOAMFILE_OUTBUFSIZE))
+  if (!this->InflateNext(this->Superclass::Outbuf + 1,
+      this->Superclass::OutbufSize))
     {
     return this->CloseIncludedFile() ? this->Getc() : EOF;
     }
@@ -2001,6 +2106,487 @@ public:
   }
 };
 
+//-----------------------------------------------------------------------------
+// string to number conversion of the values of a list in memory. converts
+// the same way as vtkFoamFile::ReadIntValue() and ReadFloatValue() do, but
+// returns false instead of throwing an exception if the value is not
+// delimited by a space, a parenthesis or the end of the input.
+// inlined, locale independent isdigit() and isspace()
+static inline bool vtkFoamIsDigit(const int c)
+{
+  return static_cast<unsigned int>(c - 48) < 10; // '0' == 48
+}
+
+static inline bool vtkFoamIsSpace(const int c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline int vtkFoamNextChar(const unsigned char *&ptr,
+    const unsigned char *endPtr)
+{
+  return ++ptr != endPtr ? *ptr : EOF;
+}
+
+static inline bool vtkFoamIsDelimiter(const int c)
+{
+  return c == EOF || vtkFoamIsSpace(c) || c == '(' || c == ')';
+}
+
+static bool vtkFoamParseValue(const unsigned char *&ptr,
+    const unsigned char *endPtr, int &value)
+{
+  int c = *ptr;
+  const int nonNegative = c - 45; // '-' == 45
+  if (nonNegative == 0 || c == 43) // '+' == 43
+    {
+    c = vtkFoamNextChar(ptr, endPtr);
+    }
+  if (!vtkFoamIsDigit(c))
+    {
+    return false;
+    }
+  int num = c - 48; // '0' == 48
+  while (vtkFoamIsDigit(c = vtkFoamNextChar(ptr, endPtr)))
+    {
+    num = 10 * num + c - 48;
+    }
+  value = nonNegative ? num : -num;
+  return vtkFoamIsDelimiter(c);
+}
+
+static bool vtkFoamParseValue(const unsigned char *&ptr,
+    const unsigned char *endPtr, float &value)
+{
+  int c = *ptr;
+  const int nonNegative = c - 45; // '-' == 45
+  if (nonNegative == 0 || c == 43) // '+' == 43
+    {
+    c = vtkFoamNextChar(ptr, endPtr);
+    }
+  if (!vtkFoamIsDigit(c) && c != 46) // '.' == 46
+    {
+    return false;
+    }
+
+  // read integer part
+  double num = c - 48; // '0' == 48
+  while (vtkFoamIsDigit(c = vtkFoamNextChar(ptr, endPtr)))
+    {
+    num = num * 10.0 + (c - 48);
+    }
+
+  // read decimal part
+  if (c == 46) // '.'
+    {
+    double divisor = 1.0;
+    while (vtkFoamIsDigit(c = vtkFoamNextChar(ptr, endPtr)))
+      {
+      num = num * 10.0 + (c - 48);
+      divisor *= 10.0;
+      }
+    num /= divisor;
+    }
+
+  // read exponent part
+  if (c == 69 || c == 101) // 'E' == 69, 'e' == 101
+    {
+    int esign = 1;
+    int eval = 0;
+    double scale = 1.0;
+
+    c = vtkFoamNextChar(ptr, endPtr);
+    if (c == 45) // '-'
+      {
+      esign = -1;
+      c = vtkFoamNextChar(ptr, endPtr);
+      }
+    else if (c == 43) // '+'
+      {
+      c = vtkFoamNextChar(ptr, endPtr);
+      }
+
+    while (vtkFoamIsDigit(c))
+      {
+      eval = eval * 10 + (c - 48);
+      c = vtkFoamNextChar(ptr, endPtr);
+      }
+
+    while (eval >= 64)
+      {
+      scale *= 1.0e+64;
+      eval -= 64;
+      }
+    while (eval >= 16)
+      {
+      scale *= 1.0e+16;
+      eval -= 16;
+      }
+    while (eval >= 4)
+      {
+      scale *= 1.0e+4;
+      eval -= 4;
+      }
+    while (eval >= 1)
+      {
+      scale *= 1.0e+1;
+      eval -= 1;
+      }
+
+    if (esign < 0)
+      {
+      num /= scale;
+      }
+    else
+      {
+      num *= scale;
+      }
+    }
+
+  value = static_cast<float>(nonNegative ? num : -num);
+  return vtkFoamIsDelimiter(c);
+}
+
+static inline const unsigned char *vtkFoamSkipSpaces(const unsigned char *ptr,
+    const unsigned char *endPtr)
+{
+  while (ptr != endPtr && vtkFoamIsSpace(*ptr))
+    {
+    ++ptr;
+    }
+  return ptr;
+}
+
+//-----------------------------------------------------------------------------
+// class vtkFoamAsciiListParser
+// parses the body of a nonuniform ASCII list concurrently. the rest of the
+// file is read into the buffer, the body is split into chunks at element
+// boundaries, and the elements of the chunks are counted and then parsed
+// into place in parallel. a body with anything but numbers in it (e. g. a
+// comment) is left to the tokenizer.
+template <typename T> class vtkFoamAsciiListParser
+{
+public:
+  // VALUES: numbers, TUPLES: nComponents numbers enclosed by (),
+  // SUBLISTS: size-prefixed lists of numbers (e. g. faces)
+  enum listType { VALUES, TUPLES, SUBLISTS };
+
+  vtkFoamAsciiListParser(const listType type, const int nComponents = 1) :
+    Type(type), NComponents(nComponents), ListEnd(NULL), Counting(true),
+    Values(NULL), Indices(NULL)
+  {
+  }
+
+  // finds the end of the list body at the read position of io and counts
+  // its elements. returns false if the body has to be read by the
+  // tokenizer.
+  bool Scan(vtkFoamFile& io)
+  {
+    if (!this->FindListEnd(io) && !(io.FillBuffer() && this->FindListEnd(io)))
+      {
+      return false;
+      }
+
+    // split the body into chunks that begin at element boundaries
+    const unsigned char *listBegin = io.GetBufferBegin();
+    const vtkIdType length = this->ListEnd - listBegin;
+    const vtkIdType nChunks = length / VTK_FOAMFILE_LIST_CHUNKSIZE + 1;
+    this->ChunkBegins.resize(nChunks + 1);
+    this->ChunkBegins[0] = listBegin;
+    for (vtkIdType chunkI = 1; chunkI < nChunks; chunkI++)
+      {
+      const unsigned char *ptr = std::max(listBegin + length * chunkI / nChunks,
+          this->ChunkBegins[chunkI - 1]);
+      if (this->Type == VALUES)
+        {
+        while (ptr != this->ListEnd && !vtkFoamIsSpace(*ptr))
+          {
+          ++ptr;
+          }
+        }
+      else
+        {
+        while (ptr != this->ListEnd && *ptr != ')')
+          {
+          ++ptr;
+          }
+        if (ptr != this->ListEnd)
+          {
+          ++ptr;
+          }
+        }
+      this->ChunkBegins[chunkI] = ptr;
+      }
+    this->ChunkBegins[nChunks] = this->ListEnd;
+
+    // count the elements and values of each chunk and turn the counts
+    // into the offsets of the chunks
+    this->ElementOffsets.assign(nChunks + 1, 0);
+    this->ValueOffsets.assign(nChunks + 1, 0);
+    this->Counting = true;
+    vtkSMPTools::For(0, nChunks, 1, *this);
+    for (vtkIdType chunkI = 0; chunkI < nChunks; chunkI++)
+      {
+      this->ElementOffsets[chunkI + 1] += this->ElementOffsets[chunkI];
+      this->ValueOffsets[chunkI + 1] += this->ValueOffsets[chunkI];
+      }
+    return true;
+  }
+
+  // the number of elements (numbers, tuples or sublists) and of numbers
+  // found by Scan()
+  vtkIdType GetNumberOfElements() const
+  {
+    return this->ElementOffsets.back();
+  }
+  vtkIdType GetNumberOfValues() const
+  {
+    return this->ValueOffsets.back();
+  }
+
+  // parses the numbers into values and, for SUBLISTS, the offsets of the
+  // sublists into indices (but the offset past the last sublist). returns
+  // false if an element is malformed.
+  bool Parse(T *values, int *indices)
+  {
+    this->Values = values;
+    this->Indices = indices;
+    this->IsValid.assign(this->ChunkBegins.size() - 1, 1);
+    this->Counting = false;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(this->IsValid.size()), 1,
+        *this);
+    return std::find(this->IsValid.begin(), this->IsValid.end(), 0)
+        == this->IsValid.end();
+  }
+
+  // skips the list body up to the closing parenthesis
+  void Finish(vtkFoamFile& io)
+  {
+    io.SkipBuffer(this->ListEnd);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunkI = begin; chunkI < end; chunkI++)
+      {
+      if (this->Counting)
+        {
+        this->Count(chunkI);
+        }
+      else
+        {
+        this->IsValid[chunkI] = this->ParseChunk(chunkI);
+        }
+      }
+  }
+
+private:
+  const listType Type;
+  const int NComponents;
+  const unsigned char *ListEnd;
+  std::vector<const unsigned char *> ChunkBegins;
+  std::vector<vtkIdType> ElementOffsets;
+  std::vector<vtkIdType> ValueOffsets;
+  std::vector<char> IsValid;
+  bool Counting;
+  T *Values;
+  int *Indices;
+
+  // finds the closing parenthesis of the list body in the buffer. only
+  // the parentheses are looked at, the rest of the body is checked by
+  // ParseChunk().
+  bool FindListEnd(vtkFoamFile& io)
+  {
+    const unsigned char *ptr = io.GetBufferBegin();
+    const unsigned char *endPtr = io.GetBufferEnd();
+    if (this->Type == VALUES)
+      {
+      this->ListEnd = static_cast<const unsigned char *>(
+          memchr(ptr, ')', endPtr - ptr));
+      return this->ListEnd != NULL;
+      }
+    bool inParentheses = false;
+    for (; ptr != endPtr; ++ptr)
+      {
+      if (*ptr == '(')
+        {
+        if (inParentheses)
+          {
+          return false;
+          }
+        inParentheses = true;
+        }
+      else if (*ptr == ')')
+        {
+        if (!inParentheses)
+          {
+          this->ListEnd = ptr;
+          return true;
+          }
+        inParentheses = false;
+        }
+      }
+    return false;
+  }
+
+  void Count(const vtkIdType chunkI)
+  {
+    const unsigned char *ptr = this->ChunkBegins[chunkI];
+    const unsigned char *endPtr = this->ChunkBegins[chunkI + 1];
+    vtkIdType nElements = 0, nValues = 0;
+    if (this->Type == TUPLES)
+      {
+      // ParseChunk() checks the number of components
+      nElements = std::count(ptr, endPtr, '(');
+      nValues = this->NComponents * nElements;
+      }
+    else if (this->Type == VALUES)
+      {
+      // count the beginnings of values. a chunk begins with a space or
+      // with the list body.
+      bool wasSpace = true;
+      for (; ptr != endPtr; ++ptr)
+        {
+        const bool isSpace = vtkFoamIsSpace(*ptr);
+        nValues += wasSpace && !isSpace;
+        wasSpace = isSpace;
+        }
+      }
+    else
+      {
+      bool inParentheses = false, inValue = false;
+      for (; ptr != endPtr; ++ptr)
+        {
+        const int c = *ptr;
+        if (vtkFoamIsSpace(c) || c == '(' || c == ')')
+          {
+          inValue = false;
+          if (c == '(')
+            {
+            inParentheses = true;
+            nElements++;
+            }
+          else if (c == ')')
+            {
+            inParentheses = false;
+            }
+          }
+        else if (!inValue)
+          {
+          inValue = true;
+          // sizes of sublists are not values
+          if (inParentheses)
+            {
+            nValues++;
+            }
+          }
+        }
+      }
+    this->ElementOffsets[chunkI + 1] =
+      this->Type == VALUES ? nValues : nElements;
+    this->ValueOffsets[chunkI + 1] = nValues;
+  }
+
+  bool ParseChunk(const vtkIdType chunkI)
+  {
+    T *values = this->Values + this->ValueOffsets[chunkI];
+    T *const valuesEnd = this->Values + this->ValueOffsets[chunkI + 1];
+    vtkIdType elementI = this->ElementOffsets[chunkI];
+    const vtkIdType elementsEnd = this->ElementOffsets[chunkI + 1];
+    const unsigned char *endPtr = this->ChunkBegins[chunkI + 1];
+    const unsigned char *ptr = this->ChunkBegins[chunkI];
+    while ((ptr = vtkFoamSkipSpaces(ptr, endPtr)) != endPtr)
+      {
+      if (elementI == elementsEnd)
+        {
+        return false;
+        }
+      if (this->Type == VALUES)
+        {
+        if (!vtkFoamParseValue(ptr, endPtr, *values++))
+          {
+          return false;
+          }
+        }
+      else
+        {
+        int nValues = this->NComponents;
+        if (this->Type == SUBLISTS)
+          {
+          if (!vtkFoamParseValue(ptr, endPtr, nValues) || nValues < 0
+              || nValues > valuesEnd - values)
+            {
+            return false;
+            }
+          this->Indices[elementI] = static_cast<int>(values - this->Values);
+          ptr = vtkFoamSkipSpaces(ptr, endPtr);
+          }
+        if (ptr == endPtr || *ptr != '(')
+          {
+          return false;
+          }
+        ++ptr;
+        for (int valueI = 0; valueI < nValues; valueI++)
+          {
+          ptr = vtkFoamSkipSpaces(ptr, endPtr);
+          if (ptr == endPtr || !vtkFoamParseValue(ptr, endPtr, *values++))
+            {
+            return false;
+            }
+          }
+        ptr = vtkFoamSkipSpaces(ptr, endPtr);
+        if (ptr == endPtr || *ptr != ')')
+          {
+          return false;
+          }
+        ++ptr;
+        }
+      elementI++;
+      }
+    return elementI == elementsEnd && values == valuesEnd;
+  }
+};
+
+//-----------------------------------------------------------------------------
+// class vtkFoamBinaryListConverter
+// converts the double precision values of a binary list to single
+// precision concurrently
+class vtkFoamBinaryListConverter
+{
+public:
+  // returns false if the values are not in the buffer of io
+  static bool Convert(vtkFoamFile& io, float *values, const vtkIdType nValues)
+  {
+    const vtkIdType nBytes = nValues * static_cast<vtkIdType>(sizeof(double));
+    if (io.GetBufferEnd() - io.GetBufferBegin() < nBytes
+        && !(io.FillBuffer()
+             && io.GetBufferEnd() - io.GetBufferBegin() >= nBytes))
+      {
+      return false;
+      }
+    vtkFoamBinaryListConverter converter;
+    converter.Buffer = io.GetBufferBegin();
+    converter.Values = values;
+    vtkSMPTools::For(0, nValues, converter);
+    io.SkipBuffer(io.GetBufferBegin() + nBytes);
+    return true;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      double value;
+      memcpy(&value, this->Buffer + i * sizeof(double), sizeof(double));
+      this->Values[i] = static_cast<float>(value);
+      }
+  }
+
+private:
+  const unsigned char *Buffer;
+  float *Values;
+};
+
 //-----------------------------------------------------------------------------
 // workarounding class for older compilers (gcc-3.3.x and possibly older)
 template <typename T> struct vtkFoamReadValue
@@ -2065,6 +2651,14 @@ public:
     }
     void ReadAsciiList(vtkFoamIOobject& io, const int size)
     {
+      typedef vtkFoamAsciiListParser<primitiveT> parserT;
+      parserT parser(parserT::VALUES);
+      if (parser.Scan(io) && parser.GetNumberOfElements() == size
+          && parser.Parse(this->Ptr->GetPointer(0), NULL))
+        {
+        parser.Finish(io);
+        return;
+        }
       for (int i = 0; i < size; i++)
         {
         this->Ptr->SetValue(i, vtkFoamReadValue<primitiveT>::ReadValue(io));
@@ -2126,6 +2720,15 @@ public:
     }
     void ReadAsciiList(vtkFoamIOobject& io, const int size)
     {
+      typedef vtkFoamAsciiListParser<primitiveT> parserT;
+      parserT parser(parserT::TUPLES, nComponents);
+      if (!isPositions && parser.Scan(io)
+          && parser.GetNumberOfElements() == size
+          && parser.Parse(this->Ptr->GetPointer(0), NULL))
+        {
+        parser.Finish(io);
+        return;
+        }
       for (int i = 0; i < size; i++)
         {
         io.ReadExpecting('(');
@@ -2165,7 +2768,8 @@ public:
           io.ReadExpecting(')');
           }
         }
-      else
+      else if (!vtkFoamBinaryListConverter::Convert(io,
+          this->Ptr->GetPointer(0), static_cast<vtkIdType>(size) * nComponents))
         {
         for (int i = 0; i < size; i++)
           {
@@ -2338,6 +2942,24 @@ public:
       this->Superclass::LabelListListPtr = new vtkFoamIntVectorVector(sizeI, 4 * sizeI);
       this->Superclass::Type = LABELLISTLIST;
       io.ReadExpecting('(');
+
+      vtkFoamAsciiListParser<int> parser(vtkFoamAsciiListParser<int>::SUBLISTS);
+      if (io.GetFormat() == vtkFoamIOobject::ASCII && parser.Scan(io)
+          && parser.GetNumberOfElements() == sizeI)
+        {
+        vtkIntArray *body = this->Superclass::LabelListListPtr->GetBody();
+        int *indices =
+          this->Superclass::LabelListListPtr->GetIndices()->GetPointer(0);
+        body->SetNumberOfValues(parser.GetNumberOfValues());
+        if (parser.Parse(body->GetPointer(0), indices))
+          {
+          indices[sizeI] = static_cast<int>(parser.GetNumberOfValues());
+          parser.Finish(io);
+          io.ReadExpecting(')');
+          return;
+          }
+        }
+
       int bodyI = 0;
       for (int i = 0; i < sizeI; i++)
         {
@@ -2514,6 +3136,10 @@ VTK_TEMPLATE_SPECIALIZE
 void vtkFoamEntryValue::listTraits<vtkFloatArray, float>::ReadBinaryList(
     vtkFoamIOobject& io, const int size)
 {
+  if (vtkFoamBinaryListConverter::Convert(io, this->Ptr->GetPointer(0), size))
+    {
+    return;
+    }
   for (int i = 0; i < size; i++)
     {
     double buffer;
@@ -8173,6 +8799,7 @@ vtkOpenFOAMReader::vtkOpenFOAMReader()
   this->LagrangianPaths = vtkStringArray::New();
 
   this->CurrentReaderIndex = 0;
+  this->UpdatingReadersConcurrently = false;
   this->NumberOfReaders = 0;
 }
 
@@ -8681,6 +9308,12 @@ void vtkOpenFOAMReader::UpdateStatus()
 //-----------------------------------------------------------------------------
 void vtkOpenFOAMReader::UpdateProgress(double amount)
 {
+  // the progress events of a parallel reader must be invoked from the
+  // thread that updates it
+  if (this->Parent->UpdatingReadersConcurrently)
+    {
+    return;
+    }
   this->vtkAlgorithm::UpdateProgress((static_cast<double>(this->Parent->CurrentReaderIndex)
       + amount) / static_cast<double>(this->Parent->NumberOfReaders));
 }
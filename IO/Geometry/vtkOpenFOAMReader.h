@@ -40,6 +40,7 @@
 
 #include "vtkIOGeometryModule.h" // For export macro
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkAtomicTypes.h" // For CurrentReaderIndex
 
 class vtkCollection;
 class vtkCharArray;
@@ -286,8 +287,12 @@ protected:
 
   // number of reader instances
   int NumberOfReaders;
-  // index of the active reader
-  int CurrentReaderIndex;
+  // index of the active reader. incremented by the readers of the
+  // subdomains of a decomposed case, which may be updated concurrently.
+  vtkAtomicInt32 CurrentReaderIndex;
+  // whether the readers of the subdomains are being updated concurrently,
+  // in which case no progress event is invoked
+  bool UpdatingReadersConcurrently;
 
   vtkOpenFOAMReader();
   ~vtkOpenFOAMReader();
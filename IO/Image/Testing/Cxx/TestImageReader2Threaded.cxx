@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageReader2Threaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that a stack of PNG or JPEG slice files read from several threads
+// gives the same volume as when it is read from one, that the progress
+// of the reader never goes backward, and that a slice that cannot be read
+// is reported from the calling thread.
+
+#include "vtkCallbackCommand.h"
+#include "vtkImageData.h"
+#include "vtkImageReader2.h"
+#include "vtkImageWriter.h"
+#include "vtkJPEGReader.h"
+#include "vtkJPEGWriter.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPNGReader.h"
+#include "vtkPNGWriter.h"
+#include "vtkTestUtilities.h"
+
+#include <cstdio>
+#include <string>
+
+static const int NUMBER_OF_SLICES = 24;
+
+//----------------------------------------------------------------------------
+static void CheckProgress(vtkObject* caller, unsigned long, void* clientData,
+                          void*)
+{
+  double* lastProgress = static_cast<double*>(clientData);
+  double progress = vtkImageReader2::SafeDownCast(caller)->GetProgress();
+  if (progress < lastProgress[0])
+    {
+    lastProgress[1] = 1.0;
+    }
+  lastProgress[0] = progress;
+}
+
+//----------------------------------------------------------------------------
+// Count the errors, and those reported from another thread than the one
+// that created the reader.
+struct ErrorCount
+{
+  vtkMultiThreaderIDType MainThread;
+  int Errors;
+  int OtherThreadErrors;
+};
+
+//----------------------------------------------------------------------------
+static void CountErrors(vtkObject*, unsigned long, void* clientData, void*)
+{
+  ErrorCount* count = static_cast<ErrorCount*>(clientData);
+  ++count->Errors;
+  if (!vtkMultiThreader::ThreadsEqual(count->MainThread,
+                                      vtkMultiThreader::GetCurrentThreadID()))
+    {
+    ++count->OtherThreadErrors;
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool ReadStack(vtkImageWriter* writer, vtkImageReader2* serial,
+                      vtkImageReader2* threaded, const std::string& prefix)
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 47, 0, 31, 0, NUMBER_OF_SLICES - 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  unsigned char* ptr =
+    static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int k = 0; k < NUMBER_OF_SLICES; ++k)
+    {
+    for (int j = 0; j < 32; ++j)
+      {
+      for (int i = 0; i < 48; ++i)
+        {
+        *ptr++ = static_cast<unsigned char>(5 * i + k);
+        *ptr++ = static_cast<unsigned char>(7 * j);
+        *ptr++ = static_cast<unsigned char>(11 * k + i * j);
+        }
+      }
+    }
+
+  writer->SetInputData(image.GetPointer());
+  writer->SetFilePrefix(prefix.c_str());
+  writer->SetFilePattern("%s.%03d");
+  writer->SetFileDimensionality(2);
+  writer->Write();
+
+  vtkImageReader2* readers[2] = { serial, threaded };
+  double lastProgress[2] = { 0.0, 0.0 };
+  vtkNew<vtkCallbackCommand> progress;
+  progress->SetCallback(CheckProgress);
+  progress->SetClientData(lastProgress);
+  for (int r = 0; r < 2; ++r)
+    {
+    readers[r]->SetFilePrefix(prefix.c_str());
+    readers[r]->SetFilePattern("%s.%03d");
+    readers[r]->SetDataExtent(0, 47, 0, 31, 0, NUMBER_OF_SLICES - 1);
+    readers[r]->AddObserver(vtkCommand::ProgressEvent, progress.GetPointer());
+    lastProgress[0] = 0.0;
+    readers[r]->Update();
+    readers[r]->RemoveObserver(progress.GetPointer());
+    }
+  if (lastProgress[1] != 0.0)
+    {
+    cerr << "Progress of " << prefix << " went backward" << endl;
+    return false;
+    }
+
+  vtkImageData* a = serial->GetOutput();
+  vtkImageData* b = threaded->GetOutput();
+  int extA[6], extB[6];
+  a->GetExtent(extA);
+  b->GetExtent(extB);
+  for (int i = 0; i < 6; ++i)
+    {
+    if (extA[i] != extB[i] || extA[i] != image->GetExtent()[i])
+      {
+      cerr << "Wrong extent reading " << prefix << endl;
+      return false;
+      }
+    }
+  vtkIdType size = a->GetNumberOfPoints() * a->GetNumberOfScalarComponents();
+  if (b->GetNumberOfPoints() * b->GetNumberOfScalarComponents() != size ||
+      memcmp(a->GetScalarPointer(), b->GetScalarPointer(), size) != 0)
+    {
+    cerr << "Slices of " << prefix << " differ when read from "
+         << threaded->GetNumberOfThreads() << " threads" << endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int TestImageReader2Threaded(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string prefix = tempDir;
+  delete [] tempDir;
+  prefix += "/TestImageReader2Threaded";
+
+  vtkNew<vtkPNGWriter> pngWriter;
+  vtkNew<vtkPNGReader> pngSerial;
+  vtkNew<vtkPNGReader> pngThreaded;
+  pngThreaded->SetNumberOfThreads(4);
+  if (!ReadStack(pngWriter.GetPointer(), pngSerial.GetPointer(),
+                 pngThreaded.GetPointer(), prefix + "PNG"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Remove every other slice: each must be reported once, by the calling
+  // thread, while the other threads keep reading.
+  for (int k = 1; k < NUMBER_OF_SLICES; k += 2)
+    {
+    char missingSlice[32];
+    sprintf(missingSlice, "PNG.%03d", k);
+    remove((prefix + missingSlice).c_str());
+    }
+  ErrorCount count = { vtkMultiThreader::GetCurrentThreadID(), 0, 0 };
+  vtkNew<vtkCallbackCommand> countErrors;
+  countErrors->SetCallback(CountErrors);
+  countErrors->SetClientData(&count);
+  pngThreaded->AddObserver(vtkCommand::ErrorEvent, countErrors.GetPointer());
+  pngThreaded->Modified();
+  pngThreaded->Update();
+  if (count.Errors != NUMBER_OF_SLICES / 2 || count.OtherThreadErrors != 0)
+    {
+    cerr << "Expected " << NUMBER_OF_SLICES / 2 << " errors from the calling "
+         << "thread for the missing slices, got " << count.Errors << " with "
+         << count.OtherThreadErrors << " from other threads" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkJPEGWriter> jpegWriter;
+  vtkNew<vtkJPEGReader> jpegSerial;
+  vtkNew<vtkJPEGReader> jpegThreaded;
+  jpegThreaded->SetNumberOfThreads(3);
+  if (!ReadStack(jpegWriter.GetPointer(), jpegSerial.GetPointer(),
+                 jpegThreaded.GetPointer(), prefix + "JPEG"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
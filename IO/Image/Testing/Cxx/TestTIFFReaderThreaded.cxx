@@ -0,0 +1,324 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTIFFReaderThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkTIFFReader reads the same pixels from one or several
+// threads, and only the pixels of the requested extent, from one file, from
+// a stack of files, from tiled files and from the pages of multi-page files,
+// with or without reduced resolution subfiles between the pages.
+
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTIFFReader.h"
+#include "vtkTIFFWriter.h"
+#include "vtkTestUtilities.h"
+
+#include "vtk_tiff.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Read \a extent with \a reader and compare it to the same extent of
+// \a image.  The reader is modified first, so that it decodes the extent
+// again instead of keeping a larger output of a previous update.
+static bool ReadExtent(vtkTIFFReader* reader, vtkImageData* image,
+                       int x0, int x1, int y0, int y1, int z0, int z1)
+{
+  int extent[6] = { x0, x1, y0, y1, z0, z1 };
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(reader->GetExecutive());
+  reader->Modified();
+  reader->UpdateInformation();
+  sddp->SetUpdateExtent(0, extent);
+  sddp->Update(0);
+
+  vtkImageData* output = reader->GetOutput();
+  int outExt[6];
+  output->GetExtent(outExt);
+  for (int i = 0; i < 6; ++i)
+    {
+    if (outExt[i] != extent[i])
+      {
+      cerr << "Read extent " << outExt[i] << " instead of " << extent[i]
+           << endl;
+      return false;
+      }
+    }
+
+  size_t rowSize = (x1 - x0 + 1) * image->GetNumberOfScalarComponents() *
+    image->GetScalarSize();
+  for (int z = z0; z <= z1; ++z)
+    {
+    for (int y = y0; y <= y1; ++y)
+      {
+      if (memcmp(output->GetScalarPointer(x0, y, z),
+                 image->GetScalarPointer(x0, y, z), rowSize) != 0)
+        {
+        cerr << "Row " << y << " of slice " << z << " differs when read from "
+             << reader->GetNumberOfThreads() << " threads" << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+static void FillImage(vtkImageData* image, int components)
+{
+  int extent[6];
+  image->GetExtent(extent);
+  T* ptr = static_cast<T*>(image->GetScalarPointer());
+  for (int z = extent[4]; z <= extent[5]; ++z)
+    {
+    for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+      for (int x = extent[0]; x <= extent[1]; ++x)
+        {
+        for (int c = 0; c < components; ++c)
+          {
+          *ptr++ = static_cast<T>(x * 3 + y * 7 + z * 13 + c * 29 + x * y);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Write \a image to \a fileName with libtiff, one page per slice, in tiles
+// of \a tileSize pixels or in strips of 7 rows if \a tileSize is 0.  The
+// first row of each page is the top row of the slice.  If \a thumbnails,
+// each page is followed by a reduced resolution subfile.
+static bool WriteTIFF(vtkImageData* image, const std::string& fileName,
+                      unsigned int tileSize, bool thumbnails)
+{
+  TIFF* tif = TIFFOpen(fileName.c_str(), "w");
+  if (!tif)
+    {
+    return false;
+    }
+  int extent[6];
+  image->GetExtent(extent);
+  unsigned int width = extent[1] - extent[0] + 1;
+  unsigned int height = extent[3] - extent[2] + 1;
+  int numPages = extent[5] - extent[4] + 1;
+  int components = image->GetNumberOfScalarComponents();
+  size_t pixelSize = components * image->GetScalarSize();
+  std::vector<unsigned char> chunk;
+  bool written = true;
+  for (int page = 0; page < numPages; ++page)
+    {
+    for (int subfile = 0; subfile < (thumbnails ? 2 : 1); ++subfile)
+      {
+      unsigned int w = subfile ? 8 : width;
+      unsigned int h = subfile ? 8 : height;
+      TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+      TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+      TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, components);
+      TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8 * image->GetScalarSize());
+      TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, components == 1 ?
+                   PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB);
+      TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_PACKBITS);
+      if (thumbnails)
+        {
+        TIFFSetField(tif, TIFFTAG_SUBFILETYPE,
+                     subfile ? FILETYPE_REDUCEDIMAGE : 0);
+        }
+      else if (numPages > 1)
+        {
+        TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
+        TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, numPages);
+        }
+
+      // The pixels of a subfile are those of the top left of its page.
+      size_t rowSize = w * pixelSize;
+      if (tileSize && !subfile)
+        {
+        TIFFSetField(tif, TIFFTAG_TILEWIDTH, tileSize);
+        TIFFSetField(tif, TIFFTAG_TILELENGTH, tileSize);
+        chunk.assign(tileSize * tileSize * pixelSize, 0);
+        for (unsigned int y0 = 0; y0 < h; y0 += tileSize)
+          {
+          for (unsigned int x0 = 0; x0 < w; x0 += tileSize)
+            {
+            unsigned int tileWidth = std::min(tileSize, w - x0);
+            for (unsigned int y = y0; y < y0 + tileSize && y < h; ++y)
+              {
+              memcpy(&chunk[(y - y0) * tileSize * pixelSize],
+                     image->GetScalarPointer(extent[0] + x0,
+                                             extent[3] - y, extent[4] + page),
+                     tileWidth * pixelSize);
+              }
+            written = written &&
+              TIFFWriteTile(tif, &chunk[0], x0, y0, 0, 0) >= 0;
+            }
+          }
+        }
+      else
+        {
+        TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, 7);
+        chunk.resize(rowSize);
+        for (unsigned int y = 0; y < h; ++y)
+          {
+          memcpy(&chunk[0], image->GetScalarPointer(extent[0], extent[3] - y,
+                                                    extent[4] + page),
+                 rowSize);
+          written = written && TIFFWriteScanline(tif, &chunk[0], y, 0) >= 0;
+          }
+        }
+      written = written && TIFFWriteDirectory(tif);
+      }
+    }
+  TIFFClose(tif);
+  return written;
+}
+
+//----------------------------------------------------------------------------
+// Read pages of the multi-page or tiled file written from \a image.
+static bool TestFile(vtkImageData* image, const std::string& fileName,
+                     unsigned int tileSize, bool thumbnails)
+{
+  if (!WriteTIFF(image, fileName, tileSize, thumbnails))
+    {
+    cerr << "Could not write " << fileName << endl;
+    return false;
+    }
+
+  int extent[6];
+  image->GetExtent(extent);
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+    vtkNew<vtkTIFFReader> reader;
+    reader->SetFileName(fileName.c_str());
+    reader->SetNumberOfThreads(numThreads);
+    if (!ReadExtent(reader.GetPointer(), image, extent[0], extent[1],
+                    extent[2], extent[3], extent[4], extent[5]) ||
+        !ReadExtent(reader.GetPointer(), image, 21, 97, 10, 83,
+                    extent[4], extent[5]) ||
+        !ReadExtent(reader.GetPointer(), image, 0, extent[1], 37, 37,
+                    extent[5], extent[5]) ||
+        !ReadExtent(reader.GetPointer(), image, 5, 5, 0, extent[3],
+                    extent[4], extent[4]))
+      {
+      cerr << "Reading " << fileName << " failed" << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static bool TestStack(vtkImageData* image, const std::string& prefix)
+{
+  vtkNew<vtkTIFFWriter> writer;
+  writer->SetInputData(image);
+  writer->SetCompressionToPackBits();
+  writer->SetFilePrefix(prefix.c_str());
+  writer->SetFilePattern("%s.%d.tif");
+  writer->SetFileDimensionality(2);
+  writer->Write();
+
+  int extent[6];
+  image->GetExtent(extent);
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+    // Whole stack, then parts of it with the same reader.
+    vtkNew<vtkTIFFReader> reader;
+    reader->SetFilePrefix(prefix.c_str());
+    reader->SetFilePattern("%s.%d.tif");
+    reader->SetDataExtent(extent);
+    reader->SetOrientationType(4); // ORIENTATION_BOTLEFT
+    reader->SetNumberOfThreads(numThreads);
+    if (!ReadExtent(reader.GetPointer(), image, extent[0], extent[1],
+                    extent[2], extent[3], extent[4], extent[5]) ||
+        !ReadExtent(reader.GetPointer(), image, 21, 97, 10, 83, 1, 4) ||
+        !ReadExtent(reader.GetPointer(), image, 0, extent[1], 37, 37, 3, 3) ||
+        !ReadExtent(reader.GetPointer(), image, 5, 5, 0, extent[3], 0, 5))
+      {
+      return false;
+      }
+
+    // One file of the stack, whose strips are read concurrently.
+    std::string fileName = prefix + ".2.tif";
+    vtkNew<vtkTIFFReader> fileReader;
+    fileReader->SetFileName(fileName.c_str());
+    fileReader->SetOrientationType(4); // ORIENTATION_BOTLEFT
+    fileReader->SetNumberOfThreads(numThreads);
+    int sliceExtent[6] = { extent[0], extent[1], extent[2], extent[3], 2, 2 };
+    vtkNew<vtkImageData> slice;
+    slice->SetExtent(sliceExtent);
+    slice->AllocateScalars(image->GetScalarType(),
+                           image->GetNumberOfScalarComponents());
+    slice->CopyAndCastFrom(image, sliceExtent);
+    slice->SetExtent(extent[0], extent[1], extent[2], extent[3], 0, 0);
+    if (!ReadExtent(fileReader.GetPointer(), slice.GetPointer(), extent[0],
+                    extent[1], extent[2], extent[3], 0, 0) ||
+        !ReadExtent(fileReader.GetPointer(), slice.GetPointer(), 60, 159,
+                    50, 119, 0, 0))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int TestTIFFReaderThreaded(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory." << endl;
+    return EXIT_FAILURE;
+    }
+  std::string prefix = tempDir;
+  delete [] tempDir;
+  prefix += "/TestTIFFReaderThreaded";
+
+  vtkNew<vtkImageData> gray;
+  gray->SetExtent(0, 159, 0, 119, 0, 5);
+  gray->AllocateScalars(VTK_UNSIGNED_SHORT, 1);
+  FillImage<unsigned short>(gray.GetPointer(), 1);
+
+  vtkNew<vtkImageData> rgb;
+  rgb->SetExtent(0, 159, 0, 119, 0, 5);
+  rgb->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  FillImage<unsigned char>(rgb.GetPointer(), 3);
+
+  if (!TestStack(gray.GetPointer(), prefix + "Gray") ||
+      !TestStack(rgb.GetPointer(), prefix + "RGB"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // One slice in tiles, with partial tiles at the right and top, then
+  // tiled pages, and pages in strips between reduced resolution subfiles.
+  vtkNew<vtkImageData> graySlice;
+  graySlice->SetExtent(0, 159, 0, 119, 0, 0);
+  graySlice->AllocateScalars(VTK_UNSIGNED_SHORT, 1);
+  FillImage<unsigned short>(graySlice.GetPointer(), 1);
+  if (!TestFile(graySlice.GetPointer(), prefix + "Tiled.tif", 48, false) ||
+      !TestFile(rgb.GetPointer(), prefix + "TiledPages.tif", 32, false) ||
+      !TestFile(gray.GetPointer(), prefix + "Pages.tif", 0, false) ||
+      !TestFile(rgb.GetPointer(), prefix + "Subfiles.tif", 0, true))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
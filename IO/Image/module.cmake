@@ -27,6 +27,7 @@ vtk_module(vtkIOImage
     vtkTestingCore
     vtkTestingRendering
     vtkIOLegacy
+    vtktiff
   KIT
     vtkIO
   )
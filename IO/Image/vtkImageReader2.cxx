@@ -14,11 +14,13 @@
 =========================================================================*/
 #include "vtkImageReader2.h"
 
+#include "vtkAtomicTypes.h"
 #include "vtkByteSwap.h"
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkErrorCode.h"
@@ -27,6 +29,9 @@
 
 #include <sys/stat.h>
 
+#include <string>
+#include <vector>
+
 vtkStandardNewMacro(vtkImageReader2);
 
 #ifdef read
@@ -72,6 +77,8 @@ vtkImageReader2::vtkImageReader2()
   this->FileNameSliceOffset = 0;
   this->FileNameSliceSpacing = 1;
 
+  this->NumberOfThreads = 1;
+
   // Left over from short reader
   this->SwapBytes = 0;
   this->FileLowerLeft = 0;
@@ -404,6 +411,7 @@ void vtkImageReader2::PrintSelf(ostream& os, vtkIndent indent)
      << this->FileNameSliceOffset << "\n";
   os << indent << "FileNameSliceSpacing: "
      << this->FileNameSliceSpacing << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 
   os << indent << "DataScalarType: "
      << vtkImageScalarTypeNameMacro(this->DataScalarType) << "\n";
@@ -556,6 +564,138 @@ void vtkImageReader2::ComputeDataIncrements()
   this->DataIncrements[3] = fileDataLength;
 }
 
+//----------------------------------------------------------------------------
+// Report what ReadSliceFile() left in \a message for a slice.
+static void vtkImageReader2ReportSlice(vtkImageReader2 *self, int succeeded,
+                                       const std::string &message)
+{
+  if (!succeeded)
+    {
+    vtkErrorWithObjectMacro(self, << message);
+    }
+  else if (!message.empty())
+    {
+    vtkWarningWithObjectMacro(self, << message);
+    }
+}
+
+//----------------------------------------------------------------------------
+// The files of a stack of slices shared by the threads reading them.
+class vtkImageReader2SliceFiles
+{
+public:
+  vtkImageReader2 *Reader;
+  vtkImageData *Data;
+  int *Extent;
+  vtkIdType *Increments;
+  char *Scalars;
+  vtkIdType SliceSize;
+  std::vector<std::string> FileNames;
+  std::vector<int> Succeeded;
+  std::vector<std::string> Messages;
+  vtkAtomicInt32 NextSlice;
+  vtkAtomicInt32 SlicesRead;
+
+  // The slices are handed out one at a time, as files of a stack may take
+  // very different times to decode.  Thread 0 is the calling thread, the
+  // only one that reports progress.
+  static VTK_THREAD_RETURN_TYPE Execute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkImageReader2SliceFiles *self =
+      static_cast<vtkImageReader2SliceFiles *>(info->UserData);
+    int numSlices = static_cast<int>(self->FileNames.size());
+    for (int slice = self->NextSlice++; slice < numSlices;
+         slice = self->NextSlice++)
+      {
+      self->Succeeded[slice] = self->Reader->ReadSliceFile(
+        self->FileNames[slice].c_str(), self->Data, self->Extent,
+        self->Increments, self->Scalars + slice * self->SliceSize,
+        self->Messages[slice]);
+      int slicesRead = ++self->SlicesRead;
+      if (info->ThreadID == 0)
+        {
+        self->Reader->UpdateProgress(
+          static_cast<double>(slicesRead) / numSlices);
+        }
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//----------------------------------------------------------------------------
+void vtkImageReader2::ReadSliceFiles(vtkImageData *data)
+{
+  int outExtent[6];
+  vtkIdType outIncr[3];
+  data->GetExtent(outExtent);
+  data->GetIncrements(outIncr);
+
+  char *outPtr = static_cast<char *>(data->GetScalarPointer());
+  vtkIdType sliceSize = outIncr[2] * data->GetScalarSize();
+  int numSlices = outExtent[5] - outExtent[4] + 1;
+
+  if (this->NumberOfThreads <= 1 || numSlices <= 1)
+    {
+    for (int idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+      {
+      this->ComputeInternalFileName(idx2);
+      std::string message;
+      int succeeded = this->ReadSliceFile(this->InternalFileName, data,
+                                          outExtent, outIncr, outPtr,
+                                          message);
+      vtkImageReader2ReportSlice(this, succeeded, message);
+      this->UpdateProgress((idx2 - outExtent[4])/
+                           (outExtent[5] - outExtent[4] + 1.0));
+      outPtr += sliceSize;
+      }
+    return;
+    }
+
+  // The file names are computed up front, as computing them modifies the
+  // reader.
+  vtkImageReader2SliceFiles slices;
+  slices.Reader = this;
+  slices.Data = data;
+  slices.Extent = outExtent;
+  slices.Increments = outIncr;
+  slices.Scalars = outPtr;
+  slices.SliceSize = sliceSize;
+  slices.FileNames.resize(numSlices);
+  slices.Succeeded.resize(numSlices, 1);
+  slices.Messages.resize(numSlices);
+  for (int idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+    {
+    this->ComputeInternalFileName(idx2);
+    if (this->InternalFileName)
+      {
+      slices.FileNames[idx2 - outExtent[4]] = this->InternalFileName;
+      }
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(
+    this->NumberOfThreads < numSlices ? this->NumberOfThreads : numSlices);
+  threader->SetSingleMethod(vtkImageReader2SliceFiles::Execute, &slices);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  for (int slice = 0; slice < numSlices; ++slice)
+    {
+    vtkImageReader2ReportSlice(this, slices.Succeeded[slice],
+                               slices.Messages[slice]);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageReader2::ReadSliceFile(const char *, vtkImageData *, int *,
+                                   vtkIdType *, void *, std::string &message)
+{
+  message = "This reader does not read its slices from files.";
+  return 0;
+}
+
 
 //----------------------------------------------------------------------------
 int vtkImageReader2::OpenFile()
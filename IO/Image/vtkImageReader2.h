@@ -41,6 +41,9 @@
 #include "vtkIOImageModule.h" // For export macro
 #include "vtkImageAlgorithm.h"
 
+#include <string> // For ReadSliceFile()
+
+class vtkImageData;
 class vtkStringArray;
 
 #define VTK_FILE_BYTE_ORDER_BIG_ENDIAN 0
@@ -184,6 +187,15 @@ public:
   vtkSetMacro(FileNameSliceSpacing,int);
   vtkGetMacro(FileNameSliceSpacing,int);
 
+  // Description:
+  // Set/Get the number of threads that decode the files of a stack of
+  // slices (FileNames, or FilePrefix and FilePattern) concurrently, for
+  // the readers that read one file per slice.  Each file is decoded
+  // directly into its slice of the output.  The default of 1 reads the
+  // files one after the other.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 
   // Description:
   // Set/Get the byte swapping to explicitly swap the bytes of a file.
@@ -271,15 +283,38 @@ protected:
   int FileNameSliceOffset;
   int FileNameSliceSpacing;
 
+  int NumberOfThreads;
+
   virtual int RequestInformation(vtkInformation* request,
                                  vtkInformationVector** inputVector,
                                  vtkInformationVector* outputVector);
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *data, vtkInformation *outInfo);
   virtual void ComputeDataIncrements();
+
+  // Description:
+  // Read every slice of the extent of \a data from its own file with
+  // ReadSliceFile(), using up to NumberOfThreads threads.  Progress is
+  // reported from the calling thread only, so it never goes backward.
+  void ReadSliceFiles(vtkImageData *data);
+
+  // Description:
+  // Read the file \a fileName holding one slice into \a outPtr, the
+  // first voxel of that slice in \a data, whose extent and increments
+  // are \a outExt and \a outInc.  Readers that use ReadSliceFiles()
+  // implement it.  It may be called from several threads at once, so it
+  // must neither modify the reader nor report errors: it returns 0 on
+  // failure and leaves what it has to report in \a message, which
+  // ReadSliceFiles() reports from the calling thread.
+  virtual int ReadSliceFile(const char *fileName, vtkImageData *data,
+                            int outExt[6], vtkIdType outInc[3],
+                            void *outPtr, std::string &message);
+
 private:
   vtkImageReader2(const vtkImageReader2&);  // Not implemented.
   void operator=(const vtkImageReader2&);  // Not implemented.
+
+  friend class vtkImageReader2SliceFiles;
 };
 
 #endif
@@ -48,6 +48,7 @@ struct vtk_jpeg_error_mgr
   jmp_buf setjmp_buffer;        /* for return to caller */
   vtkJPEGReader* JPEGReader;
   FILE *fp;
+  std::string *Messages;        /* collects the messages if not NULL */
 };
 
 // this is called on jpeg error conditions
@@ -67,6 +68,14 @@ extern "C" void vtk_jpeg_output_message (j_common_ptr cinfo)
   /* Create the message */
   (*cinfo->err->format_message) (cinfo, buffer);
   vtk_jpeg_error_mgr * err = reinterpret_cast<vtk_jpeg_error_mgr*>(cinfo->err);
+  if (err->Messages)
+    {
+    // Decoding a slice on a worker thread: the caller reports it.
+    err->Messages->append(err->Messages->empty() ? "" : "\n");
+    err->Messages->append("libjpeg error: ");
+    err->Messages->append(buffer);
+    return;
+    }
   vtkWarningWithObjectMacro(err->JPEGReader,
                             "libjpeg error: " <<  buffer);
 }
@@ -125,6 +134,7 @@ void vtkJPEGReader::ExecuteInformation()
   struct vtk_jpeg_error_mgr jerr;
   jerr.JPEGReader = this;
   jerr.fp = NULL;
+  jerr.Messages = NULL;
 
   this->ComputeInternalFileName(this->DataExtent[4]);
   if (this->InternalFileName == NULL && this->MemoryBuffer == NULL)
@@ -225,17 +235,19 @@ void vtkJPEGReader::ExecuteInformation()
 }
 
 template <class OT>
-int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
-                          int *outExt, vtkIdType *outInc, long)
+int vtkJPEGReaderUpdate2(vtkJPEGReader *self, const char *fileName,
+                         OT *outPtr, int *outExt, vtkIdType *outInc,
+                         std::string &message)
 {
   // certain variables must be stored here for longjmp
   struct vtk_jpeg_error_mgr jerr;
   jerr.JPEGReader = self;
   jerr.fp = NULL;
+  jerr.Messages = &message;
 
   if (!self->GetMemoryBuffer())
     {
-    jerr.fp = fopen(self->GetInternalFileName(), "rb");
+    jerr.fp = fopen(fileName, "rb");
     if (!jerr.fp)
       {
       return 1;
@@ -331,36 +343,34 @@ int vtkJPEGReaderUpdate2(vtkJPEGReader *self, OT *outPtr,
 }
 
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkJPEGReaderUpdate(vtkJPEGReader *self, vtkImageData *data, OT *outPtr)
+// This function reads in one slice of data from its own file.
+int vtkJPEGReader::ReadSliceFile(const char *fileName, vtkImageData *data,
+                                 int outExt[6], vtkIdType outInc[3],
+                                 void *outPtr, std::string &message)
 {
-  vtkIdType outIncr[3];
-  int outExtent[6];
-  OT *outPtr2;
-
-  data->GetExtent(outExtent);
-  data->GetIncrements(outIncr);
-
-  long pixSize = data->GetNumberOfScalarComponents()*sizeof(OT);
-
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+  int status = 0;
+  switch (data->GetScalarType())
     {
-    self->ComputeInternalFileName(idx2);
-    // read in a JPEG file
-    if ( vtkJPEGReaderUpdate2(self, outPtr2, outExtent, outIncr, pixSize) == 2 )
-      {
-      const char* fn = self->GetInternalFileName();
-      vtkErrorWithObjectMacro(self, "libjpeg could not read file: " << fn);
-      }
-
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    vtkTemplateMacro(status = vtkJPEGReaderUpdate2(this, fileName,
+                                                   (VTK_TT *)(outPtr),
+                                                   outExt, outInc,
+                                                   message));
+    default:
+      message = "UpdateFromFile: Unknown data type";
+      return 0;
     }
+  if (status == 1)
+    {
+    message = std::string("Unable to open file ") + fileName;
+    return 0;
+    }
+  if (status == 2)
+    {
+    message.append(message.empty() ? "" : "\n");
+    message.append("libjpeg could not read file: ").append(fileName);
+    return 0;
+    }
+  return 1;
 }
 
 
@@ -382,17 +392,8 @@ void vtkJPEGReader::ExecuteDataWithInformation(vtkDataObject *output,
 
   data->GetPointData()->GetScalars()->SetName("JPEGImage");
 
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
-  switch (data->GetScalarType())
-    {
-    vtkTemplateMacro(vtkJPEGReaderUpdate(this, data, (VTK_TT *)(outPtr)));
-    default:
-      vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
-    }
+  // Read the slices, each from its own file
+  this->ReadSliceFiles(data);
 }
 
 
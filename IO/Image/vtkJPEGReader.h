@@ -60,6 +60,9 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSliceFile(const char *fileName, vtkImageData *data,
+                            int outExt[6], vtkIdType outInc[3],
+                            void *outPtr, std::string &message);
 private:
   vtkJPEGReader(const vtkJPEGReader&);  // Not implemented.
   void operator=(const vtkJPEGReader&);  // Not implemented.
@@ -163,37 +163,41 @@ void vtkPNGReader::ExecuteInformation()
 
 //----------------------------------------------------------------------------
 template <class OT>
-void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
-                         int *outExt, vtkIdType *outInc, long pixSize)
+int vtkPNGReaderUpdate2(const char *fileName, OT *outPtr,
+                        int *outExt, vtkIdType *outInc, long pixSize,
+                        std::string &message)
 {
   unsigned int ui;
   int i;
-  FILE *fp = fopen(self->GetInternalFileName(), "rb");
+  FILE *fp = fopen(fileName, "rb");
   if (!fp)
     {
-    return;
+    message = std::string("Unable to open file ") + fileName;
+    return 0;
     }
   unsigned char header[8];
   if (fread(header, 1, 8, fp) != 8)
     {
-    vtkGenericWarningMacro ("PNGReader error reading file: " << self->GetInternalFileName()
-                   << " Premature EOF while reading header.");
+    message = std::string("PNGReader error reading file: ") + fileName +
+      " Premature EOF while reading header.";
     fclose (fp);
-    return;
+    return 0;
     }
   int is_png = !png_sig_cmp(header, 0, 8);
   if (!is_png)
     {
+    message = std::string("Unknown file type! Not a PNG file: ") + fileName;
     fclose(fp);
-    return;
+    return 0;
     }
 
   png_structp png_ptr = png_create_read_struct
     (PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, NULL);
   if (!png_ptr)
     {
+    message = "Out of memory.";
     fclose(fp);
-    return;
+    return 0;
     }
 
   png_infop info_ptr = png_create_info_struct(png_ptr);
@@ -201,8 +205,9 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
     {
     png_destroy_read_struct(&png_ptr,
                             (png_infopp)NULL, (png_infopp)NULL);
+    message = "Out of memory.";
     fclose(fp);
-    return;
+    return 0;
     }
 
   png_infop end_info = png_create_info_struct(png_ptr);
@@ -210,16 +215,18 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
     {
     png_destroy_read_struct(&png_ptr, &info_ptr,
                             (png_infopp)NULL);
+    message = "Out of memory.";
     fclose(fp);
-    return;
+    return 0;
     }
 
   // Set error handling
   if (setjmp (png_jmpbuf(png_ptr)))
   {
     png_destroy_read_struct (&png_ptr, &info_ptr, (png_infopp)NULL);
+    message = std::string("Unable to read PNG file: ") + fileName;
     fclose(fp);
-    return;
+    return 0;
   }
 
   png_init_io(png_ptr, fp);
@@ -295,34 +302,25 @@ void vtkPNGReaderUpdate2(vtkPNGReader *self, OT *outPtr,
   png_read_end(png_ptr, NULL);
   png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
   fclose(fp);
+  return 1;
 }
 
 //----------------------------------------------------------------------------
-// This function reads in one data of data.
-// templated to handle different data types.
-template <class OT>
-void vtkPNGReaderUpdate(vtkPNGReader *self, vtkImageData *data, OT *outPtr)
+// This function reads in one slice of data from its own file.
+int vtkPNGReader::ReadSliceFile(const char *fileName, vtkImageData *data,
+                                int outExt[6], vtkIdType outInc[3],
+                                void *outPtr, std::string &message)
 {
-  vtkIdType outIncr[3];
-  int outExtent[6];
-  OT *outPtr2;
-
-  data->GetExtent(outExtent);
-  data->GetIncrements(outIncr);
-
-  long pixSize = data->GetNumberOfScalarComponents()*sizeof(OT);
-
-  outPtr2 = outPtr;
-  int idx2;
-  for (idx2 = outExtent[4]; idx2 <= outExtent[5]; ++idx2)
+  long pixSize = data->GetNumberOfScalarComponents()*data->GetScalarSize();
+  switch (data->GetScalarType())
     {
-    self->ComputeInternalFileName(idx2);
-    // read in a PNG file
-    vtkPNGReaderUpdate2(self, outPtr2, outExtent, outIncr, pixSize);
-    self->UpdateProgress((idx2 - outExtent[4])/
-                         (outExtent[5] - outExtent[4] + 1.0));
-    outPtr2 += outIncr[2];
+    vtkTemplateMacro(return vtkPNGReaderUpdate2(fileName, (VTK_TT *)(outPtr),
+                                                outExt, outInc, pixSize,
+                                                message));
+    default:
+      message = "UpdateFromFile: Unknown data type";
     }
+  return 0;
 }
 
 
@@ -344,17 +342,8 @@ void vtkPNGReader::ExecuteDataWithInformation(vtkDataObject *output,
 
   this->ComputeDataIncrements();
 
-  // Call the correct templated function for the output
-  void *outPtr;
-
-  // Call the correct templated function for the input
-  outPtr = data->GetScalarPointer();
-  switch (data->GetScalarType())
-    {
-    vtkTemplateMacro(vtkPNGReaderUpdate(this, data, (VTK_TT *)(outPtr)));
-    default:
-      vtkErrorMacro(<< "UpdateFromFile: Unknown data type");
-    }
+  // Read the slices, each from its own file
+  this->ReadSliceFiles(data);
 }
 
 
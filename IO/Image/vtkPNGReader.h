@@ -59,6 +59,9 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSliceFile(const char *fileName, vtkImageData *data,
+                            int outExt[6], vtkIdType outInc[3],
+                            void *outPtr, std::string &message);
 private:
   vtkPNGReader(const vtkPNGReader&);  // Not implemented.
   void operator=(const vtkPNGReader&);  // Not implemented.
@@ -14,8 +14,10 @@
 =========================================================================*/
 #include "vtkTIFFReader.h"
 
+#include "vtkAtomicTypes.h"
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
+#include "vtkMultiThreader.h"
 #include "vtkPointData.h"
 #include "vtkErrorCode.h"
 #include "vtkObjectFactory.h"
@@ -25,6 +27,7 @@
 #include <sys/stat.h>
 #include <string>
 #include <algorithm>
+#include <vector>
 
 extern "C" {
 #include "vtk_tiff.h"
@@ -137,6 +140,284 @@ bool ReadTemplatedImage(T* out, Flip flip,
     }
   return true;
 }
+
+// Whether the file starts with the header of a BigTIFF file, which only
+// libtiff 4 and later can open.
+bool IsBigTIFF(const char* fileName)
+{
+  unsigned char header[4];
+  FILE* file = fopen(fileName, "rb");
+  if (!file)
+    {
+    return false;
+    }
+  size_t size = fread(header, 1, 4, file);
+  fclose(file);
+  return size == 4 &&
+    ((header[0] == 'I' && header[1] == 'I' && header[2] == 43 && header[3] == 0) ||
+     (header[0] == 'M' && header[1] == 'M' && header[2] == 0 && header[3] == 43));
+}
+
+// How the pixels of the current directory of a TIFF file are split into
+// strips or tiles, which libtiff decodes independently of each other.
+struct ChunkLayout
+{
+  uint32 Width;
+  uint32 Height;
+  uint16 SamplesPerPixel;
+  uint16 BitsPerSample;
+  uint16 Photometric;
+  bool Tiled;
+  // A strip spans the width of the image
+  uint32 ChunkWidth;
+  uint32 ChunkHeight;
+  uint32 ChunksAcross;
+  tsize_t ChunkSize;
+  int PixelSize;
+};
+
+bool GetChunkLayout(TIFF* image, ChunkLayout& layout)
+{
+  uint16 planarConfig;
+  if (!TIFFGetField(image, TIFFTAG_IMAGEWIDTH, &layout.Width) ||
+      !TIFFGetField(image, TIFFTAG_IMAGELENGTH, &layout.Height) ||
+      !TIFFGetField(image, TIFFTAG_PHOTOMETRIC, &layout.Photometric) ||
+      layout.Width == 0 || layout.Height == 0)
+    {
+    return false;
+    }
+  TIFFGetFieldDefaulted(image, TIFFTAG_SAMPLESPERPIXEL,
+                        &layout.SamplesPerPixel);
+  TIFFGetFieldDefaulted(image, TIFFTAG_BITSPERSAMPLE, &layout.BitsPerSample);
+  TIFFGetFieldDefaulted(image, TIFFTAG_PLANARCONFIG, &planarConfig);
+  if (planarConfig != PLANARCONFIG_CONTIG && layout.SamplesPerPixel > 1)
+    {
+    return false;
+    }
+  layout.PixelSize = layout.SamplesPerPixel * layout.BitsPerSample / 8;
+
+  layout.Tiled = TIFFIsTiled(image) != 0;
+  if (layout.Tiled)
+    {
+    uint32 tileDepth = 1;
+    if (!TIFFGetField(image, TIFFTAG_TILEWIDTH, &layout.ChunkWidth) ||
+        !TIFFGetField(image, TIFFTAG_TILELENGTH, &layout.ChunkHeight) ||
+        (TIFFGetField(image, TIFFTAG_TILEDEPTH, &tileDepth) && tileDepth > 1))
+      {
+      return false;
+      }
+    layout.ChunkSize = TIFFTileSize(image);
+    }
+  else
+    {
+    uint32 rowsPerStrip;
+    TIFFGetFieldDefaulted(image, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+    layout.ChunkWidth = layout.Width;
+    layout.ChunkHeight = std::min(rowsPerStrip, layout.Height);
+    layout.ChunkSize = TIFFStripSize(image);
+    }
+  if (layout.ChunkWidth == 0 || layout.ChunkHeight == 0)
+    {
+    return false;
+    }
+  layout.ChunksAcross = (layout.Width - 1) / layout.ChunkWidth + 1;
+  return true;
+}
+
+// Whether two directories have pixels of the same size and meaning.
+bool SamePixels(const ChunkLayout& a, const ChunkLayout& b)
+{
+  return a.Width == b.Width && a.Height == b.Height &&
+    a.SamplesPerPixel == b.SamplesPerPixel &&
+    a.BitsPerSample == b.BitsPerSample && a.Photometric == b.Photometric;
+}
+
+// Whether two directories are split into the same strips or tiles.
+bool SameChunks(const ChunkLayout& a, const ChunkLayout& b)
+{
+  return a.Tiled == b.Tiled && a.ChunkWidth == b.ChunkWidth &&
+    a.ChunkHeight == b.ChunkHeight;
+}
+
+// List the strips or tiles holding the pixels of the x-y extent of \a ext.
+// Rows of the output are flipped from the rows of the file unless the
+// image is stored top to bottom.
+void GetChunks(const ChunkLayout& layout, const int ext[6], bool flip,
+               std::vector<uint32>& chunks)
+{
+  uint32 firstRow = flip ? layout.Height - 1 - ext[3] : ext[2];
+  uint32 lastRow = flip ? layout.Height - 1 - ext[2] : ext[3];
+  chunks.clear();
+  for (uint32 cy = firstRow / layout.ChunkHeight;
+       cy <= lastRow / layout.ChunkHeight; ++cy)
+    {
+    for (uint32 cx = ext[0] / layout.ChunkWidth;
+         cx <= ext[1] / layout.ChunkWidth; ++cx)
+      {
+      chunks.push_back(cy * layout.ChunksAcross + cx);
+      }
+    }
+}
+
+// Decode the strip or tile \a chunk of the current directory of \a image
+// into \a out, the first byte of the x-y extent \a ext of a slice of the
+// output whose rows are \a rowIncrement bytes apart.  Strips made of whole
+// rows of the output are decoded in place, the others are decoded into
+// \a buffer and only their pixels inside the extent are copied.
+bool ReadChunk(TIFF* image, const ChunkLayout& layout, uint32 chunk,
+               bool flip, const int ext[6], vtkIdType rowIncrement,
+               unsigned char* out, std::vector<unsigned char>& buffer)
+{
+  uint32 x0 = (chunk % layout.ChunksAcross) * layout.ChunkWidth;
+  uint32 y0 = (chunk / layout.ChunksAcross) * layout.ChunkHeight;
+  uint32 rows = std::min(layout.ChunkHeight, layout.Height - y0);
+  vtkIdType chunkRowSize =
+    static_cast<vtkIdType>(layout.ChunkWidth) * layout.PixelSize;
+
+  if (!layout.Tiled && !flip && rowIncrement == chunkRowSize &&
+      static_cast<int>(y0) >= ext[2] &&
+      static_cast<int>(y0 + rows - 1) <= ext[3])
+    {
+    return TIFFReadEncodedStrip(image, chunk, out + (y0 - ext[2]) * rowIncrement,
+                                rows * chunkRowSize) >= 0;
+    }
+
+  if (buffer.size() < static_cast<size_t>(layout.ChunkSize))
+    {
+    buffer.resize(layout.ChunkSize);
+    }
+  tsize_t size = layout.Tiled ?
+    TIFFReadEncodedTile(image, chunk, &buffer[0], layout.ChunkSize) :
+    TIFFReadEncodedStrip(image, chunk, &buffer[0], layout.ChunkSize);
+  if (size < 0)
+    {
+    return false;
+    }
+
+  int firstCol = std::max(static_cast<int>(x0), ext[0]);
+  int lastCol = std::min(
+    static_cast<int>(std::min(x0 + layout.ChunkWidth, layout.Width)) - 1,
+    ext[1]);
+  size_t copySize = (lastCol - firstCol + 1) * layout.PixelSize;
+  for (uint32 r = 0; r < rows; ++r)
+    {
+    int row = flip ? layout.Height - 1 - (y0 + r) : y0 + r;
+    if (row >= ext[2] && row <= ext[3])
+      {
+      memcpy(out + (row - ext[2]) * rowIncrement +
+               (firstCol - ext[0]) * layout.PixelSize,
+             &buffer[r * chunkRowSize + (firstCol - x0) * layout.PixelSize],
+             copySize);
+      }
+    }
+  return true;
+}
+
+// Decode the x-y extent \a ext of the current directory of \a image.
+bool ReadChunks(TIFF* image, const ChunkLayout& layout, bool flip,
+                const int ext[6], vtkIdType rowIncrement, unsigned char* out,
+                std::vector<unsigned char>& buffer)
+{
+  std::vector<uint32> chunks;
+  GetChunks(layout, ext, flip, chunks);
+  for (size_t i = 0; i < chunks.size(); ++i)
+    {
+    if (!ReadChunk(image, layout, chunks[i], flip, ext, rowIncrement, out,
+                   buffer))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// The strips or tiles of the pages of one file decoded concurrently, each
+// thread opening the file for itself.  The pages are split the same way as
+// the first one in most files, so the work is handed out one strip or tile
+// at a time.  A page split differently is decoded whole by the thread that
+// gets its first strip or tile.
+class ChunkReader
+{
+public:
+  vtkAlgorithm* Reader;
+  const char* FileName;
+  ChunkLayout Layout;
+  std::vector<tdir_t> Directories;
+  std::vector<uint32> Chunks;
+  bool Flip;
+  int* Extent;
+  vtkIdType RowIncrement;
+  vtkIdType SliceIncrement;
+  unsigned char* Scalars;
+  vtkAtomicInt32 NextItem;
+  vtkAtomicInt32 ItemsRead;
+  vtkAtomicInt32 Failed;
+
+  static VTK_THREAD_RETURN_TYPE Execute(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    ChunkReader* self = static_cast<ChunkReader*>(info->UserData);
+    int numChunks = static_cast<int>(self->Chunks.size());
+    int numItems = numChunks * static_cast<int>(self->Directories.size());
+
+    TIFF* image = NULL;
+    ChunkLayout layout;
+    bool sameChunks = true;
+    int slice = -1;
+    std::vector<unsigned char> buffer;
+    for (int item = self->NextItem++; item < numItems && !self->Failed;
+         item = self->NextItem++)
+      {
+      if (!image && !(image = TIFFOpen(self->FileName, "r")))
+        {
+        self->Failed = 1;
+        break;
+        }
+      if (item / numChunks != slice)
+        {
+        slice = item / numChunks;
+        if (!TIFFSetDirectory(image, self->Directories[slice]) ||
+            !GetChunkLayout(image, layout) || !SamePixels(layout, self->Layout))
+          {
+          self->Failed = 1;
+          break;
+          }
+        sameChunks = SameChunks(layout, self->Layout);
+        }
+
+      unsigned char* out = self->Scalars + slice * self->SliceIncrement;
+      int rank = item % numChunks;
+      bool read = true;
+      if (sameChunks)
+        {
+        read = ReadChunk(image, layout, self->Chunks[rank], self->Flip,
+                         self->Extent, self->RowIncrement, out, buffer);
+        }
+      else if (rank == 0)
+        {
+        read = ReadChunks(image, layout, self->Flip, self->Extent,
+                          self->RowIncrement, out, buffer);
+        }
+      if (!read)
+        {
+        self->Failed = 1;
+        break;
+        }
+
+      int itemsRead = ++self->ItemsRead;
+      if (info->ThreadID == 0)
+        {
+        self->Reader->UpdateProgress(static_cast<double>(itemsRead) / numItems);
+        }
+      }
+    if (image)
+      {
+      TIFFClose(image);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
 }
 
 //-------------------------------------------------------------------------
@@ -149,6 +430,7 @@ public:
   bool Initialize();
   void Clean();
   bool CanRead();
+  bool CanReadChunks();
   bool Open(const char *filename);
   TIFF *Image;
   bool IsOpen;
@@ -168,7 +450,7 @@ public:
   unsigned int TileColumns;
   unsigned int TileWidth;
   unsigned int TileHeight;
-  unsigned short NumberOfTiles;
+  unsigned int NumberOfTiles;
   unsigned int SubFiles;
   unsigned int ResolutionUnit;
   float XResolution;
@@ -400,6 +682,17 @@ bool vtkTIFFReader::vtkTIFFReaderInternal::CanRead()
              this->BitsPerSample == 32) );
 }
 
+//-------------------------------------------------------------------------
+// Whether the samples of the image are stored as they are laid out in the
+// output, so that strips or tiles can be decoded straight into it.
+bool vtkTIFFReader::vtkTIFFReaderInternal::CanReadChunks()
+{
+  return this->CanRead() &&
+    ((this->Photometrics == PHOTOMETRIC_MINISBLACK &&
+      this->SamplesPerPixel == 1) ||
+     (this->Photometrics == PHOTOMETRIC_RGB && this->SamplesPerPixel == 3));
+}
+
 //-------------------------------------------------------------------------
 vtkTIFFReader::vtkTIFFReader()
 {
@@ -444,10 +737,22 @@ void vtkTIFFReader::ExecuteInformation()
 
   if (!this->InternalImage->Open(this->InternalFileName))
     {
-    vtkErrorMacro("Unable to open file "
-                  << this->InternalFileName
-                  << " Reason: "
-                  << vtksys::SystemTools::GetLastSystemError());
+#ifndef TIFF_VERSION_BIG
+    if (IsBigTIFF(this->InternalFileName))
+      {
+      vtkErrorMacro("Unable to open file "
+                    << this->InternalFileName
+                    << " Reason: BigTIFF files can only be read when VTK is"
+                    << " built against libtiff 4 (VTK_USE_SYSTEM_TIFF)");
+      }
+    else
+#endif
+      {
+      vtkErrorMacro("Unable to open file "
+                    << this->InternalFileName
+                    << " Reason: "
+                    << vtksys::SystemTools::GetLastSystemError());
+      }
     this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
     this->DataExtent[0] = 0;
     this->DataExtent[1] = 0;
@@ -716,6 +1021,24 @@ void vtkTIFFReader::ExecuteDataWithInformation(vtkDataObject *output,
     return;
     }
 
+  // The file is closed once read: open it again when another extent of
+  // the image is requested.
+  if (!this->InternalImage->IsOpen)
+    {
+    this->Initialize();
+    this->ComputeInternalFileName(this->DataExtent[4]);
+    if (!this->InternalImage->Open(this->InternalFileName))
+      {
+      vtkErrorMacro("Unable to open file " << this->InternalFileName);
+      this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+      return;
+      }
+    if (this->OrientationTypeSpecifiedFlag)
+      {
+      this->InternalImage->Orientation = this->OrientationType;
+      }
+    }
+
   this->ComputeDataIncrements();
 
   // Get the data
@@ -723,6 +1046,27 @@ void vtkTIFFReader::ExecuteDataWithInformation(vtkDataObject *output,
   data->GetExtent(this->OutputExtent);
   data->GetIncrements(this->OutputIncrements);
 
+  if (this->InternalImage->CanReadChunks())
+    {
+    // Pages of a multi-page file, or the slice of the open file, are
+    // decoded one strip or tile at a time; a stack of files one file at
+    // a time.
+    if (this->InternalImage->NumberOfPages > 1 ||
+        (this->OutputExtent[4] == this->DataExtent[4] &&
+         this->OutputExtent[5] == this->DataExtent[4]))
+      {
+      this->ReadChunks(data);
+      this->InternalImage->Clean();
+      }
+    else
+      {
+      this->InternalImage->Clean();
+      this->ReadSliceFiles(data);
+      }
+    data->GetPointData()->GetScalars()->SetName("Tiff Scalars");
+    return;
+    }
+
   // Call the correct templated function for the input
   void *outPtr = data->GetScalarPointer();
 
@@ -736,6 +1080,119 @@ void vtkTIFFReader::ExecuteDataWithInformation(vtkDataObject *output,
   data->GetPointData()->GetScalars()->SetName("Tiff Scalars");
 }
 
+//----------------------------------------------------------------------------
+void vtkTIFFReader::ReadChunks(vtkImageData *data)
+{
+  TIFF *image = this->InternalImage->Image;
+  int numSlices = this->OutputExtent[5] - this->OutputExtent[4] + 1;
+
+  ChunkReader reader;
+  reader.Reader = this;
+  reader.FileName = this->InternalFileName;
+  reader.Flip = this->InternalImage->Orientation != ORIENTATION_TOPLEFT;
+  reader.Extent = this->OutputExtent;
+  reader.RowIncrement = this->OutputIncrements[1] * data->GetScalarSize();
+  reader.SliceIncrement = this->OutputIncrements[2] * data->GetScalarSize();
+  reader.Scalars = static_cast<unsigned char *>(data->GetScalarPointer());
+
+  // Find the directory of each page of the extent.  The reduced resolution
+  // images of files with subfiles are not pages.
+  if (this->InternalImage->NumberOfPages > 1)
+    {
+    TIFFSetDirectory(image, 0);
+    int page = 0;
+    tdir_t dir = 0;
+    do
+      {
+      uint32 subfileType = 0;
+      if (this->InternalImage->SubFiles == 0 ||
+          !TIFFGetField(image, TIFFTAG_SUBFILETYPE, &subfileType) ||
+          subfileType == 0)
+        {
+        if (page >= this->OutputExtent[4])
+          {
+          reader.Directories.push_back(dir);
+          }
+        ++page;
+        }
+      ++dir;
+      }
+    while (page <= this->OutputExtent[5] && TIFFReadDirectory(image));
+    }
+  else
+    {
+    reader.Directories.push_back(TIFFCurrentDirectory(image));
+    }
+
+  if (static_cast<int>(reader.Directories.size()) != numSlices ||
+      !TIFFSetDirectory(image, reader.Directories[0]) ||
+      !GetChunkLayout(image, reader.Layout) ||
+      static_cast<int>(reader.Layout.Width) <= this->OutputExtent[1] ||
+      static_cast<int>(reader.Layout.Height) <= this->OutputExtent[3] ||
+      reader.Layout.PixelSize !=
+        data->GetNumberOfScalarComponents() * data->GetScalarSize())
+    {
+    vtkErrorMacro("The pages of " << this->InternalFileName
+                  << " do not match the requested extent.");
+    return;
+    }
+  GetChunks(reader.Layout, this->OutputExtent, reader.Flip, reader.Chunks);
+
+  int numItems = static_cast<int>(reader.Chunks.size()) * numSlices;
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(std::min(this->NumberOfThreads, numItems));
+  threader->SetSingleMethod(ChunkReader::Execute, &reader);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  if (reader.Failed)
+    {
+    vtkErrorMacro("Problem reading the strips or tiles of TIFF file "
+                  << this->InternalFileName);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkTIFFReader::ReadSliceFile(const char *fileName, vtkImageData *data,
+                                 int outExt[6], vtkIdType *outInc,
+                                 void *outPtr, std::string &message)
+{
+  vtkTIFFReaderInternal image;
+  if (!image.Open(fileName))
+    {
+    message = std::string("Unable to open file ") + fileName;
+    return 0;
+    }
+
+  ChunkLayout layout;
+  if (!image.CanReadChunks() || !GetChunkLayout(image.Image, layout) ||
+      static_cast<int>(layout.Width) <= outExt[1] ||
+      static_cast<int>(layout.Height) <= outExt[3] ||
+      layout.PixelSize !=
+        data->GetNumberOfScalarComponents() * data->GetScalarSize())
+    {
+    message = std::string("The slice file ") + fileName +
+      " is not stored like the first one of the stack.";
+    image.Clean();
+    return 0;
+    }
+
+  unsigned int orientation = this->OrientationTypeSpecifiedFlag ?
+    this->OrientationType : image.Orientation;
+  std::vector<unsigned char> buffer;
+  if (!::ReadChunks(image.Image, layout, orientation != ORIENTATION_TOPLEFT,
+                    outExt, outInc[1] * data->GetScalarSize(),
+                    static_cast<unsigned char *>(outPtr), buffer))
+    {
+    message = std::string("Problem reading the strips or tiles of TIFF file ")
+      + fileName;
+    image.Clean();
+    return 0;
+    }
+  image.Clean();
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 unsigned int vtkTIFFReader::GetFormat()
 {
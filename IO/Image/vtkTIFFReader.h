@@ -91,6 +91,9 @@ protected:
 
   virtual void ExecuteInformation();
   virtual void ExecuteDataWithInformation(vtkDataObject *out, vtkInformation *outInfo);
+  virtual int ReadSliceFile(const char *fileName, vtkImageData *data,
+                            int outExt[6], vtkIdType outInc[3],
+                            void *outPtr, std::string &message);
 
 private:
   vtkTIFFReader(const vtkTIFFReader&);  // Not implemented.
@@ -131,6 +134,11 @@ private:
   // Reads 3D data from tiled tiff
   void ReadTiles(void* buffer);
 
+  // Description:
+  // Reads the output extent from the strips or tiles of the open file that
+  // hold it, using NumberOfThreads threads.
+  void ReadChunks(vtkImageData *data);
+
   // Description:
   // Reads a generic image.
   template<typename T>
@@ -20,6 +20,9 @@
 #include "LSDynaFamily.h"
 //#include "vtksys/SystemTools.hxx"
 
+#include "vtkSMPTools.h"
+#include "vtkType.h"
+
 #include <errno.h>
 #include <ctype.h>
 #include <cassert>
@@ -64,6 +67,54 @@ int LS_DYNA_STAT(const char* fname, struct stat& s)
 }
 #endif
 
+// Reverses the bytes of each word of a chunk. Whole words are swapped with
+// shifts so the compiler can use byte swap and vector shuffle instructions,
+// and large chunks of state data are split across the SMP threads.
+class LSDynaSwapWords
+{
+public:
+  // Number of words below which swapping is not worth splitting further.
+  enum { Grain = 65536 };
+
+  LSDynaSwapWords( unsigned char* chunk, int wordSize ) :
+    Chunk( chunk ), WordSize( wordSize )
+    {
+    }
+
+  static vtkTypeUInt32 Swap4( vtkTypeUInt32 v )
+    {
+    return ( v >> 24 ) | ( ( v >> 8 ) & 0x0000ff00u ) |
+      ( ( v << 8 ) & 0x00ff0000u ) | ( v << 24 );
+    }
+
+  void operator()( vtkIdType begin, vtkIdType end )
+    {
+    if ( this->WordSize == 4 )
+      {
+      vtkTypeUInt32* words = reinterpret_cast<vtkTypeUInt32*>( this->Chunk );
+      for ( vtkIdType i = begin; i < end; ++i )
+        {
+        words[i] = Swap4( words[i] );
+        }
+      }
+    else
+      {
+      // Swap the two halves of each 8-byte word and the bytes of each half.
+      vtkTypeUInt32* words = reinterpret_cast<vtkTypeUInt32*>( this->Chunk );
+      for ( vtkIdType i = 2 * begin; i < 2 * end; i += 2 )
+        {
+        vtkTypeUInt32 low = words[i];
+        words[i] = Swap4( words[i + 1] );
+        words[i + 1] = Swap4( low );
+        }
+      }
+    }
+
+protected:
+  unsigned char* Chunk;
+  int WordSize;
+};
+
 vtkLSDynaFile_t VTK_LSDYNA_OPENFILE(const char* fname)
 {
 #ifndef WIN32
@@ -459,46 +510,10 @@ int LSDynaFamily::BufferChunk( WordType wType, vtkIdType chunkSizeInWords )
 
   if ( this->SwapEndian && wType != LSDynaFamily::Char )
     {
-    unsigned char tmp[4];
-    vtkIdType i;
-    unsigned char* cur = this->Chunk;
-
     // Currently, wType is unused, but if I ever have to support cray
     // floating point types, this will need to be different
-    switch (this->WordSize)
-      {
-    case 4:
-      for (i=0; i<chunkSizeInWords; ++i)
-        {
-        tmp[0] = cur[0];
-        tmp[1] = cur[1];
-        cur[0] = cur[3];
-        cur[1] = cur[2];
-        cur[2] = tmp[1];
-        cur[3] = tmp[0];
-        cur += this->WordSize;
-        }
-      break;
-    case 8:
-    default:
-      for (i=0; i<chunkSizeInWords; ++i)
-        {
-        tmp[0] = cur[0];
-        tmp[1] = cur[1];
-        tmp[2] = cur[2];
-        tmp[3] = cur[3];
-        cur[0] = cur[7];
-        cur[1] = cur[6];
-        cur[2] = cur[5];
-        cur[3] = cur[4];
-        cur[4] = tmp[3];
-        cur[5] = tmp[2];
-        cur[6] = tmp[1];
-        cur[7] = tmp[0];
-        cur += this->WordSize;
-        }
-      break;
-      }
+    LSDynaSwapWords swapper( this->Chunk, this->WordSize );
+    vtkSMPTools::For( 0, chunkSizeInWords, LSDynaSwapWords::Grain, swapper );
     }
 
   return 0;
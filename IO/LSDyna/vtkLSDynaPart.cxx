@@ -65,17 +65,27 @@ protected:
         {
         Data =new unsigned char[numTuples * nc * sizeof(T)];
         loc = Data;
-        len = numComps * sizeof(T);
         }
       ~CellProperty()
         {
         delete[] Data;
         }
       template<typename T>
-      void insertNextTuple(T* values)
+      void insertNextTuples(T* values, const vtkIdType& numTuples,
+                            const vtkIdType& stride)
         {
-        memcpy(loc,values+startPos,len);
-        loc = ((T*)loc) + numComps;
+        //copy this property of a run of cells in one pass, instead of
+        //visiting every property of each cell in turn
+        T* src = values + startPos;
+        T* dest = static_cast<T*>(loc);
+        for(vtkIdType i=0;i<numTuples;++i,src+=stride,dest+=numComps)
+          {
+          for(vtkIdType j=0;j<numComps;++j)
+            {
+            dest[j] = src[j];
+            }
+          }
+        loc = dest;
         }
       void resetForNextTimeStep()
         {
@@ -86,7 +96,6 @@ protected:
 
   protected:
     int startPos;
-    size_t len;
     vtkIdType numComps;
     void *loc;
   };
@@ -123,12 +132,13 @@ public:
   }
 
   template<typename T>
-  void AddCellInfo(T* cellproperty)
+  void AddCellInfo(T* cellproperty, const vtkIdType& numCells,
+                   const vtkIdType& numPropertiesInCell)
   {
     std::vector<CellProperty*>::iterator it;
     for(it=Properties.begin();it!=Properties.end();++it)
       {
-      (*it)->insertNextTuple(cellproperty);
+      (*it)->insertNextTuples(cellproperty,numCells,numPropertiesInCell);
       }
   }
 
@@ -858,25 +868,17 @@ void vtkLSDynaPart::ReadCellProperties(float *cellProperties,
                                        const vtkIdType& numCells,
                                        const vtkIdType& numPropertiesInCell)
 {
-  float *cell = cellProperties;
-  for(vtkIdType i=0;i<numCells;++i)
-    {
-    this->CellProperties->AddCellInfo(cell);
-    cell += numPropertiesInCell;
-    }
-
+  this->CellProperties->AddCellInfo(cellProperties,numCells,
+                                    numPropertiesInCell);
 }
+
 //-----------------------------------------------------------------------------
 void vtkLSDynaPart::ReadCellProperties(double *cellProperties,
                                        const vtkIdType& numCells,
                                        const vtkIdType& numPropertiesInCell)
 {
-  double *cell = cellProperties;
-  for(vtkIdType i=0;i<numCells;++i)
-    {
-    this->CellProperties->AddCellInfo(cell);
-    cell += numPropertiesInCell;
-    }
+  this->CellProperties->AddCellInfo(cellProperties,numCells,
+                                    numPropertiesInCell);
 }
 
 //-----------------------------------------------------------------------------
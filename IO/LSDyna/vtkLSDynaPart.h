@@ -102,7 +102,8 @@ public:
 
   //Description:
   //Given a chunk of point property memory copy it to the correct
-  //property on the part
+  //property on the part. Only the state of this part is changed, so
+  //different parts can read the same chunk concurrently.
   void ReadPointBasedProperty(float *data,
                               const vtkIdType& numTuples,
                               const vtkIdType& numComps,
@@ -119,7 +120,8 @@ public:
 
   //Description:
   //Given the raw data converts it to be the properties for this part
-  //The cell properties are woven together as a block for each cell
+  //The cell properties are woven together as a block for each cell.
+  //Like ReadPointBasedProperty, different parts can be read concurrently.
   void ReadCellProperties(float *cellProperties, const vtkIdType& numCells,
                           const vtkIdType &numPropertiesInCell);
   void ReadCellProperties(double *cellsProperties, const vtkIdType& numCells,
@@ -26,6 +26,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStringArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -33,6 +34,7 @@
 #include <algorithm>
 #include <vector>
 #include <list>
+#include <map>
 
 //-----------------------------------------------------------------------------
 class vtkLSDynaPartCollection::LSDynaPartStorage
@@ -633,6 +635,40 @@ void vtkLSDynaPartCollection::AddProperty(
     }
 }
 
+namespace
+{
+  //the runs of cells of a chunk of cell properties grouped by part, in
+  //file order. Each part is filled from its own runs only.
+  template<typename T>
+  class vtkLSDynaCellRuns
+  {
+  public:
+    typedef std::vector<std::pair<T*,vtkIdType> > RunList;
+
+    vtkLSDynaCellRuns(const int& numPropertiesInCell):
+      NumPropertiesInCell(numPropertiesInCell)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for(vtkIdType i=begin;i<end;++i)
+        {
+        typename RunList::const_iterator it;
+        for(it=this->Runs[i].begin();it!=this->Runs[i].end();++it)
+          {
+          this->Parts[i]->ReadCellProperties(it->first,it->second,
+                                             this->NumPropertiesInCell);
+          }
+        }
+    }
+
+    std::vector<vtkLSDynaPart*> Parts;
+    std::vector<RunList> Runs;
+    vtkIdType NumPropertiesInCell;
+  };
+}
+
 //-----------------------------------------------------------------------------
 void vtkLSDynaPartCollection::FillCellProperties(float *buffer,
   const LSDynaMetaData::LSDYNA_TYPES& type, const vtkIdType& startId,
@@ -655,10 +691,15 @@ void vtkLSDynaPartCollection::FillCellArray(T *buffer,
   const LSDynaMetaData::LSDYNA_TYPES& type, const vtkIdType& startId,
   vtkIdType numCells, const int& numPropertiesInCell)
 {
-  //we only need to iterate the array for the subsection we need
+  //we only need to iterate the array for the subsection we need.
+  //Collect the runs of cells of each part in this chunk first, each
+  //part then copies its own runs while the others are filled concurrently
   T* loc = buffer;
   vtkIdType size, globalStartId;
   vtkLSDynaPart *part;
+  vtkLSDynaCellRuns<T> runs(numPropertiesInCell);
+  std::map<vtkLSDynaPart*,size_t> partIndex;
+  std::map<vtkLSDynaPart*,size_t>::iterator pIt;
   this->Storage->InitCellIteration(type,startId);
   while(this->Storage->GetNextCellPart(globalStartId,size,part))
     {
@@ -669,12 +710,20 @@ void vtkLSDynaPartCollection::FillCellArray(T *buffer,
       break;
       }
     vtkIdType is = end - start;
-    if(part)
+    if(part && is > 0)
       {
-      part->ReadCellProperties(loc,is,numPropertiesInCell);
+      pIt = partIndex.find(part);
+      if(pIt == partIndex.end())
+        {
+        pIt = partIndex.insert(std::make_pair(part,runs.Parts.size())).first;
+        runs.Parts.push_back(part);
+        runs.Runs.resize(runs.Parts.size());
+        }
+      runs.Runs[pIt->second].push_back(std::make_pair(loc,is));
       }
     loc += is * numPropertiesInCell;
     }
+  vtkSMPTools::For(0,static_cast<vtkIdType>(runs.Parts.size()),1,runs);
 }
 
 //-----------------------------------------------------------------------------
@@ -904,6 +953,38 @@ void vtkLSDynaPartCollection::SetupPointPropertyForReading(
 
 namespace
 {
+  //copies one chunk of a point property to each of the given parts
+  template<typename T>
+  class vtkLSDynaPointChunk
+  {
+  public:
+    vtkLSDynaPointChunk(const std::list<vtkLSDynaPart*>& parts, T* buffer,
+                        const vtkIdType& numTuples, const vtkIdType& numComps,
+                        const vtkIdType& offset):
+      Parts(parts.begin(),parts.end()),
+      Buffer(buffer),
+      NumTuples(numTuples),
+      NumComps(numComps),
+      Offset(offset)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for(vtkIdType i=begin;i<end;++i)
+        {
+        this->Parts[i]->ReadPointBasedProperty(this->Buffer,this->NumTuples,
+                                               this->NumComps,this->Offset);
+        }
+    }
+
+    std::vector<vtkLSDynaPart*> Parts;
+    T* Buffer;
+    vtkIdType NumTuples;
+    vtkIdType NumComps;
+    vtkIdType Offset;
+  };
+
   //this function is used to sort a collection of parts
   //based on the max and min global point ids that the part
   //we use both to enforce better weak ordering
@@ -969,22 +1050,18 @@ void vtkLSDynaPartCollection::FillPointProperty(const vtkIdType& numTuples,
       partIt = sortedParts.begin();
       }
 
-    while(partIt!=sortedParts.end())
-      {
-      //only read the points which have a point that lies within this section
-      //so we stop once the min is larger than our max id
-      (*partIt)->ReadPointBasedProperty(buf,numPointsToRead,numComps,offset);
-      ++partIt;
-      }
+    //every part keeps its own read position, so the parts which have a
+    //point that lies within this section are filled concurrently
+    vtkLSDynaPointChunk<T> chunk(sortedParts,buf,numPointsToRead,numComps,
+                                 offset);
+    vtkSMPTools::For(0,static_cast<vtkIdType>(chunk.Parts.size()),1,chunk);
     }
   if(leftOver>0 && !sortedParts.empty())
     {
     p->Fam.BufferChunk(LSDynaFamily::Float, leftOver*numComps);
     buf = p->Fam.GetBufferAs<T>();
-    for (partIt = sortedParts.begin(); partIt!=sortedParts.end();++partIt)
-      {
-      (*partIt)->ReadPointBasedProperty(buf,leftOver,numComps,offset);
-      }
+    vtkLSDynaPointChunk<T> chunk(sortedParts,buf,leftOver,numComps,offset);
+    vtkSMPTools::For(0,static_cast<vtkIdType>(chunk.Parts.size()),1,chunk);
     }
   p->Fam.SkipWords(numPointsToSkipEnd * numComps);
 }
@@ -48,11 +48,13 @@ POSSIBILITY OF SUCH DAMAGES.
 
 #include "vtkMINCImageReader.h"
 
+#include "vtkInformation.h"
 #include "vtkObjectFactory.h"
 
 #include "vtkImageData.h"
 #include "vtkStringArray.h"
 #include "vtkCharArray.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkShortArray.h"
 #include "vtkIntArray.h"
@@ -84,6 +86,10 @@ vtkStandardNewMacro(vtkMINCImageReader);
 //-------------------------------------------------------------------------
 vtkMINCImageReader::vtkMINCImageReader()
 {
+  // The netCDF library used to read MINC files is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->NumberOfTimeSteps = 1;
   this->TimeStep = 0;
   this->DirectionCosines = vtkMatrix4x4::New();
@@ -81,6 +81,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkToolkits.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -263,6 +264,10 @@ vtkStandardNewMacro(vtkMPASReader);
 
 vtkMPASReader::vtkMPASReader()
 {
+  // The netCDF library is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->Internals = new vtkMPASReader::Internal;
 
   this->CellMask = 0;
@@ -27,6 +27,7 @@
 #include "vtkPolygon.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <map>
@@ -53,6 +54,10 @@ vtkStandardNewMacro(vtkNetCDFCAMReader);
 //----------------------------------------------------------------------------
 vtkNetCDFCAMReader::vtkNetCDFCAMReader()
 {
+  // The netCDF library is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->FileName = NULL;
   this->CurrentFileName = NULL;
   this->ConnectivityFileName = NULL;
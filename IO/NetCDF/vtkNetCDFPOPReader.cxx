@@ -24,6 +24,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRectilinearGrid.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 
 #include "vtk_netcdf.h"
 #include <string>
@@ -61,6 +62,10 @@ public:
 //set default values
 vtkNetCDFPOPReader::vtkNetCDFPOPReader()
 {
+  // The netCDF library is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->SetNumberOfInputPorts(0);
   this->SetNumberOfOutputPorts(1);
   this->FileName = NULL;
@@ -34,9 +34,11 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkStructuredGrid.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 
 #include "vtkSmartPointer.h"
 #define VTK_CREATE(type, name) \
@@ -95,12 +97,83 @@ static int NetCDFTypeToVTKType(nc_type type)
     }
 }
 
+//=============================================================================
+namespace
+{
+// Replaces the fill values of a variable with NaN.
+template<class T>
+class vtkNetCDFFillValueToNan
+{
+public:
+  T *Values;
+  T FillValue;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    const T nan = static_cast<T>(vtkMath::Nan());
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      if (this->Values[i] == this->FillValue)
+        {
+        this->Values[i] = nan;
+        }
+      }
+    }
+};
+
+// Applies the scale_factor and add_offset attributes of a variable.  Input
+// and Output may be the same array.
+template<class T>
+class vtkNetCDFScaleValues
+{
+public:
+  const T *Input;
+  double *Output;
+  double Scale;
+  double Offset;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      this->Output[i] = static_cast<double>(this->Input[i])*this->Scale
+        + this->Offset;
+      }
+    }
+};
+
+template<class T>
+void vtkNetCDFReplaceFillValue(T *values, vtkIdType numValues, T fillValue)
+{
+  vtkNetCDFFillValueToNan<T> replace;
+  replace.Values = values;
+  replace.FillValue = fillValue;
+  vtkSMPTools::For(0, numValues, replace);
+}
+
+template<class T>
+void vtkNetCDFScale(const T *input, double *output, vtkIdType numValues,
+                    double scale, double offset)
+{
+  vtkNetCDFScaleValues<T> rescale;
+  rescale.Input = input;
+  rescale.Output = output;
+  rescale.Scale = scale;
+  rescale.Offset = offset;
+  vtkSMPTools::For(0, numValues, rescale);
+}
+}
+
 //=============================================================================
 vtkStandardNewMacro(vtkNetCDFReader);
 
 //-----------------------------------------------------------------------------
 vtkNetCDFReader::vtkNetCDFReader()
 {
+  // The netCDF library is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->SetNumberOfInputPorts(0);
 
   this->FileName = NULL;
@@ -807,45 +880,84 @@ int vtkNetCDFReader::LoadVariable(int ncFD, const char *varName, double time,
     arraySize *= count[i+timeIndexOffset];
     }
 
-  // Allocate an array of the right type.
+  // Check to see if there is a scale or offset.
+  size_t attribLength;
+  double scale = 1.0;
+  double offset = 0.0;
+  if (   (nc_inq_attlen(ncFD, varId, "scale_factor", &attribLength) == NC_NOERR)
+      && (attribLength == 1) )
+    {
+    CALL_NETCDF(nc_get_att_double(ncFD, varId, "scale_factor", &scale));
+    }
+  if (   (nc_inq_attlen(ncFD, varId, "add_offset", &attribLength) == NC_NOERR)
+      && (attribLength == 1) )
+    {
+    CALL_NETCDF(nc_get_att_double(ncFD, varId, "add_offset", &offset));
+    }
+  bool rescale = (scale != 1.0) || (offset != 0.0);
+
+  // Allocate an array of the right type.  Scaled values are stored as
+  // doubles, and netCDF converts short, int and float values to doubles
+  // while reading them, so that they need not be copied afterward.
   nc_type ncType;
   CALL_NETCDF(nc_inq_vartype(ncFD, varId, &ncType));
   int vtkType = NetCDFTypeToVTKType(ncType);
   if (vtkType < 1) return 0;
+  bool readAsDouble = rescale && (   (ncType == NC_SHORT)
+                                  || (ncType == NC_INT)
+                                  || (ncType == NC_FLOAT)
+                                  || (ncType == NC_DOUBLE) );
   vtkSmartPointer<vtkDataArray> dataArray;
-  dataArray.TakeReference(vtkDataArray::CreateDataArray(vtkType));
+  dataArray.TakeReference(vtkDataArray::CreateDataArray(
+                                       readAsDouble ? VTK_DOUBLE : vtkType));
   dataArray->SetNumberOfComponents(1);
   dataArray->SetNumberOfTuples(arraySize);
 
-  // Read the array from the file.
-  CALL_NETCDF(nc_get_vars(ncFD, varId, start, count, NULL,
-                          dataArray->GetVoidPointer(0)));
+  // Read the array from the file.  The hyperslab is read with a single
+  // call so that netCDF reads (and decompresses) each chunk of the variable
+  // only once.
+  if (readAsDouble)
+    {
+    CALL_NETCDF(nc_get_vara_double(ncFD, varId, start, count,
+                      static_cast<double*>(dataArray->GetVoidPointer(0))));
+    }
+  else
+    {
+    CALL_NETCDF(nc_get_vara(ncFD, varId, start, count,
+                            dataArray->GetVoidPointer(0)));
+    }
 
   // Check for a fill value.
-  size_t attribLength;
   if (   (nc_inq_attlen(ncFD, varId, "_FillValue", &attribLength) == NC_NOERR)
       && (attribLength == 1) )
     {
     if (this->ReplaceFillValueWithNan)
       {
       // NaN only available with float and double.
-      if (dataArray->GetDataType() == VTK_FLOAT)
+      if (ncType == NC_FLOAT)
         {
         float fillValue;
         nc_get_att_float(ncFD, varId, "_FillValue", &fillValue);
-        std::replace(reinterpret_cast<float*>(dataArray->GetVoidPointer(0)),
-                        reinterpret_cast<float*>(dataArray->GetVoidPointer(
-                                               dataArray->GetNumberOfTuples())),
-                        fillValue, static_cast<float>(vtkMath::Nan()));
+        if (readAsDouble)
+          {
+          vtkNetCDFReplaceFillValue(
+            static_cast<double*>(dataArray->GetVoidPointer(0)), arraySize,
+            static_cast<double>(fillValue));
+          }
+        else
+          {
+          vtkNetCDFReplaceFillValue(
+            static_cast<float*>(dataArray->GetVoidPointer(0)), arraySize,
+            fillValue);
+          }
         }
-      else if (dataArray->GetDataType() == VTK_DOUBLE)
+      else if (ncType == NC_DOUBLE)
         {
         double fillValue;
         nc_get_att_double(ncFD, varId, "_FillValue", &fillValue);
-        std::replace(reinterpret_cast<double*>(dataArray->GetVoidPointer(0)),
-                        reinterpret_cast<double*>(dataArray->GetVoidPointer(
-                                               dataArray->GetNumberOfTuples())),
-                        fillValue, vtkMath::Nan());
+        vtkNetCDFReplaceFillValue(
+          static_cast<double*>(dataArray->GetVoidPointer(0)), arraySize,
+          fillValue);
         }
       else
         {
@@ -855,28 +967,22 @@ int vtkNetCDFReader::LoadVariable(int ncFD, const char *varName, double time,
       }
     }
 
-  // Check to see if there is a scale or offset.
-  double scale = 1.0;
-  double offset = 0.0;
-  if (   (nc_inq_attlen(ncFD, varId, "scale_factor", &attribLength) == NC_NOERR)
-      && (attribLength == 1) )
-    {
-    CALL_NETCDF(nc_get_att_double(ncFD, varId, "scale_factor", &scale));
-    }
-  if (   (nc_inq_attlen(ncFD, varId, "add_offset", &attribLength) == NC_NOERR)
-      && (attribLength == 1) )
+  if (readAsDouble)
     {
-    CALL_NETCDF(nc_get_att_double(ncFD, varId, "add_offset", &offset));
+    double *values = static_cast<double*>(dataArray->GetVoidPointer(0));
+    vtkNetCDFScale(values, values, arraySize, scale, offset);
     }
-
-  if ((scale != 1.0) || (offset != 0.0))
+  else if (rescale)
     {
     VTK_CREATE(vtkDoubleArray, adjustedArray);
     adjustedArray->SetNumberOfComponents(1);
     adjustedArray->SetNumberOfTuples(arraySize);
-    for (vtkIdType i = 0; i < arraySize; i++)
+    switch (dataArray->GetDataType())
       {
-      adjustedArray->SetValue(i, dataArray->GetTuple1(i)*scale + offset);
+      vtkTemplateMacro(
+        vtkNetCDFScale(static_cast<VTK_TT*>(dataArray->GetVoidPointer(0)),
+                       adjustedArray->GetPointer(0), arraySize,
+                       scale, offset));
       }
     dataArray = adjustedArray;
     }
@@ -36,6 +36,7 @@
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -161,6 +162,10 @@ vtkStandardNewMacro(vtkSLACParticleReader);
 //-----------------------------------------------------------------------------
 vtkSLACParticleReader::vtkSLACParticleReader()
 {
+  // The netCDF library is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->SetNumberOfInputPorts(0);
 
   this->FileName = NULL;
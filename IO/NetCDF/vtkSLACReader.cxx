@@ -40,6 +40,7 @@
 #include "vtkPoints.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -513,6 +514,10 @@ public:
 //-----------------------------------------------------------------------------
 vtkSLACReader::vtkSLACReader()
 {
+  // The netCDF library is not thread-safe.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::REQUIRES_SERIAL_EXECUTION(), 1);
+
   this->Internal = new vtkSLACReader::vtkInternal;
 
   this->SetNumberOfInputPorts(0);
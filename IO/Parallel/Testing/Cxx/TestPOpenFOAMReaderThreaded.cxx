@@ -0,0 +1,400 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPOpenFOAMReaderThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the subdomains of a decomposed OpenFOAM case read with
+// ThreadedRead on and off give the same output, and that the ASCII lists
+// are parsed to the values written, both by the list parser and by the
+// tokenizer it falls back to when a list holds a comment.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPOpenFOAMReader.h"
+#include "vtkPointData.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Each subdomain is a block of N x N x N hexahedra: the lists of points and
+// faces then span several chunks of the list parser.
+static const int N = 16;
+static const int NUMBER_OF_PROCESSORS = 2;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+void WriteHeader(std::ofstream& file, const char* foamClass,
+                 const char* object)
+{
+  file << "FoamFile\n{\n    version     2.0;\n    format      ascii;\n"
+       << "    class       " << foamClass << ";\n"
+       << "    object      " << object << ";\n}\n\n";
+}
+
+//-----------------------------------------------------------------------------
+int PointId(int i, int j, int k)
+{
+  return i + (N + 1) * (j + (N + 1) * k);
+}
+
+//-----------------------------------------------------------------------------
+int CellId(int i, int j, int k)
+{
+  return i + N * (j + N * k);
+}
+
+//-----------------------------------------------------------------------------
+void AddFace(std::vector<std::vector<int> >& faces, int p0, int p1, int p2,
+             int p3)
+{
+  std::vector<int> face(4);
+  face[0] = p0;
+  face[1] = p1;
+  face[2] = p2;
+  face[3] = p3;
+  faces.push_back(face);
+}
+
+//-----------------------------------------------------------------------------
+// The value of a cell of processor \a proc, in the order of the cells of
+// the output. Quarters are exact in single precision.
+double CellValue(int proc, int cell)
+{
+  return 0.25 * (proc * N * N * N + cell);
+}
+
+//-----------------------------------------------------------------------------
+bool WriteSubdomain(const std::string& dir, int proc, bool comment)
+{
+  std::string meshDir = dir + "/constant/polyMesh";
+  if (!vtksys::SystemTools::MakeDirectory(meshDir.c_str()) ||
+      !vtksys::SystemTools::MakeDirectory((dir + "/0").c_str()))
+    {
+    return false;
+    }
+
+  std::ofstream points((meshDir + "/points").c_str());
+  WriteHeader(points, "vectorField", "points");
+  points << (N + 1) * (N + 1) * (N + 1) << "\n(\n";
+  for (int k = 0; k <= N; ++k)
+    {
+    for (int j = 0; j <= N; ++j)
+      {
+      for (int i = 0; i <= N; ++i)
+        {
+        points << "(" << proc * N + i << " " << 0.5 * j << " " << 0.25 * k
+               << ")\n";
+        }
+      }
+    }
+  points << ")\n";
+
+  // The internal faces, ordered by owner and then neighbour, followed by
+  // the faces of the patches at x = 0, at x = N and of the walls.
+  std::vector<std::vector<int> > faces;
+  std::vector<int> owner;
+  std::vector<int> neighbour;
+  for (int k = 0; k < N; ++k)
+    {
+    for (int j = 0; j < N; ++j)
+      {
+      for (int i = 0; i < N; ++i)
+        {
+        if (i + 1 < N)
+          {
+          AddFace(faces, PointId(i + 1, j, k), PointId(i + 1, j + 1, k),
+                  PointId(i + 1, j + 1, k + 1), PointId(i + 1, j, k + 1));
+          owner.push_back(CellId(i, j, k));
+          neighbour.push_back(CellId(i + 1, j, k));
+          }
+        if (j + 1 < N)
+          {
+          AddFace(faces, PointId(i, j + 1, k), PointId(i, j + 1, k + 1),
+                  PointId(i + 1, j + 1, k + 1), PointId(i + 1, j + 1, k));
+          owner.push_back(CellId(i, j, k));
+          neighbour.push_back(CellId(i, j + 1, k));
+          }
+        if (k + 1 < N)
+          {
+          AddFace(faces, PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+                  PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1));
+          owner.push_back(CellId(i, j, k));
+          neighbour.push_back(CellId(i, j, k + 1));
+          }
+        }
+      }
+    }
+  const int numInternalFaces = static_cast<int>(faces.size());
+  for (int side = 0; side < 2; ++side)
+    {
+    int i = side * N;
+    for (int k = 0; k < N; ++k)
+      {
+      for (int j = 0; j < N; ++j)
+        {
+        if (side == 0)
+          {
+          AddFace(faces, PointId(i, j, k), PointId(i, j, k + 1),
+                  PointId(i, j + 1, k + 1), PointId(i, j + 1, k));
+          }
+        else
+          {
+          AddFace(faces, PointId(i, j, k), PointId(i, j + 1, k),
+                  PointId(i, j + 1, k + 1), PointId(i, j, k + 1));
+          }
+        owner.push_back(CellId(side * (N - 1), j, k));
+        }
+      }
+    }
+  for (int k = 0; k < N; ++k)
+    {
+    for (int i = 0; i < N; ++i)
+      {
+      AddFace(faces, PointId(i, 0, k), PointId(i + 1, 0, k),
+              PointId(i + 1, 0, k + 1), PointId(i, 0, k + 1));
+      owner.push_back(CellId(i, 0, k));
+      AddFace(faces, PointId(i, N, k), PointId(i, N, k + 1),
+              PointId(i + 1, N, k + 1), PointId(i + 1, N, k));
+      owner.push_back(CellId(i, N - 1, k));
+      }
+    }
+  for (int j = 0; j < N; ++j)
+    {
+    for (int i = 0; i < N; ++i)
+      {
+      AddFace(faces, PointId(i, j, 0), PointId(i, j + 1, 0),
+              PointId(i + 1, j + 1, 0), PointId(i + 1, j, 0));
+      owner.push_back(CellId(i, j, 0));
+      AddFace(faces, PointId(i, j, N), PointId(i + 1, j, N),
+              PointId(i + 1, j + 1, N), PointId(i, j + 1, N));
+      owner.push_back(CellId(i, j, N - 1));
+      }
+    }
+
+  std::ofstream facesFile((meshDir + "/faces").c_str());
+  WriteHeader(facesFile, "faceList", "faces");
+  facesFile << faces.size() << "\n(\n";
+  for (size_t f = 0; f < faces.size(); ++f)
+    {
+    facesFile << "4(" << faces[f][0] << " " << faces[f][1] << " "
+              << faces[f][2] << " " << faces[f][3] << ")\n";
+    }
+  facesFile << ")\n";
+
+  std::ofstream ownerFile((meshDir + "/owner").c_str());
+  WriteHeader(ownerFile, "labelList", "owner");
+  ownerFile << owner.size() << "\n(\n";
+  for (size_t f = 0; f < owner.size(); ++f)
+    {
+    ownerFile << owner[f] << "\n";
+    }
+  ownerFile << ")\n";
+
+  std::ofstream neighbourFile((meshDir + "/neighbour").c_str());
+  WriteHeader(neighbourFile, "labelList", "neighbour");
+  neighbourFile << neighbour.size() << "\n(\n";
+  for (size_t f = 0; f < neighbour.size(); ++f)
+    {
+    neighbourFile << neighbour[f] << "\n";
+    }
+  neighbourFile << ")\n";
+
+  const char* patchNames[3] = { "low", "high", "walls" };
+  const int patchSizes[3] = { N * N, N * N, 4 * N * N };
+  std::ofstream boundary((meshDir + "/boundary").c_str());
+  WriteHeader(boundary, "polyBoundaryMesh", "boundary");
+  boundary << "3\n(\n";
+  int startFace = numInternalFaces;
+  for (int patch = 0; patch < 3; ++patch)
+    {
+    boundary << patchNames[patch] << "\n{\n    type patch;\n    nFaces "
+             << patchSizes[patch] << ";\n    startFace " << startFace
+             << ";\n}\n";
+    startFace += patchSizes[patch];
+    }
+  boundary << ")\n";
+
+  // The scalars alternate between fixed and exponent notation.
+  const int numCells = N * N * N;
+  std::ofstream p((dir + "/0/p").c_str());
+  WriteHeader(p, "volScalarField", "p");
+  p << "dimensions [0 2 -2 0 0 0 0];\n\n"
+    << "internalField nonuniform List<scalar>\n" << numCells << "\n(\n";
+  if (comment)
+    {
+    p << "// the tokenizer reads the values of a list with a comment\n";
+    }
+  char value[64];
+  for (int cell = 0; cell < numCells; ++cell)
+    {
+    sprintf(value, (cell % 2) ? "%.10e\n" : "%g\n", CellValue(proc, cell));
+    p << value;
+    }
+  p << ")\n;\n\nboundaryField\n{\n";
+  for (int patch = 0; patch < 3; ++patch)
+    {
+    p << "    " << patchNames[patch] << " { type zeroGradient; }\n";
+    }
+  p << "}\n";
+
+  std::ofstream u((dir + "/0/U").c_str());
+  WriteHeader(u, "volVectorField", "U");
+  u << "dimensions [0 1 -1 0 0 0 0];\n\n"
+    << "internalField nonuniform List<vector>\n" << numCells << "\n(\n";
+  for (int cell = 0; cell < numCells; ++cell)
+    {
+    u << "(" << CellValue(proc, cell) << " " << -CellValue(proc, cell)
+      << " 1e-2)\n";
+    }
+  u << ")\n;\n\nboundaryField\n{\n";
+  for (int patch = 0; patch < 3; ++patch)
+    {
+    u << "    " << patchNames[patch] << " { type zeroGradient; }\n";
+    }
+  u << "}\n";
+
+  return points && facesFile && ownerFile && neighbourFile && boundary &&
+    p && u;
+}
+
+//-----------------------------------------------------------------------------
+bool WriteCase(const std::string& caseDir)
+{
+  vtksys::SystemTools::RemoveADirectory(caseDir.c_str());
+  if (!vtksys::SystemTools::MakeDirectory((caseDir + "/system").c_str()))
+    {
+    return false;
+    }
+  std::ofstream controlDict((caseDir + "/system/controlDict").c_str());
+  WriteHeader(controlDict, "dictionary", "controlDict");
+  controlDict << "startTime 0;\nendTime 1;\ndeltaT 1;\n"
+              << "writeControl timeStep;\nwriteInterval 1;\n";
+  std::ofstream foam((caseDir + "/case.foam").c_str());
+  if (!controlDict || !foam)
+    {
+    return false;
+    }
+  char name[32];
+  for (int proc = 0; proc < NUMBER_OF_PROCESSORS; ++proc)
+    {
+    sprintf(name, "/processor%d", proc);
+    // Only the lists of the last subdomain hold a comment.
+    if (!WriteSubdomain(caseDir + name, proc,
+                        proc == NUMBER_OF_PROCESSORS - 1))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkUnstructuredGrid* ReadCase(vtkPOpenFOAMReader* reader,
+                              const std::string& fileName, bool threaded)
+{
+  reader->SetFileName(fileName.c_str());
+  reader->SetCaseType(vtkPOpenFOAMReader::DECOMPOSED_CASE);
+  reader->SetThreadedRead(threaded ? 1 : 0);
+  reader->Update();
+  return vtkUnstructuredGrid::SafeDownCast(reader->GetOutput()->GetBlock(0));
+}
+
+//-----------------------------------------------------------------------------
+bool SameArray(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+      {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+//-----------------------------------------------------------------------------
+int TestPOpenFOAMReaderThreaded(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string caseDir = std::string(tempDir) + "/TestPOpenFOAMReaderThreaded";
+  delete [] tempDir;
+  if (!WriteCase(caseDir))
+    {
+    cerr << "Could not write the case to " << caseDir << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkPOpenFOAMReader> serialReader;
+  vtkNew<vtkPOpenFOAMReader> threadedReader;
+  vtkUnstructuredGrid* serial =
+    ReadCase(serialReader.GetPointer(), caseDir + "/case.foam", false);
+  vtkUnstructuredGrid* threaded =
+    ReadCase(threadedReader.GetPointer(), caseDir + "/case.foam", true);
+  const vtkIdType numCells = NUMBER_OF_PROCESSORS * N * N * N;
+  if (!serial || !threaded || serial->GetNumberOfCells() != numCells)
+    {
+    cerr << "Expected " << numCells << " cells" << endl;
+    return EXIT_FAILURE;
+    }
+
+  if (threaded->GetNumberOfCells() != numCells ||
+      !SameArray(serial->GetPoints()->GetData(),
+                 threaded->GetPoints()->GetData()) ||
+      !SameArray(serial->GetCellData()->GetArray("p"),
+                 threaded->GetCellData()->GetArray("p")) ||
+      !SameArray(serial->GetCellData()->GetArray("U"),
+                 threaded->GetCellData()->GetArray("U")) ||
+      !SameArray(serial->GetPointData()->GetArray("p"),
+                 threaded->GetPointData()->GetArray("p")))
+    {
+    cerr << "The threaded read differs from the serial read" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkDataArray* p = serial->GetCellData()->GetArray("p");
+  vtkDataArray* u = serial->GetCellData()->GetArray("U");
+  for (vtkIdType cell = 0; cell < numCells; ++cell)
+    {
+    double expected = CellValue(0, static_cast<int>(cell));
+    if (p->GetComponent(cell, 0) != expected ||
+        u->GetComponent(cell, 0) != expected ||
+        u->GetComponent(cell, 1) != -expected ||
+        u->GetComponent(cell, 2) != static_cast<float>(1e-2))
+      {
+      cerr << "Wrong values for cell " << cell << ": p = "
+           << p->GetComponent(cell, 0) << ", expected " << expected << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -30,14 +30,33 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkPOpenFOAMReader);
 vtkCxxSetObjectMacro(vtkPOpenFOAMReader, Controller, vtkMultiProcessController);
 
+//-----------------------------------------------------------------------------
+// updates the readers of the subdomains of a decomposed case
+class vtkPOpenFOAMReaderUpdateReaders
+{
+public:
+  std::vector<vtkOpenFOAMReader *> Readers;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType readerI = begin; readerI < end; readerI++)
+      {
+      this->Readers[readerI]->Update();
+      }
+  }
+};
+
 //-----------------------------------------------------------------------------
 vtkPOpenFOAMReader::vtkPOpenFOAMReader()
 {
@@ -55,6 +74,7 @@ vtkPOpenFOAMReader::vtkPOpenFOAMReader()
     }
   this->CaseType = RECONSTRUCTED_CASE;
   this->MTimeOld = 0;
+  this->ThreadedRead = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -72,6 +92,7 @@ void vtkPOpenFOAMReader::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "Number of Processes: " << this->NumProcesses << endl;
   os << indent << "Process Id: " << this->ProcessId << endl;
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "Threaded Read: " << this->ThreadedRead << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -331,6 +352,7 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
     // append->AppendFieldDataOn();
 
     vtkOpenFOAMReader *reader;
+    vtkPOpenFOAMReaderUpdateReaders updateReaders;
     this->Superclass::CurrentReaderIndex = 0;
     this->Superclass::Readers->InitTraversal();
     while ((reader
@@ -348,6 +370,7 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
       if (reader->MakeMetaDataAtTimeStep(false))
         {
         append->AddInputConnection(reader->GetOutputPort());
+        updateReaders.Readers.push_back(reader);
         }
       }
 
@@ -360,6 +383,17 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
       }
     else
       {
+      // the metadata of the readers are complete, so that they only read
+      // their own subdomains and the selections of this reader
+      if (this->ThreadedRead)
+        {
+        this->Superclass::UpdatingReadersConcurrently = true;
+        vtkSMPTools::For(0,
+            static_cast<vtkIdType>(updateReaders.Readers.size()), 1,
+            updateReaders);
+        this->Superclass::UpdatingReadersConcurrently = false;
+        }
+
       // reader->RequestInformation() and RequestData() are called
       // for all reader instances without setting UPDATE_TIME_STEPS
       append->Update();
@@ -53,6 +53,13 @@ public:
   virtual void SetController(vtkMultiProcessController *);
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
 
+  // Description:
+  // Set and get whether the subdomains of a decomposed case are read
+  // concurrently with vtkSMPTools. Off by default.
+  vtkSetMacro(ThreadedRead, int);
+  vtkGetMacro(ThreadedRead, int);
+  vtkBooleanMacro(ThreadedRead, int);
+
 protected:
   vtkPOpenFOAMReader();
   ~vtkPOpenFOAMReader();
@@ -68,6 +75,7 @@ private:
   unsigned long MTimeOld;
   int NumProcesses;
   int ProcessId;
+  int ThreadedRead;
 
   vtkPOpenFOAMReader(const vtkPOpenFOAMReader &); // Not implemented.
   void operator=(const vtkPOpenFOAMReader &); // Not implemented.
@@ -25,6 +25,7 @@
 #include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkToolkits.h"
 
@@ -36,6 +37,41 @@
 
 vtkStandardNewMacro(vtkVPICReader);
 
+//----------------------------------------------------------------------------
+// Copy planes of one component of the ghost enhanced block into the
+// interleaved ParaView array
+//----------------------------------------------------------------------------
+class vtkVPICReaderLoadComponent
+{
+public:
+  float* VarData;
+  const float* Block;
+  int Comp;
+  int NumberOfComponents;
+  const int* SubDimension;
+  const int* GhostDimension;
+  const int* Start;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType k = begin; k < end; k++) {
+      vtkIdType kk = k + this->Start[2];
+      for (int j = 0; j < this->SubDimension[1]; j++) {
+        vtkIdType jj = j + this->Start[1];
+        const float* block = this->Block +
+          (kk * this->GhostDimension[1] + jj) * this->GhostDimension[0] +
+          this->Start[0];
+        float* varData = this->VarData + this->NumberOfComponents *
+          ((k * this->SubDimension[1] + j) * this->SubDimension[0]) +
+          this->Comp;
+        for (int i = 0; i < this->SubDimension[0]; i++) {
+          varData[i * this->NumberOfComponents] = block[i];
+        }
+      }
+    }
+  }
+};
+
 //----------------------------------------------------------------------------
 // Constructor for VPIC Reader
 //----------------------------------------------------------------------------
@@ -529,24 +565,16 @@ void vtkVPICReader::LoadVariableData(int var, int timeStep)
 void vtkVPICReader::LoadComponent(float* varData, float* block,
                                   int comp, int numberOfComponents)
 {
-
   // Load into the data array by tuple so place data every comp'th spot
-  int pos = comp;
-  for (int k = 0; k < this->SubDimension[2]; k++) {
-    int kk = k + this->Start[2];
-    for (int j = 0; j < this->SubDimension[1]; j++) {
-      int jj = j + this->Start[1];
-      for (int i = 0; i < this->SubDimension[0]; i++) {
-        int ii = i + this->Start[0];
-
-        int index = (kk * this->GhostDimension[0] * this->GhostDimension[1]) +
-                    (jj * this->GhostDimension[0]) + ii;
-
-        varData[pos] = block[index];
-        pos += numberOfComponents;
-      }
-    }
-  }
+  vtkVPICReaderLoadComponent loadComponent;
+  loadComponent.VarData = varData;
+  loadComponent.Block = block;
+  loadComponent.Comp = comp;
+  loadComponent.NumberOfComponents = numberOfComponents;
+  loadComponent.SubDimension = this->SubDimension;
+  loadComponent.GhostDimension = this->GhostDimension;
+  loadComponent.Start = this->Start;
+  vtkSMPTools::For(0, this->SubDimension[2], loadComponent);
 }
 
 //----------------------------------------------------------------------------
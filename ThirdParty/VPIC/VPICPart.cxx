@@ -1,5 +1,14 @@
 #include "VPICPart.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Create structure to hold field data for one time step, one processor
@@ -11,15 +20,26 @@ VPICPart::VPICPart(int part)
    this->simID = part;
    this->vizID = 0;
    this->fileName = 0;
+   this->numberOfFiles = 0;
+   this->fileData = 0;
+   this->fileSize = 0;
 }
 
-void VPICPart::setFiles(string* name, int numberOfFiles)
+void VPICPart::setFiles(string* name, int count)
 {
+   // Files of the previous time step are no longer accessed
+   this->unmapFiles();
+
    if (this->fileName != 0)
       delete [] this->fileName;
-   this->fileName = new string[numberOfFiles];
-   for (int i = 0; i < numberOfFiles; i++) {
+   this->numberOfFiles = count;
+   this->fileName = new string[count];
+   this->fileData = new char*[count];
+   this->fileSize = new long int[count];
+   for (int i = 0; i < count; i++) {
       this->fileName[i] = name[i];
+      this->fileData[i] = 0;
+      this->fileSize[i] = 0;
    }
 }
 
@@ -54,10 +74,77 @@ void VPICPart::initialize()
 
 VPICPart::~VPICPart()
 {
+   this->unmapFiles();
    if (this->fileName != 0)
       delete [] this->fileName;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// Memory map a data file so that only the pages holding requested data
+// are read, directly from the file system cache.  The mapping is kept
+// until the files of the part change.  Return 0 if mapping is not possible.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+const char* VPICPart::mapFile(int fileKind, long int& size)
+{
+   if (this->fileData[fileKind] == 0) {
+      const char* name = this->fileName[fileKind].c_str();
+#ifdef _WIN32
+      HANDLE file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+         return 0;
+      LARGE_INTEGER fileSize;
+      HANDLE mapping = NULL;
+      if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+         mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      CloseHandle(file);
+      if (mapping == NULL)
+         return 0;
+      void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      CloseHandle(mapping);
+      if (data == NULL)
+         return 0;
+      this->fileSize[fileKind] = (long int) fileSize.QuadPart;
+#else
+      int fd = open(name, O_RDONLY);
+      if (fd < 0)
+         return 0;
+      struct stat fileStat;
+      void* data = MAP_FAILED;
+      if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+         data = mmap(0, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if (data == MAP_FAILED)
+         return 0;
+      this->fileSize[fileKind] = (long int) fileStat.st_size;
+#endif
+      this->fileData[fileKind] = static_cast<char*>(data);
+   }
+   size = this->fileSize[fileKind];
+   return this->fileData[fileKind];
+}
+
+void VPICPart::unmapFiles()
+{
+   for (int i = 0; i < this->numberOfFiles; i++) {
+      if (this->fileData[i] != 0) {
+#ifdef _WIN32
+         UnmapViewOfFile(this->fileData[i]);
+#else
+         munmap(this->fileData[i], this->fileSize[i]);
+#endif
+      }
+   }
+   delete [] this->fileData;
+   delete [] this->fileSize;
+   this->fileData = 0;
+   this->fileSize = 0;
+   this->numberOfFiles = 0;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // Using the offset of this part within a processor calculate the grid
@@ -74,8 +161,8 @@ void VPICPart::calculatePartLocation(int* stridedPartSize)
 //////////////////////////////////////////////////////////////////////////////
 //
 // Load the data for this part into the correct position in an overall grid
-// which has been preallocated.  All data is read from the file but only the
-// requested stride is copied to the visualizer's array as a float
+// which has been preallocated.  Only the requested stride is gathered from
+// the memory mapped file and copied to the visualizer's array as a float
 // Each file contains ghost information for one cell on each side for each
 // dimension.  Skip those ghost cells and only fill in internal data.
 // Many files will contribute to the data for one processor so use the
@@ -93,36 +180,48 @@ void VPICPart::loadVariableData(
         long int offset,        // Load data from this offset
         int stride[])           // Stride over data requested
 {
-   string name = this->fileName[fileKind];
-
    // Part stores data plus ghost cells, get all information about them
    int localghostSize[DIMENSION];
    this->header.getGhostSize(localghostSize);
+   long int blockBytes = (long int) this->numberOfGhostGrids * byteCount;
+
+   // Access the variable data in place in the memory mapped file
+   // If it can not be mapped read the contiguous variable data instead
+   char* buffer = 0;
+   long int size = 0;
+   const char* block = this->mapFile(fileKind, size);
+   if (block != 0 && offset + blockBytes <= size) {
+      block += offset;
+   } else {
+      FILE* filePtr = fopen(this->fileName[fileKind].c_str(), "rb");
+      if (filePtr == 0) {
+         cerr << "Failed to open file " << this->fileName[fileKind] << endl;
+         return;
+      }
+      fseek(filePtr, offset, SEEK_SET);
+      buffer = new char[blockBytes];
+      fread(buffer, 1, blockBytes, filePtr);
+      fclose(filePtr);
+      block = buffer;
+   }
 
    if (basicType == FLOAT && byteCount == 4) {
-      float* block = NULL;
-      LoadData(vizID, simID, varData, varOffset, block, subdimension,
-               localghostSize, this->numberOfGhostGrids,
-               this->gridOffset, name, offset, stride);
+      LoadData<float>(varData, varOffset, block, subdimension,
+                      localghostSize, this->gridOffset, stride);
 
    } else if (basicType == FLOAT && byteCount == 8) {
-      double* block = NULL;
-      LoadData(vizID, simID, varData, varOffset, block, subdimension,
-               localghostSize, this->numberOfGhostGrids,
-               this->gridOffset, name, offset, stride);
+      LoadData<double>(varData, varOffset, block, subdimension,
+                       localghostSize, this->gridOffset, stride);
 
    } else if (basicType == INTEGER && byteCount == 4) {
-      int* block = NULL;
-      LoadData(vizID, simID, varData, varOffset, block, subdimension,
-               localghostSize, this->numberOfGhostGrids,
-               this->gridOffset, name, offset, stride);
+      LoadData<int>(varData, varOffset, block, subdimension,
+                    localghostSize, this->gridOffset, stride);
 
    } else if (basicType == INTEGER && byteCount == 2) {
-      short* block = NULL;
-      LoadData(vizID, simID, varData, varOffset, block, subdimension,
-               localghostSize, this->numberOfGhostGrids,
-               this->gridOffset, name, offset, stride);
+      LoadData<short>(varData, varOffset, block, subdimension,
+                      localghostSize, this->gridOffset, stride);
    }
+   delete [] buffer;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,7 @@
 #include "VPICDefinition.h"
 #include "VPICHeader.h"
 #include <fstream>
+#include <string.h>
 
 using namespace std;
 
@@ -22,6 +23,10 @@ public:
    void setFiles(string* names, int count);
    void initialize();
 
+   // Memory map a data file of this part on first access
+   const char* mapFile(int fileKind, long int& size);
+   void unmapFiles();
+
    // Calculate the location of this part in the subgrid for a processor
    void calculatePartLocation(int* stride);
 
@@ -62,6 +67,9 @@ public:
 
 private:
    string* fileName;            // field, ehydro, hhydro data files
+   int  numberOfFiles;          // Number of data files
+   char** fileData;             // Memory mapped data files or 0
+   long int* fileSize;          // Size of memory mapped data files
    int  simID;                  // Simulation processor that wrote file
    int  vizID;                  // Visualization processor that draws part
 
@@ -78,46 +86,25 @@ private:
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// Templated read of a basic data type from a file, to be stored in a
-// block of float supplied by the visualizer
+// Templated gather of a basic data type from the memory mapped (or read)
+// part file, to be stored in a block of float supplied by the visualizer.
+// Only the values at the requested stride are accessed.
 //
 /////////////////////////////////////////////////////////////////////////////
 
 template< class basicType >
 void LoadData(
-        int , //vizID,
-        int , //simID,
         float* varData,         // Grid over all parts to be filled
         int varOffset,          // Offset into the cached paraView block
                                 // Allows for ghost cells
-        basicType* block,       // Type of data to read from file
+        const char* block,      // Data of variable in file with ghost cells
         int* subdimension,      // Subdimension for processor owning this part
         int* blockDim,          // Dimension of data in the file
-        int blockSize,          // Amount of data for variable in file
         int* gridOffset,        // Offset with total data on proc for this part
-        string fileName,        // Field or species data file
-        long int offset,        // Load data from this offset
         int stride[])           // Stride over data requested
 {
-   // Get the file pointer to the offset for this variable and component
-   // Read the contiguous variable data from the file
-   FILE* filePtr = fopen(fileName.c_str(), "r");
-   if (filePtr == 0) {
-      cerr << "Failed to open file " << fileName << endl;
-      return;
-   }
-   fseek(filePtr, offset, SEEK_SET);
-
-   // Data read in includes ghost cells
-   block = new basicType[blockSize];
-   fread(block, sizeof(basicType), blockSize, filePtr);
-   fclose(filePtr);
-
    // Iterate over all data which includes ghost cells
    // Transfer the non-ghost data to the correct offset within varData
-   int varIndex;        // Index into returned visualizer block
-   int blockIndex;      // Index into file part data block
-
    int bx, by, bz;      // Block data index from VPIC file with strides
    int vx, vy, vz;      // Visualizer data index with no strides
 
@@ -127,42 +114,41 @@ void LoadData(
         bz += stride[2], vz++) {
 
       // Offset into entire viz data block for this file's part of data
+      // Store the final ghost cell unless it is beyond the subextent
       int offsetz = gridOffset[2] + vz;
+      if (offsetz == subdimension[2])
+         continue;
 
       for (by = 1, vy = varOffset;
            by < (blockDim[1] - 1);
            by += stride[1], vy++) {
 
-         // Offset into entire viz data block for this file's part of data
          int offsety = gridOffset[1] + vy;
+         if (offsety == subdimension[1])
+            continue;
+
+         // Row of the file block and of the sub grid for this processor
+         const char* blockRow = block + sizeof(basicType) *
+            (((long int) bz * blockDim[1] + by) * blockDim[0]);
+         float* varRow = varData +
+            ((long int) offsetz * subdimension[1] + offsety) * subdimension[0];
 
          for (bx = 1, vx = varOffset;
               bx < (blockDim[0] - 1);
               bx += stride[0], vx++) {
 
-            // Offset into entire viz data block for this file's part of data
             int offsetx = gridOffset[0] + vx;
-
-            blockIndex = (bz * blockDim[0] * blockDim[1]) +
-                         (by * blockDim[0]) + bx;
-
-
-            // Calculate the index into the sub grid for this processor
-            // Store the final ghost cell unless it is beyond the subextent
-            if (offsetx != subdimension[0] &&
-                offsety != subdimension[1] &&
-                offsetz != subdimension[2]) {
-
-                varIndex = (offsetz * subdimension[0] * subdimension[1]) +
-                           (offsety * subdimension[0]) + offsetx;
-
-                varData[varIndex] = (float) block[blockIndex];
-   //             varData[varIndex] = (float) simID;
-            }
+            if (offsetx == subdimension[0])
+               continue;
+
+            // File data need not be aligned for basicType
+            basicType value;
+            memcpy(&value, blockRow + bx * sizeof(basicType),
+                   sizeof(basicType));
+            varRow[offsetx] = (float) value;
          }
       }
    }
-   delete [] block;
 }
 
 #endif
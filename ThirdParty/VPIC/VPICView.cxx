@@ -1,5 +1,6 @@
 #include "VPICView.h"
 #include "VPICGlobal.h"
+#include "vtkSMPTools.h"
 
 #include <sys/types.h>
 #include <set>
@@ -14,6 +15,41 @@ const static char * Slash = "\\";
 const static char * Slash = "/";
 #endif
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// Load a variable component from many parts concurrently.  Every part
+// fills its own region of the processor grid.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+class VPICViewLoadParts {
+public:
+   vector<VPICPart*>* parts;
+   float* varData;
+   int varOffset;
+   int* subdimension;
+   int fileKind;
+   int basicType;
+   int byteCount;
+   long int offset;
+   int* stride;
+
+   void operator()(vtkIdType begin, vtkIdType end)
+   {
+      for (vtkIdType part = begin; part < end; part++) {
+         (*this->parts)[part]->loadVariableData(
+                            this->varData,
+                            this->varOffset,
+                            this->subdimension,
+                            this->fileKind,
+                            this->basicType,
+                            this->byteCount,
+                            this->offset,
+                            this->stride);
+      }
+   }
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // Structure for view of VPIC data file components
@@ -447,17 +483,28 @@ void VPICView::loadVariableData(
 
    // Read the variable data from file and store into overall var_array
    // Load the appropriate part of the data from the part
-   for (int part = 0; part < this->numberOfMyParts; part++) {
-      this->myParts[part]->loadVariableData(
-                            varData,
-                            varOffset,
-                            _subdimension,
-                            this->global.getVariableKind(var),
-                            this->global.getVariableType(var),
-                            this->global.getVariableByteCount(var),
-                            this->global.getVariableOffset(var, comp),
-                            stride);
-   }
+   VPICViewLoadParts loadParts;
+   loadParts.parts = &this->myParts;
+   loadParts.varData = varData;
+   loadParts.varOffset = varOffset;
+   loadParts.subdimension = _subdimension;
+   loadParts.fileKind = this->global.getVariableKind(var);
+   loadParts.basicType = this->global.getVariableType(var);
+   loadParts.byteCount = this->global.getVariableByteCount(var);
+   loadParts.offset = this->global.getVariableOffset(var, comp);
+   loadParts.stride = this->stride;
+
+   // If the stride does not divide the part size a part also fills the
+   // first position of the next part, which must then overwrite it
+   bool disjoint = true;
+   for (int dim = 0; dim < DIMENSION; dim++)
+      if (this->partSize[dim] % this->stride[dim] != 0)
+         disjoint = false;
+
+   if (disjoint)
+      vtkSMPTools::For(0, this->numberOfMyParts, 1, loadParts);
+   else
+      loadParts(0, this->numberOfMyParts);
 }
 
 //////////////////////////////////////////////////////////////////////////////